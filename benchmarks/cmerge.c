@@ -0,0 +1,70 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for three-way merges with elektraMerge of growing key sets
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+#include <kdbmerge.h>
+
+/**
+ * @brief Creates a key set with numKeys keys below root, spread over directories of 100 keys.
+ *
+ * Every tenth key is changed in our or removed in their, depending on which.
+ */
+static KeySet * createKeySet (const char * root, int numKeys, int which)
+{
+	char name[256];
+	KeySet * ks = ksNew (numKeys + 1, keyNew (root, KEY_END), KS_END);
+	for (int i = 0; i < numKeys; ++i)
+	{
+		const char * value = "original";
+		if (i % 10 == 0 && i / 10 % 2 == 0 && which == 0) value = "changed";
+		if (i % 10 == 0 && i / 10 % 2 == 1 && which == 1) continue;
+		snprintf (name, sizeof (name), "%s/dir%d/key%d", root, i / 100, i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, value, KEY_END));
+	}
+	return ks;
+}
+
+static size_t benchmarkMerge (int numKeys)
+{
+	KeySet * our = createKeySet ("user:/our", numKeys, 0);
+	KeySet * their = createKeySet ("user:/their", numKeys, 1);
+	KeySet * base = createKeySet ("user:/base", numKeys, 2);
+	Key * ourRoot = keyNew ("user:/our", KEY_END);
+	Key * theirRoot = keyNew ("user:/their", KEY_END);
+	Key * baseRoot = keyNew ("user:/base", KEY_END);
+	Key * resultRoot = keyNew ("user:/result", KEY_END);
+	Key * informationKey = keyNew ("/", KEY_END);
+
+	char msg[64];
+	snprintf (msg, sizeof (msg), "elektraMerge with %d keys", numKeys);
+	timeInit ();
+	KeySet * result = elektraMerge (our, ourRoot, their, theirRoot, base, baseRoot, resultRoot, MERGE_STRATEGY_ABORT, informationKey);
+	timePrint (msg);
+
+	size_t size = result ? ksGetSize (result) : 0;
+	ksDel (result);
+	ksDel (our);
+	ksDel (their);
+	ksDel (base);
+	keyDel (ourRoot);
+	keyDel (theirRoot);
+	keyDel (baseRoot);
+	keyDel (resultRoot);
+	keyDel (informationKey);
+	return size;
+}
+
+int main (void)
+{
+	size_t size = 0;
+	for (int numKeys = 1000; numKeys <= 1000000; numKeys *= 10)
+	{
+		size += benchmarkMerge (numKeys);
+	}
+	printf ("%zu\n", size);
+}
@@ -29,6 +29,80 @@ int benchmarkIterate (void)
 	return c;
 }
 
+/**
+ * Sets the names of all keys in the large keyset again,
+ * escaped names need the full canonicalization and unescaping.
+ */
+size_t benchmarkSetNames (const char * format)
+{
+	size_t size = 0;
+	char name[KEY_NAME_LENGTH + 1];
+	Key * key = keyNew ("/", KEY_END);
+
+	for (int i = 0; i < num_dir; i++)
+	{
+		for (int j = 0; j < num_key; j++)
+		{
+			snprintf (name, KEY_NAME_LENGTH, format, KEY_ROOT, "dir", i, "key", j);
+			size += keySetName (key, name);
+		}
+	}
+
+	keyDel (key);
+	return size;
+}
+
+/**
+ * Creates keys in sorted order below a common parent,
+ * like storage plugins reading their own files do.
+ */
+KeySet * benchmarkCreateBelow (bool trusted)
+{
+	char name[KEY_NAME_LENGTH + 1];
+	Key * parent = keyNew (KEY_ROOT, KEY_END);
+	KeySet * ks = ksNew (num_key * num_dir, KS_END);
+
+	for (int i = 0; i < num_dir; i++)
+	{
+		for (int j = 0; j < num_key; j++)
+		{
+			if (trusted)
+			{
+				int size = snprintf (name, KEY_NAME_LENGTH, "%s%05d/%s%08d", "dir", i, "key", j);
+				ksAppendKey (ks, elektraKeyNewTrusted (parent, name, size));
+			}
+			else
+			{
+				snprintf (name, KEY_NAME_LENGTH, "%s/%s%05d/%s%08d", KEY_ROOT, "dir", i, "key", j);
+				ksAppendKey (ks, keyNew (name, KEY_END));
+			}
+		}
+	}
+
+	keyDel (parent);
+	return ks;
+}
+
+/**
+ * Splits the keyset into two interleaved halves and appends one to the other.
+ */
+void benchmarkAppendInterleaved (KeySet * ks)
+{
+	KeySet * even = ksNew (ksGetSize (ks) / 2 + 1, KS_END);
+	KeySet * odd = ksNew (ksGetSize (ks) / 2 + 1, KS_END);
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		ksAppendKey (it % 2 == 0 ? even : odd, ksAtCursor (ks, it));
+	}
+	timePrint ("Split keyset");
+
+	ksAppend (even, odd);
+	timePrint ("Appended interleaved keyset");
+
+	ksDel (even);
+	ksDel (odd);
+}
+
 int main (int argc, char ** argv)
 {
 	if (argc != 3)
@@ -54,6 +128,23 @@ int main (int argc, char ** argv)
 	benchmarkIterate ();
 	timePrint ("Iterated over keyset");
 
+	benchmarkSetNames ("%s/%s%d/%s%d");
+	timePrint ("Set plain names");
+
+	benchmarkSetNames ("%s/%s%d/%s\\/%d");
+	timePrint ("Set escaped names");
+
+	KeySet * below = benchmarkCreateBelow (false);
+	timePrint ("Created sorted keys with keyNew");
+	ksDel (below);
+
+	below = benchmarkCreateBelow (true);
+	timePrint ("Created sorted keys with elektraKeyNewTrusted");
+
+	benchmarkAppendInterleaved (below);
+	ksDel (below);
+	timePrint ("Del sorted keyset");
+
 	benchmarkDel ();
 	timePrint ("Del large keyset");
 }
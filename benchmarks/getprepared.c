@@ -0,0 +1,91 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for polling with kdbGet() and kdbGetPrepared()
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <stdio.h>
+
+#include <benchmarks.h>
+#include <kdb.h>
+#include <kdbproposal.h>
+
+#define NUM_POLLS 1000
+
+#define CSV_STR_FMT "%s;%s;%d\n"
+
+
+static void benchmarkDel (void)
+{
+	ksDel (large);
+}
+
+static void pollGet (void)
+{
+	Key * parentKey = keyNew (KEY_ROOT, KEY_END);
+	KDB * handle = kdbOpen (NULL, parentKey);
+	KeySet * returned = ksNew (0, KS_END);
+
+	kdbGet (handle, returned, parentKey);
+
+	timeInit ();
+	for (size_t i = 0; i < NUM_POLLS; ++i)
+	{
+		if (kdbGet (handle, returned, parentKey) == -1) printExit ("kdbGet");
+	}
+	fprintf (stdout, CSV_STR_FMT, "core", "kdbGet", timeGetDiffMicroseconds ());
+
+	ksDel (returned);
+	kdbClose (handle, parentKey);
+	keyDel (parentKey);
+}
+
+static void pollGetPrepared (void)
+{
+	Key * parentKey = keyNew (KEY_ROOT, KEY_END);
+	KDB * handle = kdbOpen (NULL, parentKey);
+	KeySet * returned = ksNew (0, KS_END);
+
+	KDBPreparedGet * prepared = kdbGetPrepare (handle, parentKey);
+	if (!prepared) printExit ("kdbGetPrepare");
+	kdbGetPrepared (prepared, returned, parentKey);
+
+	timeInit ();
+	for (size_t i = 0; i < NUM_POLLS; ++i)
+	{
+		if (kdbGetPrepared (prepared, returned, parentKey) == -1) printExit ("kdbGetPrepared");
+	}
+	fprintf (stdout, CSV_STR_FMT, "core", "kdbGetPrepared", timeGetDiffMicroseconds ());
+
+	kdbGetPreparedDel (prepared);
+	ksDel (returned);
+	kdbClose (handle, parentKey);
+	keyDel (parentKey);
+}
+
+int main (void)
+{
+	num_dir = 20;
+	num_key = 50;
+	benchmarkCreate ();
+	benchmarkFillup ();
+
+	{
+		Key * parentKey = keyNew (KEY_ROOT, KEY_END);
+		KDB * handle = kdbOpen (NULL, parentKey);
+		KeySet * returned = ksNew (0, KS_END);
+		kdbGet (handle, returned, parentKey);
+		kdbSet (handle, large, parentKey);
+		kdbClose (handle, parentKey);
+		ksDel (returned);
+		keyDel (parentKey);
+	}
+
+	fprintf (stdout, "%s;%s;%s\n", "plugin", "operation", "microseconds");
+	pollGet ();
+	pollGetPrepared ();
+
+	benchmarkDel ();
+}
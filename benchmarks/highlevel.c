@@ -0,0 +1,117 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for repeatedly reading the same values with the high-level API
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+#include <elektra.h>
+#include <elektra/conversion.h>
+
+#define NUM_SETTINGS 200
+#define NUM_ROUNDS 10000
+
+#define CSV_STR_FMT "%s;%s;%d\n"
+
+static char settingNames[NUM_SETTINGS][BUF_SIZ];
+
+static void fatalErrorHandler (ElektraError * error)
+{
+	printExit (elektraErrorDescription (error));
+}
+
+static KeySet * createDefaults (void)
+{
+	KeySet * defaults = ksNew (2 * NUM_SETTINGS, KS_END);
+	char name[BUF_SIZ];
+	char value[BUF_SIZ];
+	for (size_t i = 0; i < NUM_SETTINGS; ++i)
+	{
+		// even settings are longs, odd ones doubles
+		snprintf (name, BUF_SIZ, "/settings/setting%03zu", i);
+		strcpy (settingNames[i], name + 1);
+		snprintf (value, BUF_SIZ, i % 2 == 0 ? "%zu" : "%zu.5", i * 1000);
+		ksAppendKey (defaults, keyNew (name, KEY_VALUE, value, KEY_META, "type",
+					       i % 2 == 0 ? KDB_TYPE_LONG : KDB_TYPE_DOUBLE, KEY_END));
+	}
+	return defaults;
+}
+
+static void benchmarkGetByName (Elektra * elektra)
+{
+	kdb_double_t sum = 0;
+	timeInit ();
+	for (size_t round = 0; round < NUM_ROUNDS; ++round)
+	{
+		for (size_t i = 0; i < NUM_SETTINGS; i += 2)
+		{
+			sum += elektraGetLong (elektra, settingNames[i]);
+			sum += elektraGetDouble (elektra, settingNames[i + 1]);
+		}
+	}
+	fprintf (stdout, CSV_STR_FMT, "name", "uncached", timeGetDiffMicroseconds ());
+	if (sum <= 0) printExit ("wrong sum");
+}
+
+static void benchmarkGetByHandleUncached (Elektra * elektra)
+{
+	kdb_double_t sum = 0;
+	timeInit ();
+	for (size_t round = 0; round < NUM_ROUNDS; ++round)
+	{
+		for (size_t i = 0; i < NUM_SETTINGS; i += 2)
+		{
+			// resolved handles, but the value is converted on every read
+			kdb_long_t longValue;
+			kdb_double_t doubleValue;
+			elektraKeyToLong (elektraFindKeyByHandle (elektraKeyHandle (elektra, i, settingNames[i], KDB_TYPE_LONG)), &longValue);
+			elektraKeyToDouble (elektraFindKeyByHandle (elektraKeyHandle (elektra, i + 1, settingNames[i + 1], KDB_TYPE_DOUBLE)),
+					    &doubleValue);
+			sum += longValue + doubleValue;
+		}
+	}
+	fprintf (stdout, CSV_STR_FMT, "handle", "uncached", timeGetDiffMicroseconds ());
+	if (sum <= 0) printExit ("wrong sum");
+}
+
+static void benchmarkGetByHandle (Elektra * elektra)
+{
+	kdb_double_t sum = 0;
+	timeInit ();
+	for (size_t round = 0; round < NUM_ROUNDS; ++round)
+	{
+		for (size_t i = 0; i < NUM_SETTINGS; i += 2)
+		{
+			sum += elektraGetLongByHandle (elektraKeyHandle (elektra, i, settingNames[i], KDB_TYPE_LONG));
+			sum += elektraGetDoubleByHandle (elektraKeyHandle (elektra, i + 1, settingNames[i + 1], KDB_TYPE_DOUBLE));
+		}
+	}
+	fprintf (stdout, CSV_STR_FMT, "handle", "cached", timeGetDiffMicroseconds ());
+	if (sum <= 0) printExit ("wrong sum");
+}
+
+int main (void)
+{
+	KeySet * defaults = createDefaults ();
+	ElektraError * error = NULL;
+	Elektra * elektra = elektraOpen ("/benchmark/highlevel", defaults, NULL, &error);
+	ksDel (defaults);
+	if (elektra == NULL)
+	{
+		fprintf (stderr, "elektraOpen failed: %s\n", elektraErrorDescription (error));
+		elektraErrorReset (&error);
+		return EXIT_FAILURE;
+	}
+
+	elektraFatalErrorHandler (elektra, &fatalErrorHandler);
+
+	fprintf (stdout, "%s;%s;%s\n", "access", "value", "microseconds");
+	benchmarkGetByName (elektra);
+	benchmarkGetByHandleUncached (elektra);
+	benchmarkGetByHandle (elektra);
+
+	elektraClose (elektra);
+	return EXIT_SUCCESS;
+}
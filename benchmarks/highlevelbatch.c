@@ -0,0 +1,88 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for updating many values with the high-level API, one by one and in a batch
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+#include <elektra.h>
+
+#define NUM_SETTINGS 100
+#define NUM_ROUNDS 10
+
+#define CSV_STR_FMT "%s;%d;%d\n"
+
+static char settingNames[NUM_SETTINGS][BUF_SIZ];
+
+static void fatalErrorHandler (ElektraError * error)
+{
+	printExit (elektraErrorDescription (error));
+}
+
+static void setAll (Elektra * elektra, size_t round)
+{
+	ElektraError * error = NULL;
+	for (size_t i = 0; i < NUM_SETTINGS; ++i)
+	{
+		elektraSetLong (elektra, settingNames[i], round * NUM_SETTINGS + i, &error);
+		if (error != NULL)
+		{
+			printExit (elektraErrorDescription (error));
+		}
+	}
+}
+
+static void benchmarkSingle (Elektra * elektra)
+{
+	timeInit ();
+	for (size_t round = 0; round < NUM_ROUNDS; ++round)
+	{
+		setAll (elektra, round);
+	}
+	fprintf (stdout, CSV_STR_FMT, "single", NUM_ROUNDS * NUM_SETTINGS, timeGetDiffMicroseconds ());
+}
+
+static void benchmarkBatch (Elektra * elektra)
+{
+	ElektraError * error = NULL;
+	timeInit ();
+	for (size_t round = 0; round < NUM_ROUNDS; ++round)
+	{
+		elektraBeginBatch (elektra);
+		setAll (elektra, round);
+		elektraCommitBatch (elektra, &error);
+		if (error != NULL)
+		{
+			printExit (elektraErrorDescription (error));
+		}
+	}
+	fprintf (stdout, CSV_STR_FMT, "batch", NUM_ROUNDS * NUM_SETTINGS, timeGetDiffMicroseconds ());
+}
+
+int main (void)
+{
+	for (size_t i = 0; i < NUM_SETTINGS; ++i)
+	{
+		snprintf (settingNames[i], BUF_SIZ, "settings/setting%03zu", i);
+	}
+
+	ElektraError * error = NULL;
+	Elektra * elektra = elektraOpen ("user:/benchmark/highlevelbatch", NULL, NULL, &error);
+	if (elektra == NULL)
+	{
+		fprintf (stderr, "elektraOpen failed: %s\n", elektraErrorDescription (error));
+		elektraErrorReset (&error);
+		return EXIT_FAILURE;
+	}
+
+	elektraFatalErrorHandler (elektra, &fatalErrorHandler);
+
+	fprintf (stdout, "%s;%s;%s\n", "save", "updates", "microseconds");
+	benchmarkSingle (elektra);
+	benchmarkBatch (elektra);
+
+	elektraClose (elektra);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the latency of notification delivery through the epoll I/O binding
+ *
+ * The transport plugins deliver notifications by watching a file descriptor,
+ * so the delay between a write to a pipe in another thread and the call of the
+ * file descriptor callback is the latency the binding adds to every notification.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <kdbio.h>
+#include <kdbio/epoll.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+
+#define NUM_NOTIFICATIONS 10000
+#define NUM_TIMER_CALLS 1000
+#define NOTIFICATION_INTERVAL_MICROSECONDS 100
+#define TIMER_INTERVAL_MILLISECONDS 1
+
+typedef struct
+{
+	ElektraIoEpollLoop * loop;
+	int fds[2];
+	int count;
+	unsigned long long last;
+	unsigned long long * latencies;
+} BenchmarkData;
+
+static unsigned long long now (void)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int compareLatencies (const void * a, const void * b)
+{
+	unsigned long long x = *(const unsigned long long *) a;
+	unsigned long long y = *(const unsigned long long *) b;
+	return (x > y) - (x < y);
+}
+
+static void printLatencies (const char * msg, unsigned long long * latencies, int count)
+{
+	unsigned long long sum = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		sum += latencies[i];
+	}
+	qsort (latencies, count, sizeof (unsigned long long), compareLatencies);
+	printf ("%-40s mean %8.2f us, median %8.2f us, 99%% %8.2f us, max %8.2f us\n", msg, sum / 1000.0 / count,
+		latencies[count / 2] / 1000.0, latencies[count * 99 / 100] / 1000.0, latencies[count - 1] / 1000.0);
+}
+
+static void * notifier (void * arg)
+{
+	BenchmarkData * data = arg;
+	for (int i = 0; i < NUM_NOTIFICATIONS; ++i)
+	{
+		usleep (NOTIFICATION_INTERVAL_MICROSECONDS);
+		unsigned long long sent = now ();
+		if (write (data->fds[1], &sent, sizeof (sent)) != sizeof (sent))
+		{
+			perror ("write");
+			break;
+		}
+	}
+	return NULL;
+}
+
+static void notificationCallback (ElektraIoFdOperation * fdOp, int flags ELEKTRA_UNUSED)
+{
+	unsigned long long received = now ();
+	BenchmarkData * data = elektraIoFdGetData (fdOp);
+
+	unsigned long long sent;
+	while (read (data->fds[0], &sent, sizeof (sent)) == sizeof (sent))
+	{
+		data->latencies[data->count++] = received - sent;
+		if (data->count == NUM_NOTIFICATIONS)
+		{
+			elektraIoFdSetEnabled (fdOp, 0);
+			elektraIoBindingUpdateFd (fdOp);
+			return;
+		}
+	}
+}
+
+static void benchmarkNotifications (ElektraIoInterface * binding, BenchmarkData * data)
+{
+	if (pipe (data->fds) != 0)
+	{
+		perror ("pipe");
+		return;
+	}
+	fcntl (data->fds[0], F_SETFL, O_NONBLOCK);
+	data->count = 0;
+
+	ElektraIoFdOperation * fdOp = elektraIoNewFdOperation (data->fds[0], ELEKTRA_IO_READABLE, 1, notificationCallback, data);
+	elektraIoBindingAddFd (binding, fdOp);
+
+	pthread_t thread;
+	pthread_create (&thread, NULL, notifier, data);
+	elektraIoEpollLoopRun (data->loop);
+	pthread_join (thread, NULL);
+
+	printLatencies ("pipe write to fd callback", data->latencies, data->count);
+
+	elektraIoBindingRemoveFd (fdOp);
+	elektraFree (fdOp);
+	close (data->fds[0]);
+	close (data->fds[1]);
+}
+
+static void timerCallback (ElektraIoTimerOperation * timerOp)
+{
+	unsigned long long called = now ();
+	BenchmarkData * data = elektraIoTimerGetData (timerOp);
+
+	unsigned long long expected = TIMER_INTERVAL_MILLISECONDS * 1000000ULL;
+	unsigned long long interval = called - data->last;
+	data->latencies[data->count++] = interval > expected ? interval - expected : expected - interval;
+	data->last = called;
+
+	if (data->count == NUM_TIMER_CALLS)
+	{
+		elektraIoTimerSetEnabled (timerOp, 0);
+		elektraIoBindingUpdateTimer (timerOp);
+	}
+}
+
+static void benchmarkTimer (ElektraIoInterface * binding, BenchmarkData * data)
+{
+	data->count = 0;
+	data->last = now ();
+
+	ElektraIoTimerOperation * timerOp = elektraIoNewTimerOperation (TIMER_INTERVAL_MILLISECONDS, 1, timerCallback, data);
+	elektraIoBindingAddTimer (binding, timerOp);
+
+	elektraIoEpollLoopRun (data->loop);
+
+	printLatencies ("timer deviation from interval", data->latencies, data->count);
+
+	elektraIoBindingRemoveTimer (timerOp);
+	elektraFree (timerOp);
+}
+
+int main (void)
+{
+	BenchmarkData data;
+	data.loop = elektraIoEpollLoopNew ();
+	data.latencies = elektraMalloc (NUM_NOTIFICATIONS * sizeof (unsigned long long));
+	if (data.loop == NULL || data.latencies == NULL)
+	{
+		fprintf (stderr, "could not create loop\n");
+		return 1;
+	}
+	ElektraIoInterface * binding = elektraIoEpollNew (data.loop);
+
+	benchmarkNotifications (binding, &data);
+	benchmarkTimer (binding, &data);
+
+	elektraIoBindingCleanup (binding);
+	elektraIoEpollLoopDel (data.loop);
+	elektraFree (data.latencies);
+
+	return 0;
+}
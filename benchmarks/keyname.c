@@ -0,0 +1,82 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for building key names
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#define NUM_NAMES 100000
+
+static const char * parentName = "user:/benchmark/application/profile/current";
+
+static size_t benchmarkSetName (void)
+{
+	size_t size = 0;
+	char name[256];
+	Key * key = keyNew ("/", KEY_END);
+	for (int i = 0; i < NUM_NAMES; ++i)
+	{
+		snprintf (name, sizeof (name), "%s/group%d/setting%d", parentName, i % 100, i);
+		size += keySetName (key, name);
+	}
+	keyDel (key);
+	return size;
+}
+
+static size_t benchmarkAddName (const char * format)
+{
+	size_t size = 0;
+	char name[256];
+	Key * key = keyNew (parentName, KEY_END);
+	for (int i = 0; i < NUM_NAMES; ++i)
+	{
+		snprintf (name, sizeof (name), format, i % 100, i);
+		keySetName (key, parentName);
+		size += keyAddName (key, name);
+	}
+	keyDel (key);
+	return size;
+}
+
+static size_t benchmarkCopyAddName (const char * format)
+{
+	size_t size = 0;
+	char name[256];
+	Key * parent = keyNew (parentName, KEY_END);
+	Key * key = keyNew ("/", KEY_END);
+	for (int i = 0; i < NUM_NAMES; ++i)
+	{
+		snprintf (name, sizeof (name), format, i % 100, i);
+		keyCopy (key, parent, KEY_CP_NAME);
+		size += keyAddName (key, name);
+	}
+	keyDel (key);
+	keyDel (parent);
+	return size;
+}
+
+int main (void)
+{
+	size_t size = 0;
+
+	timeInit ();
+	size += benchmarkSetName ();
+	timePrint ("keySetName with full names");
+
+	size += benchmarkAddName ("group%d/setting%d");
+	timePrint ("keySetName of parent + keyAddName with plain names");
+
+	size += benchmarkAddName ("group%d/#%d");
+	timePrint ("keySetName of parent + keyAddName with array parts");
+
+	size += benchmarkAddName ("group%d/setting\\/%d");
+	timePrint ("keySetName of parent + keyAddName with escaped names");
+
+	size += benchmarkCopyAddName ("group%d/setting%d");
+	timePrint ("keyCopy of parent + keyAddName with plain names");
+
+	printf ("%zu\n", size);
+}
@@ -0,0 +1,119 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for binary search lookups in deep and wide hierarchies
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#define NUM_TEAMS 10
+#define NUM_SERVICES 10
+#define NUM_COMPONENTS 100
+
+#define NUM_DIRS 1000
+
+#define NUM_LOOKUPS 1000000
+
+#define CSV_STR_FMT "%s;%s;%zu;%d\n"
+
+typedef void (*KeyNameFunction) (char * name, size_t size, size_t i);
+
+// names are zero padded, so generating them in order also sorts them
+static void deepKeyName (char * name, size_t size, size_t i)
+{
+	size_t keysPerComponent = size / (NUM_TEAMS * NUM_SERVICES * NUM_COMPONENTS);
+	size_t component = i / keysPerComponent;
+	snprintf (name, KEY_NAME_LENGTH, "user:/org/department/team%02zu/service%02zu/component%03zu/settings/key%06zu",
+		  component / (NUM_SERVICES * NUM_COMPONENTS), (component / NUM_COMPONENTS) % NUM_SERVICES, component % NUM_COMPONENTS,
+		  i % keysPerComponent);
+}
+
+static void deepHierarchyName (char * name, size_t size ELEKTRA_UNUSED, size_t i)
+{
+	size_t component = i % (NUM_TEAMS * NUM_SERVICES * NUM_COMPONENTS);
+	snprintf (name, KEY_NAME_LENGTH, "user:/org/department/team%02zu/service%02zu/component%03zu",
+		  component / (NUM_SERVICES * NUM_COMPONENTS), (component / NUM_COMPONENTS) % NUM_SERVICES, component % NUM_COMPONENTS);
+}
+
+static void wideKeyName (char * name, size_t size, size_t i)
+{
+	size_t keysPerDir = size / NUM_DIRS;
+	snprintf (name, KEY_NAME_LENGTH, "%s/dir%04zu/key%06zu", KEY_ROOT, i / keysPerDir, i % keysPerDir);
+}
+
+static void wideHierarchyName (char * name, size_t size ELEKTRA_UNUSED, size_t i)
+{
+	snprintf (name, KEY_NAME_LENGTH, "%s/dir%04zu", KEY_ROOT, i % NUM_DIRS);
+}
+
+static void benchmarkLookup (const char * hierarchy, size_t size, KeyNameFunction createName, KeyNameFunction hierarchyName)
+{
+	char name[KEY_NAME_LENGTH + 1];
+	KeySet * ks = ksNew (size, KS_END);
+
+	timeInit ();
+	for (size_t i = 0; i < size; ++i)
+	{
+		createName (name, size, i);
+		ksAppendKey (ks, keyNew (name, KEY_END));
+	}
+	fprintf (stdout, CSV_STR_FMT, hierarchy, "ksAppendKey", size, timeGetDiffMicroseconds ());
+
+	Key ** lookups = elektraMalloc (NUM_LOOKUPS * sizeof (Key *));
+	if (!lookups) printExit ("malloc");
+	int32_t seed = 4711;
+	for (size_t i = 0; i < NUM_LOOKUPS; ++i)
+	{
+		elektraRand (&seed);
+		createName (name, size, (size_t) seed % size);
+		lookups[i] = keyNew (name, KEY_END);
+	}
+
+	timeInit ();
+	for (size_t i = 0; i < NUM_LOOKUPS; ++i)
+	{
+		if (!ksLookup (ks, lookups[i], KDB_O_BINSEARCH)) printExit ("key not found");
+	}
+	fprintf (stdout, CSV_STR_FMT, hierarchy, "ksLookup", size, timeGetDiffMicroseconds ());
+
+	timeInit ();
+	for (size_t i = 0; i < NUM_LOOKUPS; ++i)
+	{
+		if (ksSearch (ks, lookups[i]) < 0) printExit ("key not found");
+	}
+	fprintf (stdout, CSV_STR_FMT, hierarchy, "ksSearch", size, timeGetDiffMicroseconds ());
+
+	for (size_t i = 0; i < NUM_LOOKUPS; ++i)
+	{
+		hierarchyName (name, size, i);
+		keySetName (lookups[i], name);
+	}
+
+	timeInit ();
+	for (size_t i = 0; i < NUM_LOOKUPS; ++i)
+	{
+		elektraCursor end;
+		if (ksFindHierarchy (ks, lookups[i], &end) == ksGetSize (ks)) printExit ("hierarchy not found");
+	}
+	fprintf (stdout, CSV_STR_FMT, hierarchy, "ksFindHierarchy", size, timeGetDiffMicroseconds ());
+
+	for (size_t i = 0; i < NUM_LOOKUPS; ++i)
+	{
+		keyDel (lookups[i]);
+	}
+	elektraFree (lookups);
+	ksDel (ks);
+}
+
+int main (int argc, char ** argv)
+{
+	size_t size = 1000000;
+	if (argc > 1) size = strtoul (argv[1], NULL, 10);
+	if (size < NUM_TEAMS * NUM_SERVICES * NUM_COMPONENTS) printExit ("size too small");
+
+	fprintf (stdout, "%s;%s;%s;%s\n", "hierarchy", "operation", "keys", "microseconds");
+	benchmarkLookup ("deep", size, deepKeyName, deepHierarchyName);
+	benchmarkLookup ("wide", size, wideKeyName, wideHierarchyName);
+}
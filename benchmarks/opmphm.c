@@ -25,7 +25,7 @@
 #include <search.h>
 #endif
 
-#ifdef USE_OPENMP
+#ifdef _OPENMP
 #include <omp.h>
 #endif
 
@@ -170,6 +170,171 @@ static void benchmarkHashFunctionTime (char * name)
  * END ========================================= Measures the Opmphm Hash Function time ================================================ END
  */
 
+/**
+ * START ======================================= Compares the Opmphm Hash Functions ================================================ START
+ *
+ * This benchmark compares all hash functions available for the OPMPHM, regardless of the one selected with OPMPHM_HASHFUNCTION.
+ * For each KeySet shape and n (KeySet size) one KeySet is generated and for each hash function measured:
+ *
+ * - the median time in nanoseconds to hash one key name, over runs runs
+ * - the number of key names whose 32 bit hash collides with the hash of another key name
+ * - the number of failed mappings (retries) until the r-uniform r-partite hypergraph was acyclic, with the optimal r and c
+ *
+ * The output has the following header: shape;n;hashfunction;nsperkey;bytesperkey;collisions;retries
+ *
+ * This benchmark takes numberOfShapes * nCount * 2 seeds
+ */
+
+typedef uint32_t (*OpmphmHashfunction) (const void *, size_t, uint32_t);
+
+static int cmpHash (const void * a, const void * b)
+{
+	uint32_t x = *(const uint32_t *) a;
+	uint32_t y = *(const uint32_t *) b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief opmphmMapping (...) with a given hash function
+ *
+ * @retval 0 on success
+ * @retval -1 mapping not possible
+ */
+static int benchmarkHashFunctionCompareMapping (Opmphm * opmphm, OpmphmGraph * graph, OpmphmInit * init, size_t n,
+						OpmphmHashfunction hashFunction)
+{
+	for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
+	{
+		elektraRand (&(init->initSeed));
+		opmphm->hashFunctionSeeds[r] = init->initSeed;
+	}
+	for (size_t i = 0; i < n; ++i)
+	{
+		const char * name = init->getName (init->data[i]);
+		for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
+		{
+			uint32_t v = hashFunction (name, strlen (name), opmphm->hashFunctionSeeds[r]) % opmphm->componentSize;
+			graph->edges[i].vertices[r] = v;
+			graph->vertices[r * opmphm->componentSize + v].edgeXor ^= i;
+			++graph->vertices[r * opmphm->componentSize + v].degree;
+		}
+	}
+	if (hasCycle (opmphm, graph, n))
+	{
+		opmphmGraphClear (opmphm, graph);
+		return -1;
+	}
+	return 0;
+}
+
+static void benchmarkHashFunctionCompare (char * name)
+{
+	const size_t nCount = 4;
+	const size_t n[] = { 100, 1000, 10000, 100000 };
+	const size_t runs = 11;
+	const size_t maxMappings = 100;
+	const size_t hashFunctionsCount = 2;
+	const OpmphmHashfunction hashFunctions[] = { opmphmHashfunctionJenkins, opmphmHashfunctionWyhash };
+	const char * hashFunctionNames[] = { "jenkins", "wyhash" };
+
+	size_t * times = elektraMalloc (runs * sizeof (size_t));
+	uint32_t * hashes = elektraMalloc (n[nCount - 1] * sizeof (uint32_t));
+	if (!times || !hashes)
+	{
+		printExit ("malloc");
+	}
+	FILE * out = openOutFileWithRPartitePostfix ("benchmark_opmphm_hashfunctioncompare", 0);
+	if (!out)
+	{
+		printExit ("open out file");
+	}
+	fprintf (out, "shape;n;hashfunction;nsperkey;bytesperkey;collisions;retries\n");
+
+	printf ("Run Benchmark %s:\n", name);
+	KeySetShape * keySetShapes = getKeySetShapes ();
+	for (size_t i = 0; i < nCount; ++i)
+	{
+		for (size_t s = 0; s < numberOfShapes; ++s)
+		{
+			printf ("now at n: %zu/%zu shape: %zu/%zu\r", i, nCount, s, numberOfShapes);
+			fflush (stdout);
+			int32_t genSeed;
+			int32_t mappingSeed;
+			if (getRandomSeed (&genSeed) != &genSeed) printExit ("Seed Parsing Error or feed me more seeds");
+			if (getRandomSeed (&mappingSeed) != &mappingSeed) printExit ("Seed Parsing Error or feed me more seeds");
+			KeySet * ks = generateKeySet (n[i], &genSeed, &keySetShapes[s]);
+			size_t bytes = 0;
+			for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+			{
+				bytes += strlen (keyName (ksAtCursor (ks, it)));
+			}
+
+			for (size_t h = 0; h < hashFunctionsCount; ++h)
+			{
+				// throughput
+				for (size_t r = 0; r < runs; ++r)
+				{
+					struct timeval start;
+					struct timeval end;
+					__asm__("");
+					gettimeofday (&start, 0);
+					__asm__("");
+					for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+					{
+						const char * keyname = keyName (ksAtCursor (ks, it));
+						hashes[it] = hashFunctions[h](keyname, strlen (keyname), 1337);
+						__asm__("");
+					}
+					__asm__("");
+					gettimeofday (&end, 0);
+					__asm__("");
+					times[r] = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_usec - start.tv_usec);
+				}
+				qsort (times, runs, sizeof (size_t), cmpInteger);
+
+				// collisions
+				qsort (hashes, n[i], sizeof (uint32_t), cmpHash);
+				size_t collisions = 0;
+				for (size_t k = 1; k < n[i]; ++k)
+				{
+					if (hashes[k] == hashes[k - 1]) ++collisions;
+				}
+
+				// retries
+				Opmphm * opmphm = opmphmNew ();
+				if (!opmphm) printExit ("opmphm");
+				uint8_t rUniPar = opmphmOptR (n[i]);
+				OpmphmGraph * graph = opmphmGraphNew (opmphm, rUniPar, n[i], opmphmMinC (rUniPar) + opmphmOptC (n[i]));
+				if (!graph) printExit ("graph");
+				OpmphmInit init;
+				init.getName = getString;
+				init.data = (void **) ks->array;
+				init.initSeed = mappingSeed;
+				size_t retries = 0;
+				while (retries < maxMappings && benchmarkHashFunctionCompareMapping (opmphm, graph, &init, n[i], hashFunctions[h]))
+				{
+					++retries;
+				}
+				opmphmDel (opmphm);
+				opmphmGraphDel (graph);
+
+				fprintf (out, "%zu;%zu;%s;%.2f;%.2f;%zu;%zu\n", s, n[i], hashFunctionNames[h],
+					 (double) times[runs / 2] * 1000 / n[i], (double) bytes / n[i], collisions, retries);
+			}
+			ksDel (ks);
+		}
+	}
+	printf ("\n");
+	fclose (out);
+	elektraFree (keySetShapes);
+	elektraFree (hashes);
+	elektraFree (times);
+}
+
+/**
+ * END ========================================= Compares the Opmphm Hash Functions ================================================== END
+ */
+
 /**
  * START ======================================================= Mapping ============================================================= START
  *
@@ -1003,9 +1168,11 @@ static void benchmarkMappingAllSeeds (char * name)
  * The keyset shape 6 is excluded, because previous evaluation had show that the results with that keyset shape
  * where unusable, due to the unnatural long key names.
  * For one n (KeySet size) ksPerN KeySets are used.
+ * If built with OpenMP (`ENABLE_OPENMP`), each build is measured with 1, 2, 4 and 8 threads and the speedup
+ * compared to 1 thread is reported, otherwise only 1 thread is used.
  * The results are written out in the following format:
  *
- * n;ks;time
+ * n;ks;threads;time;speedup
  *
  * The number of needed seeds for this benchmarks is: (numberOfShapes - 1) * ( numberOfSeeds + nCount * ksPerN )
  */
@@ -1073,6 +1240,13 @@ void benchmarkOPMPHMBuildTime (char * name)
 	const size_t ksPerN = 5;
 	const size_t numberOfSeeds = 51;
 	const size_t numberOfRepeats = 7;
+#ifdef _OPENMP
+	const size_t threads[] = { 1, 2, 4, 8 };
+	const size_t threadsCount = 4;
+#else
+	const size_t threads[] = { 1 };
+	const size_t threadsCount = 1;
+#endif
 
 	// check config
 	if (startN >= endN || startN == 0)
@@ -1107,7 +1281,7 @@ void benchmarkOPMPHMBuildTime (char * name)
 		printExit ("malloc");
 	}
 	// init results
-	size_t * results = elektraMalloc (nCount * ksPerN * numberOfSeeds * sizeof (size_t));
+	size_t * results = elektraMalloc (nCount * ksPerN * numberOfSeeds * threadsCount * sizeof (size_t));
 	if (!results)
 	{
 		printExit ("malloc");
@@ -1168,11 +1342,20 @@ void benchmarkOPMPHMBuildTime (char * name)
 				// for all KeySets in the storage
 				for (size_t ksI = 0; ksI < ksPerN; ++ksI)
 				{
-					// measure
-					size_t res = benchmarkOPMPHMBuildTimeMeasure (keySetStorage[ksI], repeats, numberOfRepeats);
+					// for all thread counts
+					for (size_t threadsI = 0; threadsI < threadsCount; ++threadsI)
+					{
+#ifdef _OPENMP
+						omp_set_num_threads (threads[threadsI]);
+#endif
+						// measure
+						size_t res = benchmarkOPMPHMBuildTimeMeasure (keySetStorage[ksI], repeats, numberOfRepeats);
 
-					// store res
-					results[((nI - startN) / stepN) * ksPerN * numberOfSeeds + ksI * numberOfSeeds + seedI] = res;
+						// store res
+						results[(((nI - startN) / stepN) * ksPerN * numberOfSeeds + ksI * numberOfSeeds + seedI) *
+								threadsCount +
+							threadsI] = res;
+					}
 				}
 			}
 
@@ -1190,7 +1373,7 @@ void benchmarkOPMPHMBuildTime (char * name)
 			printExit ("open out file");
 		}
 		// print header
-		fprintf (out, "n;ks;time\n");
+		fprintf (out, "n;ks;threads;time;speedup\n");
 		// print data
 		for (size_t nI = startN; nI <= endN; nI += stepN)
 		{
@@ -1198,8 +1381,15 @@ void benchmarkOPMPHMBuildTime (char * name)
 			{
 				for (size_t seedI = 0; seedI < numberOfSeeds; ++seedI)
 				{
-					fprintf (out, "%zu;%zu;%zu\n", nI, ksI,
-						 results[((nI - startN) / stepN) * ksPerN * numberOfSeeds + ksI * numberOfSeeds + seedI]);
+					size_t * result =
+						&results[(((nI - startN) / stepN) * ksPerN * numberOfSeeds + ksI * numberOfSeeds + seedI) *
+							 threadsCount];
+					for (size_t threadsI = 0; threadsI < threadsCount; ++threadsI)
+					{
+						// speedup compared to 1 thread
+						double speedup = result[threadsI] ? (double) result[0] / result[threadsI] : 1.0;
+						fprintf (out, "%zu;%zu;%zu;%zu;%.3f\n", nI, ksI, threads[threadsI], result[threadsI], speedup);
+					}
 				}
 			}
 		}
@@ -2114,7 +2304,7 @@ static void benchmarkPrintAllKeySetShapes (char * name)
 int main (int argc, char ** argv)
 {
 	// define all benchmarks
-	size_t benchmarksCount = 9;
+	size_t benchmarksCount = 10;
 #ifdef HAVE_HSEARCHR
 	// hsearchbuildtime
 	++benchmarksCount;
@@ -2170,6 +2360,11 @@ int main (int argc, char ** argv)
 	benchmarks[8].name = benchmarkNamePredictionTime;
 	benchmarks[8].benchmarkF = benchmarkPredictionTime;
 	benchmarks[8].numberOfSeedsNeeded = 3496500;
+	// hashfunctioncompare
+	char * benchmarkNameHashFunctionCompare = "hashfunctioncompare";
+	benchmarks[9].name = benchmarkNameHashFunctionCompare;
+	benchmarks[9].benchmarkF = benchmarkHashFunctionCompare;
+	benchmarks[9].numberOfSeedsNeeded = 64;
 #ifdef HAVE_HSEARCHR
 	// hsearchbuildtime
 	char * benchmarkNameHsearchBuildTime = "hsearchbuildtime";
@@ -0,0 +1,192 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the per-call overhead of plugins executed via pluginprocess
+ *
+ * Every call of a plugin executed in a child process transfers the keyset to the
+ * child and back. The first part measures complete kdbGet calls of a plugin that
+ * returns the keyset unchanged, the second part the round trip of the keyset
+ * through the dump and the mmapstorage format on its own, as pluginprocess uses
+ * mmapstorage on memory files if available and dump on pipes otherwise.
+ * The last part compares opening and closing many instances of the plugin with
+ * a child process each and with one shared child process.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <kdbinvoke.h>
+#include <kdbpluginprocessprivate.h>
+#include <kdbprivate.h>
+
+#define NUM_CALLS 10
+#define NUM_INSTANCES 20
+
+static int benchmarkOpen (Plugin * handle, Key * errorKey)
+{
+	ElektraPluginProcess * pp = elektraPluginGetData (handle);
+	if (pp == NULL)
+	{
+		if ((pp = elektraPluginProcessInit (errorKey)) == NULL) return ELEKTRA_PLUGIN_STATUS_ERROR;
+		elektraPluginSetData (handle, pp);
+		if (!elektraPluginProcessIsParent (pp)) elektraPluginProcessStart (handle, pp);
+	}
+	if (elektraPluginProcessIsParent (pp)) return elektraPluginProcessOpen (pp, errorKey);
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+static int benchmarkSharedOpen (Plugin * handle, Key * errorKey)
+{
+	ElektraPluginProcess * pp = elektraPluginGetData (handle);
+	if (pp == NULL)
+	{
+		if ((pp = elektraPluginProcessInitShared (handle, errorKey)) == NULL) return ELEKTRA_PLUGIN_STATUS_ERROR;
+		elektraPluginSetData (handle, pp);
+		if (!elektraPluginProcessIsParent (pp)) elektraPluginProcessStart (handle, pp);
+	}
+	if (elektraPluginProcessIsParent (pp)) return elektraPluginProcessOpen (pp, errorKey);
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+static int benchmarkClose (Plugin * handle, Key * errorKey)
+{
+	ElektraPluginProcess * pp = elektraPluginGetData (handle);
+	if (pp && elektraPluginProcessIsParent (pp))
+	{
+		elektraPluginSetData (handle, NULL);
+		return elektraPluginProcessClose (pp, errorKey).result;
+	}
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+static int benchmarkGet (Plugin * handle, KeySet * returned, Key * parentKey)
+{
+	ElektraPluginProcess * pp = elektraPluginGetData (handle);
+	if (elektraPluginProcessIsParent (pp)) return elektraPluginProcessSend (pp, ELEKTRA_PLUGINPROCESS_GET, returned, parentKey);
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+static KeySet * createKeySet (int size)
+{
+	KeySet * ks = ksNew (size, KS_END);
+	char name[KEY_NAME_LENGTH];
+	for (int i = 0; i < size; ++i)
+	{
+		snprintf (name, sizeof (name), "%s/dir%d/key%d", KEY_ROOT, i / 100, i);
+		Key * key = keyNew (name, KEY_VALUE, name, KEY_END);
+		if (i % 10 == 0) keySetMeta (key, "meta/index", name);
+		ksAppendKey (ks, key);
+	}
+	return ks;
+}
+
+static void benchmarkPluginProcess (KeySet * ks)
+{
+	struct _Plugin plugin = { .kdbOpen = benchmarkOpen, .kdbClose = benchmarkClose, .kdbGet = benchmarkGet, .name = "benchmark" };
+	Key * parentKey = keyNew (KEY_ROOT, KEY_END);
+
+	if (plugin.kdbOpen (&plugin, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
+	{
+		fprintf (stderr, "could not start child process\n");
+		keyDel (parentKey);
+		return;
+	}
+
+	timeInit ();
+	for (int i = 0; i < NUM_CALLS; ++i)
+	{
+		if (plugin.kdbGet (&plugin, ks, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS) fprintf (stderr, "kdbGet failed\n");
+	}
+	printf ("%-30s %10d us per call\n", "pluginprocess kdbGet", timeGetDiffMicroseconds () / NUM_CALLS);
+
+	plugin.kdbClose (&plugin, parentKey);
+	keyDel (parentKey);
+}
+
+static void benchmarkRoundTrip (const char * pluginName, KeySet * ks)
+{
+	// pluginprocess configures dump like this
+	KeySet * config = ksNew (1, keyNew ("user:/fullname", KEY_END), KS_END);
+	ElektraInvokeHandle * handle = elektraInvokeOpen (pluginName, config, NULL);
+	ksDel (config);
+	if (handle == NULL)
+	{
+		printf ("%-30s %10s\n", pluginName, "not available");
+		return;
+	}
+
+	char path[] = "/tmp/elektra-benchmark-pluginprocess-XXXXXX";
+	int fd = mkstemp (path);
+	if (fd == -1)
+	{
+		perror ("mkstemp");
+		elektraInvokeClose (handle, NULL);
+		return;
+	}
+	unlink (path);
+	// the same kind of file name pluginprocess uses for its pipes and memory files
+	char fdPath[64];
+	snprintf (fdPath, sizeof (fdPath), "/dev/fd/%d", fd);
+	Key * fileKey = keyNew (KEY_ROOT, KEY_VALUE, fdPath, KEY_END);
+
+	timeInit ();
+	for (int i = 0; i < NUM_CALLS; ++i)
+	{
+		elektraInvoke2Args (handle, "set", ks, fileKey);
+		// dump reads directly from the file descriptor
+		lseek (fd, 0, SEEK_SET);
+		KeySet * received = ksNew (ksGetSize (ks), KS_END);
+		elektraInvoke2Args (handle, "get", received, fileKey);
+		if (ksGetSize (received) != ksGetSize (ks)) fprintf (stderr, "%s lost keys\n", pluginName);
+		ksDel (received);
+	}
+	char msg[64];
+	snprintf (msg, sizeof (msg), "%s round trip", pluginName);
+	printf ("%-30s %10d us per call\n", msg, timeGetDiffMicroseconds () / NUM_CALLS);
+
+	keyDel (fileKey);
+	close (fd);
+	elektraInvokeClose (handle, NULL);
+}
+
+static void benchmarkInstances (const char * name, kdbOpenPtr open)
+{
+	struct _Plugin plugins[NUM_INSTANCES];
+	KeySet * config = ksNew (0, KS_END);
+	Key * parentKey = keyNew (KEY_ROOT, KEY_END);
+	fflush (stdout);
+
+	timeInit ();
+	for (int i = 0; i < NUM_INSTANCES; ++i)
+	{
+		plugins[i] = (struct _Plugin){ .kdbOpen = open, .kdbClose = benchmarkClose, .name = "benchmark", .config = config };
+		if (plugins[i].kdbOpen (&plugins[i], parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS) fprintf (stderr, "kdbOpen failed\n");
+	}
+	for (int i = 0; i < NUM_INSTANCES; ++i)
+	{
+		plugins[i].kdbClose (&plugins[i], parentKey);
+	}
+	printf ("%-30s %10d us for %d instances\n", name, timeGetDiffMicroseconds (), NUM_INSTANCES);
+
+	keyDel (parentKey);
+	ksDel (config);
+}
+
+int main (void)
+{
+	for (int size = 10000; size <= 100000; size *= 10)
+	{
+		printf ("%d keys\n", size);
+		// the child process must not inherit unwritten output
+		fflush (stdout);
+		KeySet * ks = createKeySet (size);
+		benchmarkPluginProcess (ks);
+		benchmarkRoundTrip ("dump", ks);
+		benchmarkRoundTrip ("mmapstorage", ks);
+		ksDel (ks);
+	}
+	benchmarkInstances ("open and close", benchmarkOpen);
+	benchmarkInstances ("open and close shared", benchmarkSharedOpen);
+	return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the throughput of the process plugin with the dump format and the binary framing
+ *
+ * The keyset is sent to the test application of the process plugin and returned by it
+ * with every kdbGet, so every call transfers the keyset twice.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <kdbmodule.h>
+#include <kdbprivate.h>
+
+#define NUM_CALLS 10
+
+static KeySet * createKeySet (int size)
+{
+	KeySet * ks = ksNew (size, KS_END);
+	char name[KEY_NAME_LENGTH];
+	for (int i = 0; i < size; ++i)
+	{
+		snprintf (name, sizeof (name), "%s/dir%d/key%d", KEY_ROOT, i / 100, i);
+		Key * key = keyNew (name, KEY_VALUE, name, KEY_END);
+		if (i % 10 == 0) keySetMeta (key, "meta/index", name);
+		ksAppendKey (ks, key);
+	}
+	return ks;
+}
+
+static void benchmarkFraming (const char * framing, KeySet * ks)
+{
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+	KeySet * conf = ksNew (2, keyNew ("user:/executable", KEY_VALUE, PROCESS_TESTAPP, KEY_END),
+			       keyNew ("user:/framing", KEY_VALUE, framing, KEY_END), KS_END);
+	Key * parentKey = keyNew (KEY_ROOT, KEY_END);
+	Plugin * plugin = elektraPluginOpen ("process", modules, conf, parentKey);
+	if (plugin == NULL)
+	{
+		fprintf (stderr, "could not open process plugin with %s\n", PROCESS_TESTAPP);
+		keyDel (parentKey);
+		elektraModulesClose (modules, 0);
+		ksDel (modules);
+		return;
+	}
+
+	KeySet * returned = ksDup (ks);
+	size_t bytes = 0;
+	timeInit ();
+	for (int i = 0; i < NUM_CALLS; ++i)
+	{
+		if (plugin->kdbGet (plugin, returned, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS) fprintf (stderr, "kdbGet failed\n");
+		// the test application adds a key, which is removed again to send the same keyset every time
+		keyDel (ksLookupByName (returned, KEY_ROOT "/operation", KDB_O_POP));
+	}
+	int microseconds = timeGetDiffMicroseconds ();
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		bytes += keyGetNameSize (ksAtCursor (ks, it)) + keyGetValueSize (ksAtCursor (ks, it));
+	}
+	printf ("%-10s %10d us per call %10.2f MB/s of names and values\n", framing, microseconds / NUM_CALLS,
+		2.0 * bytes * NUM_CALLS / microseconds);
+
+	ksDel (returned);
+	keyDel (parentKey);
+	elektraPluginClose (plugin, 0);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+}
+
+int main (void)
+{
+	for (int size = 10000; size <= 100000; size *= 10)
+	{
+		printf ("%d keys\n", size);
+		KeySet * ks = createKeySet (size);
+		benchmarkFraming ("dump", ks);
+		benchmarkFraming ("binary", ks);
+		ksDel (ks);
+	}
+	return 0;
+}
@@ -244,6 +244,14 @@ option (INSTALL_BUILD_TOOLS "Install build tools for cross-compilation" OFF)
 
 option (ENABLE_OPTIMIZATIONS "Turn on optimizations that trade memory for speed" ON)
 
+option (ENABLE_OPENMP "Use OpenMP to build the OPMPHM of large KeySets in parallel, needs ENABLE_OPTIMIZATIONS" OFF)
+
+set (
+	OPMPHM_HASHFUNCTION
+	"jenkins"
+	CACHE STRING "The hash function used by the OPMPHM, either jenkins or wyhash, needs ENABLE_OPTIMIZATIONS")
+set_property (CACHE OPMPHM_HASHFUNCTION PROPERTY STRINGS jenkins wyhash)
+
 #
 # Developer builds
 #
@@ -36,6 +36,7 @@ set (
 	libelektra${SO_VERSION}-zeromq
 	libelektra${SO_VERSION}-fuse
 	glib-elektra
+	io-epoll-elektra
 	io-ev-elektra
 	io-glib-elektra
 	io-uv-elektra
@@ -264,6 +265,11 @@ if (UNIX)
 	set (CPACK_COMPONENT_GLIB-ELEKTRA_DEPENDS "libelektra${SO_VERSION}")
 	check_component_dependencies (glib glib-elektra BINDING)
 
+	set (CPACK_COMPONENT_IO-EPOLL-ELEKTRA_DISPLAY_NAME "io-epoll-elektra")
+	set (CPACK_COMPONENT_IO-EPOLL-ELEKTRA_DESCRIPTION "This package contains the 'io_epoll' binding.")
+	set (CPACK_COMPONENT_IO-EPOLL-ELEKTRA_DEPENDS "libelektra${SO_VERSION}")
+	check_component_dependencies (io_epoll io-epoll-elektra BINDING)
+
 	set (CPACK_COMPONENT_IO-EV-ELEKTRA_DISPLAY_NAME "io-ev-elektra")
 	set (CPACK_COMPONENT_IO-EV-ELEKTRA_DESCRIPTION "This package contains the 'io_ev' binding.")
 	set (CPACK_COMPONENT_IO-EV-ELEKTRA-IO-EV_DEPENDS "libelektra${SO_VERSION}")
@@ -315,6 +321,7 @@ if (UNIX)
 		"libelektra${SO_VERSION}-xerces"
 		"libelektra${SO_VERSION}-yajl"
 		"libelektra${SO_VERSION}-yamlcpp"
+		"io-epoll-elektra"
 		"io-ev-elektra"
 		"io-glib-elektra"
 		"io-uv-elektra"
@@ -4,6 +4,7 @@
 #
 #  HAVE_MKFIFO                  - True if mkfifo is available on the platform
 #  HAVE_FORK                    - True if fork is available on the platform
+#  HAVE_MEMFD_CREATE            - True if memfd_create is available on the platform
 #  HAVE_PLUGINPROCESS	        - True if the pluginprocess library can be built
 #  PLUGINPROCESS_NOTFOUND_INFO	- A string describing which pluginprocess dependency is missing
 #
@@ -13,6 +14,11 @@ include (SafeCheckSymbolExists)
 safe_check_symbol_exists (mkfifo "sys/types.h;sys/stat.h" HAVE_MKFIFO)
 safe_check_symbol_exists (fork "sys/types.h;unistd.h" HAVE_FORK)
 
+cmake_push_check_state ()
+set (CMAKE_REQUIRED_DEFINITIONS -D_GNU_SOURCE)
+safe_check_symbol_exists (memfd_create "sys/mman.h" HAVE_MEMFD_CREATE)
+cmake_pop_check_state ()
+
 if (HAVE_MKFIFO)
 	if (HAVE_FORK)
 		if (ENABLE_ASAN AND CMAKE_SYSTEM_NAME MATCHES FreeBSD)
@@ -27,4 +33,4 @@ else (HAVE_MKFIFO)
 	set (PLUGINPROCESS_NOTFOUND_INFO "mkfifo does not exist on the target platform, excluding pluginprocess library")
 endif (HAVE_MKFIFO)
 
-mark_as_advanced (HAVE_MKFIFO HAVE_FORK PLUGINPROCESS_FOUND PLUGINPROCESS_NOTFOUND_INFO)
+mark_as_advanced (HAVE_MKFIFO HAVE_FORK HAVE_MEMFD_CREATE PLUGINPROCESS_FOUND PLUGINPROCESS_NOTFOUND_INFO)
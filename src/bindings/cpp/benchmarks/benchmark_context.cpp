@@ -0,0 +1,81 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for switching layers of a Context with many values
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <kdbcontext.hpp>
+#include <kdbtimer.hpp>
+
+long long iterations = 10000LL; // layer switches
+// long long iterations = 100LL; // valgrind
+
+const int benchmarkIterations = 11; // is a good number to not need mean values for median
+
+const int numLayers = 10;
+const int valuesPerLayer = 100;
+
+/**
+ * @brief Every value depends on one layer,
+ * so a switch of one layer updates only valuesPerLayer values.
+ */
+__attribute__ ((noinline)) void benchmark_switch (Timer & t)
+{
+	kdb::KeySet ks;
+	kdb::Context c;
+	std::vector<std::unique_ptr<kdb::Integer>> values;
+	for (int l = 0; l < numLayers; ++l)
+	{
+		for (int v = 0; v < valuesPerLayer; ++v)
+		{
+			std::string name = "/test/%layer" + std::to_string (l) + "%/%group other%/value" + std::to_string (v);
+			values.emplace_back (new kdb::Integer (ks, c, kdb::Key (name, KEY_META, "default", "5", KEY_END)));
+		}
+	}
+
+	t.start ();
+	for (long long i = 0; i < iterations; ++i)
+	{
+		c.activate ("layer0", std::to_string (i % 8));
+	}
+	t.stop ();
+}
+
+__attribute__ ((noinline)) void benchmark_evaluate (Timer & t)
+{
+	kdb::Context c;
+	c.activate ("layer0", "0");
+	c.activate ("group", "1");
+	std::string name = "/test/%layer0%/%group other%/value";
+	kdb::NameTemplate nameTemplate (name);
+
+	size_t size = 0;
+	t.start ();
+	for (long long i = 0; i < iterations * valuesPerLayer; ++i)
+	{
+		size += c.evaluate (nameTemplate).size ();
+	}
+	t.stop ();
+	if (size != iterations * valuesPerLayer * std::string ("/test/0/%1/value").size ()) std::cerr << "wrong size" << std::endl;
+}
+
+int main (int argc, char ** argv)
+{
+	if (argc > 1) iterations = atoll (argv[1]);
+
+	Timer t ("layer switch", Timer::median_cerr);
+	for (int i = 0; i < benchmarkIterations; ++i)
+	{
+		benchmark_switch (t);
+	}
+	std::cout << t;
+
+	Timer e ("evaluate", Timer::median_cerr);
+	for (int i = 0; i < benchmarkIterations; ++i)
+	{
+		benchmark_evaluate (e);
+	}
+	std::cout << e;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for contention in the Coordinator of ThreadContexts
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <kdbthread.hpp>
+#include <kdbtimer.hpp>
+
+#include <atomic>
+
+long long iterations = 10000LL; // layer switches per thread
+// long long iterations = 100LL; // valgrind
+
+const int benchmarkIterations = 11; // is a good number to not need mean values for median
+
+const int maxThreads = 64;
+
+class Request : public kdb::Layer
+{
+public:
+	explicit Request (long long i) : m_value (std::to_string (i % 8))
+	{
+	}
+	std::string id () const override
+	{
+		return "request";
+	}
+	std::string operator() () const override
+	{
+		return m_value;
+	}
+
+private:
+	std::string m_value;
+};
+
+/**
+ * @brief Every thread switches a layer per simulated request
+ * and picks up the switches of all other threads.
+ *
+ * Every thread uses its own KeySet, so that only the Coordinator is shared.
+ */
+void switchLayers (kdb::Coordinator & gc, std::atomic<bool> & start)
+{
+	kdb::KeySet ks;
+	kdb::ThreadContext tc (gc);
+	kdb::ThreadInteger ti (ks, tc, kdb::Key ("/test/%request%/value", KEY_META, "default", "5", KEY_END));
+	while (!start)
+	{
+		std::this_thread::yield ();
+	}
+
+	long long x = 0;
+	for (long long i = 0; i < iterations; ++i)
+	{
+		tc.activate<Request> (i);
+		x += ti;
+		tc.syncLayers ();
+	}
+	if (x != iterations * 5) std::cerr << "wrong value " << x << std::endl;
+}
+
+__attribute__ ((noinline)) void benchmark_contention (int threads, Timer & t)
+{
+	kdb::Coordinator gc;
+	std::atomic<bool> start (false);
+
+	std::vector<std::thread> workers;
+	for (int i = 0; i < threads; ++i)
+	{
+		workers.emplace_back (switchLayers, std::ref (gc), std::ref (start));
+	}
+
+	t.start ();
+	start = true;
+	for (auto & w : workers)
+	{
+		w.join ();
+	}
+	t.stop ();
+}
+
+int main (int argc, char ** argv)
+{
+	if (argc > 1) iterations = atoll (argv[1]);
+
+	for (int threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		Timer t ("contention " + std::to_string (threads) + " threads", Timer::median_cerr);
+		for (int i = 0; i < benchmarkIterations; ++i)
+		{
+			benchmark_contention (threads, t);
+		}
+		std::cout << t;
+	}
+}
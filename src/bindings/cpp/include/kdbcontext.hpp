@@ -93,6 +93,18 @@ inline void Subject::attachObserverByEvent (std::string const & event, ValueObse
 
 inline void Subject::notifyByEvents (Events const & events) const
 {
+	if (events.size () == 1)
+	{
+		// no duplicates possible, avoid copying the observers
+		auto it = m_events.find (events.front ());
+		if (it == m_events.end ()) return;
+		for (auto & o : it->second)
+		{
+			o.get ().updateContext ();
+		}
+		return;
+	}
+
 	ObserverSet os;
 	for (auto & e : events)
 	{
@@ -221,33 +233,59 @@ public:
 	 */
 	std::string evaluate (std::string const & key_name) const
 	{
-		return evaluate (key_name, [&] (std::string const & current_id, std::string & ret, bool in_group) {
-			auto f = m_active_layers.find (current_id);
-			bool left_group = true;
-			if (f != m_active_layers.end ())
+		return evaluate (NameTemplate (key_name));
+	}
+
+	/**
+	 * Evaluate an already split specification (name)
+	 * and return a key name under current context
+	 *
+	 * A single layer is replaced by its value. Of a group,
+	 * the values of all layers up to the first inactive
+	 * layer are used, each of them prefixed with %.
+	 * Inactive single layers and groups become %.
+	 *
+	 * @param name the name with placeholders to be evaluated
+	 */
+	std::string evaluate (NameTemplate const & name) const
+	{
+		std::vector<std::string> const & literals = name.getLiterals ();
+		std::vector<NameTemplate::Placeholder> const & placeholders = name.getPlaceholders ();
+		std::string ret;
+		ret.reserve (name.getName ().size () * 2);
+		ret += literals[0];
+
+		for (size_t i = 0; i < placeholders.size (); ++i)
+		{
+			NameTemplate::Placeholder const & layers = placeholders[i];
+			if (layers.size () == 1)
 			{
-				assert (f->second && "no null pointers in active_layers");
-				std::string r = (*f->second) ();
-				if (!r.empty ())
+				Layer const * layer = activeLayer (layers[0]);
+				std::string r = layer ? (*layer) () : std::string ();
+				ret += r.empty () ? "%" : r;
+			}
+			else
+			{
+				bool empty_group = true;
+				for (auto const & id : layers)
 				{
-					if (in_group)
-					{
-						ret += "%";
-					}
+					Layer const * layer = activeLayer (id);
+					if (!layer) break;
+					std::string r = (*layer) ();
+					if (r.empty ()) break;
+					ret += "%";
 					ret += r;
-					left_group = false;
+					empty_group = false;
 				}
-				else if (!in_group)
+				if (empty_group)
 				{
 					ret += "%";
 				}
 			}
-			else if (!in_group)
-			{
-				ret += "%";
-			}
-			return left_group;
-		});
+			ret += literals[i + 1];
+		}
+
+		return ret;
 	}
 
 	/**
@@ -331,6 +369,15 @@ public:
 	}
 
 protected:
+	/// @return the active layer with the given id or a null pointer
+	Layer const * activeLayer (std::string const & id) const
+	{
+		auto f = m_active_layers.find (id);
+		if (f == m_active_layers.end ()) return nullptr;
+		assert (f->second && "no null pointers in active_layers");
+		return f->second.get ();
+	}
+
 	// activates layer, records it, but does not notify
 	template <typename T, typename... Args>
 	void lazyActivate (Args &&... args)
@@ -14,10 +14,13 @@
 #include <kdb.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -32,24 +35,112 @@ public:
 	virtual void syncLayers () = 0;
 };
 
+struct PerContext;
+
 struct LayerAction
 {
-	LayerAction (bool activate_, std::shared_ptr<Layer> const & layer_) : activate (activate_), layer (std::move (layer_))
+	LayerAction (bool activate_, std::shared_ptr<Layer> const & layer_, unsigned long long sequence_ = 0,
+		     std::weak_ptr<PerContext> owner_ = std::weak_ptr<PerContext> ())
+	: activate (activate_), layer (std::move (layer_)), sequence (sequence_), owner (std::move (owner_))
 	{
 	}
 	bool activate; // false if deactivate
 	std::shared_ptr<Layer> layer;
+	unsigned long long sequence; // global order of layer actions
+	std::weak_ptr<PerContext> owner; // context that did the action
 };
 
 /// A vector of layers
 typedef std::unordered_map<std::string, LayerAction> LayerMap;
 typedef std::unordered_map<std::string, std::vector<std::function<void ()>>> FunctionMap;
 
+/**
+ * @brief Unbounded lock-free queue with many producers and a single consumer
+ *
+ * push () never blocks and may be called by any thread, drain () must only
+ * be called by the consumer. An element whose push () has not completed yet
+ * may be missed by drain (), it will be returned by the next drain ().
+ */
+template <typename T>
+class MPSCQueue
+{
+public:
+	MPSCQueue () : m_head (new Node ()), m_tail (m_head.load ())
+	{
+	}
+
+	~MPSCQueue ()
+	{
+		drain ([] (T &&) {});
+		delete m_tail;
+	}
+
+	MPSCQueue (MPSCQueue const &) = delete;
+	MPSCQueue & operator= (MPSCQueue const &) = delete;
+
+	void push (T value)
+	{
+		Node * node = new Node ();
+		new (&node->storage) T (std::move (value));
+		Node * prev = m_head.exchange (node, std::memory_order_acq_rel);
+		prev->next.store (node, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Remove all elements in the order they were pushed
+	 *
+	 * @param f is called with every removed element
+	 *
+	 * @return the number of removed elements
+	 */
+	template <typename F>
+	size_t drain (F f)
+	{
+		size_t count = 0;
+		Node * next;
+		while ((next = m_tail->next.load (std::memory_order_acquire)) != nullptr)
+		{
+			// next becomes the new stub, its element is moved out
+			T * value = reinterpret_cast<T *> (&next->storage);
+			f (std::move (*value));
+			value->~T ();
+			delete m_tail;
+			m_tail = next;
+			++count;
+		}
+		return count;
+	}
+
+private:
+	struct Node
+	{
+		Node () : next (nullptr)
+		{
+		}
+		std::atomic<Node *> next;
+		typename std::aligned_storage<sizeof (T), alignof (T)>::type storage;
+	};
+
+	std::atomic<Node *> m_head; // last pushed node, shared by producers
+	Node * m_tail;		    // stub node, only used by the consumer
+};
+
 /// A data structure that is stored by context inside the Coordinator
 struct PerContext
 {
-	KeySet toUpdate;
-	LayerMap toActivate;
+	PerContext (ThreadSubject * subject_, unsigned long long baseline_) : subject (subject_), baseline (baseline_), published (0)
+	{
+	}
+	ThreadSubject * subject;
+	/// names of keys assigned by other threads
+	MPSCQueue<std::string> toUpdate;
+	/// the following members are only used by the owning thread:
+	/// sequence of the last applied action per layer
+	std::unordered_map<std::string, unsigned long long> applied;
+	/// layer actions up to this sequence are ignored
+	unsigned long long baseline;
+	/// number of published layer actions at the last fetch
+	unsigned long long published;
 };
 
 class ThreadNoContext
@@ -80,6 +171,11 @@ public:
 		return key_name;
 	}
 
+	std::string evaluate (NameTemplate const & name) const
+	{
+		return name.getName ();
+	}
+
 	/**
 	 * @brief (Re)attaches a ValueSubject to a thread or simply
 	 *        execute code in a locked section.
@@ -101,6 +197,29 @@ private:
 
 /**
  * @brief Thread safe coordination of ThreadContext per Threads.
+ *
+ * Only the latest (de)activation of every layer is kept, ordered by a
+ * global sequence, so there is no map of pending actions per context.
+ * ThreadContexts pick up the actions newer than the ones they applied,
+ * which needs no work when nothing was published since their last sync.
+ * Assignments are delivered to the other ThreadContexts via per context
+ * lock-free queues.
+ *
+ * The list of attached contexts, the layers and the layer callbacks are
+ * immutable snapshots, which are replaced on attach/detach, the first
+ * action of a layer or registration of a callback. Readers take a
+ * reference on the current snapshot with std::atomic_load, so an old
+ * snapshot (and every context in it) lives until its last reader is done.
+ * These atomic operations on std::shared_ptr are not lock-free in common
+ * standard libraries, which guard them with a small pool of global
+ * mutexes, held only while copying the pointer.
+ *
+ * So layer switches and syncLayers () do not block on the mutex of the
+ * Coordinator: it only serializes the execution of commands, which modify
+ * the shared KeySet, and the notification of assigned values. Writers
+ * replacing a snapshot are serialized with separate mutexes, which are
+ * only taken on attach/detach, the first action of a layer and for
+ * callbacks.
  */
 class Coordinator
 {
@@ -108,41 +227,35 @@ public:
 	template <typename T>
 	void onLayerActivation (std::function<void ()> f)
 	{
-		std::lock_guard<std::mutex> lock (m_mutexOnActivate);
 		std::shared_ptr<Layer> layer = std::make_shared<T> ();
-		m_onActivate[layer->id ()].push_back (f);
+		onLayerActivation (layer->id (), f);
 	}
 
 	template <typename T>
 	void onLayerDeactivation (std::function<void ()> f)
 	{
-		std::lock_guard<std::mutex> lock (m_mutexOnDeactivate);
 		std::shared_ptr<Layer> layer = std::make_shared<T> ();
-		m_onDeactivate[layer->id ()].push_back (f);
+		onLayerDeactivation (layer->id (), f);
 	}
 
 	void onLayerActivation (std::string layerid, std::function<void ()> f)
 	{
-		std::lock_guard<std::mutex> lock (m_mutexOnActivate);
-		m_onActivate[layerid].push_back (f);
+		updateFunctions (m_onActivate, m_mutexOnActivate, [&] (FunctionMap & functions) { functions[layerid].push_back (f); });
 	}
 
 	void onLayerDeactivation (std::string layerid, std::function<void ()> f)
 	{
-		std::lock_guard<std::mutex> lock (m_mutexOnDeactivate);
-		m_onDeactivate[layerid].push_back (f);
+		updateFunctions (m_onDeactivate, m_mutexOnDeactivate, [&] (FunctionMap & functions) { functions[layerid].push_back (f); });
 	}
 
 	void clearOnLayerActivation (std::string layerid)
 	{
-		std::lock_guard<std::mutex> lock (m_mutexOnActivate);
-		m_onActivate[layerid].clear ();
+		updateFunctions (m_onActivate, m_mutexOnActivate, [&] (FunctionMap & functions) { functions[layerid].clear (); });
 	}
 
 	void clearOnLayerDeactivation (std::string layerid)
 	{
-		std::lock_guard<std::mutex> lock (m_mutexOnDeactivate);
-		m_onDeactivate[layerid].clear ();
+		updateFunctions (m_onDeactivate, m_mutexOnDeactivate, [&] (FunctionMap & functions) { functions[layerid].clear (); });
 	}
 
 	std::unique_lock<std::mutex> requireLock ()
@@ -152,18 +265,17 @@ public:
 	}
 
 	Coordinator ()
+	: m_contexts (std::make_shared<Contexts> ()), m_layers (std::make_shared<LayerSlots> ()), m_sequence (0), m_published (0),
+	  m_onActivate (std::make_shared<FunctionMap> ()), m_onDeactivate (std::make_shared<FunctionMap> ())
 	{
-		std::lock_guard<std::mutex> lock (m_mutex);
-		m_updates.insert (std::make_pair (nullptr, PerContext ()));
 	}
 
 	~Coordinator ()
 	{
 #if DEBUG
-		for (auto & i : m_updates)
+		for (auto & i : *m_contexts)
 		{
-			std::cout << "coordinator " << this << " left over: " << i.first << " with updates: " << i.second.toUpdate.size ()
-				  << " activations: " << i.second.toActivate.size () << std::endl;
+			std::cout << "coordinator " << this << " left over: " << i->subject << std::endl;
 		}
 #endif
 	}
@@ -172,30 +284,80 @@ public:
 private:
 	friend class ThreadContext;
 
-	void attach (ThreadSubject * c)
+	typedef std::vector<std::shared_ptr<PerContext>> Contexts;
+
+	/// latest action of a layer
+	struct LayerSlot
 	{
-		std::lock_guard<std::mutex> lock (m_mutex);
-		m_updates.insert (std::make_pair (c, m_updates[nullptr]));
+		std::shared_ptr<const LayerAction> action;
+	};
+	typedef std::unordered_map<std::string, std::shared_ptr<LayerSlot>> LayerSlots;
+
+	/**
+	 * @param c the new context
+	 * @param withHistory deliver the latest action of every layer to c
+	 *
+	 * @return the updates for c
+	 */
+	std::shared_ptr<PerContext> attach (ThreadSubject * c, bool withHistory = true)
+	{
+		return attach (std::make_shared<PerContext> (c, withHistory ? 0 : m_sequence.load ()));
 	}
 
-	void detach (ThreadSubject * c)
+	/**
+	 * @param c the new context, a copy of the context of @p from
+	 * @param from its layer actions not yet synced are also delivered to c,
+	 * except the ones of contexts that are gone: their layers may wrap
+	 * values that no longer exist
+	 *
+	 * @return the updates for c
+	 */
+	std::shared_ptr<PerContext> attach (ThreadSubject * c, PerContext const & from)
 	{
-		std::lock_guard<std::mutex> lock (m_mutex);
-		m_updates.erase (c);
+		std::shared_ptr<PerContext> pc = std::make_shared<PerContext> (c, from.baseline);
+		pc->applied = from.applied;
+		pc->published = from.published;
+
+		std::shared_ptr<const LayerSlots> layers = std::atomic_load (&m_layers);
+		for (auto const & l : *layers)
+		{
+			std::shared_ptr<const LayerAction> action = std::atomic_load (&l.second->action);
+			if (!action || action->sequence <= pc->baseline || !action->owner.expired ()) continue;
+			unsigned long long & applied = pc->applied[l.first];
+			if (applied < action->sequence) applied = action->sequence;
+		}
+		return attach (pc);
+	}
+
+	std::shared_ptr<PerContext> attach (std::shared_ptr<PerContext> pc)
+	{
+		std::lock_guard<std::mutex> lock (m_mutexContexts);
+		std::shared_ptr<Contexts> contexts = std::make_shared<Contexts> (*std::atomic_load (&m_contexts));
+		contexts->push_back (pc);
+		std::atomic_store (&m_contexts, std::shared_ptr<const Contexts> (contexts));
+		return pc;
+	}
+
+	void detach (std::shared_ptr<PerContext> const & pc)
+	{
+		std::lock_guard<std::mutex> lock (m_mutexContexts);
+		std::shared_ptr<Contexts> contexts = std::make_shared<Contexts> (*std::atomic_load (&m_contexts));
+		contexts->erase (std::remove (contexts->begin (), contexts->end (), pc), contexts->end ());
+		std::atomic_store (&m_contexts, std::shared_ptr<const Contexts> (contexts));
 	}
 
 	/**
 	 * @brief Update the given ThreadContext with newly assigned
 	 * values.
 	 */
-	void updateNewlyAssignedValues (ThreadSubject * c)
+	void updateNewlyAssignedValues (PerContext & pc)
 	{
-		std::lock_guard<std::mutex> lock (m_mutex);
-		KeySet & toUpdate = m_updates[c].toUpdate;
+		KeySet toUpdate;
+		pc.toUpdate.drain ([&toUpdate] (std::string && name) { toUpdate.append (Key (name, KEY_END)); });
 		if (toUpdate.size () == 0) return;
 
-		c->notify (toUpdate);
-		toUpdate.clear ();
+		std::lock_guard<std::mutex> lock (m_mutex);
+		pc.subject->notify (toUpdate);
 	}
 
 	/**
@@ -210,87 +372,135 @@ private:
 		c.newKey = ret.second;
 		if (c.hasChanged)
 		{
-			for (auto & i : m_updates)
+			std::shared_ptr<const Contexts> contexts = std::atomic_load (&m_contexts);
+			for (auto & i : *contexts)
 			{
-				i.second.toUpdate.append (Key (c.newKey, KEY_END));
+				i->toUpdate.push (c.newKey);
 			}
 		}
 	}
 
-	void runOnActivate (std::shared_ptr<Layer> layer)
+	void runFunctions (std::shared_ptr<const FunctionMap> const & map, std::shared_ptr<Layer> const & layer)
 	{
-		std::lock_guard<std::mutex> lock (m_mutexOnActivate);
-		for (auto && f : m_onActivate[layer->id ()])
+		std::shared_ptr<const FunctionMap> functions = std::atomic_load (&map);
+		auto f = functions->find (layer->id ());
+		if (f == functions->end ()) return;
+		for (auto && function : f->second)
 		{
-			f ();
+			function ();
 		}
 	}
 
+	template <typename F>
+	void updateFunctions (std::shared_ptr<const FunctionMap> & map, std::mutex & mutex, F f)
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		std::shared_ptr<FunctionMap> functions = std::make_shared<FunctionMap> (*std::atomic_load (&map));
+		f (*functions);
+		std::atomic_store (&map, std::shared_ptr<const FunctionMap> (functions));
+	}
+
 	/**
-	 * @brief Request that some layer needs to be globally
-	 * activated.
-	 *
-	 * @param cc requests it and already has it updated itself
-	 * @param layer to activate for all threads
+	 * @return the slot of the layer, created on first use
 	 */
-	void globalActivate (ThreadSubject * cc, std::shared_ptr<Layer> layer)
+	std::shared_ptr<LayerSlot> layerSlot (std::string const & id)
 	{
-		runOnActivate (layer);
+		std::shared_ptr<const LayerSlots> layers = std::atomic_load (&m_layers);
+		auto it = layers->find (id);
+		if (it != layers->end ()) return it->second;
 
-		std::lock_guard<std::mutex> lock (m_mutex);
-		for (auto & c : m_updates)
+		std::lock_guard<std::mutex> lock (m_mutexContexts);
+		std::shared_ptr<LayerSlots> newLayers = std::make_shared<LayerSlots> (*std::atomic_load (&m_layers));
+		std::shared_ptr<LayerSlot> & slot = (*newLayers)[id];
+		if (!slot)
 		{
-			// caller itself has it already activated
-			if (cc == c.first) continue;
-			c.second.toActivate.insert (std::make_pair (layer->id (), LayerAction (true, layer)));
+			slot = std::make_shared<LayerSlot> ();
+			std::atomic_store (&m_layers, std::shared_ptr<const LayerSlots> (newLayers));
 		}
+		return slot;
 	}
 
-	void runOnDeactivate (std::shared_ptr<Layer> layer)
+	/**
+	 * @brief Make a layer action the latest one of its layer, unless
+	 * a newer one was published concurrently.
+	 */
+	void publish (std::shared_ptr<PerContext> const & cc, LayerAction const & action)
 	{
-		std::lock_guard<std::mutex> lock (m_mutexOnDeactivate);
-		for (auto && f : m_onDeactivate[layer->id ()])
+		std::string id = action.layer->id ();
+		// the caller itself has it already (de)activated
+		cc->applied[id] = action.sequence;
+
+		std::shared_ptr<LayerSlot> slot = layerSlot (id);
+		std::shared_ptr<const LayerAction> latest = std::make_shared<const LayerAction> (action);
+		std::shared_ptr<const LayerAction> current = std::atomic_load (&slot->action);
+		while (!current || current->sequence < action.sequence)
 		{
-			f ();
+			if (std::atomic_compare_exchange_weak (&slot->action, &current, latest)) break;
 		}
+		// counted after the store, so fetchGlobalActivation cannot miss it
+		m_published.fetch_add (1, std::memory_order_release);
 	}
 
-
-	void globalDeactivate (ThreadSubject * cc, std::shared_ptr<Layer> layer)
+	/**
+	 * @brief Request that some layer needs to be globally
+	 * activated.
+	 *
+	 * @param cc requests it and already has it updated itself
+	 * @param layer to activate for all threads
+	 */
+	void globalActivate (std::shared_ptr<PerContext> const & cc, std::shared_ptr<Layer> layer)
 	{
-		runOnDeactivate (layer);
+		runFunctions (m_onActivate, layer);
+		publish (cc, LayerAction (true, layer, ++m_sequence, cc));
+	}
 
-		std::lock_guard<std::mutex> lock (m_mutex);
-		for (auto & c : m_updates)
-		{
-			// caller itself has it already deactivated
-			if (cc == c.first) continue;
-			c.second.toActivate.insert (std::make_pair (layer->id (), LayerAction (false, layer)));
-		}
+	void globalDeactivate (std::shared_ptr<PerContext> const & cc, std::shared_ptr<Layer> layer)
+	{
+		runFunctions (m_onDeactivate, layer);
+		publish (cc, LayerAction (false, layer, ++m_sequence, cc));
 	}
 
 	/**
-	 * @param cc requester of its updates
+	 * @param pc requester of its updates
 	 *
 	 * @see globalActivate
-	 * @return all layers for that subject
+	 * @return the latest action of all layers changed since the last call
 	 */
-	LayerMap fetchGlobalActivation (ThreadSubject * cc)
+	LayerMap fetchGlobalActivation (PerContext & pc)
 	{
-		std::lock_guard<std::mutex> lock (m_mutex);
 		LayerMap ret;
-		ret.swap (m_updates[cc].toActivate);
+		unsigned long long published = m_published.load (std::memory_order_acquire);
+		if (published == pc.published) return ret;
+		pc.published = published;
+
+		std::shared_ptr<const LayerSlots> layers = std::atomic_load (&m_layers);
+		for (auto const & l : *layers)
+		{
+			std::shared_ptr<const LayerAction> action = std::atomic_load (&l.second->action);
+			if (!action || action->sequence <= pc.baseline) continue;
+			unsigned long long & applied = pc.applied[l.first];
+			if (action->sequence <= applied) continue;
+			applied = action->sequence;
+			ret.insert (std::make_pair (l.first, *action));
+		}
 		return ret;
 	}
 
-	/// stores per context updates not yet delievered
-	/// nullptr is for full history to be copied to new contexts
-	std::unordered_map<ThreadSubject *, PerContext> m_updates;
-	/// mutex protecting m_updates
+	/// all attached contexts, replaced as a whole on attach and detach
+	std::shared_ptr<const Contexts> m_contexts;
+	/// latest action per layer id, replaced as a whole when a layer id is new
+	std::shared_ptr<const LayerSlots> m_layers;
+	/// mutex serializing the replacement of m_contexts and m_layers, readers do not take it
+	std::mutex m_mutexContexts;
+	/// sequence of the last layer action
+	std::atomic<unsigned long long> m_sequence;
+	/// number of layer actions stored in m_layers
+	std::atomic<unsigned long long> m_published;
+	/// mutex protecting the KeySet modified by commands
 	std::mutex m_mutex;
-	FunctionMap m_onActivate;
+	std::shared_ptr<const FunctionMap> m_onActivate;
 	std::mutex m_mutexOnActivate;
-	FunctionMap m_onDeactivate;
+	std::shared_ptr<const FunctionMap> m_onDeactivate;
 	std::mutex m_mutexOnDeactivate;
 };
 
@@ -299,14 +509,19 @@ class ThreadContext : public ThreadSubject, public Context
 public:
 	typedef std::reference_wrapper<ValueSubject> ValueRef;
 
-	explicit ThreadContext (Coordinator & gc) : m_gc (gc)
+	explicit ThreadContext (Coordinator & gc) : m_gc (gc), m_pc (m_gc.attach (this))
+	{
+	}
+
+	/// a copy gets its own updates, starting with the ones other did not sync yet
+	ThreadContext (ThreadContext const & other)
+	: ThreadSubject (other), Context (other), m_gc (other.m_gc), m_pc (m_gc.attach (this, *other.m_pc)), m_keys (other.m_keys)
 	{
-		m_gc.attach (this);
 	}
 
 	~ThreadContext ()
 	{
-		m_gc.detach (this);
+		m_gc.detach (m_pc);
 #if DEBUG
 		for (auto & i : m_keys)
 		{
@@ -330,7 +545,7 @@ public:
 	{
 		syncLayers ();
 		std::shared_ptr<Layer> layer = Context::activate<T> (std::forward<Args> (args)...);
-		m_gc.globalActivate (this, layer);
+		m_gc.globalActivate (m_pc, layer);
 		return layer;
 	}
 
@@ -338,7 +553,7 @@ public:
 	{
 		syncLayers ();
 		std::shared_ptr<Layer> layer = Context::activate (key, value);
-		m_gc.globalActivate (this, layer);
+		m_gc.globalActivate (m_pc, layer);
 		return layer;
 	}
 
@@ -346,7 +561,7 @@ public:
 	{
 		syncLayers ();
 		std::shared_ptr<Layer> layer = Context::activate (value);
-		m_gc.globalActivate (this, layer);
+		m_gc.globalActivate (m_pc, layer);
 		return layer;
 	}
 
@@ -356,7 +571,7 @@ public:
 	{
 		syncLayers ();
 		std::shared_ptr<Layer> layer = Context::deactivate<T> (std::forward<Args> (args)...);
-		m_gc.globalDeactivate (this, layer);
+		m_gc.globalDeactivate (m_pc, layer);
 		return layer;
 	}
 
@@ -364,7 +579,7 @@ public:
 	{
 		syncLayers ();
 		std::shared_ptr<Layer> layer = Context::deactivate (key, value);
-		m_gc.globalDeactivate (this, layer);
+		m_gc.globalDeactivate (m_pc, layer);
 		return layer;
 	}
 
@@ -372,7 +587,7 @@ public:
 	{
 		syncLayers ();
 		std::shared_ptr<Layer> layer = Context::deactivate (value);
-		m_gc.globalDeactivate (this, layer);
+		m_gc.globalDeactivate (m_pc, layer);
 		return layer;
 	}
 
@@ -380,7 +595,7 @@ public:
 	{
 		// now activate/deactive layers
 		Events e;
-		for (auto const & l : m_gc.fetchGlobalActivation (this))
+		for (auto const & l : m_gc.fetchGlobalActivation (*m_pc))
 		{
 			if (l.second.activate)
 			{
@@ -395,7 +610,7 @@ public:
 		notifyByEvents (e);
 
 		// pull in assignments from other threads
-		m_gc.updateNewlyAssignedValues (this);
+		m_gc.updateNewlyAssignedValues (*m_pc);
 	}
 
 	virtual void sync ()
@@ -444,6 +659,8 @@ public:
 
 private:
 	Coordinator & m_gc;
+	/// pending updates of this context, owned by the Coordinator
+	std::shared_ptr<PerContext> m_pc;
 	/**
 	 * @brief A map of values this ThreadContext is responsible for.
 	 */
@@ -209,6 +209,75 @@ public:
 	std::string newKey; // new name after assignment
 };
 
+/**
+ * @brief A key name with placeholders, split into its parts once
+ *
+ * A placeholder is either a single layer (%layer%) or a group
+ * of layers separated by spaces (%layer1 layer2%).
+ * Literal parts and placeholders alternate, so there is always
+ * one more literal part than placeholders.
+ */
+class NameTemplate
+{
+public:
+	typedef std::vector<std::string> Placeholder;
+
+	explicit NameTemplate (std::string const & keyName) : m_name (keyName), m_literals (1)
+	{
+		bool capture_id = false; // we are currently within a % block
+		for (char c : keyName)
+		{
+			if (c == '%')
+			{
+				if (capture_id)
+				{
+					m_literals.emplace_back ();
+				}
+				else
+				{
+					m_placeholders.emplace_back (1);
+				}
+				capture_id = !capture_id;
+			}
+			else if (capture_id && c == ' ')
+			{
+				m_placeholders.back ().emplace_back ();
+			}
+			else if (capture_id)
+			{
+				m_placeholders.back ().back () += c;
+			}
+			else
+			{
+				m_literals.back () += c;
+			}
+		}
+
+		assert (!capture_id && "number of % incorrect");
+	}
+
+	/// @return the name the template was created from
+	std::string const & getName () const
+	{
+		return m_name;
+	}
+
+	std::vector<std::string> const & getLiterals () const
+	{
+		return m_literals;
+	}
+
+	std::vector<Placeholder> const & getPlaceholders () const
+	{
+		return m_placeholders;
+	}
+
+private:
+	std::string m_name;
+	std::vector<std::string> m_literals;
+	std::vector<Placeholder> m_placeholders;
+};
+
 // Default Policies for Value
 
 class NoContext
@@ -239,6 +308,11 @@ public:
 		return key_name;
 	}
 
+	std::string evaluate (NameTemplate const & name) const
+	{
+		return name.getName ();
+	}
+
 	/**
 	 * @brief (Re)attaches a ValueSubject to a thread or simply
 	 *        execute code in a locked section.
@@ -443,12 +517,12 @@ public:
 	// not to be constructed yourself
 	Value<T, PolicySetter1, PolicySetter2, PolicySetter3, PolicySetter4, PolicySetter5, PolicySetter6> (
 		KeySet & ks, typename Policies::ContextPolicy & context_, kdb::Key spec)
-	: m_cache (), m_hasChanged (false), m_ks (ks), m_context (context_), m_spec (spec)
+	: m_cache (), m_hasChanged (false), m_ks (ks), m_context (context_), m_spec (spec), m_name (m_spec.getName ())
 	{
 		assert (m_spec.getName ()[0] == '/' && "spec keys are not yet supported");
 		m_context.attachByName (m_spec.getName (), *this);
 		Command::Func fun = [this] () -> Command::Pair {
-			auto evaluatedName = m_context.evaluate (m_spec.getName ());
+			auto evaluatedName = m_context.evaluate (m_name);
 			evaluatedName = evaluatedName == "/%" ? "/" : evaluatedName;
 			this->unsafeUpdateKeyUsingContext (evaluatedName);
 			this->unsafeSyncCache (); // set m_cache
@@ -717,7 +791,7 @@ private:
 
 	virtual void updateContext (bool write) const override
 	{
-		std::string evaluatedName = m_context.evaluate (m_spec.getName ());
+		std::string evaluatedName = m_context.evaluate (m_name);
 #if DEBUG && VERBOSE
 		std::cout << "update context " << evaluatedName << " from " << m_spec.getName () << " with write " << write << std::endl;
 #endif
@@ -801,6 +875,13 @@ private:
 	 */
 	Key m_spec;
 
+	/**
+	 * @brief The name of m_spec split into its placeholders
+	 *
+	 * Avoids parsing the name every time the context changes.
+	 */
+	NameTemplate m_name;
+
 	/**
 	 * @brief The current key the Value is bound to.
 	 *
@@ -766,6 +766,35 @@ TEST (test_contextual_basic, evaluate)
 	EXPECT_EQ (j.getName (), "default:/%main%1%anonymous/serial_number");
 }
 
+TEST (test_contextual_basic, evaluateTemplate)
+{
+	using namespace kdb;
+	NameTemplate t ("/%language%/x/%country dialect%/test");
+	ASSERT_EQ (t.getName (), "/%language%/x/%country dialect%/test");
+	ASSERT_EQ (t.getLiterals (), (std::vector<std::string>{ "/", "/x/", "/test" }));
+	ASSERT_EQ (t.getPlaceholders (), (std::vector<NameTemplate::Placeholder>{ { "language" }, { "country", "dialect" } }));
+
+	NameTemplate n ("/no/placeholder");
+	ASSERT_EQ (n.getLiterals (), std::vector<std::string>{ "/no/placeholder" });
+	ASSERT_TRUE (n.getPlaceholders ().empty ());
+
+	kdb::Context c;
+	EXPECT_EQ (c.evaluate (t), "/%/x/%/test");
+	EXPECT_EQ (c.evaluate (n), "/no/placeholder");
+
+	c.activate<LanguageGermanLayer> ();
+	EXPECT_EQ (c.evaluate (t), "/german/x/%/test");
+
+	c.activate<KeyValueLayer> ("dialect", "bavarian");
+	EXPECT_EQ (c.evaluate (t), "/german/x/%/test") << "group starts with inactive layer";
+
+	c.activate<CountryGermanyLayer> ();
+	EXPECT_EQ (c.evaluate (t), "/german/x/%germany%bavarian/test");
+
+	c.activate<KeyValueLayer> ("dialect", "");
+	EXPECT_EQ (c.evaluate (t), "/german/x/%germany/test") << "empty layer ends group";
+}
+
 
 struct MockObserver : kdb::ValueObserver
 {
@@ -432,3 +432,118 @@ TEST (test_contextual_thread, syncBeforeWith)
 	ASSERT_EQ (v.getName (), "user:/act/active");
 	ASSERT_EQ (v, 22);
 }
+
+TEST (test_contextual_thread, activateLatest)
+{
+	Coordinator gc;
+	ThreadContext c1 (gc);
+	ThreadContext c2 (gc);
+
+	c1.activate ("layer", "1");
+	c1.activate ("layer", "2");
+	ASSERT_EQ (c1["layer"], "2");
+
+	c2.syncLayers ();
+	ASSERT_EQ (c2["layer"], "2");
+
+	c2.deactivate ("layer", "");
+	c1.syncLayers ();
+	ASSERT_EQ (c1["layer"], "");
+}
+
+TEST (test_contextual_thread, attachAfterActivation)
+{
+	Coordinator gc;
+	ThreadContext c1 (gc);
+
+	// only the latest action of every layer is delivered
+	for (int i = 0; i < 3000; ++i)
+	{
+		c1.activate ("layer", std::to_string (i));
+	}
+	c1.activate<Activate> ();
+	c1.deactivate<Activate> ();
+
+	ThreadContext c2 (gc);
+	c2.syncLayers ();
+	ASSERT_EQ (c2["layer"], "2999");
+	ASSERT_EQ (c2["activate"], "");
+	ASSERT_EQ (c2.size (), 1);
+}
+
+TEST (test_contextual_thread, copyWithPendingActivation)
+{
+	Coordinator gc;
+	ThreadContext c1 (gc);
+	ThreadContext c2 (gc);
+
+	c1.activate ("layer", "1");
+	c1.activate ("other", "1");
+	c2.syncLayers ();
+	c1.activate ("layer", "2");
+	c1.deactivate ("other", "");
+
+	// c2 did not sync the latest actions yet, its copy must get them too
+	ThreadContext c3 (c2);
+	ASSERT_EQ (c3["layer"], "1");
+	c3.syncLayers ();
+	ASSERT_EQ (c3["layer"], "2");
+	ASSERT_EQ (c3["other"], "");
+
+	c2.syncLayers ();
+	ASSERT_EQ (c2["layer"], "2");
+	ASSERT_EQ (c2["other"], "");
+}
+
+TEST (test_contextual_thread, copySkipsDestroyedContexts)
+{
+	Coordinator gc;
+	ThreadContext c1 (gc);
+	{
+		ThreadContext c2 (gc);
+		c2.activate ("layer", "1");
+	}
+
+	// c2 is gone, so its layers may wrap values that no longer exist
+	ThreadContext c3 (c1);
+	c3.syncLayers ();
+	ASSERT_EQ (c3["layer"], "");
+
+	c1.syncLayers ();
+	ASSERT_EQ (c1["layer"], "1");
+}
+
+TEST (test_contextual_thread, mpscQueue)
+{
+	const int producers = 4;
+	const int perProducer = 10000;
+
+	MPSCQueue<std::pair<int, int>> queue;
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; ++p)
+	{
+		threads.emplace_back ([&queue, p] () {
+			for (int i = 0; i < perProducer; ++i)
+			{
+				queue.push (std::make_pair (p, i));
+			}
+		});
+	}
+
+	// elements of each producer arrive in order
+	std::vector<int> next (producers, 0);
+	int received = 0;
+	while (received < producers * perProducer)
+	{
+		received += queue.drain ([&next] (std::pair<int, int> && e) {
+			ASSERT_EQ (e.second, next[e.first]);
+			++next[e.first];
+		});
+	}
+
+	for (auto & t : threads)
+	{
+		t.join ();
+	}
+	ASSERT_EQ (queue.drain ([] (std::pair<int, int> &&) {}), 0);
+}
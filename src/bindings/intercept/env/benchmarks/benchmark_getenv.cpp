@@ -12,7 +12,9 @@
 
 #include <fstream>
 #include <iostream>
+#include <thread>
 #include <unistd.h>
+#include <vector>
 
 #include <dlfcn.h>
 #include <string.h>
@@ -72,6 +74,33 @@ __attribute__ ((noinline)) void benchmark_getenv ()
 	dump << t.name << std::endl;
 }
 
+// every thread does all iterations, so with perfect scaling the time stays the same
+template <int nrThreads>
+__attribute__ ((noinline)) void benchmark_getenv_threads ()
+{
+	static Timer t ("elektra getenv " + std::to_string (nrThreads) + " threads");
+	std::vector<std::thread> threads;
+
+	t.start ();
+	for (int i = 0; i < nrThreads; ++i)
+	{
+		threads.emplace_back ([] () {
+			for (long long j = 0; j < iterations; ++j)
+			{
+				getenv ("HELLO");
+				__asm__("");
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	t.stop ();
+	std::cout << t;
+	dump << t.name << std::endl;
+}
+
 __attribute__ ((noinline)) void benchmark_dl_next_getenv ()
 {
 	static Timer t ("dl next getenv");
@@ -226,6 +255,10 @@ int main (int argc, char ** argv)
 
 		benchmark_nothing ();
 		benchmark_getenv ();
+		benchmark_getenv_threads<1> ();
+		benchmark_getenv_threads<2> ();
+		benchmark_getenv_threads<4> ();
+		benchmark_getenv_threads<8> ();
 		benchmark_libc_getenv ();
 		benchmark_bootstrap_getenv ();
 
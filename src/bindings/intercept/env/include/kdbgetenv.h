@@ -51,6 +51,9 @@ void elektraLockMutex ();
 /**
  * @brief Unlock the internally used mutex
  *
+ * Changes of elektraConfig done while the mutex was locked are used by
+ * getenv() afterwards.
+ *
  * @see elektraLockMutex()
  */
 void elektraUnlockMutex ();
@@ -8,6 +8,14 @@
  * 1.) bootstrapping in pre-main phase when no allocation is possible
  * 2.) bootstrapping when elektra modules use getenv()
  *
+ * Once elektra is open, getenv() does not take the mutex for plain names:
+ * the override and fallback values are resolved in advance into an immutable
+ * snapshot, which is swapped atomically whenever the configuration changes.
+ * Readers announce the snapshot they use in a hazard pointer, so replaced
+ * snapshots are freed as soon as no thread reads them anymore. Every distinct
+ * value is stored only once and kept for the lifetime of the process, so the
+ * returned pointers stay valid even if another thread reloads or reopens.
+ *
  * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
  *
  */
@@ -39,10 +47,14 @@
 #include <sys/auxv.h>
 #endif
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 /* BSDI has this functionality, but its not defined */
 #if !defined(RTLD_NEXT)
@@ -143,9 +155,9 @@ union Fork
 } ffork; // symbols for libc fork
 
 std::chrono::milliseconds elektraReloadTimeout;
-std::chrono::system_clock::time_point elektraReloadNext;
+std::atomic<std::chrono::system_clock::time_point> elektraReloadNext;
 std::shared_ptr<ostream> elektraLog;
-bool elektraInGetEnv;
+thread_local bool elektraInGetEnv;
 KeySet * elektraDocu = ksNew (20,
 #include "readme_elektrify-getenv.c"
 			      KS_END);
@@ -158,24 +170,90 @@ int to_ (int c)
 
 pthread_mutex_t elektraGetEnvMutex = ELEKTRA_MUTEX_INIT;
 
+/**
+ * @brief Values of the override and fallback keys, resolved with the context of the time it was created
+ *
+ * A null value means that a binary key was found, which hides the variable.
+ * The values point into elektraSnapshotValues, so they outlive the snapshot.
+ */
+struct GetEnvSnapshot
+{
+	std::chrono::milliseconds reloadTimeout;
+	std::unordered_map<std::string, const char *> overrides;
+	std::unordered_map<std::string, const char *> fallbacks;
+	size_t fingerprint;	// of elektraConfig when the snapshot was created
+	GetEnvSnapshot * next; // in the list of retired snapshots
+};
 
-} // anonymous namespace
+/**
+ * @brief Announces which snapshot a thread currently reads (hazard pointer)
+ *
+ * Readers are never freed, but reused once their thread exits.
+ */
+struct GetEnvReader
+{
+	std::atomic<GetEnvSnapshot *> snapshot;
+	std::atomic<bool> used;
+	GetEnvReader * next;
+};
 
+class GetEnvReaderSlot
+{
+public:
+	~GetEnvReaderSlot ()
+	{
+		if (m_reader) m_reader->used.store (false);
+	}
+	GetEnvReader * get ();
 
-extern "C" void elektraLockMutex ()
+private:
+	GetEnvReader * m_reader = nullptr;
+};
+
+std::atomic<GetEnvSnapshot *> elektraSnapshot;
+std::atomic<GetEnvReader *> elektraReaders;
+thread_local GetEnvReaderSlot elektraReaderSlot;
+GetEnvSnapshot * elektraRetiredSnapshots;
+std::unordered_set<std::string> elektraSnapshotValues;
+int elektraUserLocks; // nesting of elektraLockMutex ()
+
+void lockMutex ()
 {
 #if ELEKTRA_GETENV_USE_LOCKS
 	pthread_mutex_lock (&elektraGetEnvMutex);
 #endif
 }
 
-extern "C" void elektraUnlockMutex ()
+void unlockMutex ()
 {
 #if ELEKTRA_GETENV_USE_LOCKS
 	pthread_mutex_unlock (&elektraGetEnvMutex);
 #endif
 }
 
+} // anonymous namespace
+
+void elektraPublishSnapshot ();
+void elektraReplaceSnapshot (GetEnvSnapshot * snapshot);
+size_t elektraConfigFingerprint ();
+
+extern "C" void elektraLockMutex ()
+{
+	lockMutex ();
+	++elektraUserLocks;
+}
+
+extern "C" void elektraUnlockMutex ()
+{
+	// the caller might have changed elektraConfig, until then getenv() uses the previous snapshot
+	if (--elektraUserLocks == 0)
+	{
+		GetEnvSnapshot * snapshot = elektraSnapshot.load ();
+		if (!snapshot || snapshot->fingerprint != elektraConfigFingerprint ()) elektraPublishSnapshot ();
+	}
+	unlockMutex ();
+}
+
 
 void printVersion ()
 {
@@ -445,7 +523,7 @@ void applyOptions ()
 
 extern "C" void elektraOpen (int * argc, char ** argv)
 {
-	elektraLockMutex ();
+	lockMutex ();
 	if (elektraRepo) elektraClose (); // already opened
 
 	LOG << "opening elektra" << endl;
@@ -474,12 +552,14 @@ extern "C" void elektraOpen (int * argc, char ** argv)
 	kdbGet (elektraRepo, elektraConfig, elektraParentKey);
 	addLayers ();
 	applyOptions ();
-	elektraUnlockMutex ();
+	elektraPublishSnapshot ();
+	unlockMutex ();
 }
 
 extern "C" void elektraClose ()
 {
-	elektraLockMutex ();
+	lockMutex ();
+	elektraReplaceSnapshot (nullptr);
 	if (elektraRepo)
 	{
 		kdbClose (elektraRepo, elektraParentKey);
@@ -494,7 +574,7 @@ extern "C" void elektraClose ()
 		keyDel (elektraFallbackParentKey);
 		elektraFallbackRepo = nullptr;
 	}
-	elektraUnlockMutex ();
+	unlockMutex ();
 }
 
 extern "C" int __real_main (int argc, char ** argv, char ** env);
@@ -507,12 +587,12 @@ extern "C" int __libc_start_main (int *(main) (int, char **, char **), int argc,
 				  void (*rtld_fini) (void), void (*stack_end))
 #endif
 {
-	elektraLockMutex (); // dlsym mutex
+	lockMutex (); // dlsym mutex
 	LOG << "wrapping main" << endl;
 	if (start.d)
 	{ // double wrapping situation, do not reopen, just forward to next __libc_start_main
 		start.d = dlsym (RTLD_NEXT, "__libc_start_main");
-		elektraUnlockMutex (); // dlsym mutex end
+		unlockMutex (); // dlsym mutex end
 #ifdef __powerpc__
 		int ret = (*start.f) (argc, argv, ev, auxvec, rtld_fini, stinfo, stack_on_entry);
 #else
@@ -527,7 +607,7 @@ extern "C" int __libc_start_main (int *(main) (int, char **, char **), int argc,
 	ffork.d = dlsym (RTLD_NEXT, "fork");
 
 	elektraOpen (&argc, argv);
-	elektraUnlockMutex (); // dlsym mutex end
+	unlockMutex (); // dlsym mutex end
 #ifdef __powerpc__
 	int ret = (*start.f) (argc, argv, ev, auxvec, rtld_fini, stinfo, stack_on_entry);
 #else
@@ -594,6 +674,225 @@ char * elektraGetEnvKey (std::string const & fullName, bool & finish)
 	return nullptr;
 }
 
+void addSnapshotNames (std::unordered_map<std::string, const char *> & values, std::string const & prefix)
+{
+	for (elektraCursor it = 0; it < ksGetSize (elektraConfig); ++it)
+	{
+		std::string fullName = keyName (ksAtCursor (elektraConfig, it));
+		size_t pos = fullName.find ('/');
+		if (pos != string::npos && fullName.compare (pos, prefix.size (), prefix) == 0)
+		{
+			values.emplace (fullName.substr (pos + prefix.size ()), nullptr);
+		}
+	}
+}
+
+void resolveSnapshotValues (std::unordered_map<std::string, const char *> & values, std::string const & prefix,
+			    std::string const & fallbackPrefix)
+{
+	for (auto it = values.begin (); it != values.end ();)
+	{
+		bool finish = false;
+		char * ret = elektraGetEnvKey (prefix + it->first, finish);
+		if (!ret) ret = elektraGetEnvKey (fallbackPrefix + it->first, finish);
+		if (!finish)
+		{
+			// e.g. a context that refers to a missing key
+			it = values.erase (it);
+			continue;
+		}
+		if (ret) it->second = elektraSnapshotValues.insert (ret).first->c_str ();
+		++it;
+	}
+}
+
+/**
+ * @brief Hashes everything of elektraConfig a snapshot depends on: names, values and metadata
+ *
+ * The mutex must be held.
+ */
+size_t elektraConfigFingerprint ()
+{
+	size_t fingerprint = std::hash<KeySet *> () (elektraConfig);
+	auto combine = [&fingerprint] (size_t hash) { fingerprint ^= hash + 0x9e3779b9 + (fingerprint << 6) + (fingerprint >> 2); };
+	if (!elektraConfig) return fingerprint;
+	for (elektraCursor it = 0; it < ksGetSize (elektraConfig); ++it)
+	{
+		Key * key = ksAtCursor (elektraConfig, it);
+		combine (std::hash<std::string> () (keyName (key)));
+		combine (std::hash<std::string> () (std::string (static_cast<const char *> (keyValue (key)), keyGetValueSize (key))));
+		combine (keyIsBinary (key));
+		// the lookup depends on meta keys like context, override/#, fallback/# or default
+		KeySet * meta = keyMeta (key);
+		for (elektraCursor mit = 0; mit < ksGetSize (meta); ++mit)
+		{
+			combine (std::hash<std::string> () (keyName (ksAtCursor (meta, mit))));
+			combine (std::hash<std::string> () (keyString (ksAtCursor (meta, mit))));
+		}
+	}
+	return fingerprint;
+}
+
+GetEnvReader * GetEnvReaderSlot::get ()
+{
+	if (m_reader) return m_reader;
+	for (GetEnvReader * reader = elektraReaders.load (); reader; reader = reader->next)
+	{
+		bool unused = false;
+		if (reader->used.compare_exchange_strong (unused, true)) return m_reader = reader;
+	}
+	GetEnvReader * reader = new GetEnvReader ();
+	reader->used = true;
+	reader->next = elektraReaders.load ();
+	while (!elektraReaders.compare_exchange_weak (reader->next, reader))
+		;
+	return m_reader = reader;
+}
+
+/**
+ * @brief Gets the current snapshot and protects it from being freed
+ *
+ * @retval nullptr if there is no snapshot, getenv() must take the mutex
+ * @see elektraReleaseSnapshot
+ */
+GetEnvSnapshot * elektraAcquireSnapshot (GetEnvReader * reader)
+{
+	GetEnvSnapshot * snapshot = elektraSnapshot.load ();
+	while (snapshot)
+	{
+		reader->snapshot.store (snapshot);
+		// only valid if it was not replaced before it got announced
+		GetEnvSnapshot * current = elektraSnapshot.load ();
+		if (current == snapshot) return snapshot;
+		snapshot = current;
+	}
+	reader->snapshot.store (nullptr);
+	return nullptr;
+}
+
+void elektraReleaseSnapshot (GetEnvReader * reader)
+{
+	reader->snapshot.store (nullptr);
+}
+
+/**
+ * @brief Frees all retired snapshots that no reader announced
+ *
+ * The mutex must be held. At most one snapshot per reader stays retired.
+ */
+void elektraReclaimSnapshots ()
+{
+	GetEnvSnapshot ** retired = &elektraRetiredSnapshots;
+	while (*retired)
+	{
+		bool inUse = false;
+		for (GetEnvReader * reader = elektraReaders.load (); reader && !inUse; reader = reader->next)
+		{
+			inUse = reader->snapshot.load () == *retired;
+		}
+
+		if (inUse)
+		{
+			retired = &(*retired)->next;
+			continue;
+		}
+		GetEnvSnapshot * unused = *retired;
+		*retired = unused->next;
+		delete unused;
+	}
+}
+
+/**
+ * @brief Replaces the snapshot used by getenv() without locking
+ *
+ * The mutex must be held. The replaced snapshot is freed once no reader uses it.
+ *
+ * @param snapshot the new snapshot, nullptr to always take the mutex
+ */
+void elektraReplaceSnapshot (GetEnvSnapshot * snapshot)
+{
+	GetEnvSnapshot * old = elektraSnapshot.exchange (snapshot);
+	if (old)
+	{
+		old->next = elektraRetiredSnapshots;
+		elektraRetiredSnapshots = old;
+	}
+	elektraReclaimSnapshots ();
+}
+
+/**
+ * @brief Creates a snapshot of the current configuration and context for getenv()
+ *
+ * The mutex must be held. No snapshot is used while logging, so that every call is traced.
+ */
+void elektraPublishSnapshot ()
+{
+	if (!elektraRepo || elektraLog)
+	{
+		elektraReplaceSnapshot (nullptr);
+		return;
+	}
+
+	GetEnvSnapshot * snapshot = new GetEnvSnapshot ();
+	snapshot->reloadTimeout = elektraReloadTimeout;
+	snapshot->fingerprint = elektraConfigFingerprint ();
+	addSnapshotNames (snapshot->overrides, "/elektra/intercept/getenv/override/");
+	addSnapshotNames (snapshot->overrides, "/env/override/");
+	resolveSnapshotValues (snapshot->overrides, "/elektra/intercept/getenv/override/", "/env/override/");
+	addSnapshotNames (snapshot->fallbacks, "/elektra/intercept/getenv/fallback/");
+	addSnapshotNames (snapshot->fallbacks, "/env/fallback/");
+	resolveSnapshotValues (snapshot->fallbacks, "/elektra/intercept/getenv/fallback/", "/env/fallback/");
+	elektraReplaceSnapshot (snapshot);
+}
+
+/**
+ * @brief Checks if getenv() can answer from @p snapshot
+ *
+ * Names that are not a single unescaped part of a key name are left to the
+ * lookup, as well as all calls once a reload is due.
+ */
+bool elektraSnapshotUsable (GetEnvSnapshot const * snapshot, const char * name)
+{
+	if (*name == '\0' || *name == '#' || *name == '%' || *name == '.' || *name == '@') return false;
+	if (strpbrk (name, "/\\")) return false;
+	return snapshot->reloadTimeout == std::chrono::milliseconds::zero () ||
+	       std::chrono::system_clock::now () < elektraReloadNext.load (std::memory_order_relaxed);
+}
+
+/**
+ * @brief Same as elektraGetEnv, but uses the values of @p snapshot
+ */
+char * elektraSnapshotGetEnv (GetEnvSnapshot const * snapshot, const char * cname, gfcn origGetenv)
+{
+	std::string const name = cname;
+	auto found = snapshot->overrides.find (name);
+	if (found != snapshot->overrides.end ()) return const_cast<char *> (found->second);
+
+	char * ret = (*origGetenv) (cname);
+	if (ret) return ret;
+
+	found = snapshot->fallbacks.find (name);
+	if (found != snapshot->fallbacks.end ()) return const_cast<char *> (found->second);
+	return nullptr;
+}
+
+/**
+ * @brief Answers getenv() from the current snapshot if possible
+ *
+ * @retval true if @p ret was set from the snapshot
+ */
+bool elektraTryGetEnvSnapshot (const char * name, gfcn origGetenv, char *& ret)
+{
+	if (elektraInGetEnv || !origGetenv) return false;
+
+	GetEnvReader * reader = elektraReaderSlot.get ();
+	GetEnvSnapshot const * snapshot = elektraAcquireSnapshot (reader);
+	bool const usable = snapshot && elektraSnapshotUsable (snapshot, name);
+	if (usable) ret = elektraSnapshotGetEnv (snapshot, name, origGetenv);
+	elektraReleaseSnapshot (reader);
+	return usable;
+}
+
 
 /**
  * @brief Uses Elektra to get from environment.
@@ -625,9 +924,10 @@ char * elektraGetEnv (const char * cname, gfcn origGetenv)
 		std::chrono::system_clock::time_point const now = std::chrono::system_clock::now ();
 
 		// are we now ready to reload?
-		if (now >= elektraReloadNext)
+		if (now >= elektraReloadNext.load ())
 		{
 			int ret = kdbGet (elektraRepo, elektraConfig, elektraParentKey);
+			elektraReloadNext = now + elektraReloadTimeout;
 
 			// was there a change?
 			if (ret == 1)
@@ -635,10 +935,9 @@ char * elektraGetEnv (const char * cname, gfcn origGetenv)
 				elektraEnvContext.clearAllLayer ();
 				addLayers ();
 				applyOptions ();
+				elektraPublishSnapshot ();
 			}
 		}
-
-		elektraReloadNext = now + elektraReloadTimeout;
 	}
 
 	std::string name = cname;
@@ -715,35 +1014,41 @@ char * elektraBootstrapSecureGetEnv (const char * name)
 
 extern "C" char * getenv (const char * name) // throw ()
 {
-	elektraLockMutex ();
+	char * ret = nullptr;
+	if (elektraTryGetEnvSnapshot (name, sym.f, ret)) return ret;
+
+	lockMutex ();
 	if (!sym.f || elektraInGetEnv)
 	{
-		char * ret = elektraBootstrapGetEnv (name);
-		elektraUnlockMutex ();
+		ret = elektraBootstrapGetEnv (name);
+		unlockMutex ();
 		return ret;
 	}
 
 	elektraInGetEnv = true;
-	char * ret = elektraGetEnv (name, sym.f);
+	ret = elektraGetEnv (name, sym.f);
 	elektraInGetEnv = false;
-	elektraUnlockMutex ();
+	unlockMutex ();
 	return ret;
 }
 
 extern "C" char * secure_getenv (const char * name) // throw ()
 {
-	elektraLockMutex ();
+	char * ret = nullptr;
+	if (elektraTryGetEnvSnapshot (name, ssym.f, ret)) return ret;
+
+	lockMutex ();
 	if (!ssym.f || elektraInGetEnv)
 	{
-		char * ret = elektraBootstrapSecureGetEnv (name);
-		elektraUnlockMutex ();
+		ret = elektraBootstrapSecureGetEnv (name);
+		unlockMutex ();
 		return ret;
 	}
 
 	elektraInGetEnv = true;
-	char * ret = elektraGetEnv (name, ssym.f);
+	ret = elektraGetEnv (name, ssym.f);
 	elektraInGetEnv = false;
-	elektraUnlockMutex ();
+	unlockMutex ();
 	return ret;
 }
 } // namespace ckdb
@@ -10,6 +10,10 @@
 #include <gtest/gtest.h>
 #include <kdbgetenv.h>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 TEST (GetEnv, NonExist)
 {
 	EXPECT_EQ (getenv ("du4Maiwi/does-not-exist"), static_cast<char *> (nullptr));
@@ -19,7 +23,9 @@ TEST (GetEnv, ExistOverride)
 {
 	using namespace ckdb;
 	elektraOpen (nullptr, nullptr);
+	elektraLockMutex ();
 	ksAppendKey (elektraConfig, keyNew ("user:/elektra/intercept/getenv/override/does-exist", KEY_VALUE, "hello", KEY_END));
+	elektraUnlockMutex ();
 	ASSERT_NE (getenv ("does-exist"), static_cast<char *> (nullptr));
 	EXPECT_EQ (getenv ("does-exist"), std::string ("hello"));
 	elektraClose ();
@@ -29,7 +35,9 @@ TEST (GetEnv, ExistOverrideFallback)
 {
 	using namespace ckdb;
 	elektraOpen (nullptr, nullptr);
+	elektraLockMutex ();
 	ksAppendKey (elektraConfig, keyNew ("user:/env/override/does-exist-fb", KEY_VALUE, "hello", KEY_END));
+	elektraUnlockMutex ();
 	ASSERT_NE (getenv ("does-exist-fb"), static_cast<char *> (nullptr));
 	EXPECT_EQ (getenv ("does-exist-fb"), std::string ("hello"));
 	elektraClose ();
@@ -59,7 +67,9 @@ TEST (GetEnv, ExistFallback)
 {
 	using namespace ckdb;
 	elektraOpen (nullptr, nullptr);
+	elektraLockMutex ();
 	ksAppendKey (elektraConfig, keyNew ("user:/elektra/intercept/getenv/fallback/does-exist", KEY_VALUE, "hello", KEY_END));
+	elektraUnlockMutex ();
 	ASSERT_NE (getenv ("does-exist"), static_cast<char *> (nullptr));
 	EXPECT_EQ (getenv ("does-exist"), std::string ("hello"));
 	elektraClose ();
@@ -69,7 +79,9 @@ TEST (GetEnv, ExistFallbackFallback)
 {
 	using namespace ckdb;
 	elektraOpen (nullptr, nullptr);
+	elektraLockMutex ();
 	ksAppendKey (elektraConfig, keyNew ("user:/env/fallback/does-exist-fb", KEY_VALUE, "hello", KEY_END));
+	elektraUnlockMutex ();
 	ASSERT_NE (getenv ("does-exist-fb"), static_cast<char *> (nullptr));
 	EXPECT_EQ (getenv ("does-exist-fb"), std::string ("hello"));
 	elektraClose ();
@@ -82,7 +94,9 @@ TEST (GetEnv, OpenClose)
 	elektraOpen (nullptr, nullptr);
 	// EXPECT_NE(elektraConfig, oldElektraConfig); // even its a new object, it might point to same address
 	EXPECT_EQ (getenv ("du4Maiwi/does-not-exist"), static_cast<char *> (nullptr));
+	elektraLockMutex ();
 	ksAppendKey (elektraConfig, keyNew ("user:/elektra/intercept/getenv/override/does-exist", KEY_VALUE, "hello", KEY_END));
+	elektraUnlockMutex ();
 
 	ASSERT_NE (getenv ("does-exist"), static_cast<char *> (nullptr));
 	EXPECT_EQ (getenv ("does-exist"), std::string ("hello"));
@@ -97,7 +111,9 @@ TEST (GetEnv, OpenCloseFallback)
 	elektraOpen (nullptr, nullptr);
 	// EXPECT_NE(elektraConfig, oldElektraConfig); // even its a new object, it might point to same address
 	EXPECT_EQ (getenv ("du4Maiwi/does-not-exist-fb"), static_cast<char *> (nullptr));
+	elektraLockMutex ();
 	ksAppendKey (elektraConfig, keyNew ("user:/env/override/does-exist-fb", KEY_VALUE, "hello", KEY_END));
+	elektraUnlockMutex ();
 
 	ASSERT_NE (getenv ("does-exist-fb"), static_cast<char *> (nullptr));
 	EXPECT_EQ (getenv ("does-exist-fb"), std::string ("hello"));
@@ -105,6 +121,114 @@ TEST (GetEnv, OpenCloseFallback)
 	elektraClose ();
 }
 
+TEST (GetEnv, ChangeOverride)
+{
+	using namespace ckdb;
+	elektraOpen (nullptr, nullptr);
+	elektraLockMutex ();
+	ksAppendKey (elektraConfig, keyNew ("user:/elektra/intercept/getenv/override/does-change", KEY_VALUE, "hello", KEY_END));
+	elektraUnlockMutex ();
+	char * old = getenv ("does-change");
+	ASSERT_NE (old, static_cast<char *> (nullptr));
+	EXPECT_EQ (old, std::string ("hello"));
+
+	elektraLockMutex ();
+	keySetString (ksLookupByName (elektraConfig, "user:/elektra/intercept/getenv/override/does-change", 0), "changed");
+	elektraUnlockMutex ();
+	EXPECT_EQ (getenv ("does-change"), std::string ("changed"));
+	EXPECT_EQ (old, std::string ("hello")) << "previously returned value was freed";
+	elektraClose ();
+}
+
+TEST (GetEnv, ChangeMeta)
+{
+	using namespace ckdb;
+	elektraOpen (nullptr, nullptr);
+	elektraLockMutex ();
+	ksAppendKey (elektraConfig, keyNew ("user:/meta-change/first", KEY_VALUE, "first", KEY_END));
+	ksAppendKey (elektraConfig, keyNew ("user:/meta-change/second", KEY_VALUE, "second", KEY_END));
+	ksAppendKey (elektraConfig, keyNew ("spec:/elektra/intercept/getenv/override/meta-change", KEY_META, "override/#0",
+					    "/meta-change/first", KEY_END));
+	elektraUnlockMutex ();
+	ASSERT_NE (getenv ("meta-change"), static_cast<char *> (nullptr));
+	EXPECT_EQ (getenv ("meta-change"), std::string ("first"));
+
+	elektraLockMutex ();
+	keySetMeta (ksLookupByName (elektraConfig, "spec:/elektra/intercept/getenv/override/meta-change", 0), "override/#0",
+		    "/meta-change/second");
+	elektraUnlockMutex ();
+	ASSERT_NE (getenv ("meta-change"), static_cast<char *> (nullptr));
+	EXPECT_EQ (getenv ("meta-change"), std::string ("second")) << "change of metadata was not published";
+	elektraClose ();
+}
+
+TEST (GetEnv, Threads)
+{
+	using namespace ckdb;
+	elektraOpen (nullptr, nullptr);
+	elektraLockMutex ();
+	ksAppendKey (elektraConfig, keyNew ("user:/elektra/intercept/getenv/override/does-exist", KEY_VALUE, "hello", KEY_END));
+	elektraUnlockMutex ();
+
+	std::atomic<int> wrong (0);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i)
+	{
+		threads.emplace_back ([&wrong] () {
+			for (int j = 0; j < 1000; ++j)
+			{
+				char * value = getenv ("does-exist");
+				if (!value || std::string (value) != "hello") ++wrong;
+				if (getenv ("du4Maiwi/does-not-exist")) ++wrong;
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	EXPECT_EQ (wrong, 0);
+	elektraClose ();
+}
+
+TEST (GetEnv, ThreadsChange)
+{
+	using namespace ckdb;
+	elektraOpen (nullptr, nullptr);
+	elektraLockMutex ();
+	Key * key = keyNew ("user:/elektra/intercept/getenv/override/does-exist", KEY_VALUE, "hello", KEY_END);
+	ksAppendKey (elektraConfig, key);
+	elektraUnlockMutex ();
+
+	std::atomic<bool> done (false);
+	std::atomic<int> wrong (0);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i)
+	{
+		threads.emplace_back ([&wrong, &done] () {
+			while (!done)
+			{
+				char * value = getenv ("does-exist");
+				if (!value || (std::string (value) != "hello" && std::string (value) != "world")) ++wrong;
+			}
+		});
+	}
+	for (int j = 0; j < 1000; ++j)
+	{
+		elektraLockMutex ();
+		keySetString (key, j % 2 ? "hello" : "world");
+		elektraUnlockMutex ();
+	}
+	done = true;
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	EXPECT_EQ (wrong, 0);
+	EXPECT_EQ (getenv ("does-exist"), std::string ("hello"));
+	elektraClose ();
+}
+
 void elektraPrintConfig ()
 {
 	using namespace ckdb;
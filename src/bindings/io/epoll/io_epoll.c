@@ -0,0 +1,692 @@
+/**
+ * @file
+ *
+ * @brief I/O epoll binding.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <kdbassert.h>
+#include <kdbhelper.h>
+#include <kdbio.h>
+#include <kdbio/epoll.h>
+#include <kdblogger.h>
+
+/** maximum number of events processed per iteration of the loop */
+#define ELEKTRA_IO_EPOLL_MAX_EVENTS 64
+
+/**
+ * Type of operation
+ */
+typedef enum
+{
+	EPOLL_OPERATION_FD,
+	EPOLL_OPERATION_TIMER,
+	EPOLL_OPERATION_IDLE,
+} EpollOperationType;
+
+/**
+ * Container for required additional information for
+ * I/O binding operations
+ */
+typedef struct EpollBindingData
+{
+	EpollOperationType type;
+	union
+	{
+		ElektraIoFdOperation * fd;
+		ElektraIoTimerOperation * timer;
+		ElektraIoIdleOperation * idle;
+	} operation;
+
+	// file descriptor in the epoll set: duplicate of the watched file descriptor,
+	// timerfd or -1 for idle operations
+	int fd;
+	// file descriptor is in the epoll set (file descriptor operations only)
+	int registered;
+	// timer will fire (timer operations only), one-shot timers are disarmed after firing
+	int armed;
+	// operation was removed while the loop was dispatching
+	int removed;
+
+	ElektraIoEpollLoop * loop;
+	struct EpollBindingData * prev;
+	struct EpollBindingData * next;
+	struct EpollBindingData * nextRemoved;
+} EpollBindingData;
+
+struct _ElektraIoEpollLoop
+{
+	int epollFd;
+	int stop;
+	int dispatching;
+
+	// all added operations
+	EpollBindingData * operations;
+	// operations removed while dispatching, freed afterwards
+	EpollBindingData * removed;
+};
+
+/**
+ * Convert I/O flags to epoll event bit mask
+ * @param  flags I/O flags bit mask
+ * @return       epoll events bit mask
+ */
+static uint32_t flagsToEvents (int flags)
+{
+	uint32_t events = 0;
+	if (flags & ELEKTRA_IO_READABLE)
+	{
+		events |= EPOLLIN;
+	}
+	if (flags & ELEKTRA_IO_WRITABLE)
+	{
+		events |= EPOLLOUT;
+	}
+	return events;
+}
+
+/**
+ * Convert epoll event bit mask to I/O flags.
+ * Errors and hang ups are reported as the requested flags,
+ * so that the callback notices them when reading or writing.
+ *
+ * @param  events    epoll events bit mask
+ * @param  requested I/O flags of the operation
+ * @return           I/O flags bit mask
+ */
+static int eventsToFlags (uint32_t events, int requested)
+{
+	int flags = 0;
+	if (events & EPOLLIN)
+	{
+		flags |= ELEKTRA_IO_READABLE;
+	}
+	if (events & EPOLLOUT)
+	{
+		flags |= ELEKTRA_IO_WRITABLE;
+	}
+	if (events & (EPOLLERR | EPOLLHUP))
+	{
+		flags |= requested;
+	}
+	return flags;
+}
+
+/**
+ * @internal
+ * Create new data structure for binding operations and add it to the loop.
+ *
+ * @param  binding I/O binding
+ * @param  type    type of operation
+ * @return         new data structure
+ */
+static EpollBindingData * newBindingData (ElektraIoInterface * binding, EpollOperationType type)
+{
+	EpollBindingData * bindingData = elektraCalloc (sizeof (*bindingData));
+	if (bindingData == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("elektraCalloc failed");
+		return NULL;
+	}
+	ElektraIoEpollLoop * loop = (ElektraIoEpollLoop *) elektraIoBindingGetData (binding);
+	ELEKTRA_NOT_NULL (loop);
+
+	bindingData->type = type;
+	bindingData->fd = -1;
+	bindingData->loop = loop;
+
+	bindingData->next = loop->operations;
+	if (loop->operations != NULL)
+	{
+		loop->operations->prev = bindingData;
+	}
+	loop->operations = bindingData;
+
+	return bindingData;
+}
+
+/**
+ * @internal
+ * Remove data structure from the loop and free it.
+ *
+ * While the loop is dispatching, the data structure is only marked as removed
+ * since pending events may refer to it. `next` stays valid for iterating the loop.
+ *
+ * @param bindingData data structure
+ */
+static void removeBindingData (EpollBindingData * bindingData)
+{
+	ElektraIoEpollLoop * loop = bindingData->loop;
+
+	if (bindingData->fd != -1)
+	{
+		if ((bindingData->type != EPOLL_OPERATION_FD || bindingData->registered) &&
+		    epoll_ctl (loop->epollFd, EPOLL_CTL_DEL, bindingData->fd, NULL) == -1)
+		{
+			ELEKTRA_LOG_WARNING ("could not remove file descriptor from epoll: %s", strerror (errno));
+		}
+		close (bindingData->fd);
+		bindingData->fd = -1;
+	}
+
+	if (bindingData->prev != NULL)
+	{
+		bindingData->prev->next = bindingData->next;
+	}
+	else
+	{
+		loop->operations = bindingData->next;
+	}
+	if (bindingData->next != NULL)
+	{
+		bindingData->next->prev = bindingData->prev;
+	}
+
+	if (loop->dispatching)
+	{
+		bindingData->removed = 1;
+		bindingData->nextRemoved = loop->removed;
+		loop->removed = bindingData;
+	}
+	else
+	{
+		elektraFree (bindingData);
+	}
+}
+
+/**
+ * Update information about a file descriptor watched by I/O binding.
+ * @see kdbio.h ::ElektraIoBindingUpdateFd
+ */
+static int ioEpollBindingUpdateFd (ElektraIoFdOperation * fdOp)
+{
+	ELEKTRA_NOT_NULL (elektraIoFdGetBindingData (fdOp));
+	EpollBindingData * bindingData = (EpollBindingData *) elektraIoFdGetBindingData (fdOp);
+	int epollFd = bindingData->loop->epollFd;
+
+	if (elektraIoFdIsEnabled (fdOp))
+	{
+		struct epoll_event event = { .events = flagsToEvents (elektraIoFdGetFlags (fdOp)), .data.ptr = bindingData };
+		if (epoll_ctl (epollFd, bindingData->registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, bindingData->fd, &event) == -1)
+		{
+			ELEKTRA_LOG_WARNING ("could not update poll: %s", strerror (errno));
+			return 0;
+		}
+		bindingData->registered = 1;
+	}
+	else if (bindingData->registered)
+	{
+		if (epoll_ctl (epollFd, EPOLL_CTL_DEL, bindingData->fd, NULL) == -1)
+		{
+			ELEKTRA_LOG_WARNING ("could not stop polling: %s", strerror (errno));
+			return 0;
+		}
+		bindingData->registered = 0;
+	}
+
+	return 1;
+}
+
+/**
+ * Add file descriptor to I/O binding.
+ *
+ * epoll does not allow adding a file descriptor twice, but several operations
+ * may watch the same file descriptor (e.g. one for reading and one for writing).
+ * Therefore each operation watches its own duplicate of the file descriptor.
+ *
+ * @see kdbio.h ::ElektraIoBindingAddFd
+ */
+static int ioEpollBindingAddFd (ElektraIoInterface * binding, ElektraIoFdOperation * fdOp)
+{
+	int fd = fcntl (elektraIoFdGetFd (fdOp), F_DUPFD_CLOEXEC, 0);
+	if (fd == -1)
+	{
+		ELEKTRA_LOG_WARNING ("could not duplicate file descriptor: %s", strerror (errno));
+		return 0;
+	}
+
+	EpollBindingData * bindingData = newBindingData (binding, EPOLL_OPERATION_FD);
+	if (bindingData == NULL)
+	{
+		close (fd);
+		return 0;
+	}
+
+	elektraIoFdSetBindingData (fdOp, bindingData);
+	bindingData->operation.fd = fdOp;
+	bindingData->fd = fd;
+
+	// Start polling if enabled
+	if (elektraIoFdIsEnabled (fdOp) && !ioEpollBindingUpdateFd (fdOp))
+	{
+		removeBindingData (bindingData);
+		elektraIoFdSetBindingData (fdOp, NULL);
+		return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * Remove file descriptor from I/O binding.
+ * @see kdbio.h ::ElektraIoBindingRemoveFd
+ */
+static int ioEpollBindingRemoveFd (ElektraIoFdOperation * fdOp)
+{
+	ELEKTRA_NOT_NULL (elektraIoFdGetBindingData (fdOp));
+	removeBindingData ((EpollBindingData *) elektraIoFdGetBindingData (fdOp));
+	elektraIoFdSetBindingData (fdOp, NULL);
+	return 1;
+}
+
+/**
+ * Update timer in I/O binding.
+ * @see kdbio.h ::ElektraIoBindingUpdateTimer
+ */
+static int ioEpollBindingUpdateTimer (ElektraIoTimerOperation * timerOp)
+{
+	ELEKTRA_NOT_NULL (elektraIoTimerGetBindingData (timerOp));
+	EpollBindingData * bindingData = (EpollBindingData *) elektraIoTimerGetBindingData (timerOp);
+
+	struct itimerspec spec = { 0 };
+	int enabled = elektraIoTimerIsEnabled (timerOp);
+	if (enabled)
+	{
+		unsigned int interval = elektraIoTimerGetInterval (timerOp);
+		spec.it_interval.tv_sec = interval / 1000;
+		spec.it_interval.tv_nsec = (interval % 1000) * 1000 * 1000;
+		spec.it_value = spec.it_interval;
+		if (interval == 0)
+		{
+			// a zero value would disarm the timer, fire once instead
+			spec.it_value.tv_nsec = 1;
+		}
+	}
+
+	if (timerfd_settime (bindingData->fd, 0, &spec, NULL) == -1)
+	{
+		ELEKTRA_LOG_WARNING ("could not update timer: %s", strerror (errno));
+		return 0;
+	}
+	bindingData->armed = enabled;
+
+	return 1;
+}
+
+/**
+ * Add timer for I/O binding.
+ * @see kdbio.h ::ElektraIoBindingAddTimer
+ */
+static int ioEpollBindingAddTimer (ElektraIoInterface * binding, ElektraIoTimerOperation * timerOp)
+{
+	int fd = timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (fd == -1)
+	{
+		ELEKTRA_LOG_WARNING ("could not create timer: %s", strerror (errno));
+		return 0;
+	}
+
+	EpollBindingData * bindingData = newBindingData (binding, EPOLL_OPERATION_TIMER);
+	if (bindingData == NULL)
+	{
+		close (fd);
+		return 0;
+	}
+
+	elektraIoTimerSetBindingData (timerOp, bindingData);
+	bindingData->operation.timer = timerOp;
+	bindingData->fd = fd;
+
+	struct epoll_event event = { .events = EPOLLIN, .data.ptr = bindingData };
+	if (epoll_ctl (bindingData->loop->epollFd, EPOLL_CTL_ADD, fd, &event) == -1)
+	{
+		ELEKTRA_LOG_WARNING ("could not initialize timer: %s", strerror (errno));
+		close (fd);
+		bindingData->fd = -1;
+		removeBindingData (bindingData);
+		elektraIoTimerSetBindingData (timerOp, NULL);
+		return 0;
+	}
+
+	// Start timer if enabled
+	if (elektraIoTimerIsEnabled (timerOp))
+	{
+		ioEpollBindingUpdateTimer (timerOp);
+	}
+
+	return 1;
+}
+
+/**
+ * Remove timer from I/O binding
+ * @see kdbio.h ::ElektraIoBindingRemoveTimer
+ */
+static int ioEpollBindingRemoveTimer (ElektraIoTimerOperation * timerOp)
+{
+	ELEKTRA_NOT_NULL (elektraIoTimerGetBindingData (timerOp));
+	removeBindingData ((EpollBindingData *) elektraIoTimerGetBindingData (timerOp));
+	elektraIoTimerSetBindingData (timerOp, NULL);
+	return 1;
+}
+
+/**
+ * Update idle operation in I/O binding.
+ * @see kdbio.h ::ElektraIoBindingUpdateIdle
+ */
+static int ioEpollBindingUpdateIdle (ElektraIoIdleOperation * idleOp ELEKTRA_UNUSED)
+{
+	// the loop checks idle operations in every iteration
+	return 1;
+}
+
+/**
+ * Add idle operation to I/O binding
+ * @see kdbio.h ::ElektraIoBindingAddIdle
+ */
+static int ioEpollBindingAddIdle (ElektraIoInterface * binding, ElektraIoIdleOperation * idleOp)
+{
+	EpollBindingData * bindingData = newBindingData (binding, EPOLL_OPERATION_IDLE);
+	if (bindingData == NULL)
+	{
+		return 0;
+	}
+
+	elektraIoIdleSetBindingData (idleOp, bindingData);
+	bindingData->operation.idle = idleOp;
+
+	return 1;
+}
+
+/**
+ * Remove idle operation from I/O binding
+ * @see kdbio.h ::ElektraIoBindingRemoveIdle
+ */
+static int ioEpollBindingRemoveIdle (ElektraIoIdleOperation * idleOp)
+{
+	ELEKTRA_NOT_NULL (elektraIoIdleGetBindingData (idleOp));
+	removeBindingData ((EpollBindingData *) elektraIoIdleGetBindingData (idleOp));
+	elektraIoIdleSetBindingData (idleOp, NULL);
+	return 1;
+}
+
+/**
+ * Cleanup
+ * @param  binding I/O binding
+ * @see kdbio.h ::ElektraIoBindingCleanup
+ */
+static int ioEpollBindingCleanup (ElektraIoInterface * binding)
+{
+	ELEKTRA_NOT_NULL (binding);
+	elektraFree (binding);
+	return 1;
+}
+
+/**
+ * @internal
+ * Check if an operation keeps the loop running.
+ *
+ * @param  bindingData data structure of operation
+ * @retval 1 if the operation is enabled
+ * @retval 0 otherwise
+ */
+static int isActive (EpollBindingData * bindingData)
+{
+	switch (bindingData->type)
+	{
+	case EPOLL_OPERATION_FD:
+		return elektraIoFdIsEnabled (bindingData->operation.fd);
+	case EPOLL_OPERATION_TIMER:
+		return elektraIoTimerIsEnabled (bindingData->operation.timer) && bindingData->armed;
+	case EPOLL_OPERATION_IDLE:
+		return elektraIoIdleIsEnabled (bindingData->operation.idle);
+	}
+	return 0;
+}
+
+/**
+ * @internal
+ * Check if the loop has active operations of a given type.
+ *
+ * @param  loop loop
+ * @param  idle only check idle operations
+ * @retval 1 if there are active operations
+ * @retval 0 otherwise
+ */
+static int hasActiveOperations (ElektraIoEpollLoop * loop, int idle)
+{
+	for (EpollBindingData * bindingData = loop->operations; bindingData != NULL; bindingData = bindingData->next)
+	{
+		if ((!idle || bindingData->type == EPOLL_OPERATION_IDLE) && isActive (bindingData))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @internal
+ * Call the callback of an operation that has an event.
+ *
+ * @param bindingData data structure of operation
+ * @param events      epoll events bit mask
+ */
+static void dispatchEvent (EpollBindingData * bindingData, uint32_t events)
+{
+	switch (bindingData->type)
+	{
+	case EPOLL_OPERATION_FD: {
+		ElektraIoFdOperation * fdOp = bindingData->operation.fd;
+		if (bindingData->registered)
+		{
+			elektraIoFdGetCallback (fdOp) (fdOp, eventsToFlags (events, elektraIoFdGetFlags (fdOp)));
+		}
+		break;
+	}
+	case EPOLL_OPERATION_TIMER: {
+		ElektraIoTimerOperation * timerOp = bindingData->operation.timer;
+		uint64_t expirations;
+		// fails if the timer was updated since epoll_wait
+		if (read (bindingData->fd, &expirations, sizeof (expirations)) == sizeof (expirations))
+		{
+			if (elektraIoTimerGetInterval (timerOp) == 0)
+			{
+				bindingData->armed = 0;
+			}
+			elektraIoTimerGetCallback (timerOp) (timerOp);
+		}
+		break;
+	}
+	case EPOLL_OPERATION_IDLE:
+		break;
+	}
+}
+
+ElektraIoEpollLoop * elektraIoEpollLoopNew (void)
+{
+	ElektraIoEpollLoop * loop = elektraCalloc (sizeof (*loop));
+	if (loop == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("elektraCalloc failed");
+		return NULL;
+	}
+
+	loop->epollFd = epoll_create1 (EPOLL_CLOEXEC);
+	if (loop->epollFd == -1)
+	{
+		ELEKTRA_LOG_WARNING ("could not create epoll instance: %s", strerror (errno));
+		elektraFree (loop);
+		return NULL;
+	}
+
+	return loop;
+}
+
+int elektraIoEpollLoopRunOnce (ElektraIoEpollLoop * loop, int timeout)
+{
+	if (loop == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("loop was NULL");
+		return 0;
+	}
+
+	// do not wait if idle operations need to be called
+	if (hasActiveOperations (loop, 1))
+	{
+		timeout = 0;
+	}
+
+	struct epoll_event events[ELEKTRA_IO_EPOLL_MAX_EVENTS];
+	int count = epoll_wait (loop->epollFd, events, ELEKTRA_IO_EPOLL_MAX_EVENTS, timeout);
+	if (count == -1)
+	{
+		if (errno == EINTR)
+		{
+			return 1;
+		}
+		ELEKTRA_LOG_WARNING ("epoll_wait failed: %s", strerror (errno));
+		return 0;
+	}
+
+	loop->dispatching++;
+
+	for (int i = 0; i < count; ++i)
+	{
+		EpollBindingData * bindingData = events[i].data.ptr;
+		if (!bindingData->removed)
+		{
+			dispatchEvent (bindingData, events[i].events);
+		}
+	}
+
+	EpollBindingData * next;
+	for (EpollBindingData * bindingData = loop->operations; bindingData != NULL; bindingData = next)
+	{
+		next = bindingData->next;
+		if (bindingData->type == EPOLL_OPERATION_IDLE && !bindingData->removed && isActive (bindingData))
+		{
+			ElektraIoIdleOperation * idleOp = bindingData->operation.idle;
+			elektraIoIdleGetCallback (idleOp) (idleOp);
+		}
+	}
+
+	loop->dispatching--;
+
+	if (!loop->dispatching)
+	{
+		while (loop->removed != NULL)
+		{
+			EpollBindingData * removed = loop->removed;
+			loop->removed = removed->nextRemoved;
+			elektraFree (removed);
+		}
+	}
+
+	return 1;
+}
+
+int elektraIoEpollLoopRun (ElektraIoEpollLoop * loop)
+{
+	if (loop == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("loop was NULL");
+		return 0;
+	}
+
+	int result = 1;
+	while (!loop->stop && hasActiveOperations (loop, 0))
+	{
+		if (!elektraIoEpollLoopRunOnce (loop, -1))
+		{
+			result = 0;
+			break;
+		}
+	}
+	loop->stop = 0;
+
+	return result;
+}
+
+void elektraIoEpollLoopStop (ElektraIoEpollLoop * loop)
+{
+	if (loop == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("loop was NULL");
+		return;
+	}
+	loop->stop = 1;
+}
+
+int elektraIoEpollLoopGetFd (ElektraIoEpollLoop * loop)
+{
+	if (loop == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("loop was NULL");
+		return -1;
+	}
+	return loop->epollFd;
+}
+
+void elektraIoEpollLoopDel (ElektraIoEpollLoop * loop)
+{
+	if (loop == NULL)
+	{
+		return;
+	}
+
+	if (loop->operations != NULL)
+	{
+		ELEKTRA_LOG_WARNING ("loop still has operations");
+	}
+	while (loop->operations != NULL)
+	{
+		removeBindingData (loop->operations);
+	}
+
+	close (loop->epollFd);
+	elektraFree (loop);
+}
+
+/**
+ * Create and initialize a new I/O binding.
+ * @param  loop Loop to use for I/O operations
+ * @return      Populated I/O interface
+ */
+ElektraIoInterface * elektraIoEpollNew (ElektraIoEpollLoop * loop)
+{
+	if (loop == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("loop was NULL");
+		return NULL;
+	}
+	// Initialize I/O interface
+	ElektraIoInterface * binding = elektraIoNewBinding (
+		// file descriptors
+		ioEpollBindingAddFd, ioEpollBindingUpdateFd, ioEpollBindingRemoveFd,
+		// timers
+		ioEpollBindingAddTimer, ioEpollBindingUpdateTimer, ioEpollBindingRemoveTimer,
+		// idle
+		ioEpollBindingAddIdle, ioEpollBindingUpdateIdle, ioEpollBindingRemoveIdle,
+		// cleanup
+		ioEpollBindingCleanup);
+	if (binding == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("elektraIoNewBinding failed");
+		return NULL;
+	}
+
+	// Save the loop we are using
+	elektraIoBindingSetData (binding, loop);
+
+	return binding;
+}
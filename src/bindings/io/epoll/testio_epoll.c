@@ -0,0 +1,50 @@
+/**
+ * @file
+ *
+ * @brief Tests for I/O epoll binding.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <kdbio.h>
+#include <kdbiotest.h>
+#include <tests.h>
+
+#include <kdbio/epoll.h>
+
+static ElektraIoEpollLoop * loop;
+
+static ElektraIoInterface * createBinding (void)
+{
+	return elektraIoEpollNew (loop);
+}
+
+static void startLoop (void)
+{
+	elektraIoEpollLoopRun (loop);
+}
+
+static void stopLoop (void)
+{
+	elektraIoEpollLoopStop (loop);
+}
+
+int main (int argc, char ** argv)
+{
+	init (argc, argv);
+
+	loop = elektraIoEpollLoopNew ();
+	exit_if_fail (loop != NULL, "could not create loop");
+
+	elektraIoTestSuite (createBinding, startLoop, stopLoop);
+
+	elektraIoEpollLoopDel (loop);
+
+	print_result ("iowrapper_epoll");
+
+	return nbError;
+}
@@ -25,6 +25,9 @@
 #define ELEKTRA_GET_ARRAY_ELEMENT_SIGNATURE(cType, typeName)                                                                               \
 	cType ELEKTRA_GET_ARRAY_ELEMENT (typeName) (Elektra * elektra, const char * keyname, kdb_long_long_t index)
 
+#define ELEKTRA_GET_BY_HANDLE(typeName) ELEKTRA_CONCAT (ELEKTRA_CONCAT (elektraGet, typeName), ByHandle)
+#define ELEKTRA_GET_BY_HANDLE_SIGNATURE(cType, typeName) cType ELEKTRA_GET_BY_HANDLE (typeName) (ElektraKeyHandle * handle)
+
 #define ELEKTRA_GET_OUT_PTR_SIGNATURE(cType, typeName) void ELEKTRA_GET (typeName) (Elektra * elektra, const char * keyname, cType * result)
 #define ELEKTRA_GET_OUT_PTR_ARRAY_ELEMENT_SIGNATURE(cType, typeName)                                                                       \
 	void ELEKTRA_GET_ARRAY_ELEMENT (typeName) (Elektra * elektra, const char * keyname, kdb_long_long_t index, cType * result)
@@ -54,6 +57,7 @@ extern "C" {
 #endif
 
 typedef struct _Elektra Elektra;
+typedef struct _ElektraKeyHandle ElektraKeyHandle;
 
 // region Basics
 /**************************************
@@ -67,6 +71,9 @@ Elektra * ELEKTRA_SYMVER (elektraOpen, v1) (const char * application, KeySet * d
 Elektra * elektraOpen (const char * application, KeySet * defaults, KeySet * contract, ElektraError ** error);
 void elektraClose (Elektra * elektra);
 
+void elektraBeginBatch (Elektra * elektra);
+void elektraCommitBatch (Elektra * elektra, ElektraError ** error);
+
 // endregion Basics
 
 // region Error-Handling
@@ -96,6 +103,10 @@ const char * elektraFindReferenceArrayElement (Elektra * elektra, const char * n
 
 Key * elektraHelpKey (Elektra * elektra);
 
+ElektraKeyHandle * elektraKeyHandle (Elektra * elektra, size_t id, const char * name, KDBType type);
+Key * elektraFindKeyByHandle (ElektraKeyHandle * handle);
+void elektraKeyHandleFatalConversionError (ElektraKeyHandle * handle, KDBType type);
+
 // endregion Helpers for code generation
 
 // region Getters
@@ -127,6 +138,34 @@ kdb_long_double_t elektraGetLongDouble (Elektra * elektra, const char * keyname)
 
 // endregion Getters
 
+// region Handle-Getters
+/**************************************
+ *
+ * Handle-Getters
+ *
+ **************************************/
+
+const char * elektraGetStringByHandle (ElektraKeyHandle * handle);
+kdb_boolean_t elektraGetBooleanByHandle (ElektraKeyHandle * handle);
+kdb_char_t elektraGetCharByHandle (ElektraKeyHandle * handle);
+kdb_octet_t elektraGetOctetByHandle (ElektraKeyHandle * handle);
+kdb_short_t elektraGetShortByHandle (ElektraKeyHandle * handle);
+kdb_unsigned_short_t elektraGetUnsignedShortByHandle (ElektraKeyHandle * handle);
+kdb_long_t elektraGetLongByHandle (ElektraKeyHandle * handle);
+kdb_unsigned_long_t elektraGetUnsignedLongByHandle (ElektraKeyHandle * handle);
+kdb_long_long_t elektraGetLongLongByHandle (ElektraKeyHandle * handle);
+kdb_unsigned_long_long_t elektraGetUnsignedLongLongByHandle (ElektraKeyHandle * handle);
+kdb_float_t elektraGetFloatByHandle (ElektraKeyHandle * handle);
+kdb_double_t elektraGetDoubleByHandle (ElektraKeyHandle * handle);
+
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
+kdb_long_double_t elektraGetLongDoubleByHandle (ElektraKeyHandle * handle);
+
+#endif
+
+// endregion Handle-Getters
+
 // region Setters
 /**************************************
  *
@@ -0,0 +1,74 @@
+/**
+ * @file
+ *
+ * @brief Declarations for the epoll I/O binding.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+#ifndef KDB_IOWRAPPER_EPOLL_H_
+#define KDB_IOWRAPPER_EPOLL_H_
+
+#include <kdbio.h>
+
+/**
+ * Event loop based on epoll, timerfd and the idle operations added to it.
+ */
+typedef struct _ElektraIoEpollLoop ElektraIoEpollLoop;
+
+/**
+ * Create a new event loop.
+ * @return new loop or NULL on error
+ */
+ElektraIoEpollLoop * elektraIoEpollLoopNew (void);
+
+/**
+ * Run the loop until elektraIoEpollLoopStop() is called or no operation is enabled.
+ * @param  loop loop
+ * @retval 1 on success
+ * @retval 0 on error
+ */
+int elektraIoEpollLoopRun (ElektraIoEpollLoop * loop);
+
+/**
+ * Wait for events once and call the callbacks of all ready operations.
+ * Useful for integrating the loop into an existing main loop.
+ *
+ * @param  loop    loop
+ * @param  timeout maximum time to wait in milliseconds, -1 waits indefinitely
+ * @retval 1 on success
+ * @retval 0 on error
+ */
+int elektraIoEpollLoopRunOnce (ElektraIoEpollLoop * loop, int timeout);
+
+/**
+ * Stop elektraIoEpollLoopRun() after the current iteration.
+ * @param loop loop
+ */
+void elektraIoEpollLoopStop (ElektraIoEpollLoop * loop);
+
+/**
+ * Get the epoll file descriptor of the loop.
+ * It becomes readable when file descriptors or timers are ready,
+ * elektraIoEpollLoopRunOnce() with timeout 0 should be called then.
+ *
+ * @param  loop loop
+ * @return      epoll file descriptor
+ */
+int elektraIoEpollLoopGetFd (ElektraIoEpollLoop * loop);
+
+/**
+ * Delete the loop.
+ * All operations should be removed from bindings using this loop before.
+ *
+ * @param loop loop
+ */
+void elektraIoEpollLoopDel (ElektraIoEpollLoop * loop);
+
+/**
+ * Create and initialize a new I/O binding.
+ * @param  loop Loop to use for I/O operations
+ * @return      Populated I/O interface
+ */
+ElektraIoInterface * elektraIoEpollNew (ElektraIoEpollLoop * loop);
+
+#endif
@@ -44,14 +44,13 @@
 typedef struct
 {
 	uint32_t order;	     /*!< desired hash map return value */
-	uint32_t * nextEdge; /*!< arary with Opmphm->rUniPar indices of the next edge in the lists */
 	uint32_t * vertices; /*!< array with Opmphm->rUniPar indices of vertices that the edge connects */
 } OpmphmEdge;
 
 typedef struct
 {
-	uint32_t firstEdge; /*!< first edge in the list of edges of a vertex */
-	uint32_t degree;    /*!< length of the list */
+	uint32_t edgeXor; /*!< xor of the indices of all edges of a vertex, the remaining edge if degree is 1 */
+	uint32_t degree;  /*!< number of edges of a vertex */
 } OpmphmVertex;
 
 typedef struct
@@ -141,6 +140,14 @@ int opmphmIsBuild (const Opmphm * opmphm);
 int opmphmCopy (Opmphm * dest, const Opmphm * source);
 void opmphmClear (Opmphm * opmphm);
 
+/**
+ * Hash functions
+ *
+ * opmphmHashfunction is the hash function selected at build time with `OPMPHM_HASHFUNCTION`.
+ * All hash functions are always available, so they can be compared in the benchmarks.
+ */
+uint32_t opmphmHashfunction (const void * key, size_t length, uint32_t initval);
+
 /**
  * Hash function
  * By Bob Jenkins, May 2006
@@ -188,6 +195,13 @@ void opmphmClear (Opmphm * opmphm);
 		c ^= OPMPHM_HASHFUNCTION_ROT (b, 4);                                                                                       \
 		b += a;                                                                                                                    \
 	}
-uint32_t opmphmHashfunction (const void * key, size_t length, uint32_t initval);
+uint32_t opmphmHashfunctionJenkins (const void * key, size_t length, uint32_t initval);
+
+/**
+ * Hash function
+ * wyhash by Wang Yi, final version 4
+ * https://github.com/wangyi-fudan/wyhash
+ */
+uint32_t opmphmHashfunctionWyhash (const void * key, size_t length, uint32_t initval);
 
 #endif
@@ -106,6 +106,9 @@ void * elektraPluginGetData (Plugin * plugin);
 
 KeySet * elektraPluginGetGlobalKeySet (Plugin * plugin);
 
+int elektraPluginRequestChangeSet (Plugin * plugin);
+int elektraPluginGetChangeSet (Plugin * plugin, KeySet ** added, KeySet ** changed, KeySet ** removed);
+
 #define PLUGINVERSION "1"
 
 
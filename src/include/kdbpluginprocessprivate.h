@@ -0,0 +1,27 @@
+/**
+ * @file
+ *
+ * @brief Private functions of the pluginprocess library, not yet used by any plugin
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+#ifndef KDBPLUGINPROCESSPRIVATE_H
+#define KDBPLUGINPROCESSPRIVATE_H
+
+#include <kdbpluginprocess.h>
+
+#ifdef __cplusplus
+namespace ckdb
+{
+extern "C" {
+#endif
+
+ElektraPluginProcess * elektraPluginProcessInitShared (Plugin *, Key *);
+
+#ifdef __cplusplus
+}
+}
+#endif
+
+
+#endif
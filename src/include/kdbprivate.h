@@ -18,6 +18,7 @@
 #include <kdbmacros.h>
 #include <kdbnotificationinternal.h>
 #include <kdbplugin.h>
+#include <kdbproposal.h>
 #include <kdbtypes.h>
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
 #include <kdbopmphm.h>
@@ -68,6 +69,10 @@
 /** All keys below this are used for cache metadata in the global keyset */
 #define KDB_CACHE_PREFIX "system:/elektra/cache"
 
+/** Plugins request the changeset of kdbSet() with this key in the global keyset,
+ * the added, changed and removed keys are published below it */
+#define KDB_CHANGESET_PREFIX "system:/elektra/changeset"
+
 
 #ifdef __cplusplus
 namespace ckdb
@@ -78,6 +83,7 @@ extern "C" {
 typedef struct _Trie Trie;
 typedef struct _Split Split;
 typedef struct _Backend Backend;
+typedef struct _KDBStats KDBStats;
 
 
 /* These define the type for pointers to all the kdb functions */
@@ -265,6 +271,25 @@ struct _Key
 };
 
 
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+/**
+ * Entry of the search index of a KeySet.
+ *
+ * @ingroup backend
+ */
+typedef struct _SearchIndexEntry
+{
+	/**
+	 * 8 bytes of the unescaped name, starting after the prefix all
+	 * Keys of the KeySet share, packed big-endian so that comparing two
+	 * prefixes yields the order of the names, unless they are equal.
+	 */
+	uint64_t prefix;
+	const char * name; /**< The unescaped name of the Key */
+	size_t size;	   /**< Size of the unescaped name of the Key */
+} SearchIndexEntry;
+#endif
+
 /**
  * The private KeySet structure.
  *
@@ -306,6 +331,13 @@ struct _KeySet
 	 * The Order Preserving Minimal Perfect Hash Map Predictor.
 	 */
 	OpmphmPredictor * opmphmPredictor;
+	/**
+	 * Search index, parallel to array.
+	 * Lets binary searches compare names without dereferencing the Keys.
+	 */
+	SearchIndexEntry * searchIndex;
+	size_t searchIndexOffset;  /**< Number of leading unescaped name bytes all Keys share */
+	size_t searchIndexLookups; /**< Binary searches since the search index was dropped */
 #endif
 };
 
@@ -347,6 +379,57 @@ struct _KDB
 			up their parts of the global keyset, which they do not need any more.*/
 
 	Plugin * globalPlugins[NR_GLOBAL_POSITIONS][NR_GLOBAL_SUBPOSITIONS];
+
+	KDBStats * stats; /*!< Durations of plugin calls, NULL if they are not recorded.
+			@see kdbGetStats() */
+
+	KeySet * changeSetBase; /*!< The keys returned by the last kdbGet() or stored by the last kdbSet(),
+			the changeset of the next kdbSet() is relative to them. NULL if no plugin
+			requested the changeset. @see KDB_CHANGESET_PREFIX */
+};
+
+/**
+ * The durations of plugin calls recorded for a handle.
+ *
+ * @see kdbGetStats()
+ * @ingroup backend
+ */
+struct _KDBStats
+{
+	KDBStatsEntry * entries; /*!< One entry per phase, backend in a phase and plugin of a backend in a phase.*/
+	size_t size;		 /*!< The number of entries.*/
+	size_t alloc;		 /*!< The allocated number of entries.*/
+	char phaseNames[NR_GLOBAL_POSITIONS + 2][16]; /*!< The names of the global positions in lowercase,
+			followed by `kdbget` and `kdbset`. The entries point to them.*/
+};
+
+
+/**
+ * The state of a prepared kdbGet().
+ *
+ * Keeps everything kdbGet() derives from the name of the parentKey
+ * alive between calls.
+ *
+ * @see kdbGetPrepare()
+ * @ingroup backend
+ */
+struct _KDBPreparedGet
+{
+	KDB * handle; /*!< The handle the get was prepared for.*/
+
+	Split * split; /*!< The backends below parentKey, reused for every call.
+			The keysets are cleared at the beginning of every call.*/
+
+	size_t splitSize; /*!< The size of split after splitBuildup(),
+			everything appended later is removed before the next call.*/
+
+	Key * parentKey; /*!< Copy of the name of the prepared parentKey.*/
+
+	Key * cacheParent; /*!< The mountpoint used as parent for the global cache.*/
+
+	int fetched; /*!< Set after the first successful get. Afterwards the
+			resolvers know the state of their files and the global cache
+			does not need to be loaded anymore.*/
 };
 
 
@@ -442,6 +525,9 @@ struct _Plugin
 	KeySet * global; /*!< This keyset can be used by plugins to pass data through
 			the KDB and communicate with other plugins. Plugins shall clean
 			up their parts of the global keyset, which they do not need any more.*/
+
+	int changeSet; /*!< 1 if the plugin requested the changeset of kdbSet().
+			@see elektraPluginRequestChangeSet() */
 };
 
 
@@ -572,6 +658,7 @@ void keyInit (Key * key);
 int keyClearSync (Key * key);
 
 int keyReplacePrefix (Key * key, const Key * oldPrefix, const Key * newPrefix);
+Key * elektraKeyNewTrusted (const Key * parent, const char * name, size_t size);
 
 /*Private helper for keyset*/
 int ksInit (KeySet * ks);
@@ -618,6 +705,19 @@ int elektraGlobalGet (KDB * handle, KeySet * ks, Key * parentKey, int position,
 int elektraGlobalSet (KDB * handle, KeySet * ks, Key * parentKey, int position, int subPosition);
 int elektraGlobalError (KDB * handle, KeySet * ks, Key * parentKey, int position, int subPosition);
 
+/* statistics of plugin calls, phases are the global positions and these */
+#define ELEKTRA_STATS_KDBGET NR_GLOBAL_POSITIONS
+#define ELEKTRA_STATS_KDBSET (NR_GLOBAL_POSITIONS + 1)
+void elektraStatsOpen (KDB * handle);
+void elektraStatsClose (KDB * handle);
+unsigned long long elektraStatsStart (const KDB * handle);
+void elektraStatsStop (KDB * handle, int phase, const char * backend, const char * plugin, unsigned long long start);
+void elektraStatsStore (KDB * handle);
+int elektraStatsPluginGet (KDB * handle, int phase, const char * backend, Plugin * plugin, KeySet * ks, Key * parentKey);
+int elektraStatsPluginSet (KDB * handle, int phase, const char * backend, Plugin * plugin, KeySet * ks, Key * parentKey);
+int elektraStatsPluginCommit (KDB * handle, int phase, const char * backend, Plugin * plugin, KeySet * ks, Key * parentKey);
+int elektraStatsPluginError (KDB * handle, int phase, const char * backend, Plugin * plugin, KeySet * ks, Key * parentKey);
+
 /** Test a bit. @see set_bit(), clear_bit() */
 #define test_bit(var, bit) (((unsigned long long) (var)) & ((unsigned long long) (bit)))
 /** Set a bit. @see clear_bit() */
@@ -645,6 +745,39 @@ struct _Elektra
 	ElektraErrorHandler fatalErrorHandler;
 	char * resolvedReference;
 	size_t parentKeyLength;
+	size_t generation; /*!< Incremented whenever config is modified, invalidates all key handles */
+	struct _ElektraKeyHandle ** handles;
+	size_t handlesSize;
+	KeySet * batch; /*!< The keys modified since elektraBeginBatch(), NULL if no batch was started */
+};
+
+struct _ElektraKeyHandle
+{
+	Elektra * elektra;
+	char * name;	 /*!< The relative name of the key */
+	Key * lookupKey; /*!< The full name of the key, only built once */
+	KDBType type;
+	Key * key;	   /*!< The resolved key, only valid if generation matches elektra->generation */
+	size_t generation;
+	KDBType valueType; /*!< The type of the cached value, NULL if no value was converted since the key was resolved */
+	union
+	{
+		const char * stringValue;
+		kdb_boolean_t booleanValue;
+		kdb_char_t charValue;
+		kdb_octet_t octetValue;
+		kdb_short_t shortValue;
+		kdb_unsigned_short_t unsignedShortValue;
+		kdb_long_t longValue;
+		kdb_unsigned_long_t unsignedLongValue;
+		kdb_long_long_t longLongValue;
+		kdb_unsigned_long_long_t unsignedLongLongValue;
+		kdb_float_t floatValue;
+		kdb_double_t doubleValue;
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+		kdb_long_double_t longDoubleValue;
+#endif
+	} value; /*!< The value of key converted to valueType */
 };
 
 struct _ElektraError
@@ -19,6 +19,27 @@ namespace ckdb
 extern "C" {
 #endif
 
+typedef struct _KDBPreparedGet KDBPreparedGet;
+
+KDBPreparedGet * kdbGetPrepare (KDB * handle, Key * parentKey);
+int kdbGetPrepared (KDBPreparedGet * prepared, KeySet * returned, Key * parentKey);
+void kdbGetPreparedDel (KDBPreparedGet * prepared);
+
+/**
+ * The accumulated duration of plugin calls.
+ *
+ * @see kdbGetStats()
+ */
+typedef struct _KDBStatsEntry
+{
+	const char * phase;	       /*!< A global plugin position like getstorage or commit, or kdbget or kdbset. */
+	const char * backend;	       /*!< The mountpoint of the backend, global for global plugins or NULL for the whole phase. */
+	const char * plugin;	       /*!< The name of the plugin or NULL for the whole backend or phase. */
+	size_t calls;		       /*!< The number of calls. */
+	unsigned long long nanoseconds; /*!< The sum of the durations of all calls. */
+} KDBStatsEntry;
+
+const KDBStatsEntry * kdbGetStats (const KDB * handle, size_t * size);
 
 #ifdef __cplusplus
 }
@@ -519,6 +519,8 @@ KDB * kdbOpen (const KeySet * contract, Key * errorKey)
 		}
 	}
 
+	elektraStatsOpen (handle);
+
 	handle->split = splitNew ();
 
 	keySetString (errorKey, "kdbOpen(): mountOpen");
@@ -632,7 +634,9 @@ int kdbClose (KDB * handle, Key * errorKey)
 	}
 
 	if (handle->global) ksDel (handle->global);
+	if (handle->changeSetBase) ksDel (handle->changeSetBase);
 
+	elektraStatsClose (handle);
 	elektraFree (handle);
 
 	keySetName (errorKey, keyName (initialParent));
@@ -642,6 +646,56 @@ int kdbClose (KDB * handle, Key * errorKey)
 	return 0;
 }
 
+/**
+ * @internal
+ *
+ * @brief The name of a backend in the statistics
+ */
+static const char * statsBackendName (const Backend * backend)
+{
+	return backend->mountpoint ? keyName (backend->mountpoint) : "default";
+}
+
+/**
+ * @internal
+ *
+ * @brief The position of the get plugin with index @p p of a backend in the statistics
+ */
+static int statsGetPosition (size_t p)
+{
+	if (p == RESOLVER_PLUGIN) return GETRESOLVER;
+	if (p < STORAGE_PLUGIN) return PREGETSTORAGE;
+	if (p == STORAGE_PLUGIN) return GETSTORAGE;
+	return POSTGETSTORAGE;
+}
+
+/**
+ * @internal
+ *
+ * @brief The position of the set plugin with index @p p of a backend in the statistics
+ */
+static int statsSetPosition (size_t p)
+{
+	if (p == RESOLVER_PLUGIN) return SETRESOLVER;
+	if (p < STORAGE_PLUGIN) return PRESETSTORAGE;
+	if (p == STORAGE_PLUGIN) return SETSTORAGE;
+	if (p < COMMIT_PLUGIN) return PRECOMMIT;
+	if (p == COMMIT_PLUGIN) return COMMIT;
+	return POSTCOMMIT;
+}
+
+/**
+ * @internal
+ *
+ * @brief The position of the error plugin with index @p p of a backend in the statistics
+ */
+static int statsErrorPosition (size_t p)
+{
+	if (p < STORAGE_PLUGIN) return PREROLLBACK;
+	if (p == STORAGE_PLUGIN) return ROLLBACK;
+	return POSTROLLBACK;
+}
+
 /**
  * @internal
  *
@@ -652,7 +706,7 @@ int kdbClose (KDB * handle, Key * errorKey)
  * @retval 0 no update needed
  * @retval number of plugins which need update
  */
-static int elektraGetCheckUpdateNeeded (Split * split, Key * parentKey)
+static int elektraGetCheckUpdateNeeded (KDB * handle, Split * split, Key * parentKey)
 {
 	int updateNeededOccurred = 0;
 	size_t cacheHits = 0;
@@ -669,7 +723,7 @@ static int elektraGetCheckUpdateNeeded (Split * split, Key * parentKey)
 			ksRewind (split->keysets[i]);
 			keySetName (parentKey, keyName (split->parents[i]));
 			keySetString (parentKey, "");
-			ret = resolver->kdbGet (resolver, split->keysets[i], parentKey);
+			ret = elektraStatsPluginGet (handle, GETRESOLVER, statsBackendName (backend), resolver, split->keysets[i], parentKey);
 			// store resolved filename
 			keySetString (split->parents[i], keyString (parentKey));
 			// no keys in that backend
@@ -729,7 +783,7 @@ typedef enum
  * @retval -1 on error
  * @retval 0 on success
  */
-static int elektraGetDoUpdate (Split * split, Key * parentKey)
+static int elektraGetDoUpdate (KDB * handle, Split * split, Key * parentKey)
 {
 	const int bypassedSplits = 1;
 	for (size_t i = 0; i < split->size - bypassedSplits; i++)
@@ -751,7 +805,8 @@ static int elektraGetDoUpdate (Split * split, Key * parentKey)
 			int ret = 0;
 			if (backend->getplugins[p] && backend->getplugins[p]->kdbGet)
 			{
-				ret = backend->getplugins[p]->kdbGet (backend->getplugins[p], split->keysets[i], parentKey);
+				ret = elektraStatsPluginGet (handle, statsGetPosition (p), statsBackendName (backend), backend->getplugins[p],
+							     split->keysets[i], parentKey);
 			}
 
 			if (ret == -1)
@@ -857,8 +912,7 @@ static int elektraGetDoUpdateWithGlobalHooks (KDB * handle, Split * split, KeySe
 				keySetName (parentKey, keyName (initialParent));
 				/* TODO: Remove usage of deprecated internal iterator */
 				ksRewind (ks);
-				handle->globalPlugins[PROCGETSTORAGE][FOREACH]->kdbGet (handle->globalPlugins[PROCGETSTORAGE][FOREACH], ks,
-											parentKey);
+				elektraStatsPluginGet (handle, PROCGETSTORAGE, NULL, handle->globalPlugins[PROCGETSTORAGE][FOREACH], ks, parentKey);
 				keySetName (parentKey, keyName (split->parents[i]));
 			}
 			if (p == (STORAGE_PLUGIN + 2) && handle->globalPlugins[POSTGETSTORAGE][FOREACH])
@@ -866,8 +920,7 @@ static int elektraGetDoUpdateWithGlobalHooks (KDB * handle, Split * split, KeySe
 				keySetName (parentKey, keyName (initialParent));
 				/* TODO: Remove usage of deprecated internal iterator */
 				ksRewind (ks);
-				handle->globalPlugins[POSTGETSTORAGE][FOREACH]->kdbGet (handle->globalPlugins[POSTGETSTORAGE][FOREACH], ks,
-											parentKey);
+				elektraStatsPluginGet (handle, POSTGETSTORAGE, NULL, handle->globalPlugins[POSTGETSTORAGE][FOREACH], ks, parentKey);
 				keySetName (parentKey, keyName (split->parents[i]));
 			}
 			else if (p == (NR_OF_PLUGINS - 1) && handle->globalPlugins[POSTGETCLEANUP][FOREACH])
@@ -875,8 +928,7 @@ static int elektraGetDoUpdateWithGlobalHooks (KDB * handle, Split * split, KeySe
 				keySetName (parentKey, keyName (initialParent));
 				/* TODO: Remove usage of deprecated internal iterator */
 				ksRewind (ks);
-				handle->globalPlugins[POSTGETCLEANUP][FOREACH]->kdbGet (handle->globalPlugins[POSTGETCLEANUP][FOREACH], ks,
-											parentKey);
+				elektraStatsPluginGet (handle, POSTGETCLEANUP, NULL, handle->globalPlugins[POSTGETCLEANUP][FOREACH], ks, parentKey);
 				keySetName (parentKey, keyName (split->parents[i]));
 			}
 
@@ -890,12 +942,14 @@ static int elektraGetDoUpdateWithGlobalHooks (KDB * handle, Split * split, KeySe
 						continue;
 					}
 
-					ret = backend->getplugins[p]->kdbGet (backend->getplugins[p], split->keysets[i], parentKey);
+					ret = elektraStatsPluginGet (handle, statsGetPosition (p), statsBackendName (backend),
+								     backend->getplugins[p], split->keysets[i], parentKey);
 				}
 				else
 				{
 					KeySet * cutKS = prepareGlobalKS (ks, parentKey);
-					ret = backend->getplugins[p]->kdbGet (backend->getplugins[p], cutKS, parentKey);
+					ret = elektraStatsPluginGet (handle, statsGetPosition (p), statsBackendName (backend),
+								     backend->getplugins[p], cutKS, parentKey);
 					ksAppend (ks, cutKS);
 					ksDel (cutKS);
 				}
@@ -1117,6 +1171,9 @@ static int elektraCacheLoadSplit (KDB * handle, Split * split, KeySet * ks, KeyS
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
 		ks->opmphm = (*cache)->opmphm;
 		ks->opmphmPredictor = (*cache)->opmphmPredictor;
+		ks->searchIndex = (*cache)->searchIndex;
+		ks->searchIndexOffset = (*cache)->searchIndexOffset;
+		ks->searchIndexLookups = (*cache)->searchIndexLookups;
 #endif
 		elektraFree (*cache);
 		*cache = 0;
@@ -1143,6 +1200,221 @@ static int elektraCacheLoadSplit (KDB * handle, Split * split, KeySet * ks, KeyS
 }
 
 
+
+/**
+ * @internal
+ * @brief Create the key used as parent for the global cache.
+ *
+ * @param handle the handle to look up the mountpoint
+ * @param parentKey the parentKey passed to kdbGet()
+ *
+ * @return a copy of the mountpoint responsible for @p parentKey
+ */
+static Key * elektraCacheParentNew (KDB * handle, Key * parentKey)
+{
+	Key * cacheParent = keyDup (mountGetMountpoint (handle, keyName (parentKey)), KEY_CP_ALL);
+	if (cacheParent == NULL)
+	{
+		cacheParent = keyNew ("default:/", KEY_VALUE, "default", KEY_END);
+	}
+	if (keyGetNamespace (parentKey) == KEY_NS_CASCADING) keySetMeta (cacheParent, "cascading", "");
+	return cacheParent;
+}
+
+/**
+ * @internal
+ * @brief Release the per-call state of kdbGet().
+ *
+ * For a prepared get the split and the parent are owned by the
+ * prepared handle, only its state gets updated.
+ *
+ * @param prepared the prepared handle or NULL for plain kdbGet()
+ * @param initialParent the copy of the parentKey
+ * @param split the split used for this kdbGet()
+ * @param success whether the keys were successfully retrieved
+ */
+static void elektraGetPreparedDone (KDBPreparedGet * prepared, Key * initialParent, Split * split, int success)
+{
+	if (prepared)
+	{
+		if (success) prepared->fetched = 1;
+		return;
+	}
+
+	keyDel (initialParent);
+	splitDel (split);
+}
+
+/**
+ * @internal
+ * @brief Remember the keys the changeset of the next kdbSet() is relative to.
+ *
+ * Only done if a plugin requested the changeset by adding
+ * KDB_CHANGESET_PREFIX to the global keyset.
+ * The copy is shallow, so it costs one array of pointers.
+ *
+ * @param handle the handle to remember the keys in
+ * @param ks the keys returned by kdbGet() or stored by kdbSet()
+ */
+static void elektraChangeSetRemember (KDB * handle, KeySet * ks)
+{
+	if (!ksLookupByName (handle->global, KDB_CHANGESET_PREFIX, 0)) return;
+	if (handle->changeSetBase) ksDel (handle->changeSetBase);
+	handle->changeSetBase = ksDup (ks);
+}
+
+static void elektraChangeSetAppend (KeySet * global, const char * name, KeySet * keys)
+{
+	ksAppendKey (global, keyNew (name, KEY_BINARY, KEY_SIZE, sizeof (keys), KEY_VALUE, &keys, KEY_END));
+}
+
+/**
+ * @internal
+ * @brief Publish the changeset of kdbSet() for the postcommit plugins.
+ *
+ * Both KeySets are sorted, so a single pass over them finds the added keys,
+ * the removed keys and the changed keys (which need sync).
+ * The KeySets are published as pointers in the binary keys
+ * `added`, `changed` and `removed` below KDB_CHANGESET_PREFIX.
+ *
+ * @param global the global keyset to publish the changeset in
+ * @param old the keys of the last kdbGet()
+ * @param ks the keys stored by kdbSet()
+ */
+static void elektraChangeSetPublish (KeySet * global, KeySet * old, KeySet * ks)
+{
+	KeySet * added = ksNew (0, KS_END);
+	KeySet * changed = ksNew (0, KS_END);
+	KeySet * removed = ksNew (0, KS_END);
+
+	size_t i = 0;
+	size_t j = 0;
+	while (i < old->size || j < ks->size)
+	{
+		int cmp;
+		if (i == old->size)
+			cmp = 1;
+		else if (j == ks->size)
+			cmp = -1;
+		else
+			cmp = old->array[i] == ks->array[j] ? 0 : keyCmp (old->array[i], ks->array[j]);
+
+		if (cmp < 0)
+		{
+			ksAppendKey (removed, old->array[i++]);
+		}
+		else if (cmp > 0)
+		{
+			ksAppendKey (added, ks->array[j++]);
+		}
+		else
+		{
+			if (keyNeedSync (ks->array[j])) ksAppendKey (changed, ks->array[j]);
+			++i;
+			++j;
+		}
+	}
+
+	elektraChangeSetAppend (global, KDB_CHANGESET_PREFIX "/added", added);
+	elektraChangeSetAppend (global, KDB_CHANGESET_PREFIX "/changed", changed);
+	elektraChangeSetAppend (global, KDB_CHANGESET_PREFIX "/removed", removed);
+}
+
+static void elektraChangeSetRemove (KeySet * global, const char * name)
+{
+	Key * key = ksLookupByName (global, name, KDB_O_POP);
+	if (!key) return;
+	ksDel (*(KeySet **) keyValue (key));
+	keyDel (key);
+}
+
+static void elektraChangeSetWithdraw (KeySet * global)
+{
+	elektraChangeSetRemove (global, KDB_CHANGESET_PREFIX "/added");
+	elektraChangeSetRemove (global, KDB_CHANGESET_PREFIX "/changed");
+	elektraChangeSetRemove (global, KDB_CHANGESET_PREFIX "/removed");
+}
+
+/**
+ * @internal
+ * @brief Split the remembered keys by the backends of kdbSet().
+ *
+ * The plugins of a backend only see the keys of their backend,
+ * so their changeset is relative to the remembered keys of this backend.
+ * Only backends with a postcommit plugin that requested the changeset
+ * get their keys, all others are skipped.
+ * The remembered keys are sorted, so consecutive keys mostly belong
+ * to the same backend and are split in a single pass.
+ *
+ * @param handle the handle with the keys of the last kdbGet()
+ * @param split the backends of kdbSet()
+ * @return the remembered keys per backend, to be freed with elektraChangeSetSplitDel()
+ * @retval NULL if no postcommit plugin of a backend requested the changeset
+ */
+static KeySet ** elektraChangeSetSplit (KDB * handle, Split * split)
+{
+	if (!handle->changeSetBase) return NULL;
+
+	KeySet ** old = NULL;
+	for (size_t i = 0; i < split->size; ++i)
+	{
+		Backend * backend = split->handles[i];
+		for (size_t p = COMMIT_PLUGIN + 1; p < NR_OF_PLUGINS; ++p)
+		{
+			if (!backend->setplugins[p] || !backend->setplugins[p]->changeSet) continue;
+			if (!old) old = elektraCalloc (split->size * sizeof (KeySet *));
+			old[i] = ksNew (0, KS_END);
+			break;
+		}
+	}
+	if (!old) return NULL;
+
+	Backend * last = NULL;
+	KeySet * lastKeys = NULL;
+	for (size_t k = 0; k < handle->changeSetBase->size; ++k)
+	{
+		Key * cur = handle->changeSetBase->array[k];
+		Backend * backend = mountGetBackend (handle, keyName (cur));
+		if (backend != last)
+		{
+			last = backend;
+			lastKeys = NULL;
+			for (size_t i = 0; i < split->size; ++i)
+			{
+				if (split->handles[i] == backend) lastKeys = old[i];
+			}
+		}
+		if (lastKeys) ksAppendKey (lastKeys, cur);
+	}
+	return old;
+}
+
+static void elektraChangeSetSplitDel (KeySet ** old, Split * split)
+{
+	if (!old) return;
+	for (size_t i = 0; i < split->size; ++i)
+	{
+		if (old[i]) ksDel (old[i]);
+	}
+	elektraFree (old);
+}
+
+/**
+ * @internal
+ * @brief Drop the changeset published by elektraChangeSetPublish()
+ * and remember the stored keys for the next kdbSet().
+ *
+ * @param handle the handle the changeset was published for
+ * @param ks the keys stored by kdbSet()
+ */
+static void elektraChangeSetDone (KDB * handle, KeySet * ks)
+{
+	elektraChangeSetWithdraw (handle->global);
+	elektraChangeSetRemember (handle, ks);
+}
+
+static int elektraGetImpl (KDB * handle, KeySet * ks, Key * parentKey, KDBPreparedGet * prepared);
+
 /**
  * Retrieve Keys from a Key database in an atomic and universal way.
  *
@@ -1222,6 +1494,125 @@ static int elektraCacheLoadSplit (KDB * handle, Split * split, KeySet * ks, KeyS
  * @see kdbClose() to finish affairs with the key database.
  */
 int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
+{
+	unsigned long long start = elektraStatsStart (handle);
+	int ret = elektraGetImpl (handle, ks, parentKey, 0);
+	elektraStatsStop (handle, ELEKTRA_STATS_KDBGET, NULL, NULL, start);
+	elektraStatsStore (handle);
+	return ret;
+}
+
+/**
+ * @brief Prepare repeated kdbGet() calls for the same parent key.
+ *
+ * Everything kdbGet() would compute on every call from the name of
+ * @p parentKey is done once here: the split of the mountpoints below
+ * @p parentKey and the cache parent.
+ * The returned handle can be passed to kdbGetPrepared() arbitrarily often.
+ *
+ * After the first successful kdbGetPrepared() the global cache is not
+ * consulted anymore: the resolvers already know the state of the files
+ * they resolved, so a call without changes in the key database only
+ * does the up-to-date check of every backend.
+ *
+ * @pre The @p handle must be passed as returned from kdbOpen().
+ * @pre The handle returned must be deleted with kdbGetPreparedDel()
+ *      before @p handle is closed with kdbClose().
+ *
+ * @param handle contains internal information of @link kdbOpen() opened @endlink key database
+ * @param parentKey Keys below @p parentKey will be retrieved by kdbGetPrepared().
+ * It is also used to set error information.
+ *
+ * @return a handle to be passed to kdbGetPrepared()
+ * @retval 0 on NULL pointers or an invalid @p parentKey
+ *
+ * @ingroup kdb
+ * @see kdbGetPrepared() to use the prepared handle
+ * @see kdbGetPreparedDel() to free the prepared handle
+ */
+KDBPreparedGet * kdbGetPrepare (KDB * handle, Key * parentKey)
+{
+	if (!handle || !parentKey) return 0;
+
+	elektraNamespace ns = keyGetNamespace (parentKey);
+	if (ns == KEY_NS_NONE) return 0;
+	if (ns == KEY_NS_META)
+	{
+		ELEKTRA_SET_INTERFACE_ERRORF (parentKey, "Metakey with name '%s' passed to kdbGetPrepare as parentkey",
+					      keyName (parentKey));
+		return 0;
+	}
+
+	KDBPreparedGet * prepared = elektraCalloc (sizeof (KDBPreparedGet));
+	prepared->handle = handle;
+	prepared->parentKey = keyDup (parentKey, KEY_CP_NAME);
+	prepared->split = splitNew ();
+
+	if (splitBuildup (prepared->split, handle, prepared->parentKey) == -1)
+	{
+		ELEKTRA_SET_INTERNAL_ERROR (parentKey, "Error in splitBuildup");
+		kdbGetPreparedDel (prepared);
+		return 0;
+	}
+
+	prepared->splitSize = prepared->split->size;
+	prepared->cacheParent = elektraCacheParentNew (handle, prepared->parentKey);
+	return prepared;
+}
+
+/**
+ * @brief Retrieve Keys like kdbGet() using a handle of kdbGetPrepare().
+ *
+ * The semantics, including the return values, are the same as for kdbGet().
+ *
+ * @param prepared the handle returned by kdbGetPrepare()
+ * @param ks the (pre-initialized) KeySet returned with all keys found
+ * @param parentKey must have the same name as the key passed to kdbGetPrepare().
+ * It is used to add warnings and set error information.
+ *
+ * @retval 1 if the Keys were retrieved successfully
+ * @retval 0 if there was no update
+ * @retval -1 on failure, e.g. if the name of @p parentKey differs from the prepared one
+ *
+ * @ingroup kdb
+ * @see kdbGet() for a detailed description
+ */
+int kdbGetPrepared (KDBPreparedGet * prepared, KeySet * ks, Key * parentKey)
+{
+	if (!prepared || !parentKey) return -1;
+
+	if (keyCmp (prepared->parentKey, parentKey) != 0)
+	{
+		ELEKTRA_SET_INTERFACE_ERRORF (parentKey, "Parent key '%s' differs from the prepared parent key '%s'", keyName (parentKey),
+					      keyName (prepared->parentKey));
+		return -1;
+	}
+
+	unsigned long long start = elektraStatsStart (prepared->handle);
+	int ret = elektraGetImpl (prepared->handle, ks, parentKey, prepared);
+	elektraStatsStop (prepared->handle, ELEKTRA_STATS_KDBGET, NULL, NULL, start);
+	elektraStatsStore (prepared->handle);
+	return ret;
+}
+
+/**
+ * @brief Free a handle returned by kdbGetPrepare().
+ *
+ * @param prepared the handle to free, may be NULL
+ *
+ * @ingroup kdb
+ */
+void kdbGetPreparedDel (KDBPreparedGet * prepared)
+{
+	if (!prepared) return;
+
+	splitDel (prepared->split);
+	keyDel (prepared->parentKey);
+	keyDel (prepared->cacheParent);
+	elektraFree (prepared);
+}
+
+static int elektraGetImpl (KDB * handle, KeySet * ks, Key * parentKey, KDBPreparedGet * prepared)
 {
 	elektraNamespace ns = keyGetNamespace (parentKey);
 	if (ns == KEY_NS_NONE)
@@ -1241,11 +1632,11 @@ int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
 	}
 
 	int errnosave = errno;
-	Key * initialParent = keyDup (parentKey, KEY_CP_ALL);
+	Key * initialParent = prepared ? prepared->parentKey : keyDup (parentKey, KEY_CP_ALL);
 
 	ELEKTRA_LOG ("now in new kdbGet (%s)", keyName (parentKey));
 
-	Split * split = splitNew ();
+	Split * split = prepared ? prepared->split : splitNew ();
 
 	KeySet * cache = 0;
 	Key * cacheParent = 0;
@@ -1272,7 +1663,19 @@ int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
 		goto error;
 	}
 
-	if (splitBuildup (split, handle, parentKey) == -1)
+	if (prepared)
+	{
+		// drop the bypass appended by splitAppoint() and the keys of the previous call, they are already in ks
+		while (split->size > prepared->splitSize)
+		{
+			splitRemove (split, split->size - 1);
+		}
+		for (size_t i = 0; i < split->size; ++i)
+		{
+			if (ksGetSize (split->keysets[i]) > 0) ksClear (split->keysets[i]);
+		}
+	}
+	else if (splitBuildup (split, handle, parentKey) == -1)
 	{
 		clearError (parentKey);
 		ELEKTRA_SET_INTERNAL_ERROR (parentKey, "Error in splitBuildup");
@@ -1280,16 +1683,12 @@ int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
 	}
 
 	keySetName (parentKey, keyName (initialParent));
-	cache = ksNew (0, KS_END);
-	cacheParent = keyDup (mountGetMountpoint (handle, keyName (parentKey)), KEY_CP_ALL);
-	if (cacheParent == NULL)
-	{
-		cacheParent = keyNew ("default:/", KEY_VALUE, "default", KEY_END);
-	}
-	if (ns == KEY_NS_CASCADING) keySetMeta (cacheParent, "cascading", "");
+	cacheParent = prepared ? keyDup (prepared->cacheParent, KEY_CP_ALL) : elektraCacheParentNew (handle, parentKey);
 	keySetName (parentKey, keyName (initialParent));
-	if (handle->globalPlugins[PREGETCACHE][MAXONCE])
+	// after a successful prepared get the resolvers know the state of their files, the cache is not needed
+	if (handle->globalPlugins[PREGETCACHE][MAXONCE] && !(prepared && prepared->fetched))
 	{
+		cache = ksNew (0, KS_END);
 		elektraCacheLoad (handle, cache, parentKey, initialParent, cacheParent); // parentkey different from initialParent
 	}
 
@@ -1297,11 +1696,11 @@ int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
 				handle->globalPlugins[PROCGETSTORAGE][DEINIT];
 
 	// Check if a update is needed at all
-	switch (elektraGetCheckUpdateNeeded (split, parentKey))
+	switch (elektraGetCheckUpdateNeeded (handle, split, parentKey))
 	{
 	case -2: // We have a cache hit
 		// TODO: cache breaks procgetstorage
-		if (hasProcGetStorage ||
+		if (hasProcGetStorage || !cache ||
 		    elektraCacheLoadSplit (handle, split, ks, &cache, &cacheParent, parentKey, initialParent, debugGlobalPositions) != 0)
 		{
 			goto cachemiss;
@@ -1309,8 +1708,8 @@ int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
 
 		keySetName (parentKey, keyName (initialParent));
 		splitUpdateFileName (split, handle, parentKey);
-		keyDel (initialParent);
-		splitDel (split);
+		elektraGetPreparedDone (prepared, initialParent, split, 1);
+		elektraChangeSetRemember (handle, ks);
 		errno = errnosave;
 		keyDel (oldError);
 		return 1;
@@ -1371,8 +1770,7 @@ int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
 
 		keySetName (parentKey, keyName (initialParent));
 		splitUpdateFileName (split, handle, parentKey);
-		keyDel (initialParent);
-		splitDel (split);
+		elektraGetPreparedDone (prepared, initialParent, split, 1);
 		errno = errnosave;
 		keyDel (oldError);
 		return 0;
@@ -1460,7 +1858,7 @@ cachemiss:
 		   but not for bypassed keys in split->size-1 */
 		clearError (parentKey);
 		// do everything up to position get_storage
-		if (elektraGetDoUpdate (split, parentKey) == -1)
+		if (elektraGetDoUpdate (handle, split, parentKey) == -1)
 		{
 			goto error;
 		}
@@ -1527,9 +1925,9 @@ cachemiss:
 	keySetName (parentKey, keyName (initialParent));
 
 	splitUpdateFileName (split, handle, parentKey);
-	keyDel (initialParent);
+	elektraGetPreparedDone (prepared, initialParent, split, 1);
+	elektraChangeSetRemember (handle, ks);
 	keyDel (oldError);
-	splitDel (split);
 	errno = errnosave;
 	return 1;
 
@@ -1544,9 +1942,8 @@ error:
 
 	keySetName (parentKey, keyName (initialParent));
 	if (handle) splitUpdateFileName (split, handle, parentKey);
-	keyDel (initialParent);
+	elektraGetPreparedDone (prepared, initialParent, split, 0);
 	keyDel (oldError);
-	splitDel (split);
 	errno = errnosave;
 	return -1;
 }
@@ -1555,6 +1952,7 @@ error:
  * @internal
  * @brief Does all set steps but not commit
  *
+ * @param handle contains the global plugins and the statistics
  * @param split all information for iteration
  * @param parentKey to add warnings (also passed to plugins for the same reason)
  * @param [out] errorKey may point to which key caused the error or 0 otherwise
@@ -1562,8 +1960,9 @@ error:
  * @retval -1 on error
  * @retval 0 on success
  */
-static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, Plugin * hooks[][NR_GLOBAL_SUBPOSITIONS])
+static int elektraSetPrepare (KDB * handle, Split * split, Key * parentKey, Key ** errorKey)
 {
+	Plugin * (*hooks)[NR_GLOBAL_SUBPOSITIONS] = handle->globalPlugins;
 	int any_error = 0;
 	for (size_t i = 0; i < split->size; i++)
 	{
@@ -1585,7 +1984,8 @@ static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, P
 					keySetString (parentKey, "");
 				}
 				keySetName (parentKey, keyName (split->parents[i]));
-				ret = backend->setplugins[p]->kdbSet (backend->setplugins[p], split->keysets[i], parentKey);
+				ret = elektraStatsPluginSet (handle, statsSetPosition (p), statsBackendName (backend), backend->setplugins[p],
+							     split->keysets[i], parentKey);
 
 #if VERBOSE && DEBUG
 				printf ("Prepare %s with keys %zd in plugin: %zu, split: %zu, ret: %d\n", keyName (parentKey),
@@ -1612,7 +2012,7 @@ static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, P
 				{
 					/* TODO: Remove use of deprecated internal iterator! */
 					ksRewind (split->keysets[i]);
-					hooks[PRESETSTORAGE][FOREACH]->kdbSet (hooks[PRESETSTORAGE][FOREACH], split->keysets[i], parentKey);
+					elektraStatsPluginSet (handle, PRESETSTORAGE, NULL, hooks[PRESETSTORAGE][FOREACH], split->keysets[i], parentKey);
 				}
 			}
 			else if (p == (STORAGE_PLUGIN - 1))
@@ -1621,7 +2021,7 @@ static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, P
 				{
 					/* TODO: Remove use of deprecated internal iterator! */
 					ksRewind (split->keysets[i]);
-					hooks[PRESETCLEANUP][FOREACH]->kdbSet (hooks[PRESETCLEANUP][FOREACH], split->keysets[i], parentKey);
+					elektraStatsPluginSet (handle, PRESETCLEANUP, NULL, hooks[PRESETCLEANUP][FOREACH], split->keysets[i], parentKey);
 				}
 			}
 
@@ -1652,8 +2052,10 @@ static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, P
  * @param split all information for iteration
  * @param parentKey to add warnings (also passed to plugins for the same reason)
  */
-static void elektraSetCommit (Split * split, Key * parentKey)
+static void elektraSetCommit (KDB * handle, Split * split, Key * parentKey)
 {
+	KeySet ** changeSetOld = elektraChangeSetSplit (handle, split);
+
 	for (size_t p = COMMIT_PLUGIN; p < NR_OF_PLUGINS; ++p)
 	{
 		for (size_t i = 0; i < split->size; i++)
@@ -1676,13 +2078,18 @@ static void elektraSetCommit (Split * split, Key * parentKey)
 				ksRewind (split->keysets[i]);
 				if (p == COMMIT_PLUGIN)
 				{
-					ret = backend->setplugins[p]->kdbCommit (backend->setplugins[p], split->keysets[i], parentKey);
+					ret = elektraStatsPluginCommit (handle, statsSetPosition (p), statsBackendName (backend),
+									backend->setplugins[p], split->keysets[i], parentKey);
 					// name of non-temp file
 					keySetString (split->parents[i], keyString (parentKey));
 				}
 				else
 				{
-					ret = backend->setplugins[p]->kdbSet (backend->setplugins[p], split->keysets[i], parentKey);
+					int published = changeSetOld && changeSetOld[i] && backend->setplugins[p]->changeSet;
+					if (published) elektraChangeSetPublish (handle->global, changeSetOld[i], split->keysets[i]);
+					ret = elektraStatsPluginSet (handle, statsSetPosition (p), statsBackendName (backend),
+								     backend->setplugins[p], split->keysets[i], parentKey);
+					if (published) elektraChangeSetWithdraw (handle->global);
 				}
 			}
 
@@ -1693,6 +2100,8 @@ static void elektraSetCommit (Split * split, Key * parentKey)
 			}
 		}
 	}
+
+	elektraChangeSetSplitDel (changeSetOld, split);
 }
 
 /**
@@ -1702,7 +2111,7 @@ static void elektraSetCommit (Split * split, Key * parentKey)
  * @param split all information for iteration
  * @param parentKey to add warnings (also passed to plugins for the same reason)
  */
-static void elektraSetRollback (Split * split, Key * parentKey)
+static void elektraSetRollback (KDB * handle, Split * split, Key * parentKey)
 {
 	for (size_t p = 0; p < NR_OF_PLUGINS; ++p)
 	{
@@ -1716,7 +2125,8 @@ static void elektraSetRollback (Split * split, Key * parentKey)
 			if (backend->errorplugins[p])
 			{
 				keySetName (parentKey, keyName (split->parents[i]));
-				ret = backend->errorplugins[p]->kdbError (backend->errorplugins[p], split->keysets[i], parentKey);
+				ret = elektraStatsPluginError (handle, statsErrorPosition (p), statsBackendName (backend),
+							       backend->errorplugins[p], split->keysets[i], parentKey);
 			}
 
 			if (ret == -1)
@@ -1729,6 +2139,8 @@ static void elektraSetRollback (Split * split, Key * parentKey)
 }
 
 
+static int elektraSetImpl (KDB * handle, KeySet * ks, Key * parentKey);
+
 /**
  * Set Keys to a Key database in an atomic and universal way.
  *
@@ -1803,6 +2215,15 @@ static void elektraSetRollback (Split * split, Key * parentKey)
  * @see ksCurrent() contains the error Key
  */
 int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
+{
+	unsigned long long start = elektraStatsStart (handle);
+	int ret = elektraSetImpl (handle, ks, parentKey);
+	elektraStatsStop (handle, ELEKTRA_STATS_KDBSET, NULL, NULL, start);
+	elektraStatsStore (handle);
+	return ret;
+}
+
+static int elektraSetImpl (KDB * handle, KeySet * ks, Key * parentKey)
 {
 	if (parentKey == NULL)
 	{
@@ -1930,7 +2351,7 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 	splitPrepare (split);
 
 	clearError (parentKey); // clear previous error to set new one
-	if (elektraSetPrepare (split, parentKey, &errorKey, handle->globalPlugins) == -1)
+	if (elektraSetPrepare (handle, split, parentKey, &errorKey) == -1)
 	{
 		goto error;
 	}
@@ -1945,7 +2366,7 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 	elektraGlobalSet (handle, ks, parentKey, PRECOMMIT, MAXONCE);
 	elektraGlobalSet (handle, ks, parentKey, PRECOMMIT, DEINIT);
 
-	elektraSetCommit (split, parentKey);
+	elektraSetCommit (handle, split, parentKey);
 
 	elektraGlobalSet (handle, ks, parentKey, COMMIT, INIT);
 	elektraGlobalSet (handle, ks, parentKey, COMMIT, MAXONCE);
@@ -1955,6 +2376,8 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 
 	keySetName (parentKey, keyName (initialParent));
 
+	if (handle->changeSetBase) elektraChangeSetPublish (handle->global, handle->changeSetBase, ks);
+
 	elektraGlobalSet (handle, ks, parentKey, POSTCOMMIT, INIT);
 	elektraGlobalSet (handle, ks, parentKey, POSTCOMMIT, MAXONCE);
 	elektraGlobalSet (handle, ks, parentKey, POSTCOMMIT, DEINIT);
@@ -1965,6 +2388,8 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 		clear_bit (ks->array[i]->flags, (keyflag_t) KEY_FLAG_SYNC);
 	}
 
+	elektraChangeSetDone (handle, ks);
+
 	keySetName (parentKey, keyName (initialParent));
 	keyDel (initialParent);
 	splitDel (split);
@@ -1981,7 +2406,7 @@ error:
 	elektraGlobalError (handle, ks, parentKey, PREROLLBACK, MAXONCE);
 	elektraGlobalError (handle, ks, parentKey, PREROLLBACK, DEINIT);
 
-	elektraSetRollback (split, parentKey);
+	elektraSetRollback (handle, split, parentKey);
 
 	if (errorKey)
 	{
@@ -453,6 +453,93 @@ ssize_t keyGetUnescapedName (const Key * key, char * returnedName, size_t maxSiz
 	return key->keyUSize;
 }
 
+/**
+ * @internal
+ *
+ * Checks whether @p name, a relative name without leading slashes, is
+ * already canonical and contains no escape sequences. Such a name can be
+ * appended as is and its unescaped form only differs in the separators.
+ *
+ * @param name the name to check
+ *
+ * @return the length of @p name
+ * @retval 0 if @p name must be canonicalized or unescaped
+ */
+static size_t plainNameLength (const char * name)
+{
+	const char * part = name;
+	for (;;)
+	{
+		// strcspn is vectorized by most C libraries, so plain parts are skipped quickly
+		size_t len = strcspn (part, "/\\");
+		if (part[len] == '\\') return 0;
+
+		// end of part -> check for empty and special parts
+		if (len == 0) return 0;
+		if (part[0] == '.' && (len == 1 || (len == 2 && part[1] == '.'))) return 0;
+		if (part[0] == '%' && len == 1) return 0;
+		// possibly non-canonical array part
+		if (part[0] == '#' && len > 2 && isdigit ((unsigned char) part[1])) return 0;
+
+		if (part[len] == '\0') return part + len - name;
+		part += len + 1;
+	}
+}
+
+/**
+ * @internal
+ *
+ * Sets the name of @p key, if @p name is a valid and canonical name
+ * without escape sequences. Validation, canonicalization and unescaping
+ * then happen in a single pass over @p name.
+ *
+ * @pre @p key is not in a mmap region
+ *
+ * @return the new size of the name of @p key
+ * @retval 0 if @p name was not set, because it must be processed by the general algorithm
+ */
+static ssize_t keySetPlainName (Key * key, const char * name)
+{
+	elektraNamespace ns = KEY_NS_CASCADING;
+	const char * rootSlash = name;
+	if (*name != '/')
+	{
+		const char * colon = strchr (name, ':');
+		if (colon == NULL || colon[1] != '/') return 0;
+		ns = elektraReadNamespace (name, colon - name);
+		if (ns == KEY_NS_NONE) return 0;
+		rootSlash = colon + 1;
+	}
+
+	size_t len = 0;
+	if (rootSlash[1] != '\0')
+	{
+		len = plainNameLength (rootSlash + 1);
+		if (len == 0) return 0;
+	}
+
+	size_t size = rootSlash - name + len + 2;
+	elektraRealloc ((void **) &key->key, size);
+	memcpy (key->key, name, size);
+	key->keySize = size;
+
+	// namespace byte, separator after the root and the parts separated by null bytes
+	size_t usize = len + 3;
+	elektraRealloc ((void **) &key->ukey, usize);
+	key->ukey[0] = ns;
+	key->ukey[1] = '\0';
+	memcpy (key->ukey + 2, rootSlash + 1, len + 1);
+	char * upart = key->ukey + 2;
+	while ((upart = memchr (upart, '/', key->ukey + 2 + len - upart)) != NULL)
+	{
+		*upart++ = '\0';
+	}
+	key->keyUSize = usize;
+
+	set_bit (key->flags, KEY_FLAG_SYNC);
+	return size;
+}
+
 /**
  * Set a new name to a Key.
  *
@@ -500,6 +587,13 @@ ssize_t keySetName (Key * key, const char * newName)
 	if (test_bit (key->flags, KEY_FLAG_RO_NAME)) return -1;
 	if (newName == NULL || strlen (newName) == 0) return -1;
 
+	if (!test_bit (key->flags, KEY_FLAG_MMAP_KEY))
+	{
+		// fast path for names that need neither canonicalization nor unescaping
+		ssize_t size = keySetPlainName (key, newName);
+		if (size > 0) return size;
+	}
+
 	if (!elektraKeyNameValidate (newName, true))
 	{
 		// error invalid name
@@ -529,6 +623,41 @@ ssize_t keySetName (Key * key, const char * newName)
 	return key->keySize;
 }
 
+/**
+ * @internal
+ *
+ * Appends @p name to the name of @p key, without validating,
+ * canonicalizing and unescaping it.
+ *
+ * @pre plainNameLength (@p name) == @p len and @p len > 0
+ * @pre @p key is not in a mmap region
+ */
+static ssize_t keyAddPlainName (Key * key, const char * name, size_t len)
+{
+	// for root keys the trailing slash is re-used, "/%" also has an unescaped size of 3
+	bool isRoot = key->keyUSize == 3 && key->key[key->keySize - 2] == '/';
+	size_t keyOffset = isRoot ? key->keySize - 1 : key->keySize;
+	size_t ukeyOffset = isRoot ? key->keyUSize - 1 : key->keyUSize;
+
+	elektraRealloc ((void **) &key->key, keyOffset + len + 1);
+	elektraRealloc ((void **) &key->ukey, ukeyOffset + len + 1);
+
+	key->key[keyOffset - 1] = '/';
+	memcpy (key->key + keyOffset, name, len + 1);
+	key->keySize = keyOffset + len + 1;
+
+	char * upart = key->ukey + ukeyOffset;
+	memcpy (upart, name, len + 1);
+	while ((upart = memchr (upart, '/', key->ukey + ukeyOffset + len - upart)) != NULL)
+	{
+		*upart++ = '\0';
+	}
+	key->keyUSize = ukeyOffset + len + 1;
+
+	set_bit (key->flags, KEY_FLAG_SYNC);
+	return key->keySize;
+}
+
 /**
  * Add an already escaped name part to the Key's name.
  *
@@ -584,6 +713,13 @@ ssize_t keyAddName (Key * key, const char * newName)
 
 	if (strlen (newName) == 0) return key->keySize;
 
+	if (!test_bit (key->flags, KEY_FLAG_MMAP_KEY))
+	{
+		// fast path for names that need neither canonicalization nor unescaping
+		size_t len = plainNameLength (newName);
+		if (len > 0) return keyAddPlainName (key, newName, len);
+	}
+
 	if (!elektraKeyNameValidate (newName, false))
 	{
 		// error invalid name suffix
@@ -616,6 +752,87 @@ ssize_t keyAddName (Key * key, const char * newName)
 	return key->keySize;
 }
 
+/**
+ * @internal
+ *
+ * Creates a new Key below @p parent, without validating or canonicalizing
+ * its name. Only the @p size bytes of @p name are unescaped.
+ *
+ * This is meant for storage plugins that read back names they wrote
+ * themselves, i.e. the part of keyName() after the name of @p parent and
+ * the separating slash. Invalid input cannot cause out-of-bounds accesses,
+ * but results in a Key with an invalid name.
+ *
+ * @pre @p name MUST be a canonical key name relative to @p parent
+ *
+ * @param parent the Key the new Key is below
+ * @param name the canonical relative name, does not need to be null-terminated
+ * @param size the length of @p name, 0 creates a Key with the name of @p parent
+ *
+ * @return the new Key
+ * @retval NULL if @p parent or @p name is NULL
+ */
+Key * elektraKeyNewTrusted (const Key * parent, const char * name, size_t size)
+{
+	if (!parent || !parent->key || !name) return NULL;
+
+	Key * key = elektraCalloc (sizeof (Key));
+	if (size == 0)
+	{
+		keyCopy (key, parent, KEY_CP_NAME);
+		return key;
+	}
+
+	// for root keys the trailing slash is re-used
+	bool isRoot = parent->keyUSize == 3 && parent->key[parent->keySize - 2] == '/';
+	size_t keyOffset = isRoot ? parent->keySize - 1 : parent->keySize;
+	size_t ukeyOffset = isRoot ? parent->keyUSize - 1 : parent->keyUSize;
+
+	key->keySize = keyOffset + size + 1;
+	key->key = elektraMalloc (key->keySize);
+	memcpy (key->key, parent->key, keyOffset - 1);
+	key->key[keyOffset - 1] = '/';
+	memcpy (key->key + keyOffset, name, size);
+	key->key[key->keySize - 1] = '\0';
+
+	// the unescaped name is never longer than the escaped one
+	key->ukey = elektraMalloc (ukeyOffset + size + 1);
+	memcpy (key->ukey, parent->ukey, ukeyOffset);
+
+	char * outPtr = key->ukey + ukeyOffset;
+	const char * end = name + size;
+	bool partStart = true;
+	for (const char * cur = name; cur < end; ++cur)
+	{
+		if (partStart && *cur == '%' && (cur + 1 == end || *(cur + 1) == '/'))
+		{
+			// empty part
+			partStart = false;
+			continue;
+		}
+		partStart = false;
+
+		switch (*cur)
+		{
+		case '\\':
+			if (cur + 1 < end) *outPtr++ = *++cur;
+			break;
+		case '/':
+			*outPtr++ = '\0';
+			partStart = true;
+			break;
+		default:
+			*outPtr++ = *cur;
+			break;
+		}
+	}
+	*outPtr++ = '\0';
+	key->keyUSize = outPtr - key->ukey;
+
+	set_bit (key->flags, KEY_FLAG_SYNC);
+	return key;
+}
+
 static size_t replacePrefix (char ** buffer, size_t size, size_t oldPrefixSize, const char * newPrefix, size_t newPrefixSize)
 {
 	size_t newSize;
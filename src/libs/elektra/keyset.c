@@ -103,6 +103,29 @@ static void elektraOpmphmCopy (KeySet * dest ELEKTRA_UNUSED, const KeySet * sour
 #endif
 }
 
+/**
+ * @internal
+ *
+ * @brief KeySets search index cleaner.
+ *
+ * Must be invoked by every function that changes a Key name in a KeySet or
+ * replaces its array. Functions that only add or remove Keys keep the
+ * search index in sync instead.
+ *
+ * @param ks the KeySet
+ */
+static void elektraSearchIndexInvalidate (KeySet * ks ELEKTRA_UNUSED)
+{
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+	if (ks->searchIndex)
+	{
+		elektraFree (ks->searchIndex);
+		ks->searchIndex = NULL;
+	}
+	ks->searchIndexLookups = 0;
+#endif
+}
+
 /** @class doxygenFlatCopy
  */
 
@@ -635,6 +658,88 @@ static int keyCompareByName (const void * p1, const void * p2)
 	return k1Shorter ? -1 : 1;
 }
 
+/**
+ * @internal
+ *
+ * @brief Length of the common prefix of two byte arrays
+ *
+ * Equal bytes are skipped a word (8 bytes) at a time, only the word
+ * containing the first difference is compared byte by byte.
+ *
+ * @param a the first array
+ * @param b the second array
+ * @param start the number of leading bytes already known to be equal
+ * @param size the number of bytes to compare at most
+ *
+ * @return the number of leading bytes that are equal in @p a and @p b
+ */
+static inline size_t elektraMemCommonPrefix (const char * a, const char * b, size_t start, size_t size)
+{
+	size_t i = start;
+	for (; i + sizeof (uint64_t) <= size; i += sizeof (uint64_t))
+	{
+		uint64_t wordA, wordB;
+		memcpy (&wordA, a + i, sizeof (uint64_t));
+		memcpy (&wordB, b + i, sizeof (uint64_t));
+		if (wordA != wordB) break;
+	}
+	while (i < size && a[i] == b[i])
+	{
+		++i;
+	}
+	return i;
+}
+
+/**
+ * @brief Compare unescaped names, skipping a prefix known to be equal
+ *
+ * @internal
+ *
+ * Same order as keyCompareByName(), but additionally reports how many
+ * bytes of the unescaped names are equal. A binary search can pass the
+ * common prefix of its bounds as @p skip, so that deep hierarchies with
+ * long shared prefixes are not rescanned in every step.
+ *
+ * @param name1 the first unescaped name
+ * @param size1 the size of @p name1
+ * @param name2 the second unescaped name
+ * @param size2 the size of @p name2
+ * @param skip number of leading bytes of the unescaped names known to be equal
+ * @param[out] common the number of leading bytes of the unescaped names that are equal
+ *
+ * @retval <0 if name1 < name2
+ * @retval 0 if name1 == name2
+ * @retval >0 if name1 > name2
+ */
+static inline int elektraNameCompareSkip (const char * name1, size_t size1, const char * name2, size_t size2, size_t skip, size_t * common)
+{
+	int shorter = size1 < size2;
+	size_t size = shorter ? size1 : size2;
+	size_t prefix = elektraMemCommonPrefix (name1, name2, skip, size);
+	*common = prefix;
+	if (prefix < size)
+	{
+		return (unsigned char) name1[prefix] - (unsigned char) name2[prefix];
+	}
+	if (size1 == size2)
+	{
+		return 0;
+	}
+	return shorter ? -1 : 1;
+}
+
+/**
+ * @brief Compare by unescaped name, skipping a prefix known to be equal
+ *
+ * @internal
+ *
+ * @see elektraNameCompareSkip()
+ */
+static inline int keyCompareByNameSkip (const Key * k1, const Key * k2, size_t skip, size_t * common)
+{
+	return elektraNameCompareSkip (k1->ukey, k1->keyUSize, k2->ukey, k2->keyUSize, skip, common);
+}
+
 /**
  * Compare the name of two Keys.
  *
@@ -729,6 +834,159 @@ ssize_t ksGetSize (const KeySet * ks)
  *           Filling up KeySets            *
  *******************************************/
 
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+
+/**
+ * KeySets with fewer Keys never get a search index.
+ */
+#define ELEKTRA_SEARCH_INDEX_MIN_SIZE 64
+
+/**
+ * A search index is built once a binary search happened for every
+ * ELEKTRA_SEARCH_INDEX_BUILD_RATIO Keys, so that the build is paid for.
+ */
+#define ELEKTRA_SEARCH_INDEX_BUILD_RATIO 16
+
+/**
+ * @internal
+ *
+ * @brief Entry of the search index for a Key.
+ *
+ * Missing bytes after the end of the unescaped name are filled with 0.
+ * Because shorter names sort first, two different entries are in the
+ * same order as the names they were taken from.
+ *
+ * @param key the Key
+ * @param offset number of leading bytes of the unescaped name to skip
+ *
+ * @return the entry, with the 8 bytes of the unescaped name after @p offset as big-endian prefix
+ */
+static inline SearchIndexEntry elektraSearchIndexEntry (const Key * key, size_t offset)
+{
+	size_t size = key->keyUSize > offset ? key->keyUSize - offset : 0;
+	if (size > sizeof (uint64_t)) size = sizeof (uint64_t);
+
+	SearchIndexEntry entry = { .prefix = 0, .name = key->ukey, .size = key->keyUSize };
+	for (size_t i = 0; i < sizeof (uint64_t); ++i)
+	{
+		entry.prefix <<= 8;
+		if (i < size) entry.prefix |= (unsigned char) key->ukey[offset + i];
+	}
+	return entry;
+}
+
+/**
+ * @internal
+ *
+ * @brief Builds the search index of a KeySet
+ *
+ * @param ks the KeySet, must contain at least 2 Keys
+ */
+static void elektraSearchIndexBuild (KeySet * ks)
+{
+	ks->searchIndex = elektraMalloc (sizeof (SearchIndexEntry) * ks->alloc);
+	if (!ks->searchIndex) return;
+
+	// KeySets are sorted, so the first and the last Key share a prefix with all others
+	const Key * first = ks->array[0];
+	const Key * last = ks->array[ks->size - 1];
+	size_t size = first->keyUSize < last->keyUSize ? first->keyUSize : last->keyUSize;
+	ks->searchIndexOffset = elektraMemCommonPrefix (first->ukey, last->ukey, 0, size);
+
+	for (size_t i = 0; i < ks->size; ++i)
+	{
+		ks->searchIndex[i] = elektraSearchIndexEntry (ks->array[i], ks->searchIndexOffset);
+	}
+}
+
+/**
+ * @internal
+ *
+ * @brief Updates the search index after a Key was inserted into the array
+ *
+ * @param ks the KeySet
+ * @param pos the position of the inserted Key
+ */
+static void elektraSearchIndexInsert (KeySet * ks, size_t pos)
+{
+	if (!ks->searchIndex) return;
+
+	if (ks->size < 2)
+	{
+		elektraSearchIndexInvalidate (ks);
+		return;
+	}
+
+	const Key * key = ks->array[pos];
+	const Key * other = ks->array[pos == 0 ? 1 : 0];
+	size_t size = key->keyUSize < other->keyUSize ? key->keyUSize : other->keyUSize;
+	if (elektraMemCommonPrefix (key->ukey, other->ukey, 0, size) < ks->searchIndexOffset)
+	{
+		// the new Key does not share the prefix of all other Keys
+		elektraSearchIndexInvalidate (ks);
+		return;
+	}
+
+	memmove (ks->searchIndex + pos + 1, ks->searchIndex + pos, (ks->size - pos - 1) * sizeof (SearchIndexEntry));
+	ks->searchIndex[pos] = elektraSearchIndexEntry (key, ks->searchIndexOffset);
+}
+
+/**
+ * @internal
+ *
+ * @brief Narrows a binary search down to the Keys with the same search index entry as @p key
+ *
+ * All Keys before @p left are smaller and all Keys after @p right are greater than @p key.
+ *
+ * @param ks the KeySet
+ * @param key the Key to search for, must share the common prefix of all Keys in @p ks
+ * @param[in,out] left first position to consider
+ * @param[in,out] right last position to consider
+ */
+static void elektraSearchIndexNarrow (const KeySet * ks, const Key * key, ssize_t * left, ssize_t * right)
+{
+	uint64_t prefix = elektraSearchIndexEntry (key, ks->searchIndexOffset).prefix;
+	const SearchIndexEntry * index = ks->searchIndex;
+
+	// first position with an entry >= entry
+	ssize_t lower = *left;
+	ssize_t count = *right - *left + 1;
+	while (count > 0)
+	{
+		ssize_t step = count / 2;
+		if (index[lower + step].prefix < prefix)
+		{
+			lower += step + 1;
+			count -= step + 1;
+		}
+		else
+		{
+			count = step;
+		}
+	}
+
+	// first position with an entry > entry
+	ssize_t upper = lower;
+	count = *right - lower + 1;
+	while (count > 0)
+	{
+		ssize_t step = count / 2;
+		if (index[upper + step].prefix <= prefix)
+		{
+			upper += step + 1;
+			count -= step + 1;
+		}
+		else
+		{
+			count = step;
+		}
+	}
+
+	*left = lower;
+	*right = upper - 1;
+}
+
+#endif
 
 /**
  * @internal
@@ -756,58 +1014,88 @@ if (result >= 0)
  */
 static ssize_t ksSearchInternal (const KeySet * ks, const Key * toAppend)
 {
-	ssize_t left = 0;
-	ssize_t right = ks->size;
-	--right;
-	register int cmpresult;
-	ssize_t middle = -1;
-	ssize_t insertpos = 0;
-
 	if (ks->size == 0)
 	{
 		return -1;
 	}
 
-	cmpresult = keyCompareByName (&toAppend, &ks->array[right]);
+	ssize_t left = 0;
+	ssize_t right = ks->size;
+	--right;
+	size_t common;
+
+	/* Length of the prefix toAppend shares with the keys directly
+	 * outside of [left, right]. Every key inside shares at least
+	 * the smaller one, so it does not need to be compared again. */
+	size_t commonLeft = 0;
+	size_t commonRight;
+
+	int cmpresult = keyCompareByNameSkip (toAppend, ks->array[right], 0, &commonRight);
 	if (cmpresult > 0)
 	{
 		return -((ssize_t) ks->size) - 1;
 	}
-	cmpresult = 1;
+	if (cmpresult == 0)
+	{
+		return right;
+	}
+	--right;
+
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+	if (ks->searchIndex && right > 0)
+	{
+		cmpresult = keyCompareByNameSkip (toAppend, ks->array[0], 0, &commonLeft);
+		if (cmpresult < 0)
+		{
+			return -1;
+		}
+		if (cmpresult == 0)
+		{
+			return 0;
+		}
+
+		// toAppend lies between the first and the last Key, so it shares their common prefix
+		left = 1;
+		elektraSearchIndexNarrow (ks, toAppend, &left, &right);
+		commonLeft = ks->searchIndexOffset;
+		commonRight = ks->searchIndexOffset;
+	}
+#endif
 
-	while (1)
+	while (left <= right)
 	{
-		if (right < left)
+		ssize_t middle = left + ((right - left) / 2);
+		size_t skip = commonLeft < commonRight ? commonLeft : commonRight;
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+		if (ks->searchIndex)
 		{
-			/* Nothing was found */
-			break;
+			const SearchIndexEntry * entry = &ks->searchIndex[middle];
+			cmpresult = elektraNameCompareSkip (toAppend->ukey, toAppend->keyUSize, entry->name, entry->size, skip, &common);
+		}
+		else
+#endif
+		{
+			cmpresult = keyCompareByNameSkip (toAppend, ks->array[middle], skip, &common);
 		}
-		middle = left + ((right - left) / 2);
-		cmpresult = keyCompareByName (&toAppend, &ks->array[middle]);
 		if (cmpresult > 0)
 		{
-			insertpos = left = middle + 1;
+			left = middle + 1;
+			commonLeft = common;
 		}
 		else if (cmpresult == 0)
 		{
 			/* We have found it */
-			break;
+			return middle;
 		}
 		else
 		{
-			insertpos = middle;
 			right = middle - 1;
+			commonRight = common;
 		}
 	}
 
-	if (!cmpresult)
-	{
-		return middle;
-	}
-	else
-	{
-		return -insertpos - 1;
-	}
+	/* Nothing was found */
+	return -left - 1;
 }
 
 /**
@@ -921,6 +1209,9 @@ ssize_t ksAppendKey (KeySet * ks, Key * toAppend)
 		/* And use the other one instead */
 		keyIncRef (toAppend);
 		ks->array[result] = toAppend;
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+		if (ks->searchIndex) ks->searchIndex[result] = elektraSearchIndexEntry (toAppend, ks->searchIndexOffset);
+#endif
 		ksSetCursor (ks, result);
 	}
 	else
@@ -971,6 +1262,9 @@ ssize_t ksAppendKey (KeySet * ks, Key * toAppend)
 			ks->array[insertpos] = toAppend;
 			ksSetCursor (ks, insertpos);
 		}
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+		elektraSearchIndexInsert (ks, insertpos);
+#endif
 		elektraOpmphmInvalidate (ks);
 	}
 
@@ -986,6 +1280,10 @@ ssize_t ksAppendKey (KeySet * ks, Key * toAppend)
  * If a Key is both in @p toAppend and @p ks, the Key in @p ks will be
  * overwritten.
  *
+ * As both KeySets are sorted, they are merged in time linear to their
+ * sizes. Appending Keys that are all behind the Keys of @p ks only takes
+ * time linear to the size of @p toAppend.
+ *
  * @copydetails doxygenFlatCopy
  *
  * @post Sorted KeySet ks with all Keys it had before and additionally
@@ -1009,6 +1307,7 @@ ssize_t ksAppend (KeySet * ks, const KeySet * toAppend)
 
 	if (toAppend->size == 0) return ks->size;
 	if (toAppend->array == NULL) return ks->size;
+	if (ks == toAppend) return ks->size;
 
 	if (ks->array == NULL)
 		toAlloc = KEYSET_SIZE;
@@ -1018,12 +1317,73 @@ ssize_t ksAppend (KeySet * ks, const KeySet * toAppend)
 	/* Do only one resize in advance */
 	for (; ks->size + toAppend->size >= toAlloc; toAlloc *= 2)
 		;
-	ksResize (ks, toAlloc - 1);
+	if (ksResize (ks, toAlloc - 1) == -1) return -1;
+
+	/* Both KeySets are sorted, so they are merged from the back in a single pass,
+	 * instead of searching the position of every Key of toAppend. */
+	size_t i = ks->size;
+	size_t j = toAppend->size;
+	size_t out = ks->size + toAppend->size;
+	size_t last = 0;
+	size_t common;
+	while (j > 0)
+	{
+		Key * cur = toAppend->array[j - 1];
+		int cmpresult = i > 0 ? keyCompareByNameSkip (ks->array[i - 1], cur, 0, &common) : -1;
+		if (cmpresult > 0)
+		{
+			ks->array[--out] = ks->array[--i];
+			continue;
+		}
+
+		keyLock (cur, KEY_LOCK_NAME);
+		if (cmpresult == 0)
+		{
+			/* Seems like the key already exist, use the other one instead */
+			Key * old = ks->array[--i];
+			if (old != cur)
+			{
+				keyDecRef (old);
+				keyDel (old);
+				keyIncRef (cur);
+			}
+		}
+		else
+		{
+			keyIncRef (cur);
+		}
 
-	/* TODO: here is lots of room for optimizations */
-	for (size_t i = 0; i < toAppend->size; ++i)
+		ks->array[--out] = cur;
+		if (j == toAppend->size) last = out;
+		--j;
+	}
+
+	/* Keys that existed in both KeySets leave a gap
+	 * between the untouched Keys and the merged ones */
+	size_t gap = out - i;
+	if (gap > 0)
 	{
-		ksAppendKey (ks, toAppend->array[i]);
+		memmove (ks->array + i, ks->array + out, (ks->size + toAppend->size - out) * sizeof (struct _Key *));
+		last -= gap;
+	}
+	ks->size += toAppend->size - gap;
+	ks->array[ks->size] = 0;
+	ksSetCursor (ks, last);
+
+	if (gap == toAppend->size)
+	{
+		// only existing Keys were replaced, their positions did not change
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+		for (size_t it = 0; ks->searchIndex && it < ks->size; ++it)
+		{
+			ks->searchIndex[it] = elektraSearchIndexEntry (ks->array[it], ks->searchIndexOffset);
+		}
+#endif
+	}
+	else
+	{
+		elektraSearchIndexInvalidate (ks);
+		elektraOpmphmInvalidate (ks);
 	}
 	return ks->size;
 }
@@ -1033,6 +1393,7 @@ ssize_t ksAppend (KeySet * ks, const KeySet * toAppend)
  */
 static size_t ksRenameInternal (KeySet * ks, size_t start, size_t end, const Key * root, const Key * newRoot)
 {
+	elektraSearchIndexInvalidate (ks);
 	for (size_t it = start; it < end; ++it)
 	{
 		if (ks->array[it]->refs == 1)
@@ -1176,6 +1537,9 @@ ssize_t ksCopyInternal (KeySet * ks, size_t to, size_t from)
 	if (length != 0)
 	{
 		ret = elektraMemmove (ks->array + to, ks->array + from, length);
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+		if (ks->searchIndex) memmove (ks->searchIndex + to, ks->searchIndex + from, length * sizeof (SearchIndexEntry));
+#endif
 	}
 
 	ks->array[ks->size] = 0;
@@ -2097,14 +2461,18 @@ static Key * elektraLookupBinarySearch (KeySet * ks, Key const * key, elektraLoo
 {
 	elektraCursor cursor = 0;
 	cursor = ksGetCursor (ks);
-	Key ** found;
-	size_t jump = 0;
-	/*If there is a known offset in the beginning jump could be set*/
-	found = (Key **) bsearch (&key, ks->array + jump, ks->size - jump, sizeof (Key *), keyCompareByName);
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+	if (!ks->searchIndex && ks->size >= ELEKTRA_SEARCH_INDEX_MIN_SIZE &&
+	    ++ks->searchIndexLookups * ELEKTRA_SEARCH_INDEX_BUILD_RATIO >= ks->size)
+	{
+		elektraSearchIndexBuild (ks);
+	}
+#endif
+	ssize_t found = ksSearchInternal (ks, key);
 
-	if (found)
+	if (found >= 0)
 	{
-		cursor = found - ks->array;
+		cursor = found;
 		if (options & KDB_O_POP)
 		{
 			return elektraKsPopAtCursor (ks, cursor);
@@ -2112,7 +2480,7 @@ static Key * elektraLookupBinarySearch (KeySet * ks, Key const * key, elektraLoo
 		else
 		{
 			ksSetCursor (ks, cursor);
-			return (*found);
+			return ks->array[found];
 		}
 	}
 	else
@@ -2627,9 +2995,17 @@ int ksResize (KeySet * ks, size_t alloc)
 	{
 		elektraFree (ks->array);
 		ks->array = 0;
+		elektraSearchIndexInvalidate (ks);
 		return -1;
 	}
 
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+	if (ks->searchIndex && elektraRealloc ((void **) &ks->searchIndex, sizeof (SearchIndexEntry) * ks->alloc) == -1)
+	{
+		elektraSearchIndexInvalidate (ks);
+	}
+#endif
+
 	return 1;
 }
 
@@ -2680,6 +3056,9 @@ int ksInit (KeySet * ks)
 	// first lookup should predict so invalidate it
 	elektraOpmphmInvalidate (ks);
 	ks->opmphmPredictor = NULL;
+	ks->searchIndex = NULL;
+	ks->searchIndexOffset = 0;
+	ks->searchIndexLookups = 0;
 #endif
 
 	return 0;
@@ -2726,6 +3105,7 @@ int ksClose (KeySet * ks)
 	ksRewind (ks);
 
 	elektraOpmphmInvalidate (ks);
+	elektraSearchIndexInvalidate (ks);
 
 	return 0;
 }
@@ -18,6 +18,11 @@
 
 #include <string.h>
 
+/**
+ * Minimal number of elements to hash in parallel, smaller sets do not outweigh the thread startup.
+ */
+#define OPMPHM_PARALLEL_MIN_N 4096
+
 static int hasCycle (Opmphm * opmphm, OpmphmGraph * graph, size_t n);
 
 /**
@@ -153,6 +158,9 @@ int opmphmAssignment (Opmphm * opmphm, OpmphmGraph * graph, size_t n, int defaul
  * Inserts each element as edge in the r-uniform r-partite hypergraph and checks if the graph contains a cycle.
  * If there are cycles the `graph` will be cleaned
  *
+ * If Elektra is built with OpenMP (`ENABLE_OPENMP`), the elements of large sets are hashed in parallel chunks.
+ * In this case `OpmphmInit->getName` must be thread-safe.
+ *
  * @param opmphm the OPMPHM
  * @param graph the OpmphmGraph
  * @param init the OpmphmInit
@@ -177,25 +185,28 @@ int opmphmMapping (Opmphm * opmphm, OpmphmGraph * graph, OpmphmInit * init, size
 		elektraRand (&(init->initSeed));
 		opmphm->hashFunctionSeeds[r] = init->initSeed;
 	}
+#ifndef OPMPHM_TEST
+	// set edge.h[], the edges are independent of each other
+#ifdef _OPENMP
+#pragma omp parallel for if (n >= OPMPHM_PARALLEL_MIN_N) schedule (static)
+#endif
 	for (size_t i = 0; i < n; ++i)
 	{
-#ifndef OPMPHM_TEST
 		const char * name = init->getName (init->data[i]);
-#endif
+		size_t nameLength = strlen (name);
 		for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
 		{
-#ifndef OPMPHM_TEST
-			// set edge.h[]
-			graph->edges[i].vertices[r] =
-				opmphmHashfunction (name, strlen (name), opmphm->hashFunctionSeeds[r]) % opmphm->componentSize;
+			graph->edges[i].vertices[r] = opmphmHashfunction (name, nameLength, opmphm->hashFunctionSeeds[r]) % opmphm->componentSize;
+		}
+	}
 #endif
-			// add edge to graph
-			// set edge.nextEdge[r]
+	// add edges to graph
+	for (size_t i = 0; i < n; ++i)
+	{
+		for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
+		{
 			size_t v = r * opmphm->componentSize + graph->edges[i].vertices[r];
-			graph->edges[i].nextEdge[r] = graph->vertices[v].firstEdge;
-			// set vertex.firstEdge
-			graph->vertices[v].firstEdge = i;
-			// increment degree
+			graph->vertices[v].edgeXor ^= i;
 			++graph->vertices[v].degree;
 		}
 	}
@@ -212,45 +223,26 @@ int opmphmMapping (Opmphm * opmphm, OpmphmGraph * graph, OpmphmInit * init, size
 }
 
 /**
- * @brief Recursive function used by hasCycle
+ * @brief Removes an edge from the graph
  *
- * `v` is a degree 1 vertex with edge `e`. The edge `e` will be removed completely from the graph and
- * inserted in the `OpmphmGraph->removeSequence`.
- * For all vertices connected through `e` with degree 1 the function will be called again.
+ * The edge `e` will be removed from all its vertices and appended to the `OpmphmGraph->removeSequence`.
  *
  * @param opmphm the OPMPHM
  * @param graph the OpmphmGraph
- * @param v a vertex with degree 1
+ * @param e the edge
  */
-static void peel_off (Opmphm * opmphm, OpmphmGraph * graph, size_t v)
+static void removeEdge (Opmphm * opmphm, OpmphmGraph * graph, uint32_t e)
 {
-	uint32_t e = graph->vertices[v].firstEdge;
 	// add it to graph->removeSequence
 	graph->removeSequence[graph->removeIndex] = e;
 	++graph->removeIndex;
 	// remove edge e from graph
 	for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
 	{
-		// w is adjacent to v through e
 		size_t w = r * opmphm->componentSize + graph->edges[e].vertices[r];
-		// remove e from w
-		uint32_t * j = &(graph->vertices[w].firstEdge);
-		for (; *j != e; j = &(graph->edges[*j].nextEdge[r]))
-			;
-		*j = graph->edges[*j].nextEdge[r];
-		// decrease degree
+		graph->vertices[w].edgeXor ^= e;
 		--graph->vertices[w].degree;
 	}
-	// all vertices adjacent to v through e
-	for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
-	{
-		size_t w = r * opmphm->componentSize + graph->edges[e].vertices[r];
-		// if degree 1, go on
-		if (graph->vertices[w].degree == 1)
-		{
-			peel_off (opmphm, graph, w);
-		}
-	}
 }
 
 /**
@@ -258,6 +250,9 @@ static void peel_off (Opmphm * opmphm, OpmphmGraph * graph, size_t v)
  *
  * Removes edges that have a degree 1 vertex, until the graph is empty.
  * The sequence of removed edges will be saved in `OpmphmGraph->removeSequence`.
+ * The not yet processed part of the remove sequence serves as queue, every edge taken from it
+ * might leave degree 1 vertices behind, whose remaining edge is removed next.
+ * The remaining edge of a degree 1 vertex is its `OpmphmVertex->edgeXor`, so no edge lists are needed.
  * The passed OpmphmGraph is will be destroyed.
  *
  * @param opmphm the OPMPHM
@@ -270,13 +265,28 @@ static void peel_off (Opmphm * opmphm, OpmphmGraph * graph, size_t v)
 static int hasCycle (Opmphm * opmphm, OpmphmGraph * graph, size_t n)
 {
 	graph->removeIndex = 0;
+	size_t processed = 0;
 	// search all vertices
 	for (size_t v = 0; v < opmphm->componentSize * opmphm->rUniPar; ++v)
 	{
 		// for a vertex with degree 1
-		if (graph->vertices[v].degree == 1)
+		if (graph->vertices[v].degree != 1)
 		{
-			peel_off (opmphm, graph, v);
+			continue;
+		}
+		removeEdge (opmphm, graph, graph->vertices[v].edgeXor);
+		// peel off all vertices that got degree 1 through the removed edges
+		for (; processed < graph->removeIndex; ++processed)
+		{
+			uint32_t e = graph->removeSequence[processed];
+			for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
+			{
+				size_t w = r * opmphm->componentSize + graph->edges[e].vertices[r];
+				if (graph->vertices[w].degree == 1)
+				{
+					removeEdge (opmphm, graph, graph->vertices[w].edgeXor);
+				}
+			}
 		}
 	}
 	if (graph->removeIndex == n)
@@ -461,10 +471,9 @@ OpmphmGraph * opmphmGraphNew (Opmphm * opmphm, uint8_t r, size_t n, double c)
 	/* one malloc for:
 	 * - graph->removeSequence	n
 	 * - graph->edges[i].vertices	n * opmphm->rUniPar
-	 * - graph->edges[i].nextEdge	n * opmphm->rUniPar
 	 */
-	uint32_t * removeSequenceVerticesNextEdge = elektraMalloc ((n + 2 * n * opmphm->rUniPar) * sizeof (uint32_t));
-	if (!removeSequenceVerticesNextEdge)
+	uint32_t * removeSequenceVertices = elektraMalloc ((n + n * opmphm->rUniPar) * sizeof (uint32_t));
+	if (!removeSequenceVertices)
 	{
 		opmphm->componentSize = 0;
 		elektraFree (graph->vertices);
@@ -472,12 +481,11 @@ OpmphmGraph * opmphmGraphNew (Opmphm * opmphm, uint8_t r, size_t n, double c)
 		elektraFree (graph);
 		return NULL;
 	}
-	// split removeSequenceVerticesNextEdge for graph->removeSequence, and for graph->edges[].vertices and graph->edges[].nextEdge
-	graph->removeSequence = &removeSequenceVerticesNextEdge[0];
+	// split removeSequenceVertices for graph->removeSequence and for graph->edges[].vertices
+	graph->removeSequence = &removeSequenceVertices[0];
 	for (size_t i = 0; i < n; ++i)
 	{
-		graph->edges[i].vertices = &removeSequenceVerticesNextEdge[n + i * opmphm->rUniPar];
-		graph->edges[i].nextEdge = &removeSequenceVerticesNextEdge[(n + opmphm->rUniPar * n) + i * opmphm->rUniPar];
+		graph->edges[i].vertices = &removeSequenceVertices[n + i * opmphm->rUniPar];
 	}
 	return graph;
 }
@@ -634,6 +642,26 @@ void opmphmClear (Opmphm * opmphm)
 	}
 }
 
+/**
+ * @brief The hash function of the OPMPHM.
+ *
+ * Calls the hash function selected with `OPMPHM_HASHFUNCTION` at build time.
+ *
+ * @param key the data to hash
+ * @param length the length of key in bytes
+ * @param initval the seed
+ *
+ * @retval uint32_t the hash value
+ */
+uint32_t opmphmHashfunction (const void * key, size_t length, uint32_t initval)
+{
+#ifdef ELEKTRA_OPMPHM_WYHASH
+	return opmphmHashfunctionWyhash (key, length, initval);
+#else
+	return opmphmHashfunctionJenkins (key, length, initval);
+#endif
+}
+
 /**
  * Hash function
  * By Bob Jenkins, May 2006
@@ -646,7 +674,7 @@ void opmphmClear (Opmphm * opmphm)
 ELEKTRA_NO_SANITIZE_UNDEFINED
 ELEKTRA_NO_SANITIZE_INTEGER
 ELEKTRA_NO_SANITIZE_ADDRESS
-uint32_t opmphmHashfunction (const void * key, size_t length, uint32_t initval)
+uint32_t opmphmHashfunctionJenkins (const void * key, size_t length, uint32_t initval)
 {
 	uint32_t a, b, c;
 	a = b = c = 0xdeadbeef + ((uint32_t) length) + initval;
@@ -722,7 +750,7 @@ uint32_t opmphmHashfunction (const void * key, size_t length, uint32_t initval)
 ELEKTRA_NO_SANITIZE_UNDEFINED
 ELEKTRA_NO_SANITIZE_INTEGER
 ELEKTRA_NO_SANITIZE_ADDRESS
-uint32_t opmphmHashfunction (const void * key, size_t length, uint32_t initval)
+uint32_t opmphmHashfunctionJenkins (const void * key, size_t length, uint32_t initval)
 {
 	uint32_t a, b, c;
 	a = b = c = 0xdeadbeef + ((uint32_t) length) + initval;
@@ -790,3 +818,120 @@ uint32_t opmphmHashfunction (const void * key, size_t length, uint32_t initval)
 	return c;
 }
 #endif
+
+/**
+ * Hash function
+ * wyhash by Wang Yi, final version 4, released into the public domain
+ * https://github.com/wangyi-fudan/wyhash
+ *
+ * Reads 8 bytes at once and handles the tail of the key with overlapping reads instead of a byte-wise switch.
+ * The 64 bit result is folded to 32 bit.
+ */
+static const uint64_t opmphmWyhashSecret[4] = { 0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull,
+						0x589965cc75374cc3ull };
+
+static inline void opmphmWyhashMum (uint64_t * a, uint64_t * b)
+{
+#ifdef __SIZEOF_INT128__
+	__uint128_t r = *a;
+	r *= *b;
+	*a = (uint64_t) r;
+	*b = (uint64_t) (r >> 64);
+#else
+	uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t) *a, lb = (uint32_t) *b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32), c = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	*a = lo;
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t opmphmWyhashMix (uint64_t a, uint64_t b)
+{
+	opmphmWyhashMum (&a, &b);
+	return a ^ b;
+}
+
+static inline uint64_t opmphmWyhashRead8 (const uint8_t * p)
+{
+	uint64_t v;
+	memcpy (&v, p, 8);
+#ifdef ELEKTRA_BIG_ENDIAN
+	v = ((v >> 56) & 0xff) | ((v >> 40) & 0xff00) | ((v >> 24) & 0xff0000) | ((v >> 8) & 0xff000000) | ((v & 0xff000000) << 8) |
+	    ((v & 0xff0000) << 24) | ((v & 0xff00) << 40) | ((v & 0xff) << 56);
+#endif
+	return v;
+}
+
+static inline uint64_t opmphmWyhashRead4 (const uint8_t * p)
+{
+	uint32_t v;
+	memcpy (&v, p, 4);
+#ifdef ELEKTRA_BIG_ENDIAN
+	v = ((v >> 24) & 0xff) | ((v >> 8) & 0xff00) | ((v & 0xff00) << 8) | ((v & 0xff) << 24);
+#endif
+	return v;
+}
+
+// sanitize a hash function is silly, so ignore it!
+ELEKTRA_NO_SANITIZE_UNDEFINED
+ELEKTRA_NO_SANITIZE_INTEGER
+uint32_t opmphmHashfunctionWyhash (const void * key, size_t length, uint32_t initval)
+{
+	const uint8_t * p = (const uint8_t *) key;
+	uint64_t seed = initval;
+	seed ^= opmphmWyhashMix (seed ^ opmphmWyhashSecret[0], opmphmWyhashSecret[1]);
+	uint64_t a, b;
+	if (length <= 16)
+	{
+		if (length >= 4)
+		{
+			// two overlapping reads from the front and two from the back cover 4 to 16 bytes
+			a = (opmphmWyhashRead4 (p) << 32) | opmphmWyhashRead4 (p + ((length >> 3) << 2));
+			b = (opmphmWyhashRead4 (p + length - 4) << 32) | opmphmWyhashRead4 (p + length - 4 - ((length >> 3) << 2));
+		}
+		else if (length > 0)
+		{
+			a = (((uint64_t) p[0]) << 16) | (((uint64_t) p[length >> 1]) << 8) | p[length - 1];
+			b = 0;
+		}
+		else
+		{
+			a = b = 0;
+		}
+	}
+	else
+	{
+		size_t i = length;
+		if (i > 48)
+		{
+			// three independent lanes
+			uint64_t see1 = seed, see2 = seed;
+			do
+			{
+				seed = opmphmWyhashMix (opmphmWyhashRead8 (p) ^ opmphmWyhashSecret[1], opmphmWyhashRead8 (p + 8) ^ seed);
+				see1 = opmphmWyhashMix (opmphmWyhashRead8 (p + 16) ^ opmphmWyhashSecret[2], opmphmWyhashRead8 (p + 24) ^ see1);
+				see2 = opmphmWyhashMix (opmphmWyhashRead8 (p + 32) ^ opmphmWyhashSecret[3], opmphmWyhashRead8 (p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+			seed ^= see1 ^ see2;
+		}
+		while (i > 16)
+		{
+			seed = opmphmWyhashMix (opmphmWyhashRead8 (p) ^ opmphmWyhashSecret[1], opmphmWyhashRead8 (p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		// the last 16 bytes, overlapping with the already hashed ones
+		a = opmphmWyhashRead8 (p + i - 16);
+		b = opmphmWyhashRead8 (p + i - 8);
+	}
+	a ^= opmphmWyhashSecret[1];
+	b ^= seed;
+	opmphmWyhashMum (&a, &b);
+	uint64_t hash = opmphmWyhashMix (a ^ opmphmWyhashSecret[0] ^ length, b ^ opmphmWyhashSecret[1]);
+	return (uint32_t) (hash ^ (hash >> 32));
+}
@@ -46,6 +46,9 @@ Key * elektraKsPopAtCursor (KeySet * ks, elektraCursor pos)
 		 * */
 		memmove (found, found + 1, (ks->size - c - 1) * sizeof (Key *));
 		*(ks->array + ks->size - 1) = k; // prepare last element to pop
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+		if (ks->searchIndex) memmove (ks->searchIndex + c, ks->searchIndex + c + 1, (ks->size - c - 1) * sizeof (SearchIndexEntry));
+#endif
 	}
 	else
 	{
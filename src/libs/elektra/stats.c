@@ -0,0 +1,283 @@
+/**
+ * @file
+ *
+ * @brief Durations of plugin calls in kdbGet() and kdbSet()
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <kdbconfig.h>
+#include <kdbprivate.h>
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_CLOCK_GETTIME
+#include <time.h>
+#else
+#include <sys/time.h>
+#endif
+
+static const char * globalBackend = "global";
+
+/**
+ * @internal
+ *
+ * @brief Enables the statistics if the global KeySet contains `system:/elektra/stats`
+ *
+ * The key is usually added with the contract `system:/elektra/contract/globalkeyset/stats`.
+ *
+ * @param handle the handle to enable the statistics for
+ */
+void elektraStatsOpen (KDB * handle)
+{
+	if (ksLookupByName (handle->global, "system:/elektra/stats", 0) == NULL) return;
+
+	handle->stats = elektraCalloc (sizeof (KDBStats));
+	if (handle->stats == NULL) return;
+
+	// the phases are the positions of FOREACH_POSITION in lowercase, followed by kdbget and kdbset
+	KDBStats * stats = handle->stats;
+	for (int phase = 0; phase < NR_GLOBAL_POSITIONS; ++phase)
+	{
+		const char * position = GlobalpluginPositionsStr[phase];
+		size_t i = 0;
+		for (; position[i] != '\0' && i < sizeof (stats->phaseNames[phase]) - 1; ++i)
+		{
+			stats->phaseNames[phase][i] = tolower ((unsigned char) position[i]);
+		}
+		stats->phaseNames[phase][i] = '\0';
+	}
+	strcpy (stats->phaseNames[ELEKTRA_STATS_KDBGET], "kdbget");
+	strcpy (stats->phaseNames[ELEKTRA_STATS_KDBSET], "kdbset");
+}
+
+/**
+ * @internal
+ *
+ * @brief Frees the statistics of a handle
+ */
+void elektraStatsClose (KDB * handle)
+{
+	if (handle->stats == NULL) return;
+	elektraFree (handle->stats->entries);
+	elektraFree (handle->stats);
+	handle->stats = NULL;
+}
+
+/**
+ * @internal
+ *
+ * @brief Starts measuring a duration
+ *
+ * @param handle the handle the duration is measured for, may be NULL
+ *
+ * @return the current time of a monotonic clock in nanoseconds
+ * @retval 0 if no statistics are recorded for @p handle
+ */
+unsigned long long elektraStatsStart (const KDB * handle)
+{
+	if (handle == NULL || handle->stats == NULL) return 0;
+
+#ifdef HAVE_CLOCK_GETTIME
+	struct timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return (unsigned long long) now.tv_sec * 1000000000ULL + now.tv_nsec;
+#else
+	struct timeval now;
+	gettimeofday (&now, NULL);
+	return (unsigned long long) now.tv_sec * 1000000000ULL + now.tv_usec * 1000ULL;
+#endif
+}
+
+static void addEntry (KDBStats * stats, const char * phase, const char * backend, const char * plugin, unsigned long long duration)
+{
+	for (size_t i = 0; i < stats->size; ++i)
+	{
+		KDBStatsEntry * entry = &stats->entries[i];
+		if (entry->phase == phase && entry->backend == backend && entry->plugin == plugin)
+		{
+			++entry->calls;
+			entry->nanoseconds += duration;
+			return;
+		}
+	}
+
+	if (stats->size == stats->alloc)
+	{
+		size_t alloc = stats->alloc == 0 ? 16 : stats->alloc * 2;
+		if (elektraRealloc ((void **) &stats->entries, alloc * sizeof (KDBStatsEntry)) < 0) return;
+		stats->alloc = alloc;
+	}
+
+	stats->entries[stats->size++] = (KDBStatsEntry){
+		.phase = phase, .backend = backend, .plugin = plugin, .calls = 1, .nanoseconds = duration
+	};
+}
+
+/**
+ * @internal
+ *
+ * @brief Adds the duration since elektraStatsStart() to the statistics
+ *
+ * The duration is also added to the totals of the backend and of the phase.
+ *
+ * @param handle the handle the duration was measured for, may be NULL
+ * @param phase a position of FOREACH_POSITION, ELEKTRA_STATS_KDBGET or ELEKTRA_STATS_KDBSET
+ * @param backend the mountpoint of the backend, NULL for global plugins or for whole phases
+ * @param plugin the name of the plugin, NULL for whole phases
+ * @param start the value returned by elektraStatsStart()
+ */
+void elektraStatsStop (KDB * handle, int phase, const char * backend, const char * plugin, unsigned long long start)
+{
+	if (handle == NULL || handle->stats == NULL) return;
+
+	unsigned long long duration = elektraStatsStart (handle) - start;
+	const char * phaseName = handle->stats->phaseNames[phase];
+	if (plugin != NULL)
+	{
+		if (backend == NULL) backend = globalBackend;
+		addEntry (handle->stats, phaseName, backend, plugin, duration);
+		addEntry (handle->stats, phaseName, backend, NULL, duration);
+	}
+	addEntry (handle->stats, phaseName, NULL, NULL, duration);
+}
+
+static void storeValue (KeySet * global, Key * name, const char * basename, unsigned long long value)
+{
+	char buffer[32];
+	snprintf (buffer, sizeof (buffer), "%llu", value);
+
+	keyAddBaseName (name, basename);
+	Key * key = ksLookup (global, name, 0);
+	if (key == NULL)
+	{
+		ksAppendKey (global, keyNew (keyName (name), KEY_VALUE, buffer, KEY_END));
+	}
+	else
+	{
+		keySetString (key, buffer);
+	}
+	keySetBaseName (name, NULL);
+}
+
+/**
+ * @internal
+ *
+ * @brief Writes the statistics to the global KeySet
+ *
+ * For every entry the keys `calls` and `nanoseconds` are written below
+ * `system:/elektra/stats/<phase>`, `system:/elektra/stats/<phase>/<backend>`
+ * or `system:/elektra/stats/<phase>/<backend>/<plugin>`, where backend is the
+ * name of the mountpoint or `global` for global plugins.
+ */
+void elektraStatsStore (KDB * handle)
+{
+	if (handle == NULL || handle->stats == NULL) return;
+
+	Key * name = keyNew ("system:/elektra/stats", KEY_END);
+	for (size_t i = 0; i < handle->stats->size; ++i)
+	{
+		const KDBStatsEntry * entry = &handle->stats->entries[i];
+		keySetName (name, "system:/elektra/stats");
+		keyAddBaseName (name, entry->phase);
+		if (entry->backend != NULL) keyAddBaseName (name, entry->backend);
+		if (entry->plugin != NULL) keyAddBaseName (name, entry->plugin);
+		storeValue (handle->global, name, "calls", entry->calls);
+		storeValue (handle->global, name, "nanoseconds", entry->nanoseconds);
+	}
+	keyDel (name);
+}
+
+/**
+ * @internal
+ *
+ * @brief Calls kdbGet() of a plugin and records its duration
+ *
+ * @param backend the mountpoint of the backend or NULL for global plugins
+ */
+int elektraStatsPluginGet (KDB * handle, int phase, const char * backend, Plugin * plugin, KeySet * ks, Key * parentKey)
+{
+	unsigned long long start = elektraStatsStart (handle);
+	int ret = plugin->kdbGet (plugin, ks, parentKey);
+	elektraStatsStop (handle, phase, backend, plugin->name, start);
+	return ret;
+}
+
+/**
+ * @internal
+ *
+ * @brief Calls kdbSet() of a plugin and records its duration
+ *
+ * @param backend the mountpoint of the backend or NULL for global plugins
+ */
+int elektraStatsPluginSet (KDB * handle, int phase, const char * backend, Plugin * plugin, KeySet * ks, Key * parentKey)
+{
+	unsigned long long start = elektraStatsStart (handle);
+	int ret = plugin->kdbSet (plugin, ks, parentKey);
+	elektraStatsStop (handle, phase, backend, plugin->name, start);
+	return ret;
+}
+
+/**
+ * @internal
+ *
+ * @brief Calls kdbCommit() of a plugin and records its duration
+ *
+ * @param backend the mountpoint of the backend or NULL for global plugins
+ */
+int elektraStatsPluginCommit (KDB * handle, int phase, const char * backend, Plugin * plugin, KeySet * ks, Key * parentKey)
+{
+	unsigned long long start = elektraStatsStart (handle);
+	int ret = plugin->kdbCommit (plugin, ks, parentKey);
+	elektraStatsStop (handle, phase, backend, plugin->name, start);
+	return ret;
+}
+
+/**
+ * @internal
+ *
+ * @brief Calls kdbError() of a plugin and records its duration
+ *
+ * @param backend the mountpoint of the backend or NULL for global plugins
+ */
+int elektraStatsPluginError (KDB * handle, int phase, const char * backend, Plugin * plugin, KeySet * ks, Key * parentKey)
+{
+	unsigned long long start = elektraStatsStart (handle);
+	int ret = plugin->kdbError (plugin, ks, parentKey);
+	elektraStatsStop (handle, phase, backend, plugin->name, start);
+	return ret;
+}
+
+/**
+ * @brief Get the durations of the plugin calls of kdbGet() and kdbSet()
+ *
+ * The statistics are only recorded if kdbOpen() was called with a contract
+ * that contains the key `system:/elektra/contract/globalkeyset/stats`.
+ * The same values are also written to `system:/elektra/stats` in the global
+ * KeySet, which is passed to all plugins, after every kdbGet() and kdbSet().
+ *
+ * There is an entry for every plugin of every backend called in a phase,
+ * an entry with @p plugin NULL for the total of each backend in a phase and an entry
+ * with @p backend NULL for the total of each phase.
+ * The phases are the global plugin positions like `getstorage` or `commit`,
+ * as well as `kdbget` and `kdbset` for the whole kdbGet() and kdbSet() calls.
+ * The backend of global plugins is `global`.
+ *
+ * @param handle contains internal information of @link kdbOpen() opened @endlink key database
+ * @param size will be set to the number of entries
+ *
+ * @return the entries, valid until the next call of kdbGet(), kdbSet() or kdbClose()
+ * @retval NULL if no statistics are recorded for @p handle
+ */
+const KDBStatsEntry * kdbGetStats (const KDB * handle, size_t * size)
+{
+	if (handle == NULL || handle->stats == NULL)
+	{
+		if (size != NULL) *size = 0;
+		return NULL;
+	}
+	if (size != NULL) *size = handle->stats->size;
+	return handle->stats->entries;
+}
@@ -27,6 +27,7 @@ static void defaultFatalErrorHandler (ElektraError * error)
 }
 
 static void insertDefaults (KeySet * config, const Key * parentKey, KeySet * defaults);
+static void saveKeys (Elektra * elektra, KeySet * keys, ElektraError ** error);
 
 static kdb_boolean_t checkSpecProperlyMounted (KDB * const kdb, const char * application, ElektraError ** error);
 static kdb_boolean_t checkSpecificationMountPoint (KeySet * const mountPointsKs, const char * application, const char * mountPoint,
@@ -184,6 +185,7 @@ Elektra * elektraOpen (const char * application, KeySet * defaults, KeySet * con
 	elektra->lookupKey = keyNew ("/", KEY_END);
 	elektra->fatalErrorHandler = &defaultFatalErrorHandler;
 	elektra->defaults = ksDup (defaults);
+	elektra->generation = 1;
 
 	return elektra;
 }
@@ -527,9 +529,77 @@ void elektraClose (Elektra * elektra)
 		ksDel (elektra->defaults);
 	}
 
+	for (size_t i = 0; i < elektra->handlesSize; ++i)
+	{
+		ElektraKeyHandle * handle = elektra->handles[i];
+		if (handle != NULL)
+		{
+			keyDel (handle->lookupKey);
+			elektraFree (handle->name);
+			elektraFree (handle);
+		}
+	}
+	elektraFree (elektra->handles);
+
+	if (elektra->batch != NULL)
+	{
+		ksDel (elektra->batch);
+	}
+
 	elektraFree (elektra);
 }
 
+/**
+ * Starts a batch of modifications.
+ *
+ * Until elektraCommitBatch() is called, the elektraSet*() functions only modify the configuration
+ * of @p elektra and do not store it. Thus, updating many keys needs a single kdbSet() instead of one per key.
+ * Calling this function while a batch is already started has no effect.
+ *
+ * Modifications of a batch that was not committed are discarded by elektraClose().
+ *
+ * @param elektra An Elektra instance.
+ *
+ * @see elektraCommitBatch
+ */
+void elektraBeginBatch (Elektra * elektra)
+{
+	if (elektra->batch == NULL)
+	{
+		elektra->batch = ksNew (0, KS_END);
+	}
+}
+
+/**
+ * Stores all modifications since elektraBeginBatch() with a single kdbSet() and ends the batch.
+ *
+ * Like for the elektraSet*() functions, a conflict is resolved by fetching the configuration again
+ * and reapplying all modifications of the batch.
+ * If no batch was started, this function does nothing.
+ *
+ * @param elektra An Elektra instance.
+ * @param error   Pointer to an ElektraError. Will be set in case saving fails.
+ *
+ * @see elektraBeginBatch
+ */
+void elektraCommitBatch (Elektra * elektra, ElektraError ** error)
+{
+	if (error == NULL)
+	{
+		elektraFatalError (elektra, elektraErrorNullError (__func__));
+		return;
+	}
+
+	KeySet * batch = elektra->batch;
+	if (batch == NULL)
+	{
+		return;
+	}
+
+	elektra->batch = NULL;
+	saveKeys (elektra, batch, error);
+}
+
 /**
  * @}
  */
@@ -553,7 +623,8 @@ KDBType KDB_TYPE_ENUM = "enum";
 
 void elektraSetLookupKey (Elektra * elektra, const char * name)
 {
-	keySetName (elektra->lookupKey, keyName (elektra->parentKey));
+	// the name of the parent key is already valid, copying it avoids parsing it again
+	keyCopy (elektra->lookupKey, elektra->parentKey, KEY_CP_NAME);
 	keyAddName (elektra->lookupKey, name);
 }
 
@@ -565,12 +636,22 @@ void elektraSetArrayLookupKey (Elektra * elektra, const char * name, kdb_long_lo
 	keyAddName (elektra->lookupKey, arrayPart);
 }
 
-void elektraSaveKey (Elektra * elektra, Key * key, ElektraError ** error)
+/**
+ * Appends the keys to the configuration and stores it with kdbSet().
+ * On a conflict the configuration is fetched again and the keys are reapplied.
+ *
+ * @param keys The keys to save, will be deleted.
+ */
+static void saveKeys (Elektra * elektra, KeySet * keys, ElektraError ** error)
 {
 	int ret = 0;
+
+	// the keys in config may be replaced, so all key handles have to be resolved again
+	++elektra->generation;
+
 	do
 	{
-		ksAppendKey (elektra->config, key);
+		ksAppend (elektra->config, keys);
 
 		ret = kdbSet (elektra->kdb, elektra->config, elektra->parentKey);
 		if (ret == -1)
@@ -579,6 +660,7 @@ void elektraSaveKey (Elektra * elektra, Key * key, ElektraError ** error)
 			if (strcmp (elektraErrorCode (kdbSetError), ELEKTRA_ERROR_CONFLICTING_STATE) != 0)
 			{
 				*error = kdbSetError;
+				ksDel (keys);
 				return;
 			}
 
@@ -592,10 +674,29 @@ void elektraSaveKey (Elektra * elektra, Key * key, ElektraError ** error)
 				ELEKTRA_LOG_DEBUG ("problemKey: %s\n", keyName (problemKey));
 			}
 
-			key = keyDup (key, KEY_CP_ALL);
+			KeySet * dup = ksDeepDup (keys);
+			ksDel (keys);
+			keys = dup;
 			kdbGet (elektra->kdb, elektra->config, elektra->parentKey);
 		}
 	} while (ret == -1);
+
+	ksDel (keys);
+}
+
+void elektraSaveKey (Elektra * elektra, Key * key, ElektraError ** error)
+{
+	if (elektra->batch != NULL)
+	{
+		// the keys in config may be replaced, so all key handles have to be resolved again
+		++elektra->generation;
+
+		ksAppendKey (elektra->config, key);
+		ksAppendKey (elektra->batch, key);
+		return;
+	}
+
+	saveKeys (elektra, ksNew (1, key, KS_END), error);
 }
 
 void insertDefaults (KeySet * config, const Key * parentKey, KeySet * defaults)
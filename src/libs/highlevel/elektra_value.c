@@ -65,6 +65,138 @@ Key * elektraFindKey (Elektra * elektra, const char * name, KDBType type)
 	return resultKey;
 }
 
+static ElektraKeyHandle * resolveKeyHandle (ElektraKeyHandle * handle)
+{
+	Elektra * elektra = handle->elektra;
+	Key * const resultKey = ksLookup (elektra->config, handle->lookupKey, 0);
+	if (resultKey == NULL)
+	{
+		handle->key = NULL;
+		elektraFatalError (elektra, elektraErrorKeyNotFound (keyName (handle->lookupKey)));
+		return handle;
+	}
+
+	if (handle->type != NULL)
+	{
+		const char * actualType = keyString (keyGetMeta (resultKey, "type"));
+		if (strcmp (actualType, handle->type) != 0)
+		{
+			handle->key = NULL;
+			elektraFatalError (elektra, elektraErrorWrongType (keyName (handle->lookupKey), handle->type, actualType));
+			return handle;
+		}
+	}
+
+	// only successful resolutions are cached, failed ones report their error again on the next call
+	handle->key = resultKey;
+	handle->generation = elektra->generation;
+	handle->valueType = NULL;
+	return handle;
+}
+
+/**
+ * Helper function for code generation.
+ *
+ * Returns a handle for the key with the relative name @p name. The handle is created
+ * on the first call with a given @p id. The name of the key is canonicalized only once
+ * and the key is looked up and type checked (if @p type is not NULL) only once
+ * after elektraOpen() and after each modification of the KeySet inside @p elektra.
+ * Subsequent calls with the same @p id just return the already resolved handle.
+ *
+ * The elektraGet*ByHandle() functions also cache the converted value in the handle,
+ * so the value is only parsed again after the KeySet inside @p elektra was modified
+ * by elektraSet*(). Changes made directly to Keys returned by elektraFindKey() are not
+ * detected.
+ *
+ * The caller chooses @p id. Each id must always be used with the same @p name and @p type
+ * for a given @p elektra, ids should be small and dense, because they index a table.
+ *
+ * @param elektra The Elektra instance to use.
+ * @param id      The id of the handle.
+ * @param name    The relative name of the key.
+ * @param type    The expected type metadata value.
+ * @return the handle for @p id or NULL, if memory allocation failed
+ *   The returned pointer remains valid until elektraClose() is called on @p elektra.
+ */
+ElektraKeyHandle * elektraKeyHandle (Elektra * elektra, size_t id, const char * name, KDBType type)
+{
+	if (id < elektra->handlesSize && elektra->handles[id] != NULL)
+	{
+		ElektraKeyHandle * handle = elektra->handles[id];
+		return handle->generation == elektra->generation ? handle : resolveKeyHandle (handle);
+	}
+
+	if (id >= elektra->handlesSize)
+	{
+		size_t newSize = elektra->handlesSize == 0 ? 16 : elektra->handlesSize;
+		while (newSize <= id)
+		{
+			newSize *= 2;
+		}
+
+		if (elektraRealloc ((void **) &elektra->handles, newSize * sizeof (ElektraKeyHandle *)) < 0)
+		{
+			return NULL;
+		}
+		memset (elektra->handles + elektra->handlesSize, 0, (newSize - elektra->handlesSize) * sizeof (ElektraKeyHandle *));
+		elektra->handlesSize = newSize;
+	}
+
+	ElektraKeyHandle * handle = elektraCalloc (sizeof (struct _ElektraKeyHandle));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	elektraSetLookupKey (elektra, name);
+	handle->elektra = elektra;
+	handle->name = elektraStrDup (name);
+	handle->lookupKey = keyDup (elektra->lookupKey, KEY_CP_NAME);
+	handle->type = type;
+	elektra->handles[id] = handle;
+
+	return resolveKeyHandle (handle);
+}
+
+/**
+ * Helper function for code generation.
+ *
+ * Finds the Key referenced by a handle. See elektraFindKey().
+ *
+ * @param handle A handle returned by elektraKeyHandle().
+ * @return the Key referenced by @p handle or NULL, if a fatal error occurred while resolving @p handle
+ *   The returned pointer remains valid until the KeySet inside the Elektra instance of @p handle is modified.
+ */
+Key * elektraFindKeyByHandle (ElektraKeyHandle * handle)
+{
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle->generation == handle->elektra->generation ? handle->key : resolveKeyHandle (handle)->key;
+}
+
+/**
+ * Helper function for code generation.
+ *
+ * Reports a fatal error, because the value of the key referenced by @p handle
+ * could not be converted to @p type.
+ *
+ * @param handle A handle returned by elektraKeyHandle().
+ * @param type   The type the value should have been converted to.
+ */
+void elektraKeyHandleFatalConversionError (ElektraKeyHandle * handle, KDBType type)
+{
+	if (handle == NULL)
+	{
+		return;
+	}
+
+	const Key * key = handle->generation == handle->elektra->generation ? handle->key : NULL;
+	elektraFatalError (handle->elektra, elektraErrorConversionFromString (type, handle->name, keyString (key)));
+}
+
 /**
  * Resolves the reference stored in a key.
  * 1. Get the raw string value.
@@ -364,6 +496,200 @@ kdb_long_double_t elektraGetLongDouble (Elektra * elektra, const char * keyname)
 
 #endif // ELEKTRA_HAVE_KDB_LONG_DOUBLE
 
+#define ELEKTRA_GET_VALUE_BY_HANDLE(KEY_TO_VALUE, KDB_TYPE, FIELD, handle, result)                                                         \
+	if (handle != NULL && handle->valueType == KDB_TYPE && handle->generation == handle->elektra->generation)                          \
+	{                                                                                                                                  \
+		result = handle->value.FIELD;                                                                                              \
+	}                                                                                                                                  \
+	else                                                                                                                               \
+	{                                                                                                                                  \
+		const Key * key = elektraFindKeyByHandle (handle);                                                                         \
+		if (key == NULL || !KEY_TO_VALUE (key, &result))                                                                           \
+		{                                                                                                                          \
+			elektraKeyHandleFatalConversionError (handle, KDB_TYPE);                                                           \
+			result = 0;                                                                                                        \
+		}                                                                                                                          \
+		else                                                                                                                       \
+		{                                                                                                                          \
+			handle->value.FIELD = result;                                                                                      \
+			handle->valueType = KDB_TYPE;                                                                                      \
+		}                                                                                                                          \
+	}
+
+/**
+ * Gets a string value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_STRING.
+ * @return the string stored at the key of @p handle
+ *   The returned pointer remains valid until the internal state of the Elektra instance of @p handle is modified.
+ */
+const char * elektraGetStringByHandle (ElektraKeyHandle * handle)
+{
+	const char * result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToString, KDB_TYPE_STRING, stringValue, handle, result);
+	return result;
+}
+
+/**
+ * Gets a boolean value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_BOOLEAN.
+ * @return the boolean stored at the key of @p handle
+ */
+kdb_boolean_t elektraGetBooleanByHandle (ElektraKeyHandle * handle)
+{
+	kdb_boolean_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToBoolean, KDB_TYPE_BOOLEAN, booleanValue, handle, result);
+	return result;
+}
+
+/**
+ * Gets a char value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_CHAR.
+ * @return the char stored at the key of @p handle
+ */
+kdb_char_t elektraGetCharByHandle (ElektraKeyHandle * handle)
+{
+	kdb_char_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToChar, KDB_TYPE_CHAR, charValue, handle, result);
+	return result;
+}
+
+/**
+ * Gets an octet value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_OCTET.
+ * @return the octet stored at the key of @p handle
+ */
+kdb_octet_t elektraGetOctetByHandle (ElektraKeyHandle * handle)
+{
+	kdb_octet_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToOctet, KDB_TYPE_OCTET, octetValue, handle, result);
+	return result;
+}
+
+/**
+ * Gets a short value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_SHORT.
+ * @return the short stored at the key of @p handle
+ */
+kdb_short_t elektraGetShortByHandle (ElektraKeyHandle * handle)
+{
+	kdb_short_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToShort, KDB_TYPE_SHORT, shortValue, handle, result);
+	return result;
+}
+
+/**
+ * Gets an unsigned short value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_UNSIGNED_SHORT.
+ * @return the unsigned short stored at the key of @p handle
+ */
+kdb_unsigned_short_t elektraGetUnsignedShortByHandle (ElektraKeyHandle * handle)
+{
+	kdb_unsigned_short_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToUnsignedShort, KDB_TYPE_UNSIGNED_SHORT, unsignedShortValue, handle, result);
+	return result;
+}
+
+/**
+ * Gets a long value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_LONG.
+ * @return the long stored at the key of @p handle
+ */
+kdb_long_t elektraGetLongByHandle (ElektraKeyHandle * handle)
+{
+	kdb_long_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToLong, KDB_TYPE_LONG, longValue, handle, result);
+	return result;
+}
+
+/**
+ * Gets an unsigned long value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_UNSIGNED_LONG.
+ * @return the unsigned long stored at the key of @p handle
+ */
+kdb_unsigned_long_t elektraGetUnsignedLongByHandle (ElektraKeyHandle * handle)
+{
+	kdb_unsigned_long_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToUnsignedLong, KDB_TYPE_UNSIGNED_LONG, unsignedLongValue, handle, result);
+	return result;
+}
+
+/**
+ * Gets a long long value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_LONG_LONG.
+ * @return the long long stored at the key of @p handle
+ */
+kdb_long_long_t elektraGetLongLongByHandle (ElektraKeyHandle * handle)
+{
+	kdb_long_long_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToLongLong, KDB_TYPE_LONG_LONG, longLongValue, handle, result);
+	return result;
+}
+
+/**
+ * Gets an unsigned long long value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_UNSIGNED_LONG_LONG.
+ * @return the unsigned long long stored at the key of @p handle
+ */
+kdb_unsigned_long_long_t elektraGetUnsignedLongLongByHandle (ElektraKeyHandle * handle)
+{
+	kdb_unsigned_long_long_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToUnsignedLongLong, KDB_TYPE_UNSIGNED_LONG_LONG, unsignedLongLongValue, handle, result);
+	return result;
+}
+
+/**
+ * Gets a float value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_FLOAT.
+ * @return the float stored at the key of @p handle
+ */
+kdb_float_t elektraGetFloatByHandle (ElektraKeyHandle * handle)
+{
+	kdb_float_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToFloat, KDB_TYPE_FLOAT, floatValue, handle, result);
+	return result;
+}
+
+/**
+ * Gets a double value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_DOUBLE.
+ * @return the double stored at the key of @p handle
+ */
+kdb_double_t elektraGetDoubleByHandle (ElektraKeyHandle * handle)
+{
+	kdb_double_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToDouble, KDB_TYPE_DOUBLE, doubleValue, handle, result);
+	return result;
+}
+
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
+/**
+ * Gets a long double value via a key handle.
+ *
+ * @param handle A handle returned by elektraKeyHandle() with type KDB_TYPE_LONG_DOUBLE.
+ * @return the long double stored at the key of @p handle
+ */
+kdb_long_double_t elektraGetLongDoubleByHandle (ElektraKeyHandle * handle)
+{
+	kdb_long_double_t result;
+	ELEKTRA_GET_VALUE_BY_HANDLE (elektraKeyToLongDouble, KDB_TYPE_LONG_DOUBLE, longDoubleValue, handle, result);
+	return result;
+}
+
+#endif // ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
 #define ELEKTRA_SET_VALUE(VALUE_TO_STRING, KDB_TYPE, elektra, keyname, value, error)                                                       \
 	CHECK_ERROR (elektra, error);                                                                                                      \
 	char * string = VALUE_TO_STRING (value);                                                                                           \
@@ -84,17 +84,55 @@ static int setStatisticalValue (Key * informationKey, char * metaName, int value
 }
 
 /**
- * @brief Increase a statistical value in an information key by one
+ * @brief Counters for the statistics of a merge
+ *
+ * The merge counts in here and adds the counters to the information key once at the end,
+ * instead of updating the metadata of the information key for every conflict.
+ */
+typedef struct
+{
+	int nonOverlapOnlyBaseCounter;
+	int nonOverlapAllExistCounter;
+	int nonOverlapBaseEmptyCounter;
+	int overlap3different;
+	int overlap1empty;
+} MergeStatistics;
+
+/**
+ * @brief Add a counter to a statistical value in an information key
  * @param informationKey contains the statistics in its meta information
  * @param metaName which statistic to increase
- * @retval new value
+ * @param count the amount to add
+ * @retval 0 on success
+ * @retval -1 on error
  */
-static int increaseStatisticalValue (Key * informationKey, char * metaName)
+static int addStatisticalValue (Key * informationKey, char * metaName, int count)
 {
-	int value = getStatisticalValue (informationKey, metaName);
-	value++;
-	setStatisticalValue (informationKey, metaName, value);
-	return value;
+	if (count == 0)
+	{
+		return 0;
+	}
+	return setStatisticalValue (informationKey, metaName, getStatisticalValue (informationKey, metaName) + count);
+}
+
+/**
+ * @brief Add the counters of a merge to the statistics in an information key
+ * @param informationKey contains the statistics in its meta information
+ * @param statistics the counters of the merge
+ * @retval 0 on success
+ * @retval -1 on error
+ */
+static int addStatistics (Key * informationKey, const MergeStatistics * statistics)
+{
+	if (addStatisticalValue (informationKey, "nonOverlapOnlyBaseCounter", statistics->nonOverlapOnlyBaseCounter) < 0 ||
+	    addStatisticalValue (informationKey, "nonOverlapAllExistCounter", statistics->nonOverlapAllExistCounter) < 0 ||
+	    addStatisticalValue (informationKey, "nonOverlapBaseEmptyCounter", statistics->nonOverlapBaseEmptyCounter) < 0 ||
+	    addStatisticalValue (informationKey, "overlap3different", statistics->overlap3different) < 0 ||
+	    addStatisticalValue (informationKey, "overlap1empty", statistics->overlap1empty) < 0)
+	{
+		return -1;
+	}
+	return 0;
 }
 
 /**
@@ -193,152 +231,125 @@ int getConflicts (Key * informationKey)
 }
 
 /**
- * @brief Removes one string from the other
- * @param sub this will be removed from string
- * @param string sub is removed from this char *
- * @returns the resulting string
+ * @brief A key below the root of its key set together with its name relative to that root
+ *
+ * The relative name is a slice of the unescaped name of the key, so relative names compare like the names in a KeySet.
+ * The root itself has an empty relative name.
+ */
+typedef struct
+{
+	Key * key;
+	const char * name;
+	size_t size;
+} RelativeKey;
+
+/**
+ * @brief Compares the relative names of two keys like keyCmp compares names
  */
-static char * strremove (char * string, const char * sub)
+static int relativeKeyCmp (const RelativeKey * a, const RelativeKey * b)
 {
-	size_t length = strlen (sub);
-	if (length > 0)
+	size_t size = a->size < b->size ? a->size : b->size;
+	int cmp = memcmp (a->name, b->name, size);
+	if (cmp != 0)
 	{
-		char * p = string;
-		while ((p = strstr (p, sub)) != NULL)
-		{
-			memmove (p, p + length, strlen (p + length) + 1);
-		}
+		return cmp;
 	}
-	return string;
+	if (a->size == b->size)
+	{
+		return 0;
+	}
+	return a->size < b->size ? -1 : 1;
+}
+
+static int relativeKeyQsortCmp (const void * a, const void * b)
+{
+	return relativeKeyCmp ((const RelativeKey *) a, (const RelativeKey *) b);
 }
 
 /**
- *  @brief This is the counterpart to the removeRoot function
+ * @brief Collect the keys of a set together with their names relative to root, sorted by these names
  *
- *  Also turns the name for the /root key into the original one again
+ * Below a cascading root keys of different namespaces could share a relative name,
+ * which is not supported.
  *
- *  @param result all keys with extended name will be appended here
- *  @param input keys are from here
- *  @param string will be prepended to all the key names
- *  @param informationKey errors will be set here
- *  @retval -1 on error
- *  @retval  0 on success
+ * @param set the key set whose keys will be collected
+ * @param root all keys of set must be below or same as this key
+ * @param informationKey will contain information if an error occurs
+ * @returns an array with one entry per key of set, which must be freed with elektraFree
+ * @retval NULL on error
  */
-static int prependStringToAllKeyNames (KeySet * result, KeySet * input, const char * string, Key * informationKey)
+static RelativeKey * collectRelativeKeys (KeySet * set, Key * root, Key * informationKey)
 {
-	if (input == NULL)
-	{
-		ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Parameter input must not be null.");
-		return -1;
-	}
-	if (result == NULL)
-	{
-		ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Parameter result must not be null.");
-		return -1;
-	}
-	if (string == NULL)
+	const ssize_t size = ksGetSize (set);
+	const size_t rootSize = keyGetUnescapedNameSize (root);
+	// the relative names of keys below a root key like user:/ start after the namespace
+	const size_t offset = rootSize == 3 ? 2 : rootSize;
+
+	RelativeKey * keys = elektraMalloc ((size + 1) * sizeof (RelativeKey));
+	if (keys == NULL)
 	{
-		ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Parameter string must not be null.");
-		return -1;
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (informationKey);
+		return NULL;
 	}
 
-	for (elektraCursor it = 0; it < ksGetSize (input); ++it)
+	for (elektraCursor it = 0; it < size; ++it)
 	{
-		const Key * key = ksAtCursor (input, it);
-		bool isRoot = strcmp (keyName (key), "/root") == 0;
-		size_t size = strlen (string);
-		if (isRoot)
-		{
-			size += 1;
-		}
-		else
-		{
-			size += keyGetNameSize (key);
-		}
-		char * newName = elektraMalloc (size);
-		strcpy (newName, string);
-		if (!isRoot)
-		{
-			strcat (newName, keyName (key));
-		}
-		Key * duplicateKey = keyDup (key, KEY_CP_ALL); // keySetName returns -1 if key was inserted to a keyset before
-		int status = keySetName (duplicateKey, newName);
-		elektraFree (newName);
-		if (status < 0)
+		Key * key = ksAtCursor (set, it);
+		if (keyIsBelowOrSame (root, key) != 1)
 		{
-			ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not set key name.");
+			elektraFree (keys);
+			ELEKTRA_SET_INTERNAL_ERROR (
+				informationKey,
+				"Setting new key name was not possible. The current key is not below or equal to the root key.");
+			return NULL;
 		}
-		status = ksAppendKey (result, duplicateKey);
-		if (status < 0)
+
+		const size_t keySize = keyGetUnescapedNameSize (key);
+		keys[it].key = key;
+		keys[it].name = (const char *) keyUnescapedName (key) + offset;
+		keys[it].size = keySize == rootSize ? 0 : keySize - offset;
+	}
+
+	// below a cascading root the set is ordered by namespace first
+	qsort (keys, size, sizeof (RelativeKey), relativeKeyQsortCmp);
+
+	for (elektraCursor it = 1; it < size; ++it)
+	{
+		if (relativeKeyCmp (&keys[it - 1], &keys[it]) == 0)
 		{
-			ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
+			ELEKTRA_SET_INTERNAL_ERRORF (informationKey,
+						     "The key %s has the same name relative to the cascading root %s as the key %s.",
+						     keyName (keys[it].key), keyName (root), keyName (keys[it - 1].key));
+			elektraFree (keys);
+			return NULL;
 		}
 	}
-	return 0;
+	return keys;
 }
 
 /**
- * @brief Remove the root from each key of a set
- * @param original the key set from which root will be rmeoved
- * @param root remove this from all the keys
- * @param informationKey will contain information if an error occurs
- * @returns a new key set without the root
- *
- * Example: If root is user:/example and the KeySet contains a key with the name user:/example/something then
- * the returned KeySet will contain the key /something.
+ * @brief Duplicates a key and moves it from below root to below newRoot
+ * @param key the key to duplicate, must be below or same as root
+ * @param root the root of key
+ * @param newRoot the root of the duplicated key
+ * @returns the duplicated key
  */
-static KeySet * removeRoot (KeySet * original, Key * root, Key * informationKey)
+static Key * rebaseKey (const Key * key, const Key * root, const Key * newRoot)
 {
-	KeySet * result = ksNew (0, KS_END);
-	const char * rootKeyNameString = keyName (root);
+	Key * rebased = keyDup (key, KEY_CP_ALL);
+	if (keyReplacePrefix (rebased, root, newRoot) == 1)
+	{
+		return rebased;
+	}
 
-	for (elektraCursor it = 0; it < ksGetSize (original); ++it)
+	// root is cascading and key is not, skip the namespace of key and the name of root
+	const char * relative = strchr (keyName (key), '/') + strlen (strchr (keyName (root), '/'));
+	keyCopy (rebased, newRoot, KEY_CP_NAME);
+	if (*relative != '\0')
 	{
-		const Key * currentKey = ksAtCursor (original, it);
-		char * currentKeyNameString = elektraMalloc (keyGetNameSize (currentKey));
-		if (keyGetName (currentKey, currentKeyNameString, keyGetNameSize (currentKey)) < 0)
-		{
-			ELEKTRA_ASSERT (false, "ERROR: This should not happen");
-			elektraFree (currentKeyNameString);
-			ksDel (result);
-			return NULL;
-		};
-		if (keyIsBelow (root, currentKey) || keyCmp (currentKey, root) == 0)
-		{
-			Key * duplicateKey = keyDup (currentKey, KEY_CP_ALL);
-			int retVal;
-			if (keyIsBelow (root, currentKey))
-			{
-				currentKeyNameString = strremove (currentKeyNameString, rootKeyNameString);
-				retVal = keySetName (duplicateKey, currentKeyNameString);
-			}
-			else
-			{
-				// If the root itself is in the keyset then create a special name for it as it would be empty otherwise
-				retVal = keySetName (duplicateKey, "/root");
-			}
-			if (retVal < 0)
-			{
-				elektraFree (currentKeyNameString);
-				ksDel (result);
-				keyDel (duplicateKey);
-				ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Setting new key name was not possible.");
-				return NULL;
-			}
-			ksAppendKey (result, duplicateKey);
-			elektraFree (currentKeyNameString);
-		}
-		else
-		{
-			elektraFree (currentKeyNameString);
-			ksDel (result);
-			ELEKTRA_SET_INTERNAL_ERROR (
-				informationKey,
-				"Setting new key name was not possible. The current key is not below or equal to the root key.");
-			return NULL;
-		}
+		keyAddName (rebased, relative);
 	}
-	return result;
+	return rebased;
 }
 
 /**
@@ -365,52 +376,29 @@ static bool keysAreEqual (Key * a, Key * b)
 }
 
 /**
- * @brief Helper function for checkSingleSet for when the key (name is relevant) is only in two of the three key sets
- * @retval -1 on error
- * @retval 0 on success
+ * @brief Helper function for checkSingleKey for when the key (name is relevant) is only in two of the three key sets
  */
-static int twoOfThreeExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyInSecond, KeySet * result, bool checkedIsDominant,
-				  int baseIndicator, Key * informationKey)
+static void twoOfThreeExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyInSecond, Key ** merged, bool checkedIsDominant,
+				   int baseIndicator, MergeStatistics * statistics)
 {
-	Key * existingKey;
-	bool thisConflict = false;
-	/** This if or the else if happen when our and their set have a key that
+	/** This happens when our and their set have a key that
 	 *  base does not have. This is a conflict case.
 	 *  This place is hit twice, thus overlap1empty gets double the amount of errors.
 	 */
-	if (keyInFirst != NULL)
-	{
-		existingKey = keyInFirst;
-	}
-	else if (keyInSecond != NULL)
-	{
-		existingKey = keyInSecond;
-	}
-	else
-	{
-		ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
-		return -1;
-	}
-	if (thisConflict)
-	{
-		increaseStatisticalValue (informationKey, "nonOverlapBaseEmptyCounter");
-	}
+	Key * existingKey = keyInFirst != NULL ? keyInFirst : keyInSecond;
 	if (!keysAreEqual (checkedKey, existingKey))
 	{
 		// overlap  with single empty
 		// This spot is hit twice for a single overlap conflict. Thus calculate half later on.
-		increaseStatisticalValue (informationKey, "overlap1empty");
+		statistics->overlap1empty++;
 		if (checkedIsDominant)
 		{
-			if (ksAppendKey (result, checkedKey) < 0)
-			{
-				ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
-				return -1;
-			}
+			*merged = checkedKey;
 		}
 	}
 	else
 	{
+		bool thisConflict = false;
 		// uses the NULL properties of keysAreEqual
 		if (keysAreEqual (checkedKey, keyInFirst) && baseIndicator == 2)
 		{
@@ -424,18 +412,13 @@ static int twoOfThreeExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyI
 		{
 			// base is empty and other and their have the same (non-empty) value
 			// this is a conflict
-			increaseStatisticalValue (informationKey, "nonOverlapBaseEmptyCounter");
+			statistics->nonOverlapBaseEmptyCounter++;
 			if (checkedIsDominant)
 			{
-				if (ksAppendKey (result, checkedKey) < 0)
-				{
-					ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
-					return -1;
-				}
+				*merged = checkedKey;
 			}
 		}
 	}
-	return 0;
 }
 
 /**
@@ -443,8 +426,8 @@ static int twoOfThreeExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyI
  * @retval true if exactly two of the three keys have the same value
  * @retval false otherwise
  */
-static bool twoOfThoseKeysAreEqual (Key * checkedKey, Key * keyInFirst, Key * keyInSecond, KeySet * result, bool checkedIsDominant,
-				    int baseIndicator, Key * informationKey)
+static bool twoOfThoseKeysAreEqual (Key * checkedKey, Key * keyInFirst, Key * keyInSecond, Key ** merged, bool checkedIsDominant,
+				    int baseIndicator, MergeStatistics * statistics)
 {
 	/**
 	 * One example for the next 3 ifs
@@ -469,14 +452,11 @@ static bool twoOfThoseKeysAreEqual (Key * checkedKey, Key * keyInFirst, Key * ke
 			/** This is a non-overlap conflict
 			 *  Base is currently checked and has value A, their and our have a different value B
 			 */
-			increaseStatisticalValue (informationKey, "nonOverlapAllExistCounter");
+			statistics->nonOverlapAllExistCounter++;
 			if (checkedIsDominant)
 			{
-				// If base is also dominant then append it's key
-				if (ksAppendKey (result, checkedKey) < 0)
-				{
-					ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
-				}
+				// If base is also dominant then use its key
+				*merged = checkedKey;
 			}
 		}
 		return true;
@@ -485,59 +465,40 @@ static bool twoOfThoseKeysAreEqual (Key * checkedKey, Key * keyInFirst, Key * ke
 	{
 		if (baseIndicator == 0)
 		{
-			if (ksAppendKey (result, keyInSecond) < 0)
-			{
-				ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
-			}
+			*merged = keyInSecond;
 		}
-		else
+		else if (baseIndicator == 2)
 		{
-			if (baseIndicator == 2)
+			/** This is a non-overlap conflict
+			 *  Base is currently secondCompare and has value A, their and our have a different
+			 *  value B
+			 */
+			statistics->nonOverlapAllExistCounter++;
+			if (checkedIsDominant)
 			{
-				/** This is a non-overlap conflict
-				 *  Base is currently secondCompare and has value A, their and our have a different
-				 *  value B
-				 */
-				increaseStatisticalValue (informationKey, "nonOverlapAllExistCounter");
-				if (checkedIsDominant)
-				{
-					// If base is also dominant then append it's key
-					if (ksAppendKey (result, checkedKey) < 0)
-					{
-						ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
-					}
-				}
+				// If base is also dominant then use its key
+				*merged = checkedKey;
 			}
 		}
 		return true;
 	}
 	else if (keysAreEqual (checkedKey, keyInSecond))
 	{
-
 		if (baseIndicator == 0)
 		{
-			if (ksAppendKey (result, keyInFirst) < 0)
-			{
-				ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
-			}
+			*merged = keyInFirst;
 		}
-		else
+		else if (baseIndicator == 1)
 		{
-			if (baseIndicator == 1)
+			/** This is a non-overlap conflict
+			 *  Base is currently firstCompare and has value A, their and our have a different
+			 *  value B
+			 */
+			statistics->nonOverlapAllExistCounter++;
+			if (checkedIsDominant)
 			{
-				/** This is a non-overlap conflict
-				 *  Base is currently firstCompare and has value A, their and our have a different
-				 *  value B
-				 */
-				increaseStatisticalValue (informationKey, "nonOverlapAllExistCounter");
-				if (checkedIsDominant)
-				{
-					// If base is also dominant then append it's key
-					if (ksAppendKey (result, checkedKey) < 0)
-					{
-						ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
-					}
-				}
+				// If base is also dominant then use its key
+				*merged = checkedKey;
 			}
 		}
 		return true;
@@ -549,107 +510,156 @@ static bool twoOfThoseKeysAreEqual (Key * checkedKey, Key * keyInFirst, Key * ke
 }
 
 /**
- * @brief Helper function for checkSingleSet for when a key exists in all key sets.
- * @retval -1 on error
- * @retval 0 on success
+ * @brief Helper function for checkSingleKey for when a key exists in all key sets.
  */
-static int allExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyInSecond, KeySet * result, bool checkedIsDominant,
-			   int baseIndicator, Key * informationKey)
+static void allExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyInSecond, Key ** merged, bool checkedIsDominant,
+			    int baseIndicator, MergeStatistics * statistics)
 {
 	if (keysAreEqual (checkedKey, keyInFirst) && keysAreEqual (checkedKey, keyInSecond))
 	{
 		/**
-		 * append any of the three keys
-		 * will be appended multiple times, but that doesn't matter for the result
+		 * use any of the three keys
+		 * will be set multiple times, but that doesn't matter for the result
 		 */
-		if (ksAppendKey (result, checkedKey) < 0)
-		{
-			ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
-			return -1;
-		}
+		*merged = checkedKey;
 	}
 	else
 	{
-		if (!twoOfThoseKeysAreEqual (checkedKey, keyInFirst, keyInSecond, result, checkedIsDominant, baseIndicator, informationKey))
+		if (!twoOfThoseKeysAreEqual (checkedKey, keyInFirst, keyInSecond, merged, checkedIsDominant, baseIndicator, statistics))
 		{
 			/**
 			 * Overlap conflict case
 			 *
 			 * The same overlap conflict gets detected three times, once for each of the three invocations of
-			 * checkSingleSet. However, only one of those three times is required. Thus use a getter function
+			 * checkSingleKey. However, only one of those three times is required. Thus use a getter function
 			 * that calculates a third.
 			 */
-			increaseStatisticalValue (informationKey, "overlap3different");
+			statistics->overlap3different++;
 			if (checkedIsDominant)
 			{
-				if (ksAppendKey (result, checkedKey) < 0)
-				{
-					ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
-					return -1;
-				}
+				*merged = checkedKey;
 			}
 		}
 	}
-	return 0;
 }
 
-
 /**
- * and the element is not already in the result key set.
- * It should be called 3 times, each time with a different of our key set, their key set and base key set as checkedSet parameter.
- * Which of the remaining two key sets is firstCompared or secondCompared is irrelevant.
+ * Decides which of the keys with the same relative name ends up in the merge result.
  *
- * @param checkedIsDominant parameter is for the merge strategy. If a conflict occurs and checkedIsDominant is true then the current element
- * of checkedSet is inserted. Consequently, it has to be set to true for exactly one of the three calls of this function.
+ * It should be called up to 3 times for a name, once for each of the keys of our key set, their key set and base key set
+ * with this name as checkedKey parameter, first for base, then for their and then for our.
+ * Which of the remaining two keys is keyInFirst or keyInSecond is irrelevant.
  *
- * @param baseIndicator indicates which of the three key sets is the base key set. 0 is checkedSet, 1 firstcompared, 2 secondCompared
- * @param informationKey will contain information if an error ocurred
+ * @param merged the key for the merge result, is updated if the merge result changes
  *
- * @retval -1 on error
- * @retval 0 on success
+ * @param checkedIsDominant parameter is for the merge strategy. If a conflict occurs and checkedIsDominant is true then checkedKey
+ * is used. Consequently, it has to be set to true for exactly one of the three key sets.
  *
+ * @param baseIndicator indicates which of the three keys is the base key. 0 is checkedKey, 1 keyInFirst, 2 keyInSecond
+ * @param statistics counts the conflicts
  */
-static int checkSingleSet (KeySet * checkedSet, KeySet * firstCompared, KeySet * secondCompared, KeySet * result, bool checkedIsDominant,
-			   int baseIndicator, Key * informationKey)
+static void checkSingleKey (Key * checkedKey, Key * keyInFirst, Key * keyInSecond, Key ** merged, bool checkedIsDominant,
+			    int baseIndicator, MergeStatistics * statistics)
 {
-	for (elektraCursor it = 0; it < ksGetSize (checkedSet); ++it)
+	if (keyInFirst != NULL && keyInSecond != NULL)
 	{
-		Key * checkedKey = ksAtCursor (checkedSet, it);
-		/**
-		 * Check if a key with the same name exists
-		 * Nothing about values is said yet
-		 */
-		Key * keyInFirst = ksLookup (firstCompared, checkedKey, 0);
-		Key * keyInSecond = ksLookup (secondCompared, checkedKey, 0);
-		if (keyInFirst != NULL && keyInSecond != NULL)
+		allExistHelper (checkedKey, keyInFirst, keyInSecond, merged, checkedIsDominant, baseIndicator, statistics);
+	}
+	else if (keyInFirst == NULL && keyInSecond == NULL)
+	{
+		if (baseIndicator == 0)
 		{
-			allExistHelper (checkedKey, keyInFirst, keyInSecond, result, checkedIsDominant, baseIndicator, informationKey);
+			/**
+			 * Non-overlap conflict https://www.gnu.org/software/diffutils/manual/html_node/diff3-Merging.html
+			 *
+			 * Here keys from base could be used. But doing so is not useful.
+			 */
+			statistics->nonOverlapOnlyBaseCounter++;
 		}
-		else if (keyInFirst == NULL && keyInSecond == NULL)
+		else
 		{
-			if (baseIndicator == 0)
-			{
-				/**
-				 * Non-overlap conflict https://www.gnu.org/software/diffutils/manual/html_node/diff3-Merging.html
-				 *
-				 * Here keys from base could be appended. But doing so is not useful.
-				 */
-				increaseStatisticalValue (informationKey, "nonOverlapOnlyBaseCounter");
-			}
-			else
-			{
-				if (ksAppendKey (result, checkedKey) < 0)
-				{
-					ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
-				}
-			}
+			*merged = checkedKey;
 		}
-		else
+	}
+	else
+	{
+		twoOfThreeExistHelper (checkedKey, keyInFirst, keyInSecond, merged, checkedIsDominant, baseIndicator, statistics);
+	}
+}
+
+/**
+ * @brief Takes the next key of a set if it has the relative name of current
+ * @retval the key of the set with this relative name
+ * @retval NULL if the set has no such key
+ */
+static Key * nextRelativeKey (RelativeKey * keys, ssize_t size, ssize_t * position, const RelativeKey * current)
+{
+	if (*position < size && relativeKeyCmp (&keys[*position], current) == 0)
+	{
+		return keys[(*position)++].key;
+	}
+	return NULL;
+}
+
+/**
+ * @brief Merges three key sets in a single pass over their keys
+ *
+ * The keys of every set are sorted by their names relative to the root of their set.
+ * Thus, walking all sets in parallel visits the keys with the same relative name together.
+ *
+ * @param result the merged keys are appended here below resultRoot
+ * @retval -1 on error
+ * @retval 0 on success
+ */
+static int mergeKeySets (KeySet * our, Key * ourRoot, KeySet * their, Key * theirRoot, KeySet * base, Key * baseRoot, KeySet * result,
+			 Key * resultRoot, bool ourDominant, bool theirDominant, MergeStatistics * statistics, Key * informationKey)
+{
+	RelativeKey * ourKeys = collectRelativeKeys (our, ourRoot, informationKey);
+	RelativeKey * theirKeys = collectRelativeKeys (their, theirRoot, informationKey);
+	RelativeKey * baseKeys = collectRelativeKeys (base, baseRoot, informationKey);
+	if (ourKeys == NULL || theirKeys == NULL || baseKeys == NULL)
+	{
+		elektraFree (ourKeys);
+		elektraFree (theirKeys);
+		elektraFree (baseKeys);
+		return -1;
+	}
+
+	const ssize_t ourSize = ksGetSize (our);
+	const ssize_t theirSize = ksGetSize (their);
+	const ssize_t baseSize = ksGetSize (base);
+	ssize_t o = 0, t = 0, b = 0;
+	while (o < ourSize || t < theirSize || b < baseSize)
+	{
+		const RelativeKey * current = NULL;
+		if (o < ourSize) current = &ourKeys[o];
+		if (t < theirSize && (current == NULL || relativeKeyCmp (&theirKeys[t], current) < 0)) current = &theirKeys[t];
+		if (b < baseSize && (current == NULL || relativeKeyCmp (&baseKeys[b], current) < 0)) current = &baseKeys[b];
+
+		RelativeKey name = *current;
+		Key * ourKey = nextRelativeKey (ourKeys, ourSize, &o, &name);
+		Key * theirKey = nextRelativeKey (theirKeys, theirSize, &t, &name);
+		Key * baseKey = nextRelativeKey (baseKeys, baseSize, &b, &name);
+
+		// same order as checking all keys of base, then all keys of their and then all keys of our
+		Key * merged = NULL;
+		if (baseKey != NULL) checkSingleKey (baseKey, ourKey, theirKey, &merged, false, 0, statistics); // base is never dominant
+		if (theirKey != NULL) checkSingleKey (theirKey, baseKey, ourKey, &merged, theirDominant, 1, statistics);
+		if (ourKey != NULL) checkSingleKey (ourKey, theirKey, baseKey, &merged, ourDominant, 2, statistics);
+
+		if (merged != NULL)
 		{
-			twoOfThreeExistHelper (checkedKey, keyInFirst, keyInSecond, result, checkedIsDominant, baseIndicator,
-					       informationKey);
+			Key * root = merged == ourKey ? ourRoot : merged == theirKey ? theirRoot : baseRoot;
+			if (ksAppendKey (result, rebaseKey (merged, root, resultRoot)) < 0)
+			{
+				ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not append key.");
+			}
 		}
 	}
+
+	elektraFree (ourKeys);
+	elektraFree (theirKeys);
+	elektraFree (baseKeys);
 	return 0;
 }
 
@@ -825,13 +835,18 @@ static int numberOfConflictMarkers (const char * text)
 /**
  * Removes all the arrays from our, their, base and result and puts the result of the merge into resultSet
  * @param ourSet our
+ * @param ourRoot root of our
  * @param theirSet their
+ * @param theirRoot root of their
  * @param baseSet base
+ * @param baseRoot root of base
  * @param resultSet result
+ * @param resultRoot root of result
  * @retval 0 on success
  * @retval -1 on error
  */
-static int handleArrays (KeySet * ourSet, KeySet * theirSet, KeySet * baseSet, KeySet * resultSet, Key * informationKey, int strategy)
+static int handleArrays (KeySet * ourSet, Key * ourRoot, KeySet * theirSet, Key * theirRoot, KeySet * baseSet, Key * baseRoot,
+			 KeySet * resultSet, Key * resultRoot, Key * informationKey, int strategy)
 {
 	ELEKTRA_LOG ("cmerge now handles arrays");
 	KeySet * toAppend = NULL;
@@ -842,8 +857,12 @@ static int handleArrays (KeySet * ourSet, KeySet * theirSet, KeySet * baseSet, K
 
 		if (elektraArrayValidateName (checkedKey) >= 0)
 		{
-			Key * keyInOur = ksLookup (ourSet, checkedKey, 0);
-			Key * keyInTheir = ksLookup (theirSet, checkedKey, 0);
+			Key * lookup = rebaseKey (checkedKey, baseRoot, ourRoot);
+			Key * keyInOur = ksLookup (ourSet, lookup, 0);
+			keyDel (lookup);
+			lookup = rebaseKey (checkedKey, baseRoot, theirRoot);
+			Key * keyInTheir = ksLookup (theirSet, lookup, 0);
+			keyDel (lookup);
 			/* getValuesAsArray() calls ksLookup() with  KDP_O_POP which makes as ksRewind()*/
 			char * baseArray = getValuesAsArray (baseSet, checkedKey, informationKey);
 
@@ -931,7 +950,13 @@ static int handleArrays (KeySet * ourSet, KeySet * theirSet, KeySet * baseSet, K
 	}
 	if (toAppend != NULL)
 	{
-		ksAppend (resultSet, toAppend);
+		for (elektraCursor it = 0; it < ksGetSize (toAppend); ++it)
+		{
+			Key * arrayKey = keyDup (ksAtCursor (toAppend, it), KEY_CP_ALL);
+			keyCopy (arrayKey, resultRoot, KEY_CP_NAME);
+			keyAddName (arrayKey, keyName (ksAtCursor (toAppend, it)));
+			ksAppendKey (resultSet, arrayKey);
+		}
 		ksDel (toAppend);
 	}
 	return 0;
@@ -962,24 +987,7 @@ KeySet * elektraMerge (KeySet * our, Key * ourRoot, KeySet * their, Key * theirR
 {
 	ELEKTRA_LOG ("cmerge starts with strategy %d (see kdbmerge.h)", strategy);
 
-	KeySet * ourCropped = removeRoot (our, ourRoot, informationKey);
-	if (ourCropped == NULL)
-	{
-		return NULL;
-	}
-	KeySet * theirCropped = removeRoot (their, theirRoot, informationKey);
-	if (theirCropped == NULL)
-	{
-		ksDel (ourCropped);
-		return NULL;
-	}
-	KeySet * baseCropped = removeRoot (base, baseRoot, informationKey);
-	if (baseCropped == NULL)
-	{
-		ksDel (ourCropped);
-		ksDel (theirCropped);
-		return NULL;
-	}
+	MergeStatistics statistics = { 0 };
 	KeySet * result = ksNew (0, KS_END);
 	bool ourDominant = false;
 	bool theirDominant = false;
@@ -994,28 +1002,33 @@ KeySet * elektraMerge (KeySet * our, Key * ourRoot, KeySet * their, Key * theirR
 	}
 
 #ifdef LIBGITFOUND
+	// handleArrays removes the arrays it merged, so it must not modify the key sets of the caller
+	our = ksDeepDup (our);
+	their = ksDeepDup (their);
+	base = ksDeepDup (base);
 	git_libgit2_init ();
 	ELEKTRA_LOG ("cmerge can use libgit2 to handle arrays");
-	if (handleArrays (ourCropped, theirCropped, baseCropped, result, informationKey, strategy) > 0)
+	int status = handleArrays (our, ourRoot, their, theirRoot, base, baseRoot, result, resultRoot, informationKey, strategy);
+	if (status == 0)
 	{
-		ksDel (result);
-		return NULL;
+		status = mergeKeySets (our, ourRoot, their, theirRoot, base, baseRoot, result, resultRoot, ourDominant, theirDominant,
+				       &statistics, informationKey);
 	}
+	ksDel (our);
+	ksDel (their);
+	ksDel (base);
 #else
 	ELEKTRA_LOG ("cmerge can NOT use libgit2 to handle arrays");
+	int status = mergeKeySets (our, ourRoot, their, theirRoot, base, baseRoot, result, resultRoot, ourDominant, theirDominant,
+				   &statistics, informationKey);
 #endif
-
-	checkSingleSet (baseCropped, ourCropped, theirCropped, result, false, 0, informationKey); // base is never dominant
-	checkSingleSet (theirCropped, baseCropped, ourCropped, result, theirDominant, 1, informationKey);
-	checkSingleSet (ourCropped, theirCropped, baseCropped, result, ourDominant, 2, informationKey);
-	ksRewind (ourCropped);
-
-	if (ksDel (ourCropped) != 0 || ksDel (theirCropped) != 0 || ksDel (baseCropped) != 0)
+	if (status < 0)
 	{
 		ksDel (result);
-		ELEKTRA_SET_INTERNAL_ERROR (informationKey, "Could not delete a key set.");
 		return NULL;
 	}
+
+	addStatistics (informationKey, &statistics);
 	if (getConflicts (informationKey) > 0)
 	{
 		if (strategy == MERGE_STRATEGY_ABORT)
@@ -1026,9 +1039,5 @@ KeySet * elektraMerge (KeySet * our, Key * ourRoot, KeySet * their, Key * theirR
 			return NULL;
 		}
 	}
-
-	KeySet * resultWithRoot = ksNew (0, KS_END);
-	prependStringToAllKeyNames (resultWithRoot, result, keyName (resultRoot), informationKey);
-	ksDel (result);
-	return resultWithRoot;
+	return result;
 }
@@ -168,3 +168,66 @@ KeySet * elektraPluginGetGlobalKeySet (Plugin * plugin)
 {
 	return plugin->global;
 }
+
+/**
+ * @brief Request the changeset of kdbSet() for this plugin.
+ *
+ * Afterwards the KDB computes the added, changed and removed keys once
+ * per kdbSet() for all plugins, which retrieve them with
+ * elektraPluginGetChangeSet() in the postcommit position.
+ * Plugins of a backend get the changeset of their backend,
+ * global plugins the changeset of the whole kdbSet().
+ * Call it in kdbGet() of the plugin, the changeset is relative to the
+ * keys returned by the last kdbGet() or stored by the last kdbSet().
+ *
+ * @param plugin a pointer to the plugin
+ * @retval 1 if the changeset will be published
+ * @retval 0 if the plugin has no global keyset, e.g. because
+ *         it was not opened by the KDB
+ * @ingroup plugin
+ */
+int elektraPluginRequestChangeSet (Plugin * plugin)
+{
+	if (!plugin->global) return 0;
+	plugin->changeSet = 1;
+	if (!ksLookupByName (plugin->global, KDB_CHANGESET_PREFIX, 0))
+	{
+		ksAppendKey (plugin->global, keyNew (KDB_CHANGESET_PREFIX, KEY_END));
+	}
+	return 1;
+}
+
+static KeySet * getChangeSetPart (KeySet * global, const char * name)
+{
+	const Key * key = ksLookupByName (global, name, 0);
+	if (!key || keyGetValueSize (key) != sizeof (KeySet *)) return NULL;
+	return *(KeySet * const *) keyValue (key);
+}
+
+/**
+ * @brief Get the changeset of the current kdbSet().
+ *
+ * The KeySets belong to the KDB and are only valid during the
+ * postcommit position, they must not be modified or deleted.
+ *
+ * @see elektraPluginRequestChangeSet
+ * @param plugin a pointer to the plugin
+ * @param added will be set to the keys not returned by the last kdbGet()
+ * @param changed will be set to the keys that were modified since the last kdbGet()
+ * @param removed will be set to the keys returned by the last kdbGet() that are gone
+ * @retval 1 if the changeset was published
+ * @retval 0 if there is no changeset, the parameters are unchanged
+ * @ingroup plugin
+ */
+int elektraPluginGetChangeSet (Plugin * plugin, KeySet ** added, KeySet ** changed, KeySet ** removed)
+{
+	if (!plugin->global) return 0;
+	KeySet * a = getChangeSetPart (plugin->global, KDB_CHANGESET_PREFIX "/added");
+	KeySet * c = getChangeSetPart (plugin->global, KDB_CHANGESET_PREFIX "/changed");
+	KeySet * r = getChangeSetPart (plugin->global, KDB_CHANGESET_PREFIX "/removed");
+	if (!a || !c || !r) return 0;
+	*added = a;
+	*changed = c;
+	*removed = r;
+	return 1;
+}
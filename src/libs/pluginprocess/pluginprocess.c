@@ -45,10 +45,31 @@
  *     and copies it back to originalKeySet set
  * 13) Parent returns the result value from the child process
  *
+ * If memfd_create is available and the mmapstorage plugin is installed, the payload
+ * pipes are replaced by shared memory: Two memory files, one for each direction,
+ * are created before forking. In 4) and 10) the keyset is written with mmapstorage
+ * into the memory file instead of the payload pipe, before the commandKeySet is
+ * sent in 3) and 9), and in 6) and 12) the receiver maps it and copies the keys out. This avoids serializing and parsing the
+ * payload with dump as well as pushing it through the pipe buffers. As the
+ * commands alternate, the receiver is always done with a memory file before it
+ * is written again.
+ *
+ * Plugins initialized with elektraPluginProcessInitShared share their child
+ * process with all other instances of the same plugin with the same configuration
+ * in the current process, e.g. from different KDB handles. The commands of these
+ * instances are sent over the same pipes one after another in the order of
+ * tickets. The tickets of open and close are taken together with the update of
+ * the number of users, so the counter of the child process only reaches 0 with
+ * the close of the last instance.
+ *
  * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
  */
 
-#include "kdbpluginprocess.h"
+#ifdef HAVE_MEMFD_CREATE
+#define _GNU_SOURCE // memfd_create ()
+#endif
+
+#include "kdbpluginprocessprivate.h"
 #include <kdberrors.h>
 #include <kdbinvoke.h>
 #include <kdblogger.h>
@@ -56,9 +77,12 @@
 
 #include <errno.h>
 #include <limits.h>
+#include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -70,6 +94,10 @@ struct _ElektraPluginProcess
 	int childCommandPipe[2];
 	int childPayloadPipe[2];
 
+	// memory files replacing the payload pipes, 0 if the pipes are used
+	int parentPayloadMemory;
+	int childPayloadMemory;
+
 	Key * parentCommandPipeKey;
 	Key * parentPayloadPipeKey;
 	Key * childCommandPipeKey;
@@ -78,12 +106,34 @@ struct _ElektraPluginProcess
 	int pid;
 	int counter;
 	ElektraInvokeHandle * dump;
+	ElektraInvokeHandle * mmapstorage;
+	// plugin used for the payload, either dump or mmapstorage
+	ElektraInvokeHandle * payload;
 	void * pluginData;
+
+	// set if the process is shared via elektraPluginProcessInitShared
+	char * sharedName;
+	KeySet * sharedConfig;
+	ElektraPluginProcess * sharedNext;
+	// opens not yet matched by a close and opens sent by elektraPluginProcessInitShared
+	// that were not yet claimed by elektraPluginProcessOpen, both protected by sharedProcessesLock
+	int sharedUsers;
+	int sharedPending;
+	// the commands of the plugin instances sharing the process are sent in the order of their tickets
+	pthread_mutex_t sharedLock;
+	pthread_cond_t sharedTurn;
+	unsigned long sharedNextTicket;
+	unsigned long sharedServing;
 };
 
+// the processes shared via elektraPluginProcessInitShared
+static ElektraPluginProcess * sharedProcesses = NULL;
+static pthread_mutex_t sharedProcessesLock = PTHREAD_MUTEX_INITIALIZER;
+
 static void cleanupPluginData (ElektraPluginProcess * pp, Key * errorKey, int cleanAllPipes)
 {
 	if (pp->dump) elektraInvokeClose (pp->dump, errorKey);
+	if (pp->mmapstorage) elektraInvokeClose (pp->mmapstorage, errorKey);
 
 	if (pp->parentCommandPipeKey) keyDel (pp->parentCommandPipeKey);
 	if (pp->parentPayloadPipeKey) keyDel (pp->parentPayloadPipeKey);
@@ -99,6 +149,16 @@ static void cleanupPluginData (ElektraPluginProcess * pp, Key * errorKey, int cl
 		if (pp->childCommandPipe[pipeIdx]) close (pp->childCommandPipe[pipeIdx]);
 		if (pp->childPayloadPipe[pipeIdx]) close (pp->childPayloadPipe[pipeIdx]);
 	}
+	if (pp->parentPayloadMemory) close (pp->parentPayloadMemory);
+	if (pp->childPayloadMemory) close (pp->childPayloadMemory);
+
+	if (pp->sharedName)
+	{
+		elektraFree (pp->sharedName);
+		ksDel (pp->sharedConfig);
+		pthread_mutex_destroy (&pp->sharedLock);
+		pthread_cond_destroy (&pp->sharedTurn);
+	}
 
 	elektraFree (pp);
 }
@@ -152,7 +212,7 @@ void elektraPluginProcessStart (Plugin * handle, ElektraPluginProcess * pp)
 		if (*endPtr == '\0' && errno != ERANGE && payloadSize >= 0)
 		{
 			keySet = ksNew (payloadSize, KS_END);
-			elektraInvoke2Args (pp->dump, "get", keySet, pp->parentPayloadPipeKey);
+			elektraInvoke2Args (pp->payload, "get", keySet, pp->parentPayloadPipeKey);
 			ELEKTRA_LOG_DEBUG ("Child: We received a KeySet with %zd keys in it", ksGetSize (keySet));
 		}
 		errno = prevErrno;
@@ -211,13 +271,17 @@ void elektraPluginProcessStart (Plugin * handle, ElektraPluginProcess * pp)
 		keyDel (parentKey);
 
 		ELEKTRA_LOG_DEBUG ("Child: Writing the results back to the parent");
-		elektraInvoke2Args (pp->dump, "set", commandKeySet, pp->childCommandPipeKey);
 		if (keySet != NULL)
 		{
 			char * resultPayloadSize = longToStr (ksGetSize (keySet));
 			keySetString (payloadSizeKey, resultPayloadSize);
 			elektraFree (resultPayloadSize);
-			elektraInvoke2Args (pp->dump, "set", keySet, pp->childPayloadPipeKey);
+			if (pp->payload != pp->dump) elektraInvoke2Args (pp->payload, "set", keySet, pp->childPayloadPipeKey);
+		}
+		elektraInvoke2Args (pp->dump, "set", commandKeySet, pp->childCommandPipeKey);
+		if (keySet != NULL)
+		{
+			if (pp->payload == pp->dump) elektraInvoke2Args (pp->payload, "set", keySet, pp->childPayloadPipeKey);
 			ksDel (keySet);
 		}
 		ksDel (commandKeySet);
@@ -231,35 +295,7 @@ void elektraPluginProcessStart (Plugin * handle, ElektraPluginProcess * pp)
 	_Exit (EXIT_SUCCESS);
 }
 
-/** Call a plugin's function in a child process
- *
- * This will wrap all the required information to execute the given
- * command in a keyset and send it over to the child process. Then
- * it waits for the child process's answer and copies the result
- * back into the original plugin keyset and plugin key.
- *
- * Typically called like
- * @code
-int elektraPluginSet (Plugin * handle, KeySet * returned, Key * parentKey)
-{
-	ElektraPluginProcess * pp = elektraPluginGetData (handle);
-	if (elektraPluginProcessIsParent (pp)) return elektraPluginProcessSend (pp, ELEKTRA_PLUGINPROCESS_SET, returned, parentKey);
-
-	// actual plugin functionality to be executed in a child process
-	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
-}
- * @endcode
- *
- * @param pp the data structure containing the plugin's process information
- * @param command the plugin command that should be executed, e.g. ELEKTRA_PLUGINPROCESS_GET
- * @param originalKeySet the original key set that the parent process receives
- * @param key the original key the parent process receives
- * @retval ELEKTRA_PLUGIN_STATUS_ERROR if the child process communication failed
- * @retval the called plugin's return value otherwise
- * @see elektraPluginProcessIsParent for checking if we are in the parent or child process
- * @ingroup processplugin
- **/
-int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t command, KeySet * originalKeySet, Key * key)
+static int sendCommand (const ElektraPluginProcess * pp, pluginprocess_t command, KeySet * originalKeySet, Key * key)
 {
 	// Ensure we have a keyset when trying to call GET SET and ERROR
 	if ((command == ELEKTRA_PLUGINPROCESS_GET || command == ELEKTRA_PLUGINPROCESS_SET || command == ELEKTRA_PLUGINPROCESS_ERROR) &&
@@ -290,12 +326,20 @@ int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t c
 
 	// Serialize, currently statically use dump as our default format, this already writes everything out to the pipe
 	ELEKTRA_LOG ("Parent: Sending data to issue command %u it through pipe %s", command, keyString (pp->parentCommandPipeKey));
+	// Memory files are read as soon as the command arrives, so they have to be written before it,
+	// whereas writing to a pipe blocks until the child reads it after the command
+	if (keySet != NULL && pp->payload != pp->dump)
+	{
+		ELEKTRA_LOG ("Parent: Writing the payload keyset with %zd keys to %s", ksGetSize (keySet),
+			     keyString (pp->parentPayloadPipeKey));
+		elektraInvoke2Args (pp->payload, "set", keySet, pp->parentPayloadPipeKey);
+	}
 	elektraInvoke2Args (pp->dump, "set", commandKeySet, pp->parentCommandPipeKey);
-	if (keySet != NULL)
+	if (keySet != NULL && pp->payload == pp->dump)
 	{
 		ELEKTRA_LOG ("Parent: Sending the payload keyset with %zd keys through the pipe %s", ksGetSize (keySet),
 			     keyString (pp->parentPayloadPipeKey));
-		elektraInvoke2Args (pp->dump, "set", keySet, pp->parentPayloadPipeKey);
+		elektraInvoke2Args (pp->payload, "set", keySet, pp->parentPayloadPipeKey);
 	}
 
 	// Deserialize
@@ -315,7 +359,7 @@ int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t c
 		errno = prevErrno;
 		ksDel (keySet);
 		keySet = ksNew (payloadSize, KS_END);
-		elektraInvoke2Args (pp->dump, "get", keySet, pp->childPayloadPipeKey);
+		elektraInvoke2Args (pp->payload, "get", keySet, pp->childPayloadPipeKey);
 		ELEKTRA_LOG ("Parent: We received %zd keys in return", ksGetSize (keySet));
 	}
 
@@ -379,6 +423,67 @@ int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t c
 	return lresult; // Safe, we had a bound check before, and plugins should return values in the int range
 }
 
+static unsigned long takeTicket (ElektraPluginProcess * pp)
+{
+	pthread_mutex_lock (&pp->sharedLock);
+	unsigned long ticket = pp->sharedNextTicket++;
+	pthread_mutex_unlock (&pp->sharedLock);
+	return ticket;
+}
+
+static int sendShared (ElektraPluginProcess * pp, unsigned long ticket, pluginprocess_t command, KeySet * originalKeySet, Key * key)
+{
+	pthread_mutex_lock (&pp->sharedLock);
+	while (pp->sharedServing != ticket)
+		pthread_cond_wait (&pp->sharedTurn, &pp->sharedLock);
+	pthread_mutex_unlock (&pp->sharedLock);
+
+	int result = sendCommand (pp, command, originalKeySet, key);
+
+	pthread_mutex_lock (&pp->sharedLock);
+	pp->sharedServing++;
+	pthread_cond_broadcast (&pp->sharedTurn);
+	pthread_mutex_unlock (&pp->sharedLock);
+	return result;
+}
+
+/** Call a plugin's function in a child process
+ *
+ * This will wrap all the required information to execute the given
+ * command in a keyset and send it over to the child process. Then
+ * it waits for the child process's answer and copies the result
+ * back into the original plugin keyset and plugin key.
+ *
+ * Typically called like
+ * @code
+int elektraPluginSet (Plugin * handle, KeySet * returned, Key * parentKey)
+{
+	ElektraPluginProcess * pp = elektraPluginGetData (handle);
+	if (elektraPluginProcessIsParent (pp)) return elektraPluginProcessSend (pp, ELEKTRA_PLUGINPROCESS_SET, returned, parentKey);
+
+	// actual plugin functionality to be executed in a child process
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+ * @endcode
+ *
+ * @param pp the data structure containing the plugin's process information
+ * @param command the plugin command that should be executed, e.g. ELEKTRA_PLUGINPROCESS_GET
+ * @param originalKeySet the original key set that the parent process receives
+ * @param key the original key the parent process receives
+ * @retval ELEKTRA_PLUGIN_STATUS_ERROR if the child process communication failed
+ * @retval the called plugin's return value otherwise
+ * @see elektraPluginProcessIsParent for checking if we are in the parent or child process
+ * @ingroup processplugin
+ **/
+int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t command, KeySet * originalKeySet, Key * key)
+{
+	if (pp->sharedName == NULL) return sendCommand (pp, command, originalKeySet, key);
+
+	// other plugin instances may send their commands to the shared process at the same time
+	ElektraPluginProcess * shared = (ElektraPluginProcess *) pp;
+	return sendShared (shared, takeTicket (shared), command, originalKeySet, key);
+}
+
 /** Check if a given plugin process is the parent or the child process
  *
  * @param pp the data structure containing the plugin's process information
@@ -413,6 +518,39 @@ static int makePipe (ElektraPluginProcess * pp, Key * errorKey, const char * pip
 	return 1;
 }
 
+#ifdef HAVE_MEMFD_CREATE
+/**
+ * Prepare the transfer of payloads via shared memory instead of the payload pipes
+ *
+ * @param pp the data structure containing the plugin's process information
+ * @retval 1 if the payload is transferred via memory files written by mmapstorage
+ * @retval 0 if the payload pipes have to be used
+ */
+static int makeSharedMemory (ElektraPluginProcess * pp)
+{
+	// mmapstorage is optional, so a missing plugin is not reported
+	pp->mmapstorage = elektraInvokeOpen ("mmapstorage", NULL, NULL);
+	if (!pp->mmapstorage) return 0;
+
+	int parentMemory = memfd_create ("elektra-pluginprocess-parent", MFD_CLOEXEC);
+	int childMemory = memfd_create ("elektra-pluginprocess-child", MFD_CLOEXEC);
+	if (parentMemory == -1 || childMemory == -1)
+	{
+		ELEKTRA_LOG_WARNING ("Failed to create memory files, using pipes for the payload: %s", strerror (errno));
+		if (parentMemory != -1) close (parentMemory);
+		if (childMemory != -1) close (childMemory);
+		elektraInvokeClose (pp->mmapstorage, NULL);
+		pp->mmapstorage = NULL;
+		return 0;
+	}
+
+	pp->parentPayloadMemory = parentMemory;
+	pp->childPayloadMemory = childMemory;
+	pp->payload = pp->mmapstorage;
+	return 1;
+}
+#endif
+
 static Key * makePipeKey (const char * pipeName, const int pipeFd)
 {
 	// create the key for this pipe for the use with dump
@@ -466,13 +604,7 @@ ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
 {
 	// First time initialization
 	ElektraPluginProcess * pp;
-	pp = elektraMalloc (sizeof (ElektraPluginProcess));
-	pp->counter = 0;
-	pp->pluginData = NULL;
-	pp->parentCommandPipeKey = NULL;
-	pp->parentPayloadPipeKey = NULL;
-	pp->childCommandPipeKey = NULL;
-	pp->childPayloadPipeKey = NULL;
+	pp = elektraCalloc (sizeof (ElektraPluginProcess));
 
 	KeySet * config = ksNew (1, keyNew ("user:/fullname", KEY_END), KS_END);
 	pp->dump = elektraInvokeOpen ("dump", config, errorKey);
@@ -484,6 +616,12 @@ ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
 		ELEKTRA_SET_INSTALLATION_ERROR (errorKey, "Failed to initialize the dump plugin");
 		return NULL;
 	}
+	pp->payload = pp->dump;
+
+	int sharedMemory = 0;
+#ifdef HAVE_MEMFD_CREATE
+	sharedMemory = makeSharedMemory (pp);
+#endif
 
 	// As generally recommended, ignore SIGPIPE because we will notice that the
 	// commandKeySet has been transferred incorrectly anyway to detect broken pipes
@@ -491,9 +629,9 @@ ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
 
 	// Prepare the pipes
 	if (!makePipe (pp, errorKey, "parentCommandPipe", pp->parentCommandPipe) ||
-	    !makePipe (pp, errorKey, "parentPayloadPipe", pp->parentPayloadPipe) ||
+	    (!sharedMemory && !makePipe (pp, errorKey, "parentPayloadPipe", pp->parentPayloadPipe)) ||
 	    !makePipe (pp, errorKey, "childCommandPipe", pp->childCommandPipe) ||
-	    !makePipe (pp, errorKey, "childPayloadPipe", pp->childPayloadPipe))
+	    (!sharedMemory && !makePipe (pp, errorKey, "childPayloadPipe", pp->childPayloadPipe)))
 		return NULL;
 
 	pp->pid = fork ();
@@ -507,9 +645,9 @@ ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
 
 	int pipeIdx = elektraPluginProcessIsParent (pp);
 	close (pp->parentCommandPipe[!pipeIdx]);
-	close (pp->parentPayloadPipe[!pipeIdx]);
+	if (!sharedMemory) close (pp->parentPayloadPipe[!pipeIdx]);
 	close (pp->childCommandPipe[pipeIdx]);
-	close (pp->childPayloadPipe[pipeIdx]);
+	if (!sharedMemory) close (pp->childPayloadPipe[pipeIdx]);
 
 	ELEKTRA_LOG_DEBUG ("parentCommandPipe[%d] has file descriptor %d", pipeIdx, pp->parentCommandPipe[pipeIdx]);
 	ELEKTRA_LOG_DEBUG ("parentPayloadPipe[%d] has file descriptor %d", pipeIdx, pp->parentPayloadPipe[pipeIdx]);
@@ -518,9 +656,11 @@ ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
 
 	// Prepare the keys for the pipes to use with dump
 	pp->parentCommandPipeKey = makePipeKey ("parentCommandPipe", pp->parentCommandPipe[pipeIdx]);
-	pp->parentPayloadPipeKey = makePipeKey ("parentPayloadPipe", pp->parentPayloadPipe[pipeIdx]);
+	pp->parentPayloadPipeKey =
+		makePipeKey ("parentPayloadPipe", sharedMemory ? pp->parentPayloadMemory : pp->parentPayloadPipe[pipeIdx]);
 	pp->childCommandPipeKey = makePipeKey ("childCommandPipe", pp->childCommandPipe[!pipeIdx]);
-	pp->childPayloadPipeKey = makePipeKey ("childPayloadPipe", pp->childPayloadPipe[!pipeIdx]);
+	pp->childPayloadPipeKey =
+		makePipeKey ("childPayloadPipe", sharedMemory ? pp->childPayloadMemory : pp->childPayloadPipe[!pipeIdx]);
 
 	ELEKTRA_LOG_DEBUG ("parentCommandPipeKey is %s on %d", keyString (pp->parentCommandPipeKey), pp->pid);
 	ELEKTRA_LOG_DEBUG ("parentPayloadPipeKey is %s on %d", keyString (pp->parentPayloadPipeKey), pp->pid);
@@ -531,6 +671,118 @@ ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
 	return pp;
 }
 
+static int sameConfig (KeySet * config, KeySet * other)
+{
+	if (ksGetSize (config) != ksGetSize (other)) return 0;
+	for (elektraCursor it = 0; it < ksGetSize (config); ++it)
+	{
+		Key * key = ksAtCursor (config, it);
+		Key * otherKey = ksAtCursor (other, it);
+		size_t valueSize = keyGetValueSize (key);
+		if (keyCmp (key, otherKey) != 0 || valueSize != (size_t) keyGetValueSize (otherKey) ||
+		    (valueSize > 0 && memcmp (keyValue (key), keyValue (otherKey), valueSize) != 0))
+			return 0;
+	}
+	return 1;
+}
+
+static void removeSharedProcess (ElektraPluginProcess * pp)
+{
+	ElektraPluginProcess ** current = &sharedProcesses;
+	while (*current != NULL && *current != pp)
+		current = &(*current)->sharedNext;
+	if (*current != NULL) *current = pp->sharedNext;
+}
+
+/** Initialize a plugin to be executed in a process shared with other instances of the plugin
+ *
+ * Works like elektraPluginProcessInit, but if an instance of a plugin with the
+ * same name and the same configuration already runs in a child process, e.g. one
+ * opened by another KDB handle, that child process is returned instead of forking
+ * a new one. The commands of all instances are then sent to the same child process,
+ * one after another, and the child process runs until the last instance is closed.
+ * This function already calls the plugin's open function in the child process,
+ * the following elektraPluginProcessOpen only reports its success.
+ *
+ * As the child process only knows the plugin instance it was forked from, this
+ * is only suitable for plugins whose state in the child process only depends on
+ * their configuration. The open and close functions of this instance are called
+ * in the child process for every instance, so close must not release the state
+ * the other instances still use. Data set with elektraPluginProcessSetData is
+ * shared by all instances too, so it should only be set in the child process.
+ *
+ * Typically called in a plugin's open function like:
+ * @code
+int elektraPluginOpen (Plugin * handle, Key * errorKey)
+{
+	ElektraPluginProcess * pp = elektraPluginGetData (handle);
+	if (pp == NULL)
+	{
+		if ((pp = elektraPluginProcessInitShared (handle, errorKey)) == NULL) return ELEKTRA_PLUGIN_STATUS_ERROR;
+		elektraPluginSetData (handle, pp);
+		if (!elektraPluginProcessIsParent (pp)) elektraPluginProcessStart (handle, pp);
+	}
+	if (elektraPluginProcessIsParent (pp)) return elektraPluginProcessOpen (pp, errorKey);
+
+	// actual plugin functionality to be executed in a child process
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+ * @endcode
+ *
+ * @param handle the plugin's handle, its name and configuration select the child process
+ * @param errorKey a key where error messages will be set
+ * @retval NULL if the initialization failed
+ * @retval a pointer to the information
+ * @see elektraPluginProcessInit
+ * @ingroup processplugin
+ **/
+ElektraPluginProcess * elektraPluginProcessInitShared (Plugin * handle, Key * errorKey)
+{
+	if (handle->name == NULL) return elektraPluginProcessInit (errorKey);
+	KeySet * config = elektraPluginGetConfig (handle);
+
+	pthread_mutex_lock (&sharedProcessesLock);
+	ElektraPluginProcess * pp = sharedProcesses;
+	while (pp != NULL && (strcmp (pp->sharedName, handle->name) != 0 || !sameConfig (pp->sharedConfig, config)))
+		pp = pp->sharedNext;
+
+	if (pp != NULL)
+	{
+		ELEKTRA_LOG_DEBUG ("Reusing the plugin process with the pid %d for %s", pp->pid, handle->name);
+	}
+	else
+	{
+		pp = elektraPluginProcessInit (errorKey);
+		if (pp == NULL || !elektraPluginProcessIsParent (pp))
+		{
+			pthread_mutex_unlock (&sharedProcessesLock);
+			return pp;
+		}
+		pp->sharedName = elektraStrDup (handle->name);
+		pp->sharedConfig = ksDup (config);
+		pthread_mutex_init (&pp->sharedLock, NULL);
+		pthread_cond_init (&pp->sharedTurn, NULL);
+		pp->sharedNext = sharedProcesses;
+		sharedProcesses = pp;
+	}
+
+	// the child process counts this instance from now on, so it keeps running if other instances close first
+	pp->sharedUsers = pp->sharedUsers + 1;
+	pp->sharedPending = pp->sharedPending + 1;
+	unsigned long ticket = takeTicket (pp);
+	pthread_mutex_unlock (&sharedProcessesLock);
+
+	if (sendShared (pp, ticket, ELEKTRA_PLUGINPROCESS_OPEN, NULL, errorKey) == ELEKTRA_PLUGIN_STATUS_ERROR)
+	{
+		pthread_mutex_lock (&sharedProcessesLock);
+		pp->sharedPending = pp->sharedPending - 1;
+		pthread_mutex_unlock (&sharedProcessesLock);
+		elektraPluginProcessClose (pp, errorKey);
+		return NULL;
+	}
+	return pp;
+}
+
 /** Call a plugin's open function in a child process
  *
  * This will increase the internal counter how often open/close has been called,
@@ -544,6 +796,22 @@ ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
  **/
 int elektraPluginProcessOpen (ElektraPluginProcess * pp, Key * errorKey)
 {
+	if (pp->sharedName)
+	{
+		pthread_mutex_lock (&sharedProcessesLock);
+		if (pp->sharedPending > 0)
+		{
+			// already opened by elektraPluginProcessInitShared
+			pp->sharedPending = pp->sharedPending - 1;
+			pthread_mutex_unlock (&sharedProcessesLock);
+			return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+		}
+		pp->sharedUsers = pp->sharedUsers + 1;
+		unsigned long ticket = takeTicket (pp);
+		pthread_mutex_unlock (&sharedProcessesLock);
+		return sendShared (pp, ticket, ELEKTRA_PLUGINPROCESS_OPEN, NULL, errorKey);
+	}
+
 	pp->counter = pp->counter + 1;
 	return elektraPluginProcessSend (pp, ELEKTRA_PLUGINPROCESS_OPEN, NULL, errorKey);
 }
@@ -579,12 +847,30 @@ int elektraPluginClose (Plugin * handle, Key * errorKey)
 ElektraPluginProcessCloseResult elektraPluginProcessClose (ElektraPluginProcess * pp, Key * errorKey)
 {
 	int result = ELEKTRA_PLUGIN_STATUS_SUCCESS;
-	if (pp->counter > 0)
+	int done;
+	if (pp->sharedName)
 	{
-		pp->counter = pp->counter - 1;
-		result = elektraPluginProcessSend (pp, ELEKTRA_PLUGINPROCESS_CLOSE, NULL, errorKey);
+		pthread_mutex_lock (&sharedProcessesLock);
+		pp->sharedUsers = pp->sharedUsers - 1;
+		// closed after elektraPluginProcessInitShared without calling open
+		if (pp->sharedPending > pp->sharedUsers) pp->sharedPending = pp->sharedUsers;
+		done = pp->sharedUsers <= 0;
+		// no other instance can find the process anymore, so this close is the last command
+		if (done) removeSharedProcess (pp);
+		unsigned long ticket = takeTicket (pp);
+		pthread_mutex_unlock (&sharedProcessesLock);
+		result = sendShared (pp, ticket, ELEKTRA_PLUGINPROCESS_CLOSE, NULL, errorKey);
 	}
-	int done = pp->counter <= 0;
+	else
+	{
+		if (pp->counter > 0)
+		{
+			pp->counter = pp->counter - 1;
+			result = elektraPluginProcessSend (pp, ELEKTRA_PLUGINPROCESS_CLOSE, NULL, errorKey);
+		}
+		done = pp->counter <= 0;
+	}
+
 	if (done) cleanupPluginData (pp, errorKey, 0);
 	ElektraPluginProcessCloseResult closeResult = { result, done };
 	return closeResult;
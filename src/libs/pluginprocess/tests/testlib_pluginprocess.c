@@ -9,12 +9,13 @@
 
 #include <stdio.h>
 
-#include <kdbpluginprocess.h>
+#include <kdbpluginprocessprivate.h>
 
 #include <kdb.h>
 #include <kdbplugin.h>
 #include <kdbprivate.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <tests.h>
 
@@ -334,6 +335,206 @@ static void test_childAddingParentKey (void)
 	elektraFree (plugin);
 }
 
+static void test_largeKeySet (void)
+{
+	printf ("test largeKeySet\n");
+
+	Key * parentKey = keyNew ("user:/tests/pluginprocess", KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	Plugin * plugin = createDummyPlugin (conf);
+
+	KeySet * ks = ksNew (0, KS_END);
+	char name[64];
+	for (int i = 0; i < 1000; ++i)
+	{
+		snprintf (name, sizeof (name), "user:/tests/pluginprocess/key%04d", i);
+		Key * key = keyNew (name, KEY_VALUE, name, KEY_META, "meta/index", name + sizeof ("user:/tests/pluginprocess"), KEY_END);
+		if (i % 10 == 0) keySetBinary (key, &i, sizeof (i));
+		ksAppendKey (ks, key);
+	}
+
+	succeed_if (plugin->kdbOpen (plugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbOpen was not successful");
+	ElektraPluginProcess * pp = elektraPluginGetData (plugin);
+	if (pp)
+	{
+		succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+		succeed_if (ksGetSize (ks) == 1001, "wrong number of keys returned from child");
+		succeed_if (ksLookupByName (ks, "user:/tests/pluginprocess/get", KDB_O_NONE) != NULL, "key added by child is missing");
+		for (int i = 0; i < 1000; ++i)
+		{
+			snprintf (name, sizeof (name), "user:/tests/pluginprocess/key%04d", i);
+			Key * key = ksLookupByName (ks, name, KDB_O_NONE);
+			succeed_if_fmt (key != NULL, "key %s is missing", name);
+			if (key == NULL) continue;
+			const Key * meta = keyGetMeta (key, "meta/index");
+			succeed_if_fmt (meta != NULL && strcmp (keyString (meta), name + sizeof ("user:/tests/pluginprocess")) == 0,
+					"wrong metadata of key %s", name);
+			if (i % 10 == 0)
+			{
+				int value = -1;
+				succeed_if_fmt (keyIsBinary (key) && keyGetBinary (key, &value, sizeof (value)) == sizeof (value) && value == i,
+						"wrong binary value of key %s", name);
+			}
+			else
+			{
+				succeed_if_fmt (strcmp (keyString (key), name) == 0, "wrong value of key %s", name);
+			}
+		}
+	}
+	succeed_if (plugin->kdbClose (plugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbClose was not successful");
+
+	output_warnings (parentKey);
+	output_error (parentKey);
+
+	keyDel (parentKey);
+	ksDel (ks);
+	ksDel (conf);
+	elektraFree (plugin);
+}
+
+static int elektraDummySharedOpen (Plugin * handle, Key * errorKey)
+{
+	ElektraPluginProcess * pp = elektraPluginGetData (handle);
+	if (pp == NULL)
+	{
+		if ((pp = elektraPluginProcessInitShared (handle, errorKey)) == NULL) return ELEKTRA_PLUGIN_STATUS_ERROR;
+		elektraPluginSetData (handle, pp);
+		if (!elektraPluginProcessIsParent (pp))
+		{
+			// the data is shared by all instances, so only the child sets it
+			int * testData = (int *) malloc (sizeof (int));
+			*testData = 42;
+			elektraPluginProcessSetData (pp, testData);
+			elektraPluginProcessStart (handle, pp);
+		}
+	}
+	if (elektraPluginProcessIsParent (pp)) return elektraPluginProcessOpen (pp, errorKey);
+
+	keySetMeta (errorKey, "user:/tests/pluginprocess/open", "");
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+static int elektraDummySharedClose (Plugin * handle, Key * errorKey)
+{
+	ElektraPluginProcess * pp = elektraPluginGetData (handle);
+	if (elektraPluginProcessIsParent (pp))
+	{
+		elektraPluginSetData (handle, NULL);
+		return elektraPluginProcessClose (pp, errorKey).result;
+	}
+
+	// the child process keeps its data for the other instances
+	keySetMeta (errorKey, "user:/tests/pluginprocess/close", "");
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
+static void test_sharedProcess (void)
+{
+	printf ("test sharedProcess\n");
+
+	Key * parentKey = keyNew ("user:/tests/pluginprocess", KEY_END);
+	KeySet * conf = ksNew (1, keyNew ("user:/setting", KEY_VALUE, "shared", KEY_END), KS_END);
+	KeySet * sameConf = ksDup (conf);
+	KeySet * otherConf = ksNew (1, keyNew ("user:/setting", KEY_VALUE, "other", KEY_END), KS_END);
+	Plugin * plugin = createDummyPlugin (conf);
+	Plugin * samePlugin = createDummyPlugin (sameConf);
+	Plugin * otherPlugin = createDummyPlugin (otherConf);
+	plugin->kdbOpen = samePlugin->kdbOpen = otherPlugin->kdbOpen = &elektraDummySharedOpen;
+	plugin->kdbClose = samePlugin->kdbClose = otherPlugin->kdbClose = &elektraDummySharedClose;
+
+	succeed_if (plugin->kdbOpen (plugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbOpen was not successful");
+	succeed_if (samePlugin->kdbOpen (samePlugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbOpen was not successful");
+	succeed_if (otherPlugin->kdbOpen (otherPlugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbOpen was not successful");
+
+	ElektraPluginProcess * pp = elektraPluginGetData (plugin);
+	ElektraPluginProcess * samePp = elektraPluginGetData (samePlugin);
+	ElektraPluginProcess * otherPp = elektraPluginGetData (otherPlugin);
+	exit_if_fail (pp != NULL && samePp != NULL && otherPp != NULL, "didn't store the pluginprocess struct in the plugin's data");
+	succeed_if (pp == samePp, "plugins with the same configuration don't share the process");
+	succeed_if (pp != otherPp, "plugins with different configurations share the process");
+
+	KeySet * ks = ksNew (0, KS_END);
+	succeed_if (samePlugin->kdbGet (samePlugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	succeed_if (keyGetMeta (parentKey, "user:/tests/pluginprocess/testdata") != NULL, "child process didn't have its plugin data");
+
+	// the process is kept for the remaining instance
+	succeed_if (plugin->kdbClose (plugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbClose was not successful");
+	ksClear (ks);
+	succeed_if (samePlugin->kdbSet (samePlugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+	succeed_if (ksLookupByName (ks, "user:/tests/pluginprocess/set", KDB_O_NONE) != NULL, "key added by child is missing");
+
+	succeed_if (samePlugin->kdbClose (samePlugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbClose was not successful");
+	succeed_if (otherPlugin->kdbClose (otherPlugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbClose was not successful");
+
+	// a new instance gets a new process after all instances were closed
+	succeed_if (plugin->kdbOpen (plugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbOpen was not successful");
+	succeed_if (elektraPluginGetData (plugin) != NULL, "didn't store the pluginprocess struct in the plugin's data");
+	succeed_if (plugin->kdbClose (plugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbClose was not successful");
+
+	output_warnings (parentKey);
+	output_error (parentKey);
+
+	keyDel (parentKey);
+	ksDel (ks);
+	ksDel (conf);
+	ksDel (sameConf);
+	ksDel (otherConf);
+	elektraFree (plugin);
+	elektraFree (samePlugin);
+	elektraFree (otherPlugin);
+}
+
+static void test_sharedProcessPending (void)
+{
+	printf ("test sharedProcessPending\n");
+
+	Key * parentKey = keyNew ("user:/tests/pluginprocess", KEY_END);
+	KeySet * conf = ksNew (1, keyNew ("user:/setting", KEY_VALUE, "pending", KEY_END), KS_END);
+	KeySet * sameConf = ksDup (conf);
+	KeySet * laterConf = ksDup (conf);
+	Plugin * plugin = createDummyPlugin (conf);
+	Plugin * samePlugin = createDummyPlugin (sameConf);
+	Plugin * laterPlugin = createDummyPlugin (laterConf);
+	plugin->kdbOpen = samePlugin->kdbOpen = laterPlugin->kdbOpen = &elektraDummySharedOpen;
+	plugin->kdbClose = samePlugin->kdbClose = laterPlugin->kdbClose = &elektraDummySharedClose;
+
+	succeed_if (plugin->kdbOpen (plugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbOpen was not successful");
+	ElektraPluginProcess * pp = elektraPluginGetData (plugin);
+	exit_if_fail (pp != NULL, "didn't store the pluginprocess struct in the plugin's data");
+
+	// the second instance is initialized, but the first one is closed before it is opened
+	ElektraPluginProcess * samePp = elektraPluginProcessInitShared (samePlugin, parentKey);
+	succeed_if (samePp == pp, "plugins with the same configuration don't share the process");
+	elektraPluginSetData (samePlugin, samePp);
+	succeed_if (plugin->kdbClose (plugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbClose was not successful");
+	succeed_if (samePlugin->kdbOpen (samePlugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbOpen was not successful");
+
+	KeySet * ks = ksNew (0, KS_END);
+	succeed_if (samePlugin->kdbGet (samePlugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS,
+		    "child process exited while an instance was pending");
+
+	succeed_if (laterPlugin->kdbOpen (laterPlugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbOpen was not successful");
+	succeed_if (elektraPluginGetData (laterPlugin) == pp, "running process was not reused");
+	ksClear (ks);
+	succeed_if (laterPlugin->kdbSet (laterPlugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+	succeed_if (ksLookupByName (ks, "user:/tests/pluginprocess/set", KDB_O_NONE) != NULL, "key added by child is missing");
+
+	succeed_if (samePlugin->kdbClose (samePlugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbClose was not successful");
+	succeed_if (laterPlugin->kdbClose (laterPlugin, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbClose was not successful");
+
+	output_warnings (parentKey);
+	output_error (parentKey);
+
+	keyDel (parentKey);
+	ksDel (ks);
+	ksDel (conf);
+	ksDel (sameConf);
+	ksDel (laterConf);
+	elektraFree (plugin);
+	elektraFree (samePlugin);
+	elektraFree (laterPlugin);
+}
+
 static int elektraDummyOpenWithError (Plugin * handle, Key * errorKey)
 {
 	ElektraPluginProcess * pp = elektraPluginGetData (handle);
@@ -426,6 +627,9 @@ int main (int argc, char ** argv)
 	test_emptyKeySet ();
 	test_reservedParentKeyName ();
 	test_keysetContainingParentKey ();
+	test_largeKeySet ();
+	test_sharedProcess ();
+	test_sharedProcessPending ();
 	test_closeWithoutOpen ();
 	test_childAddingParentKey ();
 	test_childDies ();
@@ -0,0 +1,91 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for three-way merges of growing key trees
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <kdbtimer.hpp>
+#include <merging/automergeconfiguration.hpp>
+#include <merging/threewaymerge.hpp>
+
+#include <iostream>
+#include <string>
+
+using namespace kdb;
+using namespace kdb::tools::merging;
+
+const int benchmarkIterations = 11; // is a good number to not need mean values for median
+
+/**
+ * @brief Creates a tree with nr_keys keys below parent, spread over groups of 100 keys.
+ */
+KeySet createTree (std::string const & parent, long long nr_keys)
+{
+	KeySet ks;
+	ks.append (Key (parent, KEY_END));
+	for (long long i = 0; i < nr_keys; ++i)
+	{
+		ks.append (Key (parent + "/group" + std::to_string (i / 100) + "/key" + std::to_string (i), KEY_VALUE,
+				std::to_string (i).c_str (), KEY_END));
+	}
+	return ks;
+}
+
+/**
+ * @brief Every tenth key is changed on one of the sides, so a tenth of the keys are conflicts
+ * that the auto merge strategies resolve.
+ */
+__attribute__ ((noinline)) void benchmark_merge (long long nr_keys)
+{
+	Timer t (std::to_string (nr_keys) + " keys", Timer::median_cerr);
+
+	KeySet base = createTree ("user:/base", nr_keys);
+	KeySet ours = createTree ("user:/ours", nr_keys);
+	KeySet theirs = createTree ("user:/theirs", nr_keys);
+	for (long long i = 0; i < nr_keys; i += 10)
+	{
+		std::string name = "/group" + std::to_string (i / 100) + "/key" + std::to_string (i);
+		switch (i / 10 % 3)
+		{
+		case 0:
+			ours.lookup ("user:/ours" + name).setString ("modified");
+			break;
+		case 1:
+			theirs.lookup ("user:/theirs" + name, KDB_O_POP);
+			break;
+		case 2:
+			theirs.append (Key ("user:/theirs" + name + "/added", KEY_VALUE, "added", KEY_END));
+			break;
+		}
+	}
+
+	ThreeWayMerge merger;
+	AutoMergeConfiguration configuration;
+	configuration.configureMerger (merger);
+
+	size_t merged = 0;
+	for (int i = 0; i < benchmarkIterations; ++i)
+	{
+		t.start ();
+		MergeResult result = merger.mergeKeySet (base, ours, theirs, Key ("user:/merged", KEY_END));
+		t.stop ();
+		merged += result.getMergedKeys ().size ();
+		if (result.hasConflicts ()) std::cerr << "unexpected unresolved conflicts" << std::endl;
+	}
+	std::cout << t;
+	std::cout << "merged keys: " << merged / benchmarkIterations << std::endl;
+}
+
+int main (int argc, char ** argv)
+{
+	long long max_keys = 100000LL;
+	if (argc > 1) max_keys = atoll (argv[1]);
+
+	for (long long nr_keys = 1000LL; nr_keys <= max_keys; nr_keys *= 10)
+	{
+		benchmark_merge (nr_keys);
+	}
+}
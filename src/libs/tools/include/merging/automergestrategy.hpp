@@ -32,6 +32,7 @@ class AutoMergeStrategy : public MergeConflictStrategy
 {
 public:
 	virtual void resolveConflict (const MergeTask & task, Key & conflictKey, MergeResult & result) override;
+	virtual bool canResolve (ConflictOperation ourOperation, ConflictOperation theirOperation) override;
 };
 } // namespace merging
 } // namespace tools
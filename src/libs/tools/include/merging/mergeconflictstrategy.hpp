@@ -36,6 +36,17 @@ public:
 	virtual ~MergeConflictStrategy (){};
 	virtual void resolveConflict (const MergeTask & task, Key & conflictKey, MergeResult & result) = 0;
 
+	/**
+	 * Tells the merger which conflicts this strategy has to be consulted for.
+	 * Strategies that also modify conflicts they do not resolve must keep the default.
+	 *
+	 * @return false if resolveConflict would leave a conflict with these operations untouched
+	 */
+	virtual bool canResolve (ConflictOperation, ConflictOperation)
+	{
+		return true;
+	}
+
 protected:
 	virtual ConflictOperation getOurConflictOperation (const Key & conflictKey);
 	virtual ConflictOperation getTheirConflictOperation (const Key & conflictKey);
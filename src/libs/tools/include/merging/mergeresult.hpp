@@ -35,6 +35,14 @@ public:
 
 	void resolveConflict (Key & key);
 
+	/**
+	 * Takes over a result that resolved the conflicts of this result.
+	 * Its merged keys are added at once and its remaining conflicts replace the conflicts of this result.
+	 *
+	 * @param resolution a result that was created with the conflicts of this result and no merged keys
+	 */
+	void applyResolution (MergeResult & resolution);
+
 	bool isConflict (const Key & key)
 	{
 		return conflictSet.lookup (key);
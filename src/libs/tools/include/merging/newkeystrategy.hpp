@@ -30,6 +30,7 @@ public:
 	}
 
 	virtual void resolveConflict (const MergeTask & task, Key & conflictKey, MergeResult & result) override;
+	virtual bool canResolve (ConflictOperation ourOperation, ConflictOperation theirOperation) override;
 };
 } // namespace merging
 } // namespace tools
@@ -72,6 +72,8 @@ public:
 private:
 	std::vector<MergeConflictStrategy *> strategies;
 	void detectConflicts (const MergeTask & task, MergeResult & mergeResult, bool reverseConflictMeta);
+	void detectConflict (Key & our, Key & their, Key & base, Key & mergeKey, bool keepOurs, MergeResult & mergeResult, bool reverse);
+	bool joinConflicts (const MergeTask & task, MergeResult & mergeResult);
 };
 } // namespace merging
 } // namespace tools
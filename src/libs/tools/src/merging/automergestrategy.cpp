@@ -23,6 +23,13 @@ namespace tools
 namespace merging
 {
 
+bool AutoMergeStrategy::canResolve (ConflictOperation ourOperation, ConflictOperation theirOperation)
+{
+	if (ourOperation == CONFLICT_SAME) return theirOperation != CONFLICT_SAME && theirOperation != CONFLICT_META;
+	if (theirOperation != CONFLICT_SAME) return false;
+	return ourOperation == CONFLICT_MODIFY || ourOperation == CONFLICT_ADD || ourOperation == CONFLICT_DELETE;
+}
+
 void AutoMergeStrategy::resolveConflict (const MergeTask & task, Key & conflictKey, MergeResult & result)
 {
 
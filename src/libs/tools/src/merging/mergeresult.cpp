@@ -75,6 +75,12 @@ void MergeResult::resolveConflict (Key & key)
 	conflictSet.lookup (key, KDB_O_POP);
 	resolvedKeys++;
 }
+void MergeResult::applyResolution (MergeResult & resolution)
+{
+	conflictSet = resolution.conflictSet;
+	mergedKeys.append (resolution.mergedKeys);
+	resolvedKeys += resolution.resolvedKeys;
+}
 } // namespace merging
 } // namespace tools
 } // namespace kdb
@@ -23,6 +23,12 @@ namespace tools
 namespace merging
 {
 
+bool NewKeyStrategy::canResolve (ConflictOperation ourOperation, ConflictOperation theirOperation)
+{
+	return (ourOperation == CONFLICT_SAME && theirOperation == CONFLICT_ADD) ||
+	       (ourOperation == CONFLICT_ADD && theirOperation == CONFLICT_SAME);
+}
+
 void NewKeyStrategy::resolveConflict (const MergeTask & task, Key & conflictKey, MergeResult & result)
 {
 
@@ -23,6 +23,12 @@ namespace tools
 namespace merging
 {
 
+bool OneSideValueStrategy::canResolve (ConflictOperation ourOperation, ConflictOperation theirOperation)
+{
+	return (ourOperation == CONFLICT_SAME && theirOperation == CONFLICT_MODIFY) ||
+	       (ourOperation == CONFLICT_MODIFY && theirOperation == CONFLICT_SAME);
+}
+
 void OneSideValueStrategy::resolveConflict (const MergeTask & task, Key & conflictKey, MergeResult & result)
 {
 	ConflictOperation ourOperation = getOurConflictOperation (conflictKey);
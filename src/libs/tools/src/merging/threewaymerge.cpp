@@ -9,8 +9,12 @@
 
 #include <helper/comparison.hpp>
 #include <helper/keyhelper.hpp>
+#include <kdbprivate.h>
 #include <merging/threewaymerge.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 using namespace std;
 using namespace kdb::tools::helper;
 
@@ -35,154 +39,304 @@ inline void addAsymmetricConflict (MergeResult & result, Key & key, ConflictOper
 	}
 }
 
-void ThreeWayMerge::detectConflicts (const MergeTask & task, MergeResult & mergeResult, bool reverseConflictMeta = false)
+void ThreeWayMerge::detectConflict (Key & our, Key & their, Key & base, Key & mergeKey, bool keepOurs, MergeResult & mergeResult,
+				    bool reverse)
 {
-	for (Key our : task.ours)
+	if (keyDataEqual (our, their))
 	{
-		string theirLookup = rebasePath (our, task.ourParent, task.theirParent);
-		Key theirLookupResult = task.theirs.lookup (theirLookup);
-
-		// we have to copy it to obtain owner etc...
-		Key mergeKey = rebaseKey (our, task.ourParent, task.mergeRoot);
-
-		if (keyDataEqual (our, theirLookupResult))
+		// keydata matches, see if metakeys match
+		if (keyMetaEqual (our, their))
 		{
-			// keydata matches, see if metakeys match
-			if (keyMetaEqual (our, theirLookupResult))
+			if (keepOurs)
 			{
-				if (task.ourParent.getName () == task.mergeRoot.getName ())
-				{
-					// the key was not rebased, we can reuse our (prevents that the key is rewritten)
-					mergeResult.addMergeKey (our);
-				}
-				else
-				{
-					// the key causes no merge conflict, but the merge result is below a new parent
-					mergeResult.addMergeKey (mergeKey);
-				}
+				// the key was not rebased, we can reuse our (prevents that the key is rewritten)
+				mergeResult.addMergeKey (our);
 			}
 			else
 			{
-				// metakeys are different
-				mergeResult.addConflict (mergeKey, CONFLICT_META, CONFLICT_META);
+				// the key causes no merge conflict, but the merge result is below a new parent
+				mergeResult.addMergeKey (mergeKey);
 			}
 		}
 		else
 		{
-			string baseLookup = rebasePath (our, task.ourParent, task.baseParent);
-			Key baseLookupResult = task.base.lookup (baseLookup);
-
-			// check if the keys was newly added in ours
-			if (baseLookupResult)
+			// metakeys are different
+			mergeResult.addConflict (mergeKey, CONFLICT_META, CONFLICT_META);
+		}
+	}
+	else
+	{
+		// check if the keys was newly added in ours
+		if (base)
+		{
+			// the key exists in base, check if the key still exists in theirs
+			if (their)
 			{
-				// the key exists in base, check if the key still exists in theirs
-				if (theirLookupResult)
+				// check if only they modified it
+				if (!keyDataEqual (our, base) && keyDataEqual (their, base))
 				{
-					// check if only they modified it
-					if (!keyDataEqual (our, baseLookupResult) && keyDataEqual (theirLookupResult, baseLookupResult))
-					{
-						// the key was only modified in ours
-						addAsymmetricConflict (mergeResult, mergeKey, CONFLICT_MODIFY, CONFLICT_SAME,
-								       reverseConflictMeta);
-					}
-					else
-					{
-						// check if both modified it
-						if (!keyDataEqual (our, baseLookupResult) &&
-						    !keyDataEqual (theirLookupResult, baseLookupResult))
-						{
-							// the key was modified on both sides
-							mergeResult.addConflict (mergeKey, CONFLICT_MODIFY, CONFLICT_MODIFY);
-						}
-					}
+					// the key was only modified in ours
+					addAsymmetricConflict (mergeResult, mergeKey, CONFLICT_MODIFY, CONFLICT_SAME, reverse);
 				}
 				else
 				{
-					// the key does not exist in theirs anymore, check if ours has modified it
-					if (keyDataEqual (our, baseLookupResult))
-					{
-						// the key was deleted in theirs, and not modified in ours
-						addAsymmetricConflict (mergeResult, mergeKey, CONFLICT_SAME, CONFLICT_DELETE,
-								       reverseConflictMeta);
-					}
-					else
+					// check if both modified it
+					if (!keyDataEqual (our, base) && !keyDataEqual (their, base))
 					{
-						// the key was deleted in theirs, but modified in ours
-						addAsymmetricConflict (mergeResult, mergeKey, CONFLICT_MODIFY, CONFLICT_DELETE,
-								       reverseConflictMeta);
+						// the key was modified on both sides
+						mergeResult.addConflict (mergeKey, CONFLICT_MODIFY, CONFLICT_MODIFY);
 					}
 				}
 			}
 			else
 			{
-				// the key does not exist in base, check if the key was added in theirs
-				if (theirLookupResult)
+				// the key does not exist in theirs anymore, check if ours has modified it
+				if (keyDataEqual (our, base))
+				{
+					// the key was deleted in theirs, and not modified in ours
+					addAsymmetricConflict (mergeResult, mergeKey, CONFLICT_SAME, CONFLICT_DELETE, reverse);
+				}
+				else
+				{
+					// the key was deleted in theirs, but modified in ours
+					addAsymmetricConflict (mergeResult, mergeKey, CONFLICT_MODIFY, CONFLICT_DELETE, reverse);
+				}
+			}
+		}
+		else
+		{
+			// the key does not exist in base, check if the key was added in theirs
+			if (their)
+			{
+				// check if the key was added with the same value in theirs
+				if (keyDataEqual (mergeKey, their))
 				{
-					// check if the key was added with the same value in theirs
-					if (keyDataEqual (mergeKey, theirLookupResult))
+					if (keyMetaEqual (our, their))
 					{
-						if (keyMetaEqual (our, theirLookupResult))
+						// the key was added on both sides with the same value
+						if (keepOurs)
 						{
-							// the key was added on both sides with the same value
-							if (task.ourParent.getName () == task.mergeRoot.getName ())
-							{
-								// the key was not rebased, we can reuse our and prevent the sync flag being
-								// set
-								mergeResult.addMergeKey (our);
-							}
-							else
-							{
-								// the key causes no merge conflict, but the merge result is below a new
-								// parent
-								mergeResult.addMergeKey (mergeKey);
-							}
+							// the key was not rebased, we can reuse our and prevent the sync flag being
+							// set
+							mergeResult.addMergeKey (our);
 						}
 						else
 						{
-							// metakeys are different
-							mergeResult.addConflict (mergeKey, CONFLICT_META, CONFLICT_META);
+							// the key causes no merge conflict, but the merge result is below a new
+							// parent
+							mergeResult.addMergeKey (mergeKey);
 						}
 					}
 					else
 					{
-						// the key was added on both sides with different values
-						mergeResult.addConflict (mergeKey, CONFLICT_ADD, CONFLICT_ADD);
+						// metakeys are different
+						mergeResult.addConflict (mergeKey, CONFLICT_META, CONFLICT_META);
 					}
 				}
 				else
 				{
-					// the key was only added to ours
-					addAsymmetricConflict (mergeResult, mergeKey, CONFLICT_ADD, CONFLICT_SAME, reverseConflictMeta);
+					// the key was added on both sides with different values
+					mergeResult.addConflict (mergeKey, CONFLICT_ADD, CONFLICT_ADD);
 				}
 			}
+			else
+			{
+				// the key was only added to ours
+				addAsymmetricConflict (mergeResult, mergeKey, CONFLICT_ADD, CONFLICT_SAME, reverse);
+			}
+		}
+	}
+}
+
+void ThreeWayMerge::detectConflicts (const MergeTask & task, MergeResult & mergeResult, bool reverseConflictMeta = false)
+{
+	bool keepOurs = task.ourParent.getName () == task.mergeRoot.getName ();
+	for (Key our : task.ours)
+	{
+		Key their = task.theirs.lookup (rebasePath (our, task.ourParent, task.theirParent));
+		Key base = task.base.lookup (rebasePath (our, task.ourParent, task.baseParent));
+
+		// we have to copy it to obtain owner etc...
+		Key mergeKey = rebaseKey (our, task.ourParent, task.mergeRoot);
+		detectConflict (our, their, base, mergeKey, keepOurs, mergeResult, reverseConflictMeta);
+	}
+}
+
+/**
+ * A key of one side of the merge together with its name relative to the parent of that side.
+ * The relative name is a slice of the unescaped name, so it compares like the names in a KeySet.
+ */
+struct RelativeKey
+{
+	ckdb::Key * key;
+	int ns;
+	const char * name;
+	size_t size;
+};
+
+static int compareRelative (const RelativeKey & a, const RelativeKey & b)
+{
+	if (a.ns != b.ns) return a.ns < b.ns ? -1 : 1;
+	int cmp = memcmp (a.name, b.name, std::min (a.size, b.size));
+	if (cmp != 0) return cmp;
+	if (a.size == b.size) return 0;
+	return a.size < b.size ? -1 : 1;
+}
+
+/**
+ * Collects the keys below parent in KeySet order. Because all of them share the
+ * name of the parent, their relative names are sorted too.
+ *
+ * @param cascading if the parents are cascading, the namespace of the key is part of the relative name
+ * @param strict if true, fail on keys not below the parent instead of skipping them
+ * @retval false if a key needs the lookup based merge
+ */
+static bool collectRelative (const KeySet & ks, const Key & parent, bool cascading, bool strict, std::vector<RelativeKey> & keys)
+{
+	const char * parentName = static_cast<const char *> (ckdb::keyUnescapedName (*parent));
+	size_t parentSize = ckdb::keyGetUnescapedNameSize (*parent);
+	bool root = parentSize == 3;
+
+	keys.reserve (ks.size ());
+	for (elektraCursor it = 0; it < ks.size (); ++it)
+	{
+		ckdb::Key * key = ckdb::ksAtCursor (ks.getKeySet (), it);
+		const char * name = static_cast<const char *> (ckdb::keyUnescapedName (key));
+		size_t size = ckdb::keyGetUnescapedNameSize (key);
+
+		// cascading keys are looked up with cascading lookups
+		bool below = name[0] != KEY_NS_CASCADING && (cascading || name[0] == parentName[0]);
+		below = below && (root || (size >= parentSize && memcmp (name + 1, parentName + 1, parentSize - 1) == 0));
+		if (!below)
+		{
+			if (strict) return false;
+			continue;
 		}
+
+		size_t offset = root ? 2 : parentSize;
+		if (size == parentSize) offset = size;
+		keys.push_back ({ key, cascading ? name[0] : 0, name + offset, size - offset });
 	}
+	return true;
 }
 
+/**
+ * Same as rebaseKey, but only replaces the prefix of the name instead of parsing the rebased name.
+ */
+static Key rebaseRelative (const RelativeKey & key, const Key & oldParent, const Key & newParent)
+{
+	Key result = ckdb::keyDup (key.key, KEY_CP_ALL);
+	if (key.ns == 0)
+	{
+		ckdb::keyReplacePrefix (*result, *oldParent, *newParent);
+		return result;
+	}
+
+	Key actualOldParent = oldParent.dup (KEY_CP_NAME);
+	Key actualNewParent = newParent.dup (KEY_CP_NAME);
+	actualOldParent.setNamespace (static_cast<ElektraNamespace> (key.ns));
+	actualNewParent.setNamespace (static_cast<ElektraNamespace> (key.ns));
+	ckdb::keyReplacePrefix (*result, *actualOldParent, *actualNewParent);
+	return result;
+}
+
+bool ThreeWayMerge::joinConflicts (const MergeTask & task, MergeResult & mergeResult)
+{
+	bool cascading = task.ourParent.getNamespace () == ElektraNamespace::CASCADING;
+	for (const Key * parent : { &task.baseParent, &task.theirParent, &task.mergeRoot })
+	{
+		// rebasing between cascading and other parents depends on the namespace of each key
+		if ((parent->getNamespace () == ElektraNamespace::CASCADING) != cascading) return false;
+	}
+
+	std::vector<RelativeKey> ours, theirs, base;
+	if (!collectRelative (task.ours, task.ourParent, cascading, true, ours)) return false;
+	if (!collectRelative (task.theirs, task.theirParent, cascading, true, theirs)) return false;
+	collectRelative (task.base, task.baseParent, cascading, false, base);
+
+	bool keepOurs = task.ourParent.getName () == task.mergeRoot.getName ();
+	bool keepTheirs = task.theirParent.getName () == task.mergeRoot.getName ();
+
+	size_t o = 0, t = 0, b = 0;
+	while (o < ours.size () || t < theirs.size ())
+	{
+		int cmp = o == ours.size () ? 1 : t == theirs.size () ? -1 : compareRelative (ours[o], theirs[t]);
+		const RelativeKey & current = cmp <= 0 ? ours[o] : theirs[t];
+		while (b < base.size () && compareRelative (base[b], current) < 0)
+			++b;
+
+		Key our (cmp <= 0 ? ours[o].key : nullptr);
+		Key their (cmp >= 0 ? theirs[t].key : nullptr);
+		Key baseKey (b < base.size () && compareRelative (base[b], current) == 0 ? base[b].key : nullptr);
+
+		// the same order of operations per key as detecting conflicts of ours first and theirs afterwards
+		if (our)
+		{
+			Key mergeKey = rebaseRelative (ours[o], task.ourParent, task.mergeRoot);
+			detectConflict (our, their, baseKey, mergeKey, keepOurs, mergeResult, false);
+		}
+		if (their)
+		{
+			Key mergeKey = rebaseRelative (theirs[t], task.theirParent, task.mergeRoot);
+			detectConflict (their, our, baseKey, mergeKey, keepTheirs, mergeResult, true);
+		}
+
+		if (cmp <= 0) ++o;
+		if (cmp >= 0) ++t;
+	}
+	return true;
+}
 
 MergeResult ThreeWayMerge::mergeKeySet (const MergeTask & task)
 {
 
 	MergeResult result;
-	detectConflicts (task, result);
-	detectConflicts (task.reverse (), result, true);
+	if (!joinConflicts (task, result))
+	{
+		detectConflicts (task, result);
+		detectConflicts (task.reverse (), result, true);
+	}
 
 	if (!result.hasConflicts ()) return result;
 
+	// only consult the strategies that can resolve the type of a conflict
+	const int operations = CONFLICT_SAME + 1;
+	std::vector<MergeConflictStrategy *> dispatch[operations][operations];
+	for (int our = 0; our < operations; ++our)
+	{
+		for (int their = 0; their < operations; ++their)
+		{
+			for (auto & elem : strategies)
+			{
+				if (elem->canResolve (ConflictOperation (our), ConflictOperation (their)))
+				{
+					dispatch[our][their].push_back (elem);
+				}
+			}
+		}
+	}
 
 	// TODO: test this behaviour (would probably need mocks)
 	KeySet conflicts = result.getConflictSet ();
 
+	// resolved keys are collected separately and merged into the other merged keys at once
+	KeySet resolvedKeys;
+	MergeResult resolution (conflicts, resolvedKeys);
+
 	for (Key current : conflicts)
 	{
-		for (auto & elem : strategies)
+		ConflictOperation our = MergeConflictOperation::getFromName (current.getMeta<string> ("conflict/operation/our"));
+		ConflictOperation their = MergeConflictOperation::getFromName (current.getMeta<string> ("conflict/operation/their"));
+
+		for (auto & elem : dispatch[our][their])
 		{
-			(elem)->resolveConflict (task, current, result);
+			(elem)->resolveConflict (task, current, resolution);
 
-			if (!result.isConflict (current)) break;
+			if (!resolution.isConflict (current)) break;
 		}
 	}
 
+	result.applyResolution (resolution);
 	return result;
 }
 
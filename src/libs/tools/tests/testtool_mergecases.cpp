@@ -182,3 +182,29 @@ TEST_F (ThreeWayMergeTest, SameMetaKeyModifyConflict)
 	EXPECT_EQ (4, merged.size ());
 	compareAllExceptKey1 (merged);
 }
+
+TEST_F (ThreeWayMergeTest, InterleavedChangesConflict)
+{
+	ours.append (Key ("user:/parento/config/key0", KEY_VALUE, "value0", KEY_END));
+	theirs.append (Key ("user:/parentt/config/key2/below", KEY_VALUE, "below", KEY_END));
+	ours.lookup ("user:/parento/config/key3", KDB_O_POP);
+	theirs.lookup ("user:/parentt/config/key4").setString ("modifiedvalue");
+	ours.append (Key ("user:/parento/config/key5", KEY_VALUE, "value5", KEY_END));
+	base.append (Key ("user:/unrelated/config/key5", KEY_VALUE, "unrelated", KEY_END));
+
+	MergeResult result = merger.mergeKeySet (base, ours, theirs, mergeParent);
+
+	ASSERT_TRUE (result.hasConflicts ()) << "No conflict detected although conflicts should exist";
+	KeySet conflicts = result.getConflictSet ();
+	ASSERT_EQ (5, conflicts.size ());
+	testConflictMeta (conflicts.lookup ("user:/parentm/config/key0"), CONFLICT_ADD, CONFLICT_SAME);
+	testConflictMeta (conflicts.lookup ("user:/parentm/config/key2/below"), CONFLICT_SAME, CONFLICT_ADD);
+	testConflictMeta (conflicts.lookup ("user:/parentm/config/key3"), CONFLICT_DELETE, CONFLICT_SAME);
+	testConflictMeta (conflicts.lookup ("user:/parentm/config/key4"), CONFLICT_SAME, CONFLICT_MODIFY);
+	testConflictMeta (conflicts.lookup ("user:/parentm/config/key5"), CONFLICT_ADD, CONFLICT_SAME);
+
+	KeySet merged = result.getMergedKeys ();
+	EXPECT_EQ (3, merged.size ());
+	compareKeys (mk1, merged.lookup (mk1));
+	compareKeys (mk2, merged.lookup (mk2));
+}
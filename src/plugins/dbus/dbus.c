@@ -50,7 +50,10 @@ int elektraDbusGet (Plugin * handle, KeySet * returned, Key * parentKey)
 		return 1; /* success */
 	}
 
-	// remember all keys
+	// the KDB computes the changeset for us
+	if (elektraPluginRequestChangeSet (handle)) return 1;
+
+	// otherwise remember all keys
 	ElektraDbusPluginData * pluginData = elektraPluginGetData (handle);
 	ELEKTRA_NOT_NULL (pluginData);
 
@@ -61,6 +64,44 @@ int elektraDbusGet (Plugin * handle, KeySet * returned, Key * parentKey)
 	return 1; /* success */
 }
 
+/**
+ * @internal
+ * Compute the changeset from the keys remembered in elektraDbusGet.
+ *
+ * Only used if the plugin was not opened by the KDB, which
+ * otherwise computes the changeset once for all plugins.
+ *
+ * @param oldKeys     keys remembered by elektraDbusGet
+ * @param returned    keys passed to elektraDbusSet
+ * @param addedKeys   will be set to the added keys
+ * @param changedKeys will be set to the changed keys
+ * @param removedKeys will be set to the removed keys
+ */
+static void computeChangeSet (KeySet * oldKeys, KeySet * returned, KeySet ** addedKeys, KeySet ** changedKeys, KeySet ** removedKeys)
+{
+	*addedKeys = ksDup (returned);
+	*changedKeys = ksNew (0, KS_END);
+	*removedKeys = ksNew (0, KS_END);
+
+	for (elektraCursor it = 0; it < ksGetSize (oldKeys); ++it)
+	{
+		Key * k = ksAtCursor (oldKeys, it);
+		Key * p = ksLookup (*addedKeys, k, KDB_O_POP);
+		// Note: keyDel not needed, because at least two references exist
+		if (p)
+		{
+			if (keyNeedSync (p))
+			{
+				ksAppendKey (*changedKeys, p);
+			}
+		}
+		else
+		{
+			ksAppendKey (*removedKeys, k);
+		}
+	}
+}
+
 /**
  * @internal
  * Announce multiple keys with same signal name.
@@ -88,30 +129,13 @@ int elektraDbusSet (Plugin * handle, KeySet * returned, Key * parentKey)
 	ElektraDbusPluginData * pluginData = elektraPluginGetData (handle);
 	ELEKTRA_NOT_NULL (pluginData);
 
-	// because elektraLogchangeGet will always be executed before elektraLogchangeSet
-	// we know that oldKeys must exist here!
-	KeySet * oldKeys = pluginData->keys;
-
-	KeySet * addedKeys = ksDup (returned);
-	KeySet * changedKeys = ksNew (0, KS_END);
-	KeySet * removedKeys = ksNew (0, KS_END);
-
-	for (elektraCursor it = 0; it < ksGetSize (oldKeys); ++it)
+	KeySet * addedKeys;
+	KeySet * changedKeys;
+	KeySet * removedKeys;
+	int ownChangeSet = !elektraPluginGetChangeSet (handle, &addedKeys, &changedKeys, &removedKeys);
+	if (ownChangeSet)
 	{
-		Key * k = ksAtCursor (oldKeys, it);
-		Key * p = ksLookup (addedKeys, k, KDB_O_POP);
-		// Note: keyDel not needed, because at least two references exist
-		if (p)
-		{
-			if (keyNeedSync (p))
-			{
-				ksAppendKey (changedKeys, p);
-			}
-		}
-		else
-		{
-			ksAppendKey (removedKeys, k);
-		}
+		computeChangeSet (pluginData->keys, returned, &addedKeys, &changedKeys, &removedKeys);
 	}
 
 	Key * resolvedParentKey = parentKey;
@@ -149,14 +173,16 @@ int elektraDbusSet (Plugin * handle, KeySet * returned, Key * parentKey)
 		}
 	}
 
+	if (ownChangeSet)
+	{
+		ksDel (addedKeys);
+		ksDel (changedKeys);
+		ksDel (removedKeys);
 
-	ksDel (oldKeys);
-	ksDel (addedKeys);
-	ksDel (changedKeys);
-	ksDel (removedKeys);
-
-	// for next invocation of elektraLogchangeSet, remember our current keyset
-	pluginData->keys = ksDup (returned);
+		// for next invocation of elektraDbusSet, remember our current keyset
+		if (pluginData->keys) ksDel (pluginData->keys);
+		pluginData->keys = ksDup (returned);
+	}
 
 	return 1; /* success */
 }
@@ -11,7 +11,9 @@
 
 #include <kdb.h>
 #include <kdbassert.h>
+#include <kdbconfig.h>
 #include <kdbhelper.h>
+#include <kdbio.h>
 #include <kdblogger.h>
 #include <kdbnotificationinternal.h>
 
@@ -19,6 +21,12 @@
 #include <errno.h>  // errno
 #include <stdlib.h> // strto* functions
 
+#ifdef HAVE_CLOCK_GETTIME
+#include <time.h> // clock_gettime()
+#else
+#include <sys/time.h> // gettimeofday()
+#endif
+
 /**
  * Structure for registered key variable pairs
  * @internal
@@ -45,6 +53,14 @@ struct _PluginState
 	KeyRegistration * last;
 	ElektraNotificationConversionErrorCallback conversionErrorCallback;
 	void * conversionErrorCallbackContext;
+
+	// delayed updates, only used if an I/O binding is available
+	unsigned int debounce;
+	unsigned int minReloadInterval;
+	Key * pendingUpdate;
+	ElektraNotificationCallbackContext * pendingContext;
+	ElektraIoTimerOperation * reloadTimer;
+	unsigned long long lastReload;
 };
 typedef struct _PluginState PluginState;
 
@@ -123,11 +139,168 @@ static int checkKeyIsBelowOrSame (Key * key, Key * check)
 	return result;
 }
 
+/**
+ * @internal
+ * Widen the key passed to kdbGet so that it is the same as or above a key.
+ *
+ * @param updateKey key passed to kdbGet or NULL if there is none yet
+ * @param key       key that needs to be updated
+ * @return          the widened update key
+ */
+static Key * widenUpdateKey (Key * updateKey, Key * key)
+{
+	if (updateKey == NULL)
+	{
+		return keyDup (key, KEY_CP_NAME);
+	}
+
+	if (keyGetNamespace (updateKey) != keyGetNamespace (key))
+	{
+		keySetNamespace (updateKey, KEY_NS_CASCADING);
+	}
+	// remove base names until updateKey is the common parent
+	while (keyIsBelowOrSame (updateKey, key) != 1)
+	{
+		if (keySetBaseName (updateKey, NULL) < 0) break;
+	}
+	return updateKey;
+}
+
+/**
+ * @internal
+ * Get the current time of a monotonic clock.
+ *
+ * @return time in milliseconds
+ */
+static unsigned long long getMilliseconds (void)
+{
+#ifdef HAVE_CLOCK_GETTIME
+	struct timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return (unsigned long long) now.tv_sec * 1000ULL + now.tv_nsec / 1000000;
+#else
+	struct timeval now;
+	gettimeofday (&now, NULL);
+	return (unsigned long long) now.tv_sec * 1000ULL + now.tv_usec / 1000;
+#endif
+}
+
+/**
+ * @internal
+ * Get the I/O binding from the global keyset.
+ *
+ * @param  plugin plugin handle
+ * @return        I/O binding or NULL if the application did not set one
+ */
+static ElektraIoInterface * getIoBinding (Plugin * plugin)
+{
+	KeySet * global = elektraPluginGetGlobalKeySet (plugin);
+	if (global == NULL)
+	{
+		return NULL;
+	}
+	Key * ioBindingKey = ksLookupByName (global, "system:/elektra/io/binding", 0);
+	const void * bindingPtr = keyValue (ioBindingKey);
+	return bindingPtr == NULL ? NULL : *(ElektraIoInterface **) bindingPtr;
+}
+
+/**
+ * @internal
+ * Call kdbGet for the given key.
+ *
+ * @param plugin    plugin handle
+ * @param context   callback context
+ * @param updateKey key passed to kdbGet, will be deleted
+ */
+static void reload (Plugin * plugin, ElektraNotificationCallbackContext * context, Key * updateKey)
+{
+	PluginState * pluginState = elektraPluginGetData (plugin);
+
+	KeySet * global = elektraPluginGetGlobalKeySet (plugin);
+	Key * kdbKey = ksLookupByName (global, "system:/elektra/kdb", 0);
+	const void * kdbPtr = keyValue (kdbKey);
+	KDB * kdb = kdbPtr == NULL ? NULL : *(KDB **) keyValue (kdbKey);
+	context->kdbUpdate (kdb, updateKey);
+	keyDel (updateKey);
+
+	pluginState->lastReload = getMilliseconds ();
+}
+
+/**
+ * @internal
+ * Called when the reload timer fires.
+ * Calls kdbGet once for all changes collected since the timer was started.
+ *
+ * @param timerOp reload timer
+ */
+static void reloadTimerCallback (ElektraIoTimerOperation * timerOp)
+{
+	Plugin * plugin = elektraIoTimerGetData (timerOp);
+	PluginState * pluginState = elektraPluginGetData (plugin);
+	ELEKTRA_NOT_NULL (pluginState);
+
+	elektraIoTimerSetEnabled (timerOp, 0);
+	elektraIoBindingUpdateTimer (timerOp);
+
+	if (pluginState->pendingUpdate != NULL)
+	{
+		Key * updateKey = pluginState->pendingUpdate;
+		pluginState->pendingUpdate = NULL;
+		reload (plugin, pluginState->pendingContext, updateKey);
+	}
+}
+
+/**
+ * @internal
+ * (Re)start the reload timer.
+ *
+ * The reload happens after no change was received for `debounce` milliseconds,
+ * but not earlier than `minReloadInterval` milliseconds after the last reload.
+ *
+ * @param plugin  plugin handle
+ * @param binding I/O binding
+ */
+static void scheduleReload (Plugin * plugin, ElektraIoInterface * binding)
+{
+	PluginState * pluginState = elektraPluginGetData (plugin);
+
+	unsigned long long now = getMilliseconds ();
+	unsigned long long delay = pluginState->debounce;
+	if (pluginState->lastReload != 0 && pluginState->lastReload + pluginState->minReloadInterval > now + delay)
+	{
+		delay = pluginState->lastReload + pluginState->minReloadInterval - now;
+	}
+
+	if (pluginState->reloadTimer == NULL)
+	{
+		pluginState->reloadTimer = elektraIoNewTimerOperation (delay, 1, reloadTimerCallback, plugin);
+		if (pluginState->reloadTimer == NULL || !elektraIoBindingAddTimer (binding, pluginState->reloadTimer))
+		{
+			ELEKTRA_LOG_WARNING ("could not add reload timer, reloading immediately");
+			elektraFree (pluginState->reloadTimer);
+			pluginState->reloadTimer = NULL;
+			Key * updateKey = pluginState->pendingUpdate;
+			pluginState->pendingUpdate = NULL;
+			reload (plugin, pluginState->pendingContext, updateKey);
+		}
+	}
+	else
+	{
+		elektraIoTimerSetInterval (pluginState->reloadTimer, delay);
+		elektraIoTimerSetEnabled (pluginState->reloadTimer, 1);
+		elektraIoBindingUpdateTimer (pluginState->reloadTimer);
+	}
+}
+
 /**
  * @internal
  * Call kdbGet if there are registrations below the changed key.
  *
  * On kdbGet this plugin implicitly updates registered keys.
+ * kdbGet is called for the common parent of the affected registrations,
+ * so a change high up in the hierarchy does not reload unrelated keys.
+ * If `debounce` or `minReloadInterval` are configured and an I/O binding is available,
+ * changes are collected and kdbGet is called once by a timer.
  *
  * @see ElektraNotificationChangeCallback (kdbnotificationinternal.h)
  * @param key     changed key
@@ -143,32 +316,45 @@ void elektraInternalnotificationDoUpdate (Key * changedKey, ElektraNotificationC
 	PluginState * pluginState = elektraPluginGetData (plugin);
 	ELEKTRA_NOT_NULL (pluginState);
 
-	int kdbChanged = 0;
+	Key * updateKey = NULL;
 	KeyRegistration * keyRegistration = pluginState->head;
 	while (keyRegistration != NULL)
 	{
 		Key * registeredKey = keyNew (keyRegistration->name, KEY_END);
 
-		// check if registered key is same or below changed/commit key
-		kdbChanged |= checkKeyIsBelowOrSame (changedKey, registeredKey);
-
-		if (keyRegistration->sameOrBelow)
+		if (checkKeyIsBelowOrSame (changedKey, registeredKey))
 		{
-			// check if registered key is also above changed/commit key
-			kdbChanged |= checkKeyIsBelowOrSame (registeredKey, changedKey);
+			// registered key is same or below changed/commit key
+			updateKey = widenUpdateKey (updateKey, registeredKey);
+		}
+		else if (keyRegistration->sameOrBelow && checkKeyIsBelowOrSame (registeredKey, changedKey))
+		{
+			// registered key is also above changed/commit key
+			updateKey = widenUpdateKey (updateKey, changedKey);
 		}
 
 		keyRegistration = keyRegistration->next;
 		keyDel (registeredKey);
 	}
 
-	if (kdbChanged)
+	if (updateKey == NULL)
+	{
+		keyDel (changedKey);
+		return;
+	}
+
+	ElektraIoInterface * binding = getIoBinding (plugin);
+	if (binding == NULL || (pluginState->debounce == 0 && pluginState->minReloadInterval == 0))
+	{
+		reload (plugin, context, updateKey);
+	}
+	else
 	{
-		KeySet * global = elektraPluginGetGlobalKeySet (plugin);
-		Key * kdbKey = ksLookupByName (global, "system:/elektra/kdb", 0);
-		const void * kdbPtr = keyValue (kdbKey);
-		KDB * kdb = kdbPtr == NULL ? NULL : *(KDB **) keyValue (kdbKey);
-		context->kdbUpdate (kdb, changedKey);
+		// collect changes until the reload timer fires
+		pluginState->pendingUpdate = widenUpdateKey (pluginState->pendingUpdate, updateKey);
+		pluginState->pendingContext = context;
+		keyDel (updateKey);
+		scheduleReload (plugin, binding);
 	}
 	keyDel (changedKey);
 }
@@ -585,6 +771,33 @@ int elektraInternalnotificationSet (Plugin * handle, KeySet * returned, Key * pa
 	return 1;
 }
 
+/**
+ * @internal
+ * Read a duration from the plugin configuration.
+ *
+ * @param  config plugin configuration
+ * @param  name   name of configuration key
+ * @return        duration in milliseconds or 0 if not set or invalid
+ */
+static unsigned int getMillisecondsConfig (KeySet * config, const char * name)
+{
+	Key * key = ksLookupByName (config, name, 0);
+	if (key == NULL)
+	{
+		return 0;
+	}
+
+	char * end;
+	errno = 0;
+	unsigned long value = strtoul (keyString (key), &end, 10);
+	if (*end != '\0' || errno != 0 || value > UINT_MAX || keyString (key)[0] == '-')
+	{
+		ELEKTRA_LOG_WARNING ("invalid value for %s: %s", name, keyString (key));
+		return 0;
+	}
+	return (unsigned int) value;
+}
+
 /**
  * Initialize data plugin data structures.
  * Part of elektra plugin contract.
@@ -612,9 +825,16 @@ int elektraInternalnotificationOpen (Plugin * handle, Key * parentKey ELEKTRA_UN
 		pluginState->last = NULL;
 		pluginState->conversionErrorCallback = NULL;
 		pluginState->conversionErrorCallbackContext = NULL;
+		pluginState->pendingUpdate = NULL;
+		pluginState->pendingContext = NULL;
+		pluginState->reloadTimer = NULL;
+		pluginState->lastReload = 0;
 	}
 
 	KeySet * config = elektraPluginGetConfig (handle);
+
+	pluginState->debounce = getMillisecondsConfig (config, "/debounce");
+	pluginState->minReloadInterval = getMillisecondsConfig (config, "/minReloadInterval");
 	KeySet * global = elektraPluginGetGlobalKeySet (handle);
 
 	if (global != NULL)
@@ -649,6 +869,14 @@ int elektraInternalnotificationClose (Plugin * handle, Key * parentKey ELEKTRA_U
 	PluginState * pluginState = elektraPluginGetData (handle);
 	if (pluginState != NULL)
 	{
+		// Stop delayed updates, pending changes are discarded
+		if (pluginState->reloadTimer != NULL)
+		{
+			elektraIoBindingRemoveTimer (pluginState->reloadTimer);
+			elektraFree (pluginState->reloadTimer);
+		}
+		keyDel (pluginState->pendingUpdate);
+
 		// Free registrations
 		KeyRegistration * current = pluginState->head;
 		KeyRegistration * next;
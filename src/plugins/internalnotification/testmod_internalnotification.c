@@ -12,6 +12,7 @@
 #include <string.h>
 
 #include <kdbconfig.h>
+#include <kdbio.h>
 #include <kdbmacros.h>
 #include <kdbnotificationinternal.h>
 #include <kdbtypes.h>
@@ -26,6 +27,10 @@ char * callback_keyValue;
 char * callback_keyName;
 
 int doUpdate_callback_called;
+int doUpdate_callback_count;
+char doUpdate_callback_keyName[128];
+
+ElektraIoTimerOperation * test_timer;
 
 #define CALLBACK_CONTEXT_MAGIC_NUMBER ((void *) 1234)
 
@@ -430,9 +435,11 @@ static void test_callbackCalledWithChangeDetection (void)
 	PLUGIN_CLOSE ();
 }
 
-static void test_doUpdate_callback (KDB * kdb ELEKTRA_UNUSED, Key * changedKey ELEKTRA_UNUSED)
+static void test_doUpdate_callback (KDB * kdb ELEKTRA_UNUSED, Key * changedKey)
 {
 	doUpdate_callback_called = 1;
+	doUpdate_callback_count++;
+	strncpy (doUpdate_callback_keyName, keyName (changedKey), sizeof (doUpdate_callback_keyName) - 1);
 }
 
 static void test_doUpdateShouldUpdateKey (void)
@@ -570,6 +577,240 @@ static void test_doUpdateShouldNotUpdateUnregisteredKey (void)
 	PLUGIN_CLOSE ();
 }
 
+static void test_doUpdateShouldNarrowToRegisteredKeys (void)
+{
+	printf ("test doUpdate should only update registered keys below changed key\n");
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("internalnotification");
+
+	Key * registeredKey = keyNew ("user:/test/internalnotification/a/value", KEY_END);
+	succeed_if (internalnotificationRegisterCallback (plugin, registeredKey, test_callback, NULL) == 1,
+		    "call to elektraInternalnotificationRegisterCallback was not successful");
+
+	ElektraNotificationCallbackContext * context = elektraMalloc (sizeof *context);
+	context->kdbUpdate = test_doUpdate_callback;
+	context->notificationPlugin = plugin;
+
+	doUpdate_callback_called = 0;
+	elektraInternalnotificationDoUpdate (keyNew ("user:/test", KEY_END), context);
+	succeed_if (doUpdate_callback_called, "did not call callback for registered key");
+	succeed_if_same_string (doUpdate_callback_keyName, "user:/test/internalnotification/a/value");
+
+	Key * otherKey = keyNew ("user:/test/internalnotification/a/other/value", KEY_END);
+	succeed_if (internalnotificationRegisterCallback (plugin, otherKey, test_callback, NULL) == 1,
+		    "call to elektraInternalnotificationRegisterCallback was not successful");
+	Key * unrelatedKey = keyNew ("user:/unrelated", KEY_END);
+	succeed_if (internalnotificationRegisterCallback (plugin, unrelatedKey, test_callback, NULL) == 1,
+		    "call to elektraInternalnotificationRegisterCallback was not successful");
+
+	doUpdate_callback_called = 0;
+	elektraInternalnotificationDoUpdate (keyNew ("user:/test", KEY_END), context);
+	succeed_if (doUpdate_callback_called, "did not call callback for registered keys");
+	succeed_if_same_string (doUpdate_callback_keyName, "user:/test/internalnotification/a");
+
+	Key * cascadingKey = keyNew ("/test/internalnotification/b", KEY_END);
+	succeed_if (internalnotificationRegisterCallback (plugin, cascadingKey, test_callback, NULL) == 1,
+		    "call to elektraInternalnotificationRegisterCallback was not successful");
+
+	doUpdate_callback_called = 0;
+	elektraInternalnotificationDoUpdate (keyNew ("user:/test", KEY_END), context);
+	succeed_if (doUpdate_callback_called, "did not call callback for registered keys");
+	succeed_if_same_string (doUpdate_callback_keyName, "/test/internalnotification");
+
+	doUpdate_callback_called = 0;
+	elektraInternalnotificationDoUpdate (keyNew ("user:/", KEY_END), context);
+	succeed_if (doUpdate_callback_called, "did not call callback for registered keys");
+	succeed_if_same_string (doUpdate_callback_keyName, "/");
+
+	elektraFree (context);
+	keyDel (registeredKey);
+	keyDel (otherKey);
+	keyDel (unrelatedKey);
+	keyDel (cascadingKey);
+	PLUGIN_CLOSE ();
+}
+
+static int test_bindingFd (ElektraIoFdOperation * fdOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int test_bindingAddFd (ElektraIoInterface * binding ELEKTRA_UNUSED, ElektraIoFdOperation * fdOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int test_bindingAddTimer (ElektraIoInterface * binding ELEKTRA_UNUSED, ElektraIoTimerOperation * timerOp)
+{
+	test_timer = timerOp;
+	return 1;
+}
+
+static int test_bindingUpdateTimer (ElektraIoTimerOperation * timerOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int test_bindingRemoveTimer (ElektraIoTimerOperation * timerOp ELEKTRA_UNUSED)
+{
+	test_timer = NULL;
+	return 1;
+}
+
+static int test_bindingIdle (ElektraIoIdleOperation * idleOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int test_bindingAddIdle (ElektraIoInterface * binding ELEKTRA_UNUSED, ElektraIoIdleOperation * idleOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int test_bindingCleanup (ElektraIoInterface * binding)
+{
+	elektraFree (binding);
+	return 1;
+}
+
+/**
+ * Create I/O binding that only remembers the last added timer, which is fired by the test.
+ * @internal
+ *
+ * @return global keyset containing the binding
+ */
+static KeySet * createGlobalWithIoBinding (void)
+{
+	ElektraIoInterface * binding =
+		elektraIoNewBinding (test_bindingAddFd, test_bindingFd, test_bindingFd, test_bindingAddTimer, test_bindingUpdateTimer,
+				     test_bindingRemoveTimer, test_bindingAddIdle, test_bindingIdle, test_bindingIdle, test_bindingCleanup);
+	return ksNew (1, keyNew ("system:/elektra/io/binding", KEY_BINARY, KEY_SIZE, sizeof (binding), KEY_VALUE, &binding, KEY_END),
+		      KS_END);
+}
+
+static void deleteGlobalWithIoBinding (KeySet * global)
+{
+	elektraIoBindingCleanup (*(ElektraIoInterface **) keyValue (ksLookupByName (global, "system:/elektra/io/binding", 0)));
+	ksDel (global);
+}
+
+static void test_doUpdateShouldDebounce (void)
+{
+	printf ("test doUpdate should reload once for a burst of changes\n");
+
+	KeySet * conf = ksNew (1, keyNew ("/debounce", KEY_VALUE, "100", KEY_END), KS_END);
+	PLUGIN_OPEN ("internalnotification");
+	KeySet * global = createGlobalWithIoBinding ();
+	plugin->global = global;
+
+	Key * registeredKey = keyNew ("user:/test/internalnotification/value", KEY_END);
+	succeed_if (internalnotificationRegisterCallback (plugin, registeredKey, test_callback, NULL) == 1,
+		    "call to elektraInternalnotificationRegisterCallback was not successful");
+	Key * otherKey = keyNew ("user:/test/internalnotification/other", KEY_END);
+	succeed_if (internalnotificationRegisterCallback (plugin, otherKey, test_callback, NULL) == 1,
+		    "call to elektraInternalnotificationRegisterCallback was not successful");
+
+	ElektraNotificationCallbackContext * context = elektraMalloc (sizeof *context);
+	context->kdbUpdate = test_doUpdate_callback;
+	context->notificationPlugin = plugin;
+
+	test_timer = NULL;
+	doUpdate_callback_count = 0;
+	for (int i = 0; i < 50; ++i)
+	{
+		elektraInternalnotificationDoUpdate (keyNew (i % 2 ? keyName (registeredKey) : keyName (otherKey), KEY_END), context);
+	}
+	succeed_if (doUpdate_callback_count == 0, "did not wait for end of burst");
+	exit_if_fail (test_timer != NULL, "reload timer was not added");
+	succeed_if (elektraIoTimerIsEnabled (test_timer), "reload timer was not enabled");
+	succeed_if (elektraIoTimerGetInterval (test_timer) == 100, "wrong debounce interval");
+
+	elektraIoTimerGetCallback (test_timer) (test_timer);
+	succeed_if (doUpdate_callback_count == 1, "did not reload exactly once for burst");
+	succeed_if_same_string (doUpdate_callback_keyName, "user:/test/internalnotification");
+	succeed_if (!elektraIoTimerIsEnabled (test_timer), "reload timer was not disabled");
+
+	elektraInternalnotificationDoUpdate (keyNew (keyName (registeredKey), KEY_END), context);
+	succeed_if (doUpdate_callback_count == 1, "did not wait for second burst");
+	succeed_if (elektraIoTimerIsEnabled (test_timer), "reload timer was not enabled again");
+	elektraIoTimerGetCallback (test_timer) (test_timer);
+	succeed_if (doUpdate_callback_count == 2, "did not reload after second burst");
+	succeed_if_same_string (doUpdate_callback_keyName, "user:/test/internalnotification/value");
+
+	elektraFree (context);
+	keyDel (registeredKey);
+	keyDel (otherKey);
+	PLUGIN_CLOSE ();
+	succeed_if (test_timer == NULL, "reload timer was not removed");
+	deleteGlobalWithIoBinding (global);
+}
+
+static void test_doUpdateShouldLimitReloadRate (void)
+{
+	printf ("test doUpdate should not reload more often than configured\n");
+
+	KeySet * conf = ksNew (1, keyNew ("/minReloadInterval", KEY_VALUE, "60000", KEY_END), KS_END);
+	PLUGIN_OPEN ("internalnotification");
+	KeySet * global = createGlobalWithIoBinding ();
+	plugin->global = global;
+
+	Key * registeredKey = keyNew ("user:/test/internalnotification/value", KEY_END);
+	succeed_if (internalnotificationRegisterCallback (plugin, registeredKey, test_callback, NULL) == 1,
+		    "call to elektraInternalnotificationRegisterCallback was not successful");
+
+	ElektraNotificationCallbackContext * context = elektraMalloc (sizeof *context);
+	context->kdbUpdate = test_doUpdate_callback;
+	context->notificationPlugin = plugin;
+
+	test_timer = NULL;
+	doUpdate_callback_count = 0;
+	elektraInternalnotificationDoUpdate (keyNew (keyName (registeredKey), KEY_END), context);
+	exit_if_fail (test_timer != NULL, "reload timer was not added");
+	succeed_if (elektraIoTimerGetInterval (test_timer) == 0, "first reload should not be delayed");
+	elektraIoTimerGetCallback (test_timer) (test_timer);
+	succeed_if (doUpdate_callback_count == 1, "did not reload");
+
+	for (int i = 0; i < 10; ++i)
+	{
+		elektraInternalnotificationDoUpdate (keyNew (keyName (registeredKey), KEY_END), context);
+	}
+	succeed_if (doUpdate_callback_count == 1, "reloaded before minimum interval");
+	succeed_if (elektraIoTimerGetInterval (test_timer) > 50000, "reload was not delayed until end of minimum interval");
+	elektraIoTimerGetCallback (test_timer) (test_timer);
+	succeed_if (doUpdate_callback_count == 2, "did not reload exactly once after minimum interval");
+
+	elektraFree (context);
+	keyDel (registeredKey);
+	PLUGIN_CLOSE ();
+	deleteGlobalWithIoBinding (global);
+}
+
+static void test_doUpdateWithoutIoBinding (void)
+{
+	printf ("test doUpdate should reload immediately without I/O binding\n");
+
+	KeySet * conf = ksNew (1, keyNew ("/debounce", KEY_VALUE, "100", KEY_END), KS_END);
+	PLUGIN_OPEN ("internalnotification");
+
+	Key * registeredKey = keyNew ("user:/test/internalnotification/value", KEY_END);
+	succeed_if (internalnotificationRegisterCallback (plugin, registeredKey, test_callback, NULL) == 1,
+		    "call to elektraInternalnotificationRegisterCallback was not successful");
+
+	ElektraNotificationCallbackContext * context = elektraMalloc (sizeof *context);
+	context->kdbUpdate = test_doUpdate_callback;
+	context->notificationPlugin = plugin;
+
+	doUpdate_callback_count = 0;
+	elektraInternalnotificationDoUpdate (keyNew (keyName (registeredKey), KEY_END), context);
+	elektraInternalnotificationDoUpdate (keyNew (keyName (registeredKey), KEY_END), context);
+	succeed_if (doUpdate_callback_count == 2, "did not reload immediately");
+
+	elektraFree (context);
+	keyDel (registeredKey);
+	PLUGIN_CLOSE ();
+}
+
 // Generate test cases for C built-in types
 #define TYPE unsigned int
 #define TYPE_NAME UnsignedInt
@@ -775,6 +1016,10 @@ int main (int argc, char ** argv)
 	test_doUpdateShouldNotUpdateKeyAbove ();
 	test_doUpdateShouldNotUpdateUnregisteredKey ();
 	test_doUpdateShouldUpdateKeyAbove ();
+	test_doUpdateShouldNarrowToRegisteredKeys ();
+	test_doUpdateShouldDebounce ();
+	test_doUpdateShouldLimitReloadRate ();
+	test_doUpdateWithoutIoBinding ();
 
 	print_result ("testmod_internalnotification");
 
@@ -44,10 +44,13 @@ int elektraLogchangeGet (Plugin * handle, KeySet * returned, Key * parentKey ELE
 		return 1; /* success */
 	}
 
-	// remember all keys
-	KeySet * ks = (KeySet *) elektraPluginGetData (handle);
-	if (ks) ksDel (ks);
-	elektraPluginSetData (handle, ksDup (returned));
+	// remember all keys, unless the KDB computes the changeset for us
+	if (!elektraPluginRequestChangeSet (handle))
+	{
+		KeySet * ks = (KeySet *) elektraPluginGetData (handle);
+		if (ks) ksDel (ks);
+		elektraPluginSetData (handle, ksDup (returned));
+	}
 
 	if (strncmp (keyString (ksLookupByName (elektraPluginGetConfig (handle), "/log/get", 0)), "1", 1) == 0)
 	{
@@ -61,12 +64,22 @@ int elektraLogchangeGet (Plugin * handle, KeySet * returned, Key * parentKey ELE
 
 int elektraLogchangeSet (Plugin * handle, KeySet * returned, Key * parentKey ELEKTRA_UNUSED)
 {
-	// because elektraLogchangeGet will always be executed before elektraLogchangeSet
-	// we know that oldKeys must exist here!
+	KeySet * addedKeys;
+	KeySet * changedKeys;
+	KeySet * removedKeys;
+	if (elektraPluginGetChangeSet (handle, &addedKeys, &changedKeys, &removedKeys))
+	{
+		logKeys (addedKeys, "added key");
+		logKeys (changedKeys, "changed key");
+		logKeys (removedKeys, "removed key");
+		return 1; /* success */
+	}
+
+	// not opened by the KDB, so elektraLogchangeGet remembered the keys
 	KeySet * oldKeys = (KeySet *) elektraPluginGetData (handle);
-	KeySet * addedKeys = ksDup (returned);
-	KeySet * changedKeys = ksNew (0, KS_END);
-	KeySet * removedKeys = ksNew (0, KS_END);
+	addedKeys = ksDup (returned);
+	changedKeys = ksNew (0, KS_END);
+	removedKeys = ksNew (0, KS_END);
 
 	for (elektraCursor it = 0; it < ksGetSize (oldKeys); ++it)
 	{
@@ -67,6 +67,7 @@
 
 #define STDOUT_FILENAME ("/dev/stdout")
 #define STDIN_FILENAME ("/dev/stdin")
+#define FD_FILENAME_PREFIX ("/dev/fd/")
 
 /** Suppress warnings in cache mode to debug level */
 #define ELEKTRA_MMAP_LOG_WARNING(...)                                                                                                      \
@@ -91,6 +92,9 @@
 /** Defines whether file was written with opmphm data structures. */
 #define MMAP_FLAG_OPMPHM (1 << 2)
 
+/** Defines whether the opmphm data structures were built with wyhash instead of the default hash function. */
+#define MMAP_FLAG_OPMPHM_WYHASH (1 << 3)
+
 /**
  * Internal MmapAddr structure.
  * Used for functions passing around relevant pointers into the mmap region.
@@ -55,7 +55,8 @@ typedef enum
 {
 	MODE_STORAGE = 1,
 	MODE_GLOBALCACHE = 1 << 1,
-	MODE_NONREGULAR_FILE = 1 << 2
+	MODE_NONREGULAR_FILE = 1 << 2,
+	MODE_FILEDESCRIPTOR = 1 << 3
 } PluginMode;
 
 /* -- File handling --------------------------------------------------------------------------------------------------------------------- */
@@ -280,6 +281,9 @@ static void initHeader (MmapHeader * mmapHeader)
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
 	set_bit (mmapHeader->formatFlags, MMAP_FLAG_OPMPHM);
 #endif
+#ifdef ELEKTRA_OPMPHM_WYHASH
+	set_bit (mmapHeader->formatFlags, MMAP_FLAG_OPMPHM_WYHASH);
+#endif
 }
 
 /**
@@ -410,6 +414,9 @@ static void initMagicKeySet (const uintptr_t magicNumber)
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
 	magicKeySet.opmphm = (Opmphm *) ELEKTRA_MMAP_MAGIC_BOM;
 	magicKeySet.opmphmPredictor = 0;
+	magicKeySet.searchIndex = 0;
+	magicKeySet.searchIndexOffset = 0;
+	magicKeySet.searchIndexLookups = 0;
 #endif
 }
 
@@ -544,6 +551,23 @@ static int verifyMagicOpmphmPredictor (OpmphmPredictor * opmphmPredictor)
 	if (!opmphmPredictor) return -1;
 	return memcmp (opmphmPredictor, &magicOpmphmPredictor, sizeof (OpmphmPredictor));
 }
+
+/**
+ * @brief Checks whether the OPMPHM of a file was built with the hash function of this build.
+ *
+ * @param mmapHeader header of the mapped file
+ *
+ * @retval 1 if the stored OPMPHM can be used
+ * @retval 0 if the OPMPHM was built with another hash function
+ */
+static int opmphmHashFunctionMatches (MmapHeader * mmapHeader)
+{
+#ifdef ELEKTRA_OPMPHM_WYHASH
+	return test_bit (mmapHeader->formatFlags, MMAP_FLAG_OPMPHM_WYHASH) != 0;
+#else
+	return test_bit (mmapHeader->formatFlags, MMAP_FLAG_OPMPHM_WYHASH) == 0;
+#endif
+}
 #endif
 
 /**
@@ -977,6 +1001,9 @@ static int copyKeySetToMmap (char * const dest, KeySet * keySet, KeySet * global
 	// We FIRST write the opmphm data. If this is changed, you'll run into alignment problems.
 	// set OPMPHM flag, so file is not readable by builds without OPMPHM
 	set_bit (mmapHeader->formatFlags, MMAP_FLAG_OPMPHM);
+#ifdef ELEKTRA_OPMPHM_WYHASH
+	set_bit (mmapHeader->formatFlags, MMAP_FLAG_OPMPHM_WYHASH);
+#endif
 	if (keySet->opmphm)
 	{
 		mmapAddr.ksPtr->opmphm = (Opmphm *) (dest + OFFSET_OPMPHM);
@@ -1171,6 +1198,37 @@ static void mmapToKeySet (Plugin * handle, char * mappedRegion, KeySet * returne
 	}
 }
 
+/**
+ * @brief Replaces contents of a keyset with copies of the keys from the mapped region.
+ *
+ * Unlike mmapToKeySet() no key points into the mapped region afterwards,
+ * so the region can be unmapped and the file can be overwritten.
+ *
+ * @param mappedRegion pointer to mapped region, holding an already written keyset
+ * @param returned keyset to be replaced by the copied keyset
+ */
+static void copyMmapToKeySet (char * mappedRegion, KeySet * returned)
+{
+	KeySet * keySet = (KeySet *) (mappedRegion + OFFSET_KEYSET);
+	KeySet * copy = ksNew (keySet->size, KS_END);
+
+	for (size_t i = 0; i < keySet->size; ++i)
+	{
+		Key * key = keySet->array[i];
+		Key * dup = keyDup (key, KEY_CP_NAME | KEY_CP_VALUE);
+		// meta keys would be shared by keyDup, so copy them one by one
+		for (size_t j = 0; key->meta && j < key->meta->size; ++j)
+		{
+			Key * meta = key->meta->array[j];
+			keySetMeta (dup, keyName (meta), keyString (meta));
+		}
+		ksAppendKey (copy, dup);
+	}
+
+	ksCopy (returned, copy);
+	ksDel (copy);
+}
+
 /**
  * @brief Updates pointers of a mapped keyset to a new location in memory.
  *
@@ -1367,6 +1425,12 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks,
 		goto error;
 	}
 
+	if (strncmp (keyString (parentKey), FD_FILENAME_PREFIX, sizeof (FD_FILENAME_PREFIX) - 1) == 0)
+	{
+		ELEKTRA_LOG_DEBUG ("MODE_FILEDESCRIPTOR");
+		set_bit (mode, MODE_FILEDESCRIPTOR);
+	}
+
 	struct stat sbuf;
 	if (fstatFile (fd, &sbuf, parentKey, mode) != 1)
 	{
@@ -1467,8 +1531,29 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks,
 		goto error;
 	}
 
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+	if (!opmphmHashFunctionMatches (mmapHeader))
+	{
+		// the region is mapped privately, so the file keeps its OPMPHM for builds with the other hash function
+		ELEKTRA_MMAP_LOG_WARNING ("mmap file written with OPMPHM of another hash function, OPMPHM will be rebuilt");
+		((KeySet *) (mappedRegion + OFFSET_KEYSET))->opmphm = NULL;
+	}
+#endif
+
 	updatePointers (mmapMetaData, mappedRegion);
-	mmapToKeySet (handle, mappedRegion, ks, mode);
+	if (test_bit (mode, MODE_FILEDESCRIPTOR))
+	{
+		// the file descriptor may be overwritten by its owner, so do not keep the mapping
+		copyMmapToKeySet (mappedRegion, ks);
+		if (munmap (mappedRegion, sbuf.st_size) != 0)
+		{
+			ELEKTRA_MMAP_LOG_WARNING ("could not munmap");
+		}
+	}
+	else
+	{
+		mmapToKeySet (handle, mappedRegion, ks, mode);
+	}
 
 	if (close (fd) != 0)
 	{
@@ -1542,7 +1627,9 @@ int ELEKTRA_PLUGIN_FUNCTION (set) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks,
 	}
 	else
 	{
-		if (unlink (keyString (parentKey)) != 0 && errno != ENOENT)
+		// file descriptors are shared with their owner, so they are written in place
+		if (strncmp (keyString (parentKey), FD_FILENAME_PREFIX, sizeof (FD_FILENAME_PREFIX) - 1) != 0 &&
+		    unlink (keyString (parentKey)) != 0 && errno != ENOENT)
 		{
 			ELEKTRA_MMAP_LOG_WARNING ("could not unlink");
 			goto error;
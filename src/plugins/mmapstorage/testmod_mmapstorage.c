@@ -837,6 +837,76 @@ static void test_mmap_opmphm (const char * tmpFile)
 	keyDel (parentKey);
 	PLUGIN_CLOSE ();
 }
+
+static void test_mmap_opmphm_other_hashfunction (const char * tmpFile)
+{
+	Key * parentKey = keyNew (TEST_ROOT_KEY, KEY_VALUE, tmpFile, KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("mmapstorage");
+	KeySet * ks = largeTestKeySet ();
+
+	// store the keyset together with its OPMPHM
+	const char * name = "user:/tests/mmapstorage/dir7/key3";
+	succeed_if (ksLookupByName (ks, name, KDB_O_OPMPHM) != 0, "Key not found.");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == 1, "kdbSet was not successful");
+
+	// pretend the file was written by a build with the other hash function
+	FILE * fp;
+	if ((fp = fopen (tmpFile, "r+")) == 0)
+	{
+		yield_error ("fopen() error");
+	}
+	struct stat sbuf;
+	if (stat (tmpFile, &sbuf) == -1)
+	{
+		yield_error ("stat() error");
+	}
+
+	int fd = fileno (fp);
+	char * mappedRegion = mmap (0, sbuf.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (mappedRegion == MAP_FAILED)
+	{
+		ELEKTRA_LOG_WARNING ("error mapping file %s\nmmapSize: " ELEKTRA_STAT_ST_SIZE_F, tmpFile, sbuf.st_size);
+		yield_error ("mmap() error");
+		return;
+	}
+	if (fp)
+	{
+		fclose (fp);
+	}
+
+	MmapHeader * mmapHeader = (MmapHeader *) mappedRegion;
+	mmapHeader->formatFlags ^= MMAP_FLAG_OPMPHM_WYHASH;
+
+	if (msync ((void *) mappedRegion, sbuf.st_size, MS_SYNC) != 0)
+	{
+		yield_error ("msync() error");
+		return;
+	}
+
+	if (munmap (mappedRegion, sbuf.st_size) != 0)
+	{
+		yield_error ("munmap() error");
+		return;
+	}
+
+	// the file is still read, but its OPMPHM is not used
+	KeySet * returned = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, returned, parentKey) == 1, "kdbGet was not successful");
+	succeed_if (returned->opmphm == 0, "OPMPHM of another hash function was used");
+	succeed_if (ksGetSize (returned) == ksGetSize (ks), "wrong number of keys");
+
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		Key * found = ksLookupByName (returned, keyName (ksAtCursor (ks, it)), KDB_O_OPMPHM);
+		succeed_if (found != 0 && !strcmp (keyName (found), keyName (ksAtCursor (ks, it))), "key not found with rebuilt OPMPHM");
+	}
+
+	ksDel (returned);
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
 #endif
 
 static void test_mmap_ksDupFun (const char * tmpFile, KeySet * copyFunction (const KeySet * source))
@@ -1151,6 +1221,9 @@ int main (int argc, char ** argv)
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
 	clearStorage (tmpFile);
 	test_mmap_opmphm (tmpFile);
+
+	clearStorage (tmpFile);
+	test_mmap_opmphm_other_hashfunction (tmpFile);
 #endif
 
 	clearStorage (tmpFile);
@@ -0,0 +1,211 @@
+/**
+ * @file
+ *
+ * @brief Binary framing of keysets for the process plugin protocol
+ *
+ * A keyset is written as the number of keys followed by one record per key,
+ * similar to the records of the quickdump format:
+ * the full name, `s` or `b` for the type of the value, the value and
+ * `m` followed by name and value for every metakey. A `0` byte ends the record.
+ * All numbers and the sizes of names and values are quickdump varints.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <kdb.h>
+#include <kdbhelper.h>
+#include <kdbtypes.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <strings.h>
+
+#include "../quickdump/varint.c"
+
+struct framingbuffer
+{
+	char * data;
+	size_t alloc;
+};
+
+static bool framingWriteData (FILE * file, const char * data, kdb_unsigned_long_long_t size)
+{
+	if (!varintWrite (file, size))
+	{
+		return false;
+	}
+	return size == 0 || fwrite (data, sizeof (char), size, file) == size;
+}
+
+static bool framingReadData (FILE * file, struct framingbuffer * buffer, kdb_unsigned_long_long_t * size)
+{
+	if (!varintRead (file, size))
+	{
+		return false;
+	}
+
+	// the size comes from another process, so it must not overflow the buffer size and its doubling
+	if (*size >= SIZE_MAX / 2)
+	{
+		return false;
+	}
+
+	if (*size + 1 > buffer->alloc)
+	{
+		size_t alloc = buffer->alloc == 0 ? 64 : buffer->alloc;
+		while (*size + 1 > alloc)
+		{
+			if (alloc > SIZE_MAX / 2)
+			{
+				return false;
+			}
+			alloc *= 2;
+		}
+		if (elektraRealloc ((void **) &buffer->data, alloc) < 0)
+		{
+			return false;
+		}
+		buffer->alloc = alloc;
+	}
+
+	if (fread (buffer->data, sizeof (char), *size, file) != *size)
+	{
+		return false;
+	}
+	buffer->data[*size] = '\0';
+	return true;
+}
+
+/**
+ * Writes @p ks in the binary framing to @p file
+ *
+ * @retval true on success
+ * @retval false if writing failed
+ */
+static bool framingWriteKeySet (FILE * file, KeySet * ks)
+{
+	if (!varintWrite (file, ksGetSize (ks)))
+	{
+		return false;
+	}
+
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		Key * cur = ksAtCursor (ks, it);
+
+		if (!framingWriteData (file, keyName (cur), keyGetNameSize (cur) - 1))
+		{
+			return false;
+		}
+
+		if (keyIsBinary (cur))
+		{
+			if (fputc ('b', file) == EOF || !framingWriteData (file, keyValue (cur), keyGetValueSize (cur)))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			if (fputc ('s', file) == EOF || !framingWriteData (file, keyString (cur), keyGetValueSize (cur) - 1))
+			{
+				return false;
+			}
+		}
+
+		KeySet * meta = keyMeta (cur);
+		for (elektraCursor mit = 0; mit < ksGetSize (meta); ++mit)
+		{
+			Key * curMeta = ksAtCursor (meta, mit);
+			if (fputc ('m', file) == EOF || !framingWriteData (file, keyName (curMeta), keyGetNameSize (curMeta) - 1) ||
+			    !framingWriteData (file, keyString (curMeta), keyGetValueSize (curMeta) - 1))
+			{
+				return false;
+			}
+		}
+
+		if (fputc (0, file) == EOF)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Reads a keyset in the binary framing from @p file
+ *
+ * @return the keyset, has to be deleted by the caller
+ * @retval NULL if reading failed or the data was invalid
+ */
+static KeySet * framingReadKeySet (FILE * file)
+{
+	kdb_unsigned_long_long_t count;
+	if (!varintRead (file, &count))
+	{
+		return NULL;
+	}
+
+	struct framingbuffer name = { NULL, 0 };
+	struct framingbuffer value = { NULL, 0 };
+	kdb_unsigned_long_long_t size;
+
+	KeySet * ks = ksNew (count, KS_END);
+	for (kdb_unsigned_long_long_t i = 0; i < count; ++i)
+	{
+		if (!framingReadData (file, &name, &size))
+		{
+			goto error;
+		}
+
+		Key * key = keyNew (name.data, KEY_END);
+		if (key == NULL)
+		{
+			goto error;
+		}
+		ksAppendKey (ks, key);
+
+		int type = fgetc (file);
+		if ((type != 'b' && type != 's') || !framingReadData (file, &value, &size))
+		{
+			goto error;
+		}
+
+		if (type == 'b')
+		{
+			keySetBinary (key, size == 0 ? NULL : value.data, size);
+		}
+		else
+		{
+			keySetString (key, value.data);
+		}
+
+		int c;
+		while ((c = fgetc (file)) == 'm')
+		{
+			if (!framingReadData (file, &name, &size) || !framingReadData (file, &value, &size))
+			{
+				goto error;
+			}
+			keySetMeta (key, name.data, value.data);
+		}
+
+		if (c != 0)
+		{
+			goto error;
+		}
+	}
+
+	elektraFree (name.data);
+	elektraFree (value.data);
+	return ks;
+
+error:
+	elektraFree (name.data);
+	elektraFree (value.data);
+	ksDel (ks);
+	return NULL;
+}
@@ -20,6 +20,8 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include "framing.c"
+
 typedef struct
 {
 	pid_t childPid;
@@ -28,6 +30,8 @@ typedef struct
 	Key * childContractKey;
 	KeySet * childContract;
 	ElektraInvokeHandle * dump;
+	// keysets are sent in the binary framing instead of the dump format
+	bool binary;
 	struct
 	{
 		bool open;
@@ -40,12 +44,14 @@ typedef struct
 #define MSG_HANDSHAKE_HEADER_V1 "ELEKTRA_PROCESS INIT v1\n"
 #define MSG_HANDSHAKE_ACK_V1 "ELEKTRA_PROCESS ACK v1\n"
 #define MSG_TERMINATION "ELEKTRA_PROCESS TERMINATE\n"
+#define MSG_FRAMING_BINARY "ELEKTRA_PROCESS FRAMING binary\n"
 
 
 static char ** readArgs (KeySet * config, const char * arg0);
 static char ** readEnv (KeySet * config);
 static void freeConfigArray (char ** array);
 static int executeOperation (IoData * data, const char * op, KeySet * ks, bool readKs, Key * parentKey);
+static bool writeKeySet (IoData * data, KeySet * ks, Key * errorKey);
 static KeySet * readKeySet (IoData * data, Key * errorKey);
 static void deleteData (IoData * data, Key * errorKey);
 
@@ -252,6 +258,25 @@ int elektraProcessOpen (Plugin * handle, Key * errorKey)
 	}
 	keyDel (closeKey);
 
+	// the child offers the binary framing in its contract, we select it unless the config says otherwise
+	Key * binaryKey = ksLookupByName (contract, "system:/elektra/modules/process/protocol/binary", KDB_O_POP);
+	Key * framingKey = ksLookupByName (config, "/framing", 0);
+	if (binaryKey != NULL && strcmp (keyString (binaryKey), "1") == 0 &&
+	    (framingKey == NULL || strcmp (keyString (framingKey), "dump") != 0))
+	{
+		if (fputs (MSG_FRAMING_BINARY, data->toChild) == EOF)
+		{
+			ELEKTRA_SET_RESOURCE_ERRORF (errorKey, "Could not execute app (framing write failed). Reason: %s", strerror (errno));
+			keyDel (binaryKey);
+			ksDel (contract);
+			deleteData (data, errorKey);
+			free (childName);
+			return ELEKTRA_PLUGIN_STATUS_ERROR;
+		}
+		data->binary = true;
+	}
+	keyDel (binaryKey);
+
 	Key * oldContractRoot = keyNew ("system:/elektra/modules/process", KEY_END);
 	Key * newContractRoot = keyNew ("system:/elektra/modules", KEY_END);
 	keyAddBaseName (newContractRoot, childName);
@@ -541,11 +566,7 @@ static void deleteData (IoData * data, Key * errorKey)
 
 static int executeOperation (IoData * data, const char * op, KeySet * ks, bool readKs, Key * parentKey)
 {
-	typedef int (*fserialize_t) (KeySet *, FILE *, Key *);
-
-	fserialize_t fserialize = *(fserialize_t *) elektraInvokeGetFunction (data->dump, "fserialize");
-
-	if (fserialize == NULL)
+	if (!data->binary && elektraInvokeGetFunction (data->dump, "fserialize") == NULL)
 	{
 		ELEKTRA_SET_INTERFACE_ERRORF (parentKey, "Could not execute  '%s' (write failed). Reason: fserialize missing", op);
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
@@ -559,15 +580,16 @@ static int executeOperation (IoData * data, const char * op, KeySet * ks, bool r
 	}
 
 	KeySet * parentKs = ksNew (1, keyDup (parentKey, KEY_CP_ALL), KS_END);
-	if (fserialize (parentKs, data->toChild, parentKey) < 0)
+	if (!writeKeySet (data, parentKs, parentKey))
 	{
+		ksDel (parentKs);
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 	ksDel (parentKs);
 
 	if (ks != NULL)
 	{
-		if (fserialize (ks, data->toChild, parentKey) < 0)
+		if (!writeKeySet (data, ks, parentKey))
 		{
 			return ELEKTRA_PLUGIN_STATUS_ERROR;
 		}
@@ -632,8 +654,31 @@ static int executeOperation (IoData * data, const char * op, KeySet * ks, bool r
 	return rc;
 }
 
+static bool writeKeySet (IoData * data, KeySet * ks, Key * errorKey)
+{
+	if (data->binary)
+	{
+		if (!framingWriteKeySet (data->toChild, ks))
+		{
+			ELEKTRA_SET_RESOURCE_ERRORF (errorKey, "Could not write keyset to app. Reason: %s", strerror (errno));
+			return false;
+		}
+		return true;
+	}
+
+	typedef int (*fserialize_t) (KeySet *, FILE *, Key *);
+
+	fserialize_t fserialize = *(fserialize_t *) elektraInvokeGetFunction (data->dump, "fserialize");
+	return fserialize (ks, data->toChild, errorKey) >= 0;
+}
+
 static KeySet * readKeySet (IoData * data, Key * errorKey)
 {
+	if (data->binary)
+	{
+		return framingReadKeySet (data->fromChild);
+	}
+
 	typedef int (*funserialize_t) (KeySet *, FILE *, Key *);
 
 	funserialize_t funserialize = *(funserialize_t *) elektraInvokeGetFunction (data->dump, "funserialize");
@@ -0,0 +1,161 @@
+/**
+ * @file
+ *
+ * @brief Test application for the process plugin that supports the binary framing
+ *
+ * Behaves like testapp.sh, but returns the received keyset unchanged apart from
+ * the key `<parent>/operation` and sets the metakey `framing` of the parent key
+ * to the framing that was used. If the first argument is `dump`, the binary
+ * framing is not offered.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <kdbinvoke.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "framing.c"
+
+typedef int (*serialize_t) (KeySet *, FILE *, Key *);
+
+static serialize_t fserialize;
+static serialize_t funserialize;
+static bool binary = false;
+
+static bool writeKeySet (KeySet * ks, Key * errorKey)
+{
+	return binary ? framingWriteKeySet (stdout, ks) : fserialize (ks, stdout, errorKey) >= 0;
+}
+
+static KeySet * readKeySet (Key * errorKey)
+{
+	if (binary)
+	{
+		return framingReadKeySet (stdin);
+	}
+
+	KeySet * ks = ksNew (0, KS_END);
+	if (funserialize (ks, stdin, errorKey) < 0)
+	{
+		ksDel (ks);
+		return NULL;
+	}
+	return ks;
+}
+
+static bool handleOperation (const char * op, bool hasData, Key * errorKey)
+{
+	KeySet * parentKs = readKeySet (errorKey);
+	KeySet * data = hasData ? readKeySet (errorKey) : NULL;
+	if (parentKs == NULL || ksGetSize (parentKs) != 1 || (hasData && data == NULL))
+	{
+		ksDel (parentKs);
+		ksDel (data);
+		return false;
+	}
+
+	Key * parent = ksAtCursor (parentKs, 0);
+	keySetString (parent, op);
+	keySetMeta (parent, "framing", binary ? "binary" : "dump");
+
+	printf ("success\n");
+	bool success = writeKeySet (parentKs, errorKey);
+
+	// the data of open is the config, which is not returned
+	if (success && hasData && strcmp (op, "open") != 0)
+	{
+		Key * operation = keyNew (keyName (parent), KEY_VALUE, op, KEY_END);
+		keyAddBaseName (operation, "operation");
+		ksAppendKey (data, operation);
+		success = writeKeySet (data, errorKey);
+	}
+
+	ksDel (parentKs);
+	ksDel (data);
+	return success;
+}
+
+int main (int argc, char ** argv)
+{
+	bool offerBinary = argc < 2 || strcmp (argv[1], "dump") != 0;
+
+	Key * errorKey = keyNew ("/", KEY_END);
+	ElektraInvokeHandle * dump = elektraInvokeOpen ("dump", NULL, errorKey);
+	if (dump == NULL)
+	{
+		keyDel (errorKey);
+		return EXIT_FAILURE;
+	}
+	fserialize = *(serialize_t *) elektraInvokeGetFunction (dump, "fserialize");
+	funserialize = *(serialize_t *) elektraInvokeGetFunction (dump, "funserialize");
+
+	char * line = NULL;
+	size_t n = 0;
+	if (getline (&line, &n, stdin) < 0 || strcmp (line, "ELEKTRA_PROCESS INIT v1\n") != 0)
+	{
+		free (line);
+		elektraInvokeClose (dump, errorKey);
+		keyDel (errorKey);
+		return EXIT_FAILURE;
+	}
+
+	KeySet * contract = ksNew (8, keyNew ("system:/elektra/modules/process/exports/has/open", KEY_VALUE, "1", KEY_END),
+				   keyNew ("system:/elektra/modules/process/exports/has/close", KEY_VALUE, "1", KEY_END),
+				   keyNew ("system:/elektra/modules/process/exports/has/get", KEY_VALUE, "1", KEY_END),
+				   keyNew ("system:/elektra/modules/process/exports/has/set", KEY_VALUE, "1", KEY_END),
+				   keyNew ("system:/elektra/modules/process/infos/status", KEY_VALUE, "experimental", KEY_END), KS_END);
+	if (offerBinary)
+	{
+		ksAppendKey (contract, keyNew ("system:/elektra/modules/process/protocol/binary", KEY_VALUE, "1", KEY_END));
+	}
+
+	printf ("ELEKTRA_PROCESS ACK v1\ntestapp\n");
+	fserialize (contract, stdout, errorKey);
+	fflush (stdout);
+	ksDel (contract);
+
+	int result = EXIT_FAILURE;
+	ssize_t readBytes;
+	while ((readBytes = getline (&line, &n, stdin)) > 0)
+	{
+		line[readBytes - 1] = '\0';
+
+		bool success;
+		if (strcmp (line, "ELEKTRA_PROCESS FRAMING binary") == 0)
+		{
+			binary = true;
+			success = true;
+		}
+		else if (strcmp (line, "ELEKTRA_PROCESS TERMINATE") == 0)
+		{
+			result = EXIT_SUCCESS;
+			break;
+		}
+		else if (strcmp (line, "open") == 0 || strcmp (line, "get") == 0 || strcmp (line, "set") == 0)
+		{
+			success = handleOperation (line, true, errorKey);
+		}
+		else if (strcmp (line, "close") == 0)
+		{
+			success = handleOperation (line, false, errorKey);
+		}
+		else
+		{
+			success = false;
+		}
+
+		if (!success)
+		{
+			break;
+		}
+		fflush (stdout);
+	}
+
+	free (line);
+	elektraInvokeClose (dump, errorKey);
+	keyDel (errorKey);
+	return result;
+}
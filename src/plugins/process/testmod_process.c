@@ -14,6 +14,8 @@
 
 #include <tests_plugin.h>
 
+#include "framing.c"
+
 static void test_success (void)
 {
 	printf ("test success\n");
@@ -188,6 +190,89 @@ static void test_noupdate (void)
 	PLUGIN_CLOSE ();
 }
 
+static void test_framing (const char * testappArg, const char * framing, const char * expectedFraming)
+{
+	printf ("test framing %s %s\n", testappArg, framing);
+
+	Key * parentKey = keyNew ("user:/tests/process", KEY_END);
+	KeySet * conf = ksNew (4, keyNew ("user:/executable", KEY_VALUE, bindir_file ("elektra-process-testapp"), KEY_END),
+			       keyNew ("user:/args", KEY_VALUE, "#0", KEY_END), keyNew ("user:/args/#0", KEY_VALUE, testappArg, KEY_END),
+			       keyNew ("user:/framing", KEY_VALUE, framing, KEY_END), KS_END);
+	PLUGIN_OPEN ("process");
+
+	char binaryValue[] = { 'a', '\0', '\n', 'b' };
+	Key * binaryKey = keyNew ("user:/tests/process/binary", KEY_BINARY, KEY_SIZE, sizeof (binaryValue), KEY_VALUE, binaryValue, KEY_END);
+	keySetMeta (binaryKey, "meta/first", "1");
+	keySetMeta (binaryKey, "meta/second", "multi\nline");
+	KeySet * ks = ksNew (4, binaryKey, keyNew ("user:/tests/process/empty", KEY_BINARY, KEY_END),
+			     keyNew ("user:/tests/process/string", KEY_VALUE, "$end\nkdbOpen 2", KEY_END),
+			     keyNew ("user:/tests/process/#0/\\/escaped", KEY_VALUE, "", KEY_END), KS_END);
+	KeySet * expected = ksDup (ks);
+	ksAppendKey (expected, keyNew ("user:/tests/process/operation", KEY_VALUE, "get", KEY_END));
+
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	succeed_if_same_string (keyString (parentKey), "get");
+	succeed_if (keyGetMeta (parentKey, "framing") != NULL, "framing missing");
+	succeed_if_same_string (keyString (keyGetMeta (parentKey, "framing")), expectedFraming);
+	compare_keyset (ks, expected);
+
+	Key * empty = ksLookupByName (ks, "user:/tests/process/empty", 0);
+	succeed_if (empty != NULL && keyIsBinary (empty) && keyGetValueSize (empty) == 0, "empty binary value not preserved");
+
+	ksDel (expected);
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
+
+static KeySet * readFraming (kdb_unsigned_long_long_t count, kdb_unsigned_long_long_t size, const char * data)
+{
+	FILE * file = tmpfile ();
+	exit_if_fail (file != NULL, "could not create temporary file");
+	varintWrite (file, count);
+	varintWrite (file, size);
+	fputs (data, file);
+	rewind (file);
+	KeySet * ks = framingReadKeySet (file);
+	fclose (file);
+	return ks;
+}
+
+static void test_framingInvalid (void)
+{
+	printf ("test invalid framing\n");
+
+	// every proper prefix of a valid keyset is rejected
+	KeySet * valid = ksNew (1, keyNew ("user:/tests/abc", KEY_VALUE, "value", KEY_META, "meta", "1", KEY_END), KS_END);
+	FILE * file = tmpfile ();
+	exit_if_fail (file != NULL, "could not create temporary file");
+	succeed_if (framingWriteKeySet (file, valid), "could not write keyset");
+	long length = ftell (file);
+	char * data = elektraMalloc (length);
+	rewind (file);
+	succeed_if (fread (data, 1, length, file) == (size_t) length, "could not read keyset");
+	fclose (file);
+	for (long truncated = 0; truncated < length; ++truncated)
+	{
+		file = tmpfile ();
+		exit_if_fail (file != NULL, "could not create temporary file");
+		fwrite (data, 1, truncated, file);
+		rewind (file);
+		KeySet * ks = framingReadKeySet (file);
+		succeed_if (ks == NULL, "truncated record not rejected");
+		ksDel (ks);
+		fclose (file);
+	}
+	elektraFree (data);
+	ksDel (valid);
+
+	KeySet * ks = readFraming (1, UINT64_MAX, "user:/tests/");
+	succeed_if (ks == NULL, "maximum size not rejected");
+
+	ks = readFraming (1, (kdb_unsigned_long_long_t) SIZE_MAX / 2 + 1, "user:/tests/");
+	succeed_if (ks == NULL, "oversized name not rejected");
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("PROCESS     TESTS\n");
@@ -198,6 +283,10 @@ int main (int argc, char ** argv)
 	test_success ();
 	test_error ();
 	test_noupdate ();
+	test_framing ("binary", "binary", "binary");
+	test_framing ("binary", "dump", "dump");
+	test_framing ("dump", "binary", "dump");
+	test_framingInvalid ();
 
 	print_result ("testmod_process");
 
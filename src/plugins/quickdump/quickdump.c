@@ -11,6 +11,7 @@
 
 #include <kdbendian.h>
 #include <kdbhelper.h>
+#include <kdbprivate.h>
 
 #include <kdberrors.h>
 #include <stdio.h>
@@ -201,7 +202,10 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		}
 
 		char type = ftype;
-		Key * k;
+
+		// names were written by elektraQuickdumpSet and are therefore canonical
+		const char * relativeName = &nameBuffer.string[nameBuffer.offset];
+		Key * k = elektraKeyNewTrusted (parentKey, relativeName, strlen (relativeName));
 
 		switch (type)
 		{
@@ -211,6 +215,7 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			if (!varintRead (file, &valueSize))
 			{
 				ELEKTRA_SET_RESOURCE_ERROR (parentKey, feof (file) ? "Premature end of file" : "Unknown error");
+				keyDel (k);
 				elektraFree (nameBuffer.string);
 				elektraFree (metaNameBuffer.string);
 				elektraFree (valueBuffer.string);
@@ -220,20 +225,23 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 
 			if (valueSize == 0)
 			{
-				k = keyNew (nameBuffer.string, KEY_BINARY, KEY_SIZE, valueSize, KEY_END);
+				keySetBinary (k, NULL, 0);
 			}
 			else
 			{
 				void * value = elektraMalloc (valueSize);
 				if (fread (value, sizeof (char), valueSize, file) < valueSize)
 				{
+					keyDel (k);
+					elektraFree (value);
 					elektraFree (nameBuffer.string);
 					elektraFree (metaNameBuffer.string);
+					elektraFree (valueBuffer.string);
 					fclose (file);
 					ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (parentKey, "Error while reading file");
 					return ELEKTRA_PLUGIN_STATUS_ERROR;
 				}
-				k = keyNew (nameBuffer.string, KEY_BINARY, KEY_SIZE, (size_t) valueSize, KEY_VALUE, value, KEY_END);
+				keySetBinary (k, value, valueSize);
 				elektraFree (value);
 			}
 			break;
@@ -242,16 +250,18 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			// string key value
 			if (!readStringIntoBuffer (file, &valueBuffer, parentKey))
 			{
+				keyDel (k);
 				elektraFree (nameBuffer.string);
 				elektraFree (metaNameBuffer.string);
 				elektraFree (valueBuffer.string);
 				fclose (file);
 				return ELEKTRA_PLUGIN_STATUS_ERROR;
 			}
-			k = keyNew (nameBuffer.string, KEY_VALUE, valueBuffer.string, KEY_END);
+			keySetString (k, valueBuffer.string);
 			break;
 		}
 		default:
+			keyDel (k);
 			elektraFree (nameBuffer.string);
 			elektraFree (metaNameBuffer.string);
 			elektraFree (valueBuffer.string);
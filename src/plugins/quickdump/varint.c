@@ -15,7 +15,7 @@ static bool varintRead (FILE * file, kdb_unsigned_long_long_t * result)
 	int c = fgetc (file);
 	if (c == EOF)
 	{
-		return -1;
+		return false;
 	}
 
 	varintBuf[0] = c;
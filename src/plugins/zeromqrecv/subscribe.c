@@ -11,6 +11,8 @@
 #include <kdbhelper.h>
 #include <kdblogger.h>
 
+#include <errno.h> // EAGAIN
+
 static int setupNotificationCallback (Plugin * handle)
 {
 	ELEKTRA_NOT_NULL (handle);
@@ -44,9 +46,83 @@ static int setupNotificationCallback (Plugin * handle)
 
 /**
  * @internal
- * Called whenever the socket becomes readable.
+ * Receive a single notification.
  * ZeroMq since sends multipart messages atomically (all or nothing)
- * both message parts are instantly available.
+ * all message parts are instantly available.
+ * The first part is the change type, every further part the name of a changed key.
+ *
+ * @param  socket      ZeroMq socket
+ * @param  changedKeys the changed keys of a received notification are appended to it
+ * @retval 1 if a notification was received
+ * @retval 0 if no more messages are available
+ * @retval -1 if a malformed message was skipped
+ */
+static int receiveNotification (void * socket, KeySet * changedKeys)
+{
+	zmq_msg_t message;
+	zmq_msg_init (&message);
+
+	int result = zmq_msg_recv (&message, socket, ZMQ_DONTWAIT);
+	if (result == -1)
+	{
+		int error = zmq_errno ();
+		zmq_msg_close (&message);
+		if (error == EINTR)
+		{
+			return -1;
+		}
+		if (error != EAGAIN)
+		{
+			ELEKTRA_LOG_WARNING ("receiving change type failed: %s; aborting", zmq_strerror (error));
+		}
+		return 0;
+	}
+	if (!zmq_msg_more (&message))
+	{
+		ELEKTRA_LOG_WARNING ("message has only one part; skipping");
+		zmq_msg_close (&message);
+		return -1;
+	}
+	ELEKTRA_LOG_DEBUG ("received change type %.*s", (int) zmq_msg_size (&message), (char *) zmq_msg_data (&message));
+
+	int valid = 1;
+	while (zmq_msg_more (&message))
+	{
+		result = zmq_msg_recv (&message, socket, ZMQ_DONTWAIT);
+		if (result == -1)
+		{
+			ELEKTRA_LOG_WARNING ("receiving key name failed: %s; skipping", zmq_strerror (zmq_errno ()));
+			zmq_msg_close (&message);
+			return -1;
+		}
+		int length = zmq_msg_size (&message);
+		char * changedKeyName = elektraMemDup (zmq_msg_data (&message), length + 1);
+		changedKeyName[length] = '\0';
+		ELEKTRA_LOG_DEBUG ("received key name %s", changedKeyName);
+
+		Key * changedKey = keyNew (changedKeyName, KEY_END);
+		if (changedKey == NULL)
+		{
+			ELEKTRA_LOG_WARNING ("received invalid key name %s; skipping", changedKeyName);
+			valid = 0;
+		}
+		else
+		{
+			ksAppendKey (changedKeys, changedKey);
+		}
+		elektraFree (changedKeyName);
+	}
+
+	zmq_msg_close (&message);
+
+	return valid ? 1 : -1;
+}
+
+/**
+ * @internal
+ * Called whenever the socket becomes readable.
+ * All available notifications are received at once and coalesced:
+ * keys below another changed key are not notified separately.
  *
  * @param socket  ZeroMq socket
  * @param context context passed to elektraIoAdapterZeroMqAttach()
@@ -67,50 +143,24 @@ static void zeroMqRecvSocketReadable (void * socket, void * context)
 		}
 	}
 
-	char * changeType;
-	char * changedKeyName;
-
-	zmq_msg_t message;
-	zmq_msg_init (&message);
-
-	int result = zmq_msg_recv (&message, socket, ZMQ_DONTWAIT);
-	if (result == -1)
-	{
-		ELEKTRA_LOG_WARNING ("receiving change type failed: %s; aborting", zmq_strerror (zmq_errno ()));
-		zmq_msg_close (&message);
-		return;
-	}
-	if (!zmq_msg_more (&message))
-	{
-		ELEKTRA_LOG_WARNING ("message has only one part; aborting");
-		zmq_msg_close (&message);
-		return;
-	}
-	int length = zmq_msg_size (&message);
-	changeType = elektraMemDup (zmq_msg_data (&message), length + 1);
-	changeType[length] = '\0';
-	ELEKTRA_LOG_DEBUG ("received change type %s", changeType);
+	// the socket is edge-triggered, so all queued messages must be received, even after malformed ones
+	KeySet * changedKeys = ksNew (0, KS_END);
+	while (receiveNotification (socket, changedKeys) != 0)
+		;
 
-	result = zmq_msg_recv (&message, socket, ZMQ_DONTWAIT);
-	if (result == -1)
+	// notify about changes, keys below a notified key are sorted right after it
+	Key * notified = NULL;
+	for (elektraCursor it = 0; it < ksGetSize (changedKeys); ++it)
 	{
-		ELEKTRA_LOG_WARNING ("receiving key name failed: %s; aborting", zmq_strerror (zmq_errno ()));
-		elektraFree (changeType);
-		zmq_msg_close (&message);
-		return;
+		Key * current = ksAtCursor (changedKeys, it);
+		if (notified != NULL && keyIsBelow (notified, current) == 1)
+		{
+			continue;
+		}
+		notified = current;
+		data->notificationCallback (keyDup (current, KEY_CP_NAME), data->notificationContext);
 	}
-	length = zmq_msg_size (&message);
-	changedKeyName = elektraMemDup (zmq_msg_data (&message), length + 1);
-	changedKeyName[length] = '\0';
-	ELEKTRA_LOG_DEBUG ("received key name %s", changedKeyName);
-
-	// notify about changes
-	Key * changedKey = keyNew (changedKeyName, KEY_END);
-	data->notificationCallback (changedKey, data->notificationContext);
-
-	zmq_msg_close (&message);
-	elektraFree (changeType);
-	elektraFree (changedKeyName);
+	ksDel (changedKeys);
 }
 
 /**
@@ -146,11 +196,14 @@ void elektraZeroMqRecvSetup (Plugin * handle)
 			return;
 		}
 
-		// subscribe to notifications
-		char * keyCommitType = "Commit";
-		if (zmq_setsockopt (data->zmqSubscriber, ZMQ_SUBSCRIBE, keyCommitType, elektraStrLen (keyCommitType)) != 0)
+		// subscribe to notifications, the key types are sent by zeromqsend with announce=keys
+		const char * changeTypes[] = { "Commit", "KeyAdded", "KeyChanged", "KeyDeleted" };
+		for (size_t i = 0; i < sizeof (changeTypes) / sizeof (changeTypes[0]); ++i)
 		{
-			ELEKTRA_LOG_WARNING ("failed to subscribe to %s messages", keyCommitType);
+			if (zmq_setsockopt (data->zmqSubscriber, ZMQ_SUBSCRIBE, changeTypes[i], elektraStrLen (changeTypes[i])) != 0)
+			{
+				ELEKTRA_LOG_WARNING ("failed to subscribe to %s messages", changeTypes[i]);
+			}
 		}
 
 		// connect to endpoint
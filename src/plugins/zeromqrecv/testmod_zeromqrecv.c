@@ -33,6 +33,7 @@ void * context;
 #define TEST_TIMEOUT 10
 
 Key * test_callbackKey;
+KeySet * test_callbackKeys;
 uv_loop_t * test_callbackLoop;
 int test_incompleteMessageTimeout;
 
@@ -90,6 +91,20 @@ static void test_notificationCallback (Key * key, ElektraNotificationCallbackCon
 	uv_stop (test_callbackLoop);
 }
 
+/**
+ * @internal
+ * Called by plugin when a notification was received.
+ * The keys are collected and the event loop is stopped after two keys.
+ *
+ * @param key     changed key
+ * @param context notification callback context
+ */
+static void test_notificationKeysCallback (Key * key, ElektraNotificationCallbackContext * callbackContext ELEKTRA_UNUSED)
+{
+	ksAppendKey (test_callbackKeys, key);
+	if (ksGetSize (test_callbackKeys) == 2) uv_stop (test_callbackLoop);
+}
+
 /**
  * Timeout for tests.
  *
@@ -156,6 +171,51 @@ static void test_commit (uv_loop_t * loop, ElektraIoInterface * binding)
 	PLUGIN_CLOSE ();
 }
 
+static void test_announcedKeys (uv_loop_t * loop, ElektraIoInterface * binding)
+{
+	printf ("test notification with multiple keys\n");
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("zeromqrecv");
+
+	void * pubSocket = createTestSocket ();
+
+	ksDel (plugin->global);
+	plugin->global =
+		ksNew (5, keyNew ("system:/elektra/io/binding", KEY_BINARY, KEY_SIZE, sizeof (binding), KEY_VALUE, &binding, KEY_END),
+		       keyNew ("system:/elektra/notification/callback", KEY_FUNC, test_notificationKeysCallback, KEY_END), KS_END);
+	// call open again after correctly setting up global keyset
+	plugin->kdbOpen (plugin, NULL);
+
+	usleep (TIME_SETTLE_US);
+
+	// zeromqsend sends all keys of a kdbSet with the same change type in one message
+	char * changeType = "KeyChanged";
+	succeed_if (zmq_send (pubSocket, changeType, elektraStrLen (changeType), ZMQ_SNDMORE) != -1, "failed to send change type");
+	succeed_if (zmq_send (pubSocket, "system:/foo/bar", elektraStrLen ("system:/foo/bar"), ZMQ_SNDMORE) != -1,
+		    "failed to send key name");
+	succeed_if (zmq_send (pubSocket, "system:/foo/baz", elektraStrLen ("system:/foo/baz"), 0) != -1, "failed to send key name");
+
+	ElektraIoTimerOperation * timerOp = elektraIoNewTimerOperation (TEST_TIMEOUT * 1000, 1, test_timerCallback, NULL);
+	elektraIoBindingAddTimer (binding, timerOp);
+
+	test_callbackKeys = ksNew (0, KS_END);
+	test_callbackLoop = loop;
+	uv_run (loop, UV_RUN_DEFAULT);
+
+	succeed_if (ksGetSize (test_callbackKeys) == 2, "not all keys were notified");
+	succeed_if (ksLookupByName (test_callbackKeys, "system:/foo/bar", 0) != NULL, "first key was not notified");
+	succeed_if (ksLookupByName (test_callbackKeys, "system:/foo/baz", 0) != NULL, "second key was not notified");
+
+	zmq_close (pubSocket);
+
+	elektraIoBindingRemoveTimer (timerOp);
+	elektraFree (timerOp);
+	ksDel (test_callbackKeys);
+	ksDel (plugin->global);
+	PLUGIN_CLOSE ();
+}
+
 static void test_incompleteMessage (uv_loop_t * loop, ElektraIoInterface * binding)
 {
 	printf ("test incomplete message\n");
@@ -217,6 +277,7 @@ int main (int argc, char ** argv)
 	ElektraIoInterface * binding = elektraIoUvNew (loop);
 
 	test_commit (loop, binding);
+	test_announcedKeys (loop, binding);
 	test_incompleteMessage (loop, binding);
 
 	print_result ("testmod_zeromqrecv");
@@ -315,15 +315,16 @@ int elektraZeroMqSendConnect (ElektraZeroMqSendPluginData * data)
 /**
  * Publish notification on ZeroMq connection.
  *
- * @param changeType type of change
- * @param keyName    name of changed key
- * @param data       plugin data
+ * @param changeType   type of change
+ * @param keyNames     null-terminated names of the changed keys, one after another
+ * @param keyNamesSize size of keyNames including all null bytes
+ * @param data         plugin data
  * @retval 1 on success
  * @retval -1 on connection timeout
  * @retval -2 on subscription timeout
  * @retval 0 on other errors
  */
-int elektraZeroMqSendPublish (const char * changeType, const char * keyName, ElektraZeroMqSendPluginData * data)
+int elektraZeroMqSendPublish (const char * changeType, const char * keyNames, size_t keyNamesSize, ElektraZeroMqSendPluginData * data)
 {
 	if (!elektraZeroMqSendConnect (data))
 	{
@@ -360,7 +361,7 @@ int elektraZeroMqSendPublish (const char * changeType, const char * keyName, Ele
 	}
 
 	// send notification
-	if (!elektraZeroMqSendNotification (data->zmqPublisher, changeType, keyName))
+	if (!elektraZeroMqSendNotification (data->zmqPublisher, changeType, keyNames, keyNamesSize))
 	{
 		ELEKTRA_LOG_WARNING ("could not send notification");
 		return 0;
@@ -375,14 +376,16 @@ int elektraZeroMqSendPublish (const char * changeType, const char * keyName, Ele
  *
  * zmq_send() asynchronous.
  * Processing already handled in a thread created by ZeroMq.
+ * Every key name is sent as separate part of the same message.
  *
- * @param  socket     ZeroMq socket
- * @param  changeType type of change
- * @param  keyName    name of changed key
+ * @param  socket       ZeroMq socket
+ * @param  changeType   type of change
+ * @param  keyNames     null-terminated names of the changed keys, one after another
+ * @param  keyNamesSize size of keyNames including all null bytes
  * @retval 1 on success
  * @retval 0 on error
  */
-int elektraZeroMqSendNotification (void * socket, const char * changeType, const char * keyName)
+int elektraZeroMqSendNotification (void * socket, const char * changeType, const char * keyNames, size_t keyNamesSize)
 {
 	unsigned int size;
 
@@ -393,10 +396,17 @@ int elektraZeroMqSendNotification (void * socket, const char * changeType, const
 		return 0;
 	}
 
-	size = zmq_send (socket, keyName, elektraStrLen (keyName), 0);
-	if (size != elektraStrLen (keyName))
+	// Send key names
+	size_t offset = 0;
+	while (offset < keyNamesSize)
 	{
-		return 0;
+		const char * keyName = keyNames + offset;
+		offset += elektraStrLen (keyName);
+		size = zmq_send (socket, keyName, elektraStrLen (keyName), offset < keyNamesSize ? ZMQ_SNDMORE : 0);
+		if (size != elektraStrLen (keyName))
+		{
+			return 0;
+		}
 	}
 
 	return 1;
@@ -0,0 +1,207 @@
+/**
+ * @file
+ *
+ * @brief Queue and sender thread for asynchronous notifications
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include "zeromqsend.h"
+
+#include <kdbhelper.h>
+#include <kdblogger.h>
+
+#include <string.h> // strcmp(), memcmp()
+
+static void freeEntry (ElektraZeroMqSendQueueEntry * entry)
+{
+	elektraFree (entry->changeType);
+	elektraFree (entry->keyNames);
+}
+
+/**
+ * @internal
+ * Main function of the sender thread.
+ *
+ * Publishes queued notifications until the queue is empty and
+ * elektraZeroMqSendQueueClose() was called.
+ * After a failed publish during close the remaining notifications are dropped,
+ * so closing waits for at most one connection and subscription timeout.
+ *
+ * @param  arg plugin data
+ * @return     always NULL
+ */
+static void * senderThreadMain (void * arg)
+{
+	ElektraZeroMqSendPluginData * data = arg;
+
+	pthread_mutex_lock (&data->queueMutex);
+	while (1)
+	{
+		while (data->queueLength == 0 && !data->stopSender)
+		{
+			pthread_cond_wait (&data->queueNotEmpty, &data->queueMutex);
+		}
+		if (data->queueLength == 0)
+		{
+			break;
+		}
+
+		ElektraZeroMqSendQueueEntry entry = data->queue[data->queueStart];
+		data->queueStart = (data->queueStart + 1) % data->queueSize;
+		data->queueLength--;
+		pthread_cond_signal (&data->queueNotFull);
+		pthread_mutex_unlock (&data->queueMutex);
+
+		int result = elektraZeroMqSendPublish (entry.changeType, entry.keyNames, entry.keyNamesSize, data);
+		freeEntry (&entry);
+
+		pthread_mutex_lock (&data->queueMutex);
+		if (result != 1)
+		{
+			data->lastResult = result;
+			if (data->stopSender)
+			{
+				while (data->queueLength > 0)
+				{
+					freeEntry (&data->queue[data->queueStart]);
+					data->queueStart = (data->queueStart + 1) % data->queueSize;
+					data->queueLength--;
+				}
+			}
+		}
+	}
+	pthread_mutex_unlock (&data->queueMutex);
+
+	return NULL;
+}
+
+/**
+ * @internal
+ * Enable asynchronous sending.
+ *
+ * @param data             plugin data
+ * @param queueSize        maximum number of queued notifications
+ * @param blockOnFullQueue wait for the sender thread if the queue is full instead of dropping notifications
+ */
+void elektraZeroMqSendQueueInit (ElektraZeroMqSendPluginData * data, size_t queueSize, int blockOnFullQueue)
+{
+	data->queue = elektraCalloc (queueSize * sizeof (ElektraZeroMqSendQueueEntry));
+	data->queueSize = queueSize;
+	data->queueStart = 0;
+	data->queueLength = 0;
+	data->blockOnFullQueue = blockOnFullQueue;
+	data->senderStarted = 0;
+	data->stopSender = 0;
+	data->lastResult = 1;
+	data->dropped = 0;
+	pthread_mutex_init (&data->queueMutex, NULL);
+	pthread_cond_init (&data->queueNotEmpty, NULL);
+	pthread_cond_init (&data->queueNotFull, NULL);
+}
+
+/**
+ * @internal
+ * Queue notification for the sender thread.
+ *
+ * A notification equal to one that is still queued is not queued again.
+ * If the queue is full the notification is dropped, unless the plugin
+ * was configured to wait for the sender thread.
+ *
+ * @param  data         plugin data
+ * @param  changeType   type of change
+ * @param  keyNames     null-terminated names of the changed keys, one after another
+ * @param  keyNamesSize size of keyNames including all null bytes
+ * @retval 1 if the notification was queued or is already queued
+ * @retval 0 if the sender thread could not be started
+ * @retval -1 if the notification was dropped
+ */
+int elektraZeroMqSendEnqueue (ElektraZeroMqSendPluginData * data, const char * changeType, const char * keyNames, size_t keyNamesSize)
+{
+	if (!data->senderStarted)
+	{
+		if (pthread_create (&data->sender, NULL, senderThreadMain, data) != 0)
+		{
+			ELEKTRA_LOG_WARNING ("could not start sender thread");
+			return 0;
+		}
+		data->senderStarted = 1;
+	}
+
+	pthread_mutex_lock (&data->queueMutex);
+	for (size_t i = 0; i < data->queueLength; ++i)
+	{
+		ElektraZeroMqSendQueueEntry * queued = &data->queue[(data->queueStart + i) % data->queueSize];
+		if (!strcmp (queued->changeType, changeType) && queued->keyNamesSize == keyNamesSize &&
+		    !memcmp (queued->keyNames, keyNames, keyNamesSize))
+		{
+			pthread_mutex_unlock (&data->queueMutex);
+			return 1;
+		}
+	}
+
+	while (data->queueLength == data->queueSize && data->blockOnFullQueue)
+	{
+		pthread_cond_wait (&data->queueNotFull, &data->queueMutex);
+	}
+	if (data->queueLength == data->queueSize)
+	{
+		data->dropped++;
+		pthread_mutex_unlock (&data->queueMutex);
+		return -1;
+	}
+
+	ElektraZeroMqSendQueueEntry * entry = &data->queue[(data->queueStart + data->queueLength) % data->queueSize];
+	entry->changeType = elektraStrDup (changeType);
+	entry->keyNames = elektraMemDup (keyNames, keyNamesSize);
+	entry->keyNamesSize = keyNamesSize;
+	data->queueLength++;
+	pthread_cond_signal (&data->queueNotEmpty);
+	pthread_mutex_unlock (&data->queueMutex);
+
+	return 1;
+}
+
+/**
+ * @internal
+ * Get and reset the problems of the sender thread since the last call.
+ *
+ * @param  data    plugin data
+ * @param  dropped will be set to the number of dropped notifications
+ * @return         result of the last failed elektraZeroMqSendPublish() or 1 if there was none
+ */
+int elektraZeroMqSendQueueStatus (ElektraZeroMqSendPluginData * data, size_t * dropped)
+{
+	pthread_mutex_lock (&data->queueMutex);
+	int result = data->lastResult;
+	*dropped = data->dropped;
+	data->lastResult = 1;
+	data->dropped = 0;
+	pthread_mutex_unlock (&data->queueMutex);
+	return result;
+}
+
+/**
+ * @internal
+ * Send the queued notifications and stop the sender thread.
+ *
+ * @param data plugin data
+ */
+void elektraZeroMqSendQueueClose (ElektraZeroMqSendPluginData * data)
+{
+	if (data->senderStarted)
+	{
+		pthread_mutex_lock (&data->queueMutex);
+		data->stopSender = 1;
+		pthread_cond_signal (&data->queueNotEmpty);
+		pthread_mutex_unlock (&data->queueMutex);
+		pthread_join (data->sender, NULL);
+		data->senderStarted = 0;
+	}
+
+	pthread_cond_destroy (&data->queueNotFull);
+	pthread_cond_destroy (&data->queueNotEmpty);
+	pthread_mutex_destroy (&data->queueMutex);
+	elektraFree (data->queue);
+	data->queue = NULL;
+}
@@ -26,6 +26,12 @@ char * receivedChangeType;
 /** key name received by readNotificationFromTestSocket() */
 char * receivedKeyName;
 
+/** last of multiple key names received by readNotificationFromTestSocket() */
+char * receivedLastKeyName;
+
+/** number of key names received by readNotificationFromTestSocket() */
+int receivedKeyCount;
+
 /** variable indicating that a timeout occurred while receiving */
 int receiveTimeout;
 
@@ -41,6 +47,15 @@ void * context;
 /** endpoint for tests */
 #define TEST_ENDPOINT "tcp://127.0.0.1:6002"
 
+/** local endpoint for tests of the sender thread */
+#define TEST_IPC_ENDPOINT "ipc:///tmp/elektra-testmod-zeromqsend"
+
+/** short timeouts for tests of the sender thread without subscriber */
+#define TESTCONFIG_SHORT_TIMEOUT "500"
+
+/** endpoint the test socket binds to */
+const char * testEndpoint = TEST_ENDPOINT;
+
 /** extended timeouts for tests */
 #define TESTCONFIG_CONNECT_TIMEOUT "5000"
 #define TESTCONFIG_SUBSCRIBE_TIMEOUT "5000"
@@ -58,7 +73,7 @@ static void * createTestSocket (char * subscribeFilter)
 	usleep (TIME_HOLDOFF);
 
 	void * subSocket = zmq_socket (context, ZMQ_SUB);
-	int result = zmq_bind (subSocket, TEST_ENDPOINT);
+	int result = zmq_bind (subSocket, testEndpoint);
 	if (result != 0)
 	{
 		yield_error ("zmq_bind failed");
@@ -76,7 +91,7 @@ static void * createTestSocket (char * subscribeFilter)
 /**
  * Main function for notification reader thread.
  *
- * Sets global variables receivedKeyName and receivedChangeType.
+ * Sets global variables receivedKeyName, receivedLastKeyName, receivedKeyCount and receivedChangeType.
  *
  * @internal
  *
@@ -95,7 +110,7 @@ static void * notificationReaderThreadMain (void * filter)
 	size_t moreSize = sizeof (more);
 	int rc;
 	int partCounter = 0;
-	int maxParts = 2; // change type and key name
+	int maxParts = 16; // change type and key names
 	int lastErrno;
 	do
 	{
@@ -153,8 +168,10 @@ static void * notificationReaderThreadMain (void * filter)
 				receivedKeyName = buffer;
 				break;
 			default:
-				yield_error ("test inconsistency");
+				elektraFree (receivedLastKeyName);
+				receivedLastKeyName = buffer;
 			}
+			if (partCounter > 0) receivedKeyCount++;
 
 			partCounter++;
 		}
@@ -228,9 +245,10 @@ static void test_timeoutConnect (void)
 	Key * toAdd = keyNew ("system:/tests/foo/bar", KEY_END);
 	KeySet * ks = ksNew (0, KS_END);
 
-	KeySet * conf = ksNew (3, keyNew ("/endpoint", KEY_VALUE, TEST_ENDPOINT, KEY_END),
+	KeySet * conf = ksNew (4, keyNew ("/endpoint", KEY_VALUE, TEST_ENDPOINT, KEY_END),
 			       keyNew ("/connectTimeout", KEY_VALUE, TESTCONFIG_CONNECT_TIMEOUT, KEY_END),
-			       keyNew ("/subscribeTimeout", KEY_VALUE, TESTCONFIG_SUBSCRIBE_TIMEOUT, KEY_END), KS_END);
+			       keyNew ("/subscribeTimeout", KEY_VALUE, TESTCONFIG_SUBSCRIBE_TIMEOUT, KEY_END),
+			       keyNew ("/async", KEY_VALUE, "0", KEY_END), KS_END);
 	PLUGIN_OPEN ("zeromqsend");
 
 	// initial get to save current state
@@ -259,9 +277,10 @@ static void test_timeoutSubscribe (void)
 	Key * toAdd = keyNew ("system:/tests/foo/bar", KEY_END);
 	KeySet * ks = ksNew (0, KS_END);
 
-	KeySet * conf = ksNew (3, keyNew ("/endpoint", KEY_VALUE, TEST_ENDPOINT, KEY_END),
+	KeySet * conf = ksNew (4, keyNew ("/endpoint", KEY_VALUE, TEST_ENDPOINT, KEY_END),
 			       keyNew ("/connectTimeout", KEY_VALUE, TESTCONFIG_CONNECT_TIMEOUT, KEY_END),
-			       keyNew ("/subscribeTimeout", KEY_VALUE, TESTCONFIG_SUBSCRIBE_TIMEOUT, KEY_END), KS_END);
+			       keyNew ("/subscribeTimeout", KEY_VALUE, TESTCONFIG_SUBSCRIBE_TIMEOUT, KEY_END),
+			       keyNew ("/async", KEY_VALUE, "0", KEY_END), KS_END);
 	PLUGIN_OPEN ("zeromqsend");
 
 	// initial get to save current state
@@ -294,6 +313,244 @@ static void test_timeoutSubscribe (void)
 	elektraFree (thread);
 }
 
+static long elapsedMilliseconds (struct timespec start)
+{
+	struct timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / (1000 * 1000);
+}
+
+static void test_asyncCommit (void)
+{
+	printf ("test commit notification from sender thread\n");
+
+	Key * parentKey = keyNew ("system:/tests/foo", KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+
+	KeySet * conf = ksNew (3, keyNew ("/endpoint", KEY_VALUE, TEST_IPC_ENDPOINT, KEY_END),
+			       keyNew ("/connectTimeout", KEY_VALUE, TESTCONFIG_CONNECT_TIMEOUT, KEY_END),
+			       keyNew ("/subscribeTimeout", KEY_VALUE, TESTCONFIG_SUBSCRIBE_TIMEOUT, KEY_END), KS_END);
+	PLUGIN_OPEN ("zeromqsend");
+
+	plugin->kdbGet (plugin, ks, parentKey);
+	ksAppendKey (ks, keyNew ("system:/tests/foo/bar", KEY_END));
+
+	receiveTimeout = 0;
+	receivedKeyName = NULL;
+	receivedChangeType = NULL;
+
+	testEndpoint = TEST_IPC_ENDPOINT;
+	pthread_t * thread = startNotificationReaderThread ("Commit");
+
+	// the reader thread binds its socket only after TIME_HOLDOFF, a blocking kdbSet would wait for it
+	struct timespec start;
+	clock_gettime (CLOCK_MONOTONIC, &start);
+	plugin->kdbSet (plugin, ks, parentKey);
+	succeed_if (elapsedMilliseconds (start) < TIME_HOLDOFF / 1000 / 2, "kdbSet waited for the notification to be sent");
+
+	pthread_join (*thread, NULL);
+	testEndpoint = TEST_ENDPOINT;
+
+	succeed_if (receiveTimeout == 0, "receiving did time out");
+	succeed_if (!keyGetMeta (parentKey, "warnings"), "warning meta key was set");
+	succeed_if_same_string ("Commit", receivedChangeType);
+	succeed_if_same_string (keyName (parentKey), receivedKeyName);
+
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+	elektraFree (receivedKeyName);
+	elektraFree (receivedChangeType);
+	elektraFree (thread);
+}
+
+static void test_asyncCoalesce (void)
+{
+	printf ("test coalescing of queued notifications\n");
+
+	Key * parentKey = keyNew ("system:/tests/foo", KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+
+	KeySet * conf = ksNew (3, keyNew ("/endpoint", KEY_VALUE, TEST_IPC_ENDPOINT, KEY_END),
+			       keyNew ("/connectTimeout", KEY_VALUE, TESTCONFIG_SHORT_TIMEOUT, KEY_END),
+			       keyNew ("/subscribeTimeout", KEY_VALUE, TESTCONFIG_SHORT_TIMEOUT, KEY_END), KS_END);
+	PLUGIN_OPEN ("zeromqsend");
+	ElektraZeroMqSendPluginData * data = elektraPluginGetData (plugin);
+
+	plugin->kdbGet (plugin, ks, parentKey);
+
+	// pretend the sender thread runs already, so that nothing is taken from the queue
+	data->senderStarted = 1;
+	plugin->kdbSet (plugin, ks, parentKey);
+	plugin->kdbSet (plugin, ks, parentKey);
+	plugin->kdbSet (plugin, ks, parentKey);
+	succeed_if (data->queueLength == 1, "equal notifications were not coalesced");
+
+	// start the sender thread, which takes the queued notification
+	data->senderStarted = 0;
+	plugin->kdbSet (plugin, ks, parentKey);
+	pthread_mutex_lock (&data->queueMutex);
+	succeed_if (data->queueLength <= 1, "equal notifications were not coalesced");
+	pthread_mutex_unlock (&data->queueMutex);
+
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
+
+static void test_asyncDrop (void)
+{
+	printf ("test dropping notifications when queue is full\n");
+
+	Key * parentKey = keyNew ("system:/tests/foo", KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+
+	KeySet * conf = ksNew (4, keyNew ("/endpoint", KEY_VALUE, TEST_IPC_ENDPOINT, KEY_END),
+			       keyNew ("/connectTimeout", KEY_VALUE, TESTCONFIG_SHORT_TIMEOUT, KEY_END),
+			       keyNew ("/subscribeTimeout", KEY_VALUE, TESTCONFIG_SHORT_TIMEOUT, KEY_END),
+			       keyNew ("/queueSize", KEY_VALUE, "1", KEY_END), KS_END);
+	PLUGIN_OPEN ("zeromqsend");
+
+	plugin->kdbGet (plugin, ks, parentKey);
+
+	// different parent keys are not coalesced, at most two fit into the sender thread and the queue
+	char name[32];
+	for (int i = 0; i < 3; ++i)
+	{
+		snprintf (name, sizeof (name), "system:/tests/foo%d", i);
+		keySetName (parentKey, name);
+		plugin->kdbSet (plugin, ks, parentKey);
+	}
+
+	succeed_if (keyGetMeta (parentKey, "warnings"), "no warning for dropped notification");
+
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
+
+/**
+ * Create global keyset with a changeset like the one published by the KDB.
+ * @internal
+ *
+ * @param  added keys added by kdbSet, owned by the returned keyset
+ * @return       new global keyset
+ */
+static KeySet * createGlobalWithChangeSet (KeySet * added)
+{
+	KeySet * changed = ksNew (0, KS_END);
+	KeySet * removed = ksNew (0, KS_END);
+	return ksNew (3, keyNew ("system:/elektra/changeset/added", KEY_BINARY, KEY_SIZE, sizeof (added), KEY_VALUE, &added, KEY_END),
+		      keyNew ("system:/elektra/changeset/changed", KEY_BINARY, KEY_SIZE, sizeof (changed), KEY_VALUE, &changed, KEY_END),
+		      keyNew ("system:/elektra/changeset/removed", KEY_BINARY, KEY_SIZE, sizeof (removed), KEY_VALUE, &removed, KEY_END),
+		      KS_END);
+}
+
+static void deleteGlobalWithChangeSet (KeySet * global)
+{
+	const char * parts[] = { "added", "changed", "removed" };
+	char name[64];
+	for (size_t i = 0; i < sizeof (parts) / sizeof (parts[0]); ++i)
+	{
+		snprintf (name, sizeof (name), "system:/elektra/changeset/%s", parts[i]);
+		ksDel (*(KeySet **) keyValue (ksLookupByName (global, name, 0)));
+	}
+	ksDel (global);
+}
+
+static void test_announceKeys (void)
+{
+	printf ("test notification for changed key\n");
+
+	Key * parentKey = keyNew ("system:/tests/foo", KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+
+	KeySet * conf = ksNew (5, keyNew ("/endpoint", KEY_VALUE, TEST_ENDPOINT, KEY_END),
+			       keyNew ("/connectTimeout", KEY_VALUE, TESTCONFIG_CONNECT_TIMEOUT, KEY_END),
+			       keyNew ("/subscribeTimeout", KEY_VALUE, TESTCONFIG_SUBSCRIBE_TIMEOUT, KEY_END),
+			       keyNew ("/async", KEY_VALUE, "0", KEY_END), keyNew ("/announce", KEY_VALUE, "keys", KEY_END), KS_END);
+	PLUGIN_OPEN ("zeromqsend");
+	KeySet * global = createGlobalWithChangeSet (
+		ksNew (2, keyNew ("system:/tests/foo/bar", KEY_END), keyNew ("system:/tests/foo/baz", KEY_END), KS_END));
+	plugin->global = global;
+
+	plugin->kdbGet (plugin, ks, parentKey);
+	ksAppendKey (ks, keyNew ("system:/tests/foo/bar", KEY_END));
+	ksAppendKey (ks, keyNew ("system:/tests/foo/baz", KEY_END));
+
+	receiveTimeout = 0;
+	receivedKeyName = NULL;
+	receivedLastKeyName = NULL;
+	receivedKeyCount = 0;
+	receivedChangeType = NULL;
+
+	pthread_t * thread = startNotificationReaderThread ("KeyAdded");
+	plugin->kdbSet (plugin, ks, parentKey);
+	pthread_join (*thread, NULL);
+
+	// all keys of a kdbSet with the same change type are sent in one message
+	succeed_if (receiveTimeout == 0, "receiving did time out");
+	succeed_if (!keyGetMeta (parentKey, "warnings"), "warning meta key was set");
+	succeed_if_same_string ("KeyAdded", receivedChangeType);
+	succeed_if (receivedKeyCount == 2, "keys were not sent in one message");
+	succeed_if_same_string ("system:/tests/foo/bar", receivedKeyName);
+	succeed_if_same_string ("system:/tests/foo/baz", receivedLastKeyName);
+
+	ksDel (ks);
+	keyDel (parentKey);
+	plugin->global = NULL;
+	PLUGIN_CLOSE ();
+	deleteGlobalWithChangeSet (global);
+	elektraFree (receivedKeyName);
+	elektraFree (receivedLastKeyName);
+	receivedLastKeyName = NULL;
+	elektraFree (receivedChangeType);
+	elektraFree (thread);
+}
+
+static void test_announceKeysLimit (void)
+{
+	printf ("test commit notification when too many keys changed\n");
+
+	Key * parentKey = keyNew ("system:/tests/foo", KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+
+	KeySet * conf = ksNew (6, keyNew ("/endpoint", KEY_VALUE, TEST_ENDPOINT, KEY_END),
+			       keyNew ("/connectTimeout", KEY_VALUE, TESTCONFIG_CONNECT_TIMEOUT, KEY_END),
+			       keyNew ("/subscribeTimeout", KEY_VALUE, TESTCONFIG_SUBSCRIBE_TIMEOUT, KEY_END),
+			       keyNew ("/async", KEY_VALUE, "0", KEY_END), keyNew ("/announce", KEY_VALUE, "keys", KEY_END),
+			       keyNew ("/announce/limit", KEY_VALUE, "1", KEY_END), KS_END);
+	PLUGIN_OPEN ("zeromqsend");
+	KeySet * global = createGlobalWithChangeSet (
+		ksNew (2, keyNew ("system:/tests/foo/bar", KEY_END), keyNew ("system:/tests/foo/baz", KEY_END), KS_END));
+	plugin->global = global;
+
+	plugin->kdbGet (plugin, ks, parentKey);
+	ksAppendKey (ks, keyNew ("system:/tests/foo/bar", KEY_END));
+	ksAppendKey (ks, keyNew ("system:/tests/foo/baz", KEY_END));
+
+	receiveTimeout = 0;
+	receivedKeyName = NULL;
+	receivedChangeType = NULL;
+
+	pthread_t * thread = startNotificationReaderThread ("Commit");
+	plugin->kdbSet (plugin, ks, parentKey);
+	pthread_join (*thread, NULL);
+
+	succeed_if (receiveTimeout == 0, "receiving did time out");
+	succeed_if_same_string ("Commit", receivedChangeType);
+	succeed_if_same_string (keyName (parentKey), receivedKeyName);
+
+	ksDel (ks);
+	keyDel (parentKey);
+	plugin->global = NULL;
+	PLUGIN_CLOSE ();
+	deleteGlobalWithChangeSet (global);
+	elektraFree (receivedKeyName);
+	elektraFree (receivedChangeType);
+	elektraFree (thread);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("ZEROMQSEND TESTS\n");
@@ -314,6 +571,15 @@ int main (int argc, char ** argv)
 	test_timeoutConnect ();
 	test_timeoutSubscribe ();
 
+	// test sender thread
+	test_asyncCommit ();
+	test_asyncCoalesce ();
+	test_asyncDrop ();
+
+	// test notifications for changed keys
+	test_announceKeys ();
+	test_announceKeysLimit ();
+
 	print_result ("testmod_zeromqsend");
 
 	zmq_ctx_destroy (context);
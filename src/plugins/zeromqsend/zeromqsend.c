@@ -20,6 +20,7 @@
 
 #include <errno.h>  // errno
 #include <stdlib.h> // strtol()
+#include <string.h> // memcpy()
 
 static long convertUnsignedLong (const char * string, long defaultValue)
 {
@@ -62,6 +63,36 @@ int elektraZeroMqSendOpen (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 		subscribeTimeout = convertUnsignedLong (keyString (subscribeTimeoutKey), ELEKTRA_ZEROMQ_DEFAULT_SUBSCRIBE_TIMEOUT);
 	}
 
+	// send notifications in a separate thread unless disabled in plugin configuration
+	Key * asyncKey = ksLookupByName (elektraPluginGetConfig (handle), "/async", 0);
+	int async = !asyncKey || strcmp (keyString (asyncKey), "0") != 0;
+
+	// read size of queue for the sender thread from plugin configuration
+	Key * queueSizeKey = ksLookupByName (elektraPluginGetConfig (handle), "/queueSize", 0);
+	long queueSize = ELEKTRA_ZEROMQ_DEFAULT_QUEUE_SIZE;
+	if (queueSizeKey)
+	{
+		queueSize = convertUnsignedLong (keyString (queueSizeKey), ELEKTRA_ZEROMQ_DEFAULT_QUEUE_SIZE);
+		if (queueSize < 1) queueSize = ELEKTRA_ZEROMQ_DEFAULT_QUEUE_SIZE;
+	}
+
+	// read what to do when the queue is full from plugin configuration
+	Key * overflowKey = ksLookupByName (elektraPluginGetConfig (handle), "/overflow", 0);
+	int blockOnFullQueue = overflowKey && !strcmp (keyString (overflowKey), "block");
+
+	// read whether changed keys are announced from plugin configuration
+	Key * announceKey = ksLookupByName (elektraPluginGetConfig (handle), "/announce", 0);
+	int announce = announceKey && !strcmp (keyString (announceKey), "keys");
+
+	// read maximum number of announced keys from plugin configuration
+	Key * announceLimitKey = ksLookupByName (elektraPluginGetConfig (handle), "/announce/limit", 0);
+	long announceLimit = ELEKTRA_ZEROMQ_DEFAULT_ANNOUNCE_LIMIT;
+	if (announceLimitKey)
+	{
+		announceLimit = convertUnsignedLong (keyString (announceLimitKey), ELEKTRA_ZEROMQ_DEFAULT_ANNOUNCE_LIMIT);
+		if (announceLimit < 0) announceLimit = ELEKTRA_ZEROMQ_DEFAULT_ANNOUNCE_LIMIT;
+	}
+
 	ElektraZeroMqSendPluginData * data = elektraPluginGetData (handle);
 	if (!data)
 	{
@@ -72,13 +103,20 @@ int elektraZeroMqSendOpen (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 		data->connectTimeout = connectTimeout;
 		data->subscribeTimeout = subscribeTimeout;
 		data->hasSubscriber = 0;
+		data->announceKeys = announce;
+		data->announceLimit = announceLimit;
+		data->queue = NULL;
+		if (async)
+		{
+			elektraZeroMqSendQueueInit (data, queueSize, blockOnFullQueue);
+		}
 	}
 	elektraPluginSetData (handle, data);
 
 	return 1; /* success */
 }
 
-int elektraZeroMqSendGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+int elektraZeroMqSendGet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	if (!strcmp (keyName (parentKey), "system:/elektra/modules/zeromqsend"))
 	{
@@ -97,15 +135,101 @@ int elektraZeroMqSendGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		return 1; /* success */
 	}
 
+	ElektraZeroMqSendPluginData * pluginData = elektraPluginGetData (handle);
+	ELEKTRA_NOT_NULL (pluginData);
+
+	// the KDB computes the changed keys for us
+	if (pluginData->announceKeys) elektraPluginRequestChangeSet (handle);
+
 	return 1; /* success */
 }
 
+/**
+ * @internal
+ * Send notification, from the sender thread if enabled.
+ *
+ * @param  pluginData   plugin data
+ * @param  changeType   type of change
+ * @param  keyNames     null-terminated names of the changed keys, one after another
+ * @param  keyNamesSize size of keyNames including all null bytes
+ * @return              result of elektraZeroMqSendPublish() or 1 if the notification was queued
+ */
+static int sendNotification (ElektraZeroMqSendPluginData * pluginData, const char * changeType, const char * keyNames,
+			     size_t keyNamesSize)
+{
+	if (pluginData->queue && elektraZeroMqSendEnqueue (pluginData, changeType, keyNames, keyNamesSize) != 0)
+	{
+		return 1;
+	}
+	return elektraZeroMqSendPublish (changeType, keyNames, keyNamesSize, pluginData);
+}
+
+/**
+ * @internal
+ * Send a single notification for all keys with the same change type.
+ *
+ * @param  pluginData plugin data
+ * @param  ks         changed keys
+ * @param  changeType type of change
+ * @return            result of sendNotification() or 1 if there are no keys
+ */
+static int announceKeys (ElektraZeroMqSendPluginData * pluginData, KeySet * ks, const char * changeType)
+{
+	size_t keyNamesSize = 0;
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		keyNamesSize += elektraStrLen (keyName (ksAtCursor (ks, it)));
+	}
+	if (keyNamesSize == 0) return 1;
+
+	char * keyNames = elektraMalloc (keyNamesSize);
+	size_t offset = 0;
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		const char * name = keyName (ksAtCursor (ks, it));
+		memcpy (keyNames + offset, name, elektraStrLen (name));
+		offset += elektraStrLen (name);
+	}
+
+	int result = sendNotification (pluginData, changeType, keyNames, keyNamesSize);
+	elektraFree (keyNames);
+	return result;
+}
+
 int elektraZeroMqSendSet (Plugin * handle, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
 {
 	ElektraZeroMqSendPluginData * pluginData = elektraPluginGetData (handle);
 	ELEKTRA_NOT_NULL (pluginData);
 
-	int result = elektraZeroMqSendPublish ("Commit", keyName (parentKey), pluginData);
+	// announce the changed keys if there are not too many, otherwise fall back to a single commit notification
+	KeySet * addedKeys;
+	KeySet * changedKeys;
+	KeySet * removedKeys;
+	int result;
+	if (pluginData->announceKeys && elektraPluginGetChangeSet (handle, &addedKeys, &changedKeys, &removedKeys) &&
+	    (size_t) (ksGetSize (addedKeys) + ksGetSize (changedKeys) + ksGetSize (removedKeys)) <= pluginData->announceLimit)
+	{
+		result = announceKeys (pluginData, addedKeys, "KeyAdded");
+		if (result == 1) result = announceKeys (pluginData, changedKeys, "KeyChanged");
+		if (result == 1) result = announceKeys (pluginData, removedKeys, "KeyDeleted");
+	}
+	else
+	{
+		result = sendNotification (pluginData, "Commit", keyName (parentKey), elektraStrLen (keyName (parentKey)));
+	}
+
+	if (result == 1 && pluginData->queue)
+	{
+		// the sender thread publishes the notifications, report its problems since the last kdbSet
+		size_t dropped;
+		result = elektraZeroMqSendQueueStatus (pluginData, &dropped);
+		if (dropped > 0)
+		{
+			ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Dropped %zu notifications because the queue of the sender thread was full",
+						       dropped);
+		}
+	}
+
 	switch (result)
 	{
 	case 1:
@@ -134,6 +258,12 @@ int elektraZeroMqSendClose (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
 		return 1;
 	}
 
+	// the sender thread uses the sockets, so stop it first
+	if (pluginData->queue)
+	{
+		elektraZeroMqSendQueueClose (pluginData);
+	}
+
 	if (pluginData->zmqPublisher)
 	{
 		zmq_close (pluginData->zmqPublisher);
@@ -13,6 +13,7 @@
 #include <kdbassert.h>
 #include <kdbplugin.h>
 
+#include <pthread.h>
 #include <time.h> // struct timespec
 
 #include <zmq.h>
@@ -26,6 +27,24 @@
 /** default subscription timeout for plugin */
 #define ELEKTRA_ZEROMQ_DEFAULT_SUBSCRIBE_TIMEOUT 200
 
+/** default number of notifications queued for the sender thread */
+#define ELEKTRA_ZEROMQ_DEFAULT_QUEUE_SIZE 64
+
+/** default maximum number of changed keys announced per kdbSet() */
+#define ELEKTRA_ZEROMQ_DEFAULT_ANNOUNCE_LIMIT 32
+
+/**
+ * @internal
+ * Notification queued for the sender thread
+ */
+typedef struct
+{
+	char * changeType;
+	// null-terminated key names, one after another
+	char * keyNames;
+	size_t keyNamesSize;
+} ElektraZeroMqSendQueueEntry;
+
 /**
  * @internal
  * Private plugin state
@@ -45,11 +64,40 @@ typedef struct
 	long subscribeTimeout;
 
 	int hasSubscriber;
+
+	// announce the changed keys instead of a single commit notification
+	int announceKeys;
+	size_t announceLimit;
+
+	// ring buffer of notifications for the sender thread (NULL when sending synchronously)
+	ElektraZeroMqSendQueueEntry * queue;
+	size_t queueSize;
+	size_t queueStart;
+	size_t queueLength;
+	// wait for the sender thread instead of dropping notifications when the queue is full
+	int blockOnFullQueue;
+
+	// sender thread (started at first elektraZeroMqSendEnqueue())
+	pthread_t sender;
+	int senderStarted;
+	int stopSender;
+	pthread_mutex_t queueMutex;
+	pthread_cond_t queueNotEmpty;
+	pthread_cond_t queueNotFull;
+
+	// problems of the sender thread, reported by the next kdbSet()
+	int lastResult;
+	size_t dropped;
 } ElektraZeroMqSendPluginData;
 
+void elektraZeroMqSendQueueInit (ElektraZeroMqSendPluginData * data, size_t queueSize, int blockOnFullQueue);
+int elektraZeroMqSendEnqueue (ElektraZeroMqSendPluginData * data, const char * changeType, const char * keyNames, size_t keyNamesSize);
+int elektraZeroMqSendQueueStatus (ElektraZeroMqSendPluginData * data, size_t * dropped);
+void elektraZeroMqSendQueueClose (ElektraZeroMqSendPluginData * data);
+
 int elektraZeroMqSendConnect (ElektraZeroMqSendPluginData * data);
-int elektraZeroMqSendPublish (const char * changeType, const char * keyName, ElektraZeroMqSendPluginData * data);
-int elektraZeroMqSendNotification (void * socket, const char * changeType, const char * keyName);
+int elektraZeroMqSendPublish (const char * changeType, const char * keyNames, size_t keyNamesSize, ElektraZeroMqSendPluginData * data);
+int elektraZeroMqSendNotification (void * socket, const char * changeType, const char * keyNames, size_t keyNamesSize);
 
 int elektraZeroMqSendOpen (Plugin * handle, Key * errorKey);
 int elektraZeroMqSendClose (Plugin * handle, Key * errorKey);
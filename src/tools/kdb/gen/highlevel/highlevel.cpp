@@ -297,6 +297,7 @@ kainjow::mustache::data HighlevelGenTemplate::getTemplateData (const std::string
 	list enums;
 	list structs;
 	list keys;
+	size_t handlesCount = 0;
 	list unions;
 	list commands;
 
@@ -614,6 +615,13 @@ kainjow::mustache::data HighlevelGenTemplate::getTemplateData (const std::string
 			}
 		}
 
+		if (args.empty () && type != "struct" && type != "struct_ref")
+		{
+			// keys with a fixed name are accessed via key handles, that are only resolved once
+			keyObject["handle_id"] = std::to_string (handlesCount++);
+			keyObject["kdb_type"] = "KDB_TYPE_" + snakeCaseToMacroCase (type);
+		}
+
 		keys.emplace_back (keyObject);
 	}
 
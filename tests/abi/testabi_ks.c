@@ -2881,6 +2881,39 @@ static void test_ksAppend3 (void)
 	ksDel (ks);
 }
 
+static void test_ksAppendMerge (void)
+{
+	printf ("Test appending interleaved keysets\n");
+
+	Key * shared = keyNew ("user:/c", KEY_VALUE, "shared", KEY_END);
+	KeySet * ks = ksNew (5, keyNew ("user:/b", KEY_VALUE, "old", KEY_END), shared, keyNew ("user:/d", KEY_VALUE, "old", KEY_END),
+			     keyNew ("user:/f", KEY_END), keyNew ("user:/f/g", KEY_END), KS_END);
+	KeySet * toAppend = ksNew (7, keyNew ("user:/a", KEY_END), keyNew ("user:/b", KEY_VALUE, "new", KEY_END), shared,
+				   keyNew ("user:/d", KEY_VALUE, "new", KEY_END), keyNew ("user:/e", KEY_END),
+				   keyNew ("user:/f/a", KEY_END), keyNew ("user:/z", KEY_END), KS_END);
+
+	succeed_if (ksAppend (ks, toAppend) == 9, "wrong size after merge");
+	const char * expected[] = { "user:/a", "user:/b", "user:/c", "user:/d", "user:/e", "user:/f", "user:/f/a", "user:/f/g", "user:/z" };
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		succeed_if_same_string (keyName (ksAtCursor (ks, it)), expected[it]);
+	}
+	succeed_if_same_string (keyString (ksLookupByName (ks, "user:/b", 0)), "new");
+	succeed_if_same_string (keyString (ksLookupByName (ks, "user:/d", 0)), "new");
+	succeed_if (ksLookupByName (ks, "user:/c", 0) == shared, "key in both keysets was replaced");
+	succeed_if (keyGetRef (shared) == 2, "wrong reference count of key in both keysets");
+	succeed_if (keyGetRef (ksLookupByName (ks, "user:/a", 0)) == 2, "wrong reference count of appended key");
+	succeed_if (keyIsLocked (ksLookupByName (ks, "user:/e", 0), KEY_LOCK_NAME), "name of appended key not locked");
+
+	// appending only existing keys does not change the size
+	succeed_if (ksAppend (ks, toAppend) == 9, "wrong size after appending again");
+	succeed_if (ksAppend (ks, ks) == 9, "wrong size after appending to itself");
+
+	ksDel (toAppend);
+	succeed_if (keyGetRef (ksLookupByName (ks, "user:/a", 0)) == 1, "wrong reference count after deleting appended keyset");
+	ksDel (ks);
+}
+
 
 int main (int argc, char ** argv)
 {
@@ -2934,6 +2967,7 @@ int main (int argc, char ** argv)
 	test_nsLookup ();
 	test_ksAppend2 ();
 	test_ksAppend3 ();
+	test_ksAppendMerge ();
 	test_ksOrderNs ();
 
 	printf ("\ntestabi_ks RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
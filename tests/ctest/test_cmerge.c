@@ -241,6 +241,122 @@ static void array_conflict_number_test (void)
 	keyDel (informationKey);
 }
 
+/**
+ * Many keys with interleaved changes, every fourth key is
+ *  0: changed in ours
+ *  1: removed in theirs
+ *  2: changed differently in ours and theirs (conflict)
+ *  3: unchanged
+ * Additionally, the roots are part of the key sets and there is a key named root below them.
+ */
+static void interleaved_changes_test (void)
+{
+	printf ("Executing %s\n", __func__);
+	Key * our_root = keyNew ("user:/our", KEY_END);
+	Key * their_root = keyNew ("user:/their", KEY_END);
+	Key * base_root = keyNew ("user:/base", KEY_END);
+	Key * result_root = keyNew ("user:/result", KEY_END);
+	Key * informationKey = keyNew ("/", KEY_END);
+	KeySet * our = ksNew (0, KS_END);
+	KeySet * their = ksNew (0, KS_END);
+	KeySet * base = ksNew (0, KS_END);
+	const char * roots[] = { "user:/our", "user:/their", "user:/base" };
+	KeySet * sets[] = { our, their, base };
+	char name[64];
+	for (int set = 0; set < 3; ++set)
+	{
+		ksAppendKey (sets[set], keyNew (roots[set], KEY_VALUE, "parent", KEY_END));
+		snprintf (name, sizeof (name), "%s/root", roots[set]);
+		ksAppendKey (sets[set], keyNew (name, KEY_VALUE, "child", KEY_END));
+		for (int i = 0; i < 200; ++i)
+		{
+			const char * value = ORIGINAL_VALUE;
+			if (i % 4 == 0 && set == 0) value = CHANGED_VALUE;
+			if (i % 4 == 1 && set == 1) continue;
+			if (i % 4 == 2 && set != 2) value = set == 0 ? CHANGED_VALUE : MORE_CHANGED_VALUE;
+			snprintf (name, sizeof (name), "%s/dir%d/key%03d", roots[set], i / 10, i);
+			ksAppendKey (sets[set], keyNew (name, KEY_VALUE, value, KEY_END));
+		}
+	}
+
+	KeySet * result =
+		elektraMerge (our, our_root, their, their_root, base, base_root, result_root, MERGE_STRATEGY_OUR, informationKey);
+	exit_if_fail (result != NULL, "merge failed");
+	succeed_if (getConflicts (informationKey) == 50, "wrong number of conflicts");
+	succeed_if (ksGetSize (result) == 152, "wrong number of keys in result");
+	succeed_if_same_string (keyString (ksLookupByName (result, "user:/result", 0)), "parent");
+	succeed_if_same_string (keyString (ksLookupByName (result, "user:/result/root", 0)), "child");
+	for (int i = 0; i < 200; ++i)
+	{
+		snprintf (name, sizeof (name), "user:/result/dir%d/key%03d", i / 10, i);
+		Key * resultKey = ksLookupByName (result, name, 0);
+		if (i % 4 == 1)
+		{
+			succeed_if (resultKey == NULL, "removed key should not be in result");
+			continue;
+		}
+		exit_if_fail (resultKey != NULL, "key missing in result");
+		succeed_if_same_string (keyString (resultKey), i % 4 == 3 ? ORIGINAL_VALUE : CHANGED_VALUE);
+	}
+
+	ksDel (our);
+	ksDel (their);
+	ksDel (base);
+	ksDel (result);
+	keyDel (our_root);
+	keyDel (their_root);
+	keyDel (base_root);
+	keyDel (result_root);
+	keyDel (informationKey);
+}
+
+static void cascading_namespaces_test (void)
+{
+	printf ("Executing %s\n", __func__);
+	Key * our_root = keyNew ("/our", KEY_END);
+	Key * their_root = keyNew ("/their", KEY_END);
+	Key * base_root = keyNew ("/base", KEY_END);
+	Key * result_root = keyNew ("user:/result", KEY_END);
+	Key * informationKey = keyNew ("/", KEY_END);
+	KeySet * our = ksNew (0, KS_END);
+	KeySet * their = ksNew (0, KS_END);
+	KeySet * base = ksNew (0, KS_END);
+	const char * roots[] = { "/our", "/their", "/base" };
+	KeySet * sets[] = { our, their, base };
+	char name[64];
+	for (int set = 0; set < 3; ++set)
+	{
+		// user:/ keys are ordered before system:/ keys, but here their relative names are greater
+		snprintf (name, sizeof (name), "user:%s/z", roots[set]);
+		ksAppendKey (sets[set], keyNew (name, KEY_VALUE, ORIGINAL_VALUE, KEY_END));
+		snprintf (name, sizeof (name), "system:%s/a", roots[set]);
+		ksAppendKey (sets[set], keyNew (name, KEY_VALUE, set == 1 ? CHANGED_VALUE : ORIGINAL_VALUE, KEY_END));
+	}
+
+	KeySet * result =
+		elektraMerge (our, our_root, their, their_root, base, base_root, result_root, MERGE_STRATEGY_ABORT, informationKey);
+	exit_if_fail (result != NULL, "merge of keys from several namespaces below cascading roots failed");
+	succeed_if (ksGetSize (result) == 2, "wrong number of keys in result");
+	succeed_if_same_string (keyString (ksLookupByName (result, "user:/result/a", 0)), CHANGED_VALUE);
+	succeed_if_same_string (keyString (ksLookupByName (result, "user:/result/z", 0)), ORIGINAL_VALUE);
+
+	// the same relative name in two namespaces is still an error
+	ksAppendKey (our, keyNew ("system:/our/z", KEY_VALUE, ORIGINAL_VALUE, KEY_END));
+	ksDel (result);
+	result = elektraMerge (our, our_root, their, their_root, base, base_root, result_root, MERGE_STRATEGY_ABORT, informationKey);
+	succeed_if (result == NULL, "keys with the same relative name should not be merged");
+
+	ksDel (our);
+	ksDel (their);
+	ksDel (base);
+	ksDel (result);
+	keyDel (our_root);
+	keyDel (their_root);
+	keyDel (base_root);
+	keyDel (result_root);
+	keyDel (informationKey);
+}
+
 static void testValuesWithGivenLength (int size)
 {
 	printf ("Executing %s with size %d\n", __func__, size);
@@ -330,6 +446,8 @@ int main (int argc, char ** argv)
 	test_order ("1", "1", "1", 1, "1");
 	test_order ("2", "1", "1", 1, "2");
 	array_conflict_number_test ();
+	interleaved_changes_test ();
+	cascading_namespaces_test ();
 
 	printf ("\ntest_merge RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
 
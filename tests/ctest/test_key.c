@@ -455,6 +455,33 @@ static void test_keySetName (void)
 		keyDel (dup);
 	}
 
+	// names with and without the need for canonicalization or unescaping must give the same result as the general algorithm
+	const char * names[] = { "/",      "user:/",  "/a",      "system:/a/b", "/a/b/c",   "/a/",      "/a//b",     "/./a",
+				 "/a/..",  "/a/.b",   "/a/%",    "/a/%b",       "/a/#",     "/a/#1",    "/a/#12",    "/a/#_12",
+				 "/a/#1a", "/a\\/b",  "/a\\\\b", "/\\#12",      "/ä/ö",     "dir:/a b", "default:/", "spec:/a/#0",
+				 "user:/a/b/../c", NULL };
+	for (const char ** name = names; *name; ++name)
+	{
+		char * canonical = NULL;
+		size_t canonicalSize = 0;
+		size_t usize = 0;
+		elektraKeyNameCanonicalize (*name, &canonical, &canonicalSize, 0, &usize);
+		char * unescaped = elektraMalloc (usize);
+		elektraKeyNameUnescape (canonical, unescaped);
+
+		succeed_if_fmt (keySetName (key, *name) == (ssize_t) canonicalSize, "wrong size for %s", *name);
+		succeed_if_same_string (keyName (key), canonical);
+		succeed_if_fmt (keyGetUnescapedNameSize (key) == (ssize_t) usize && memcmp (keyUnescapedName (key), unescaped, usize) == 0,
+				"wrong unescaped name for %s", *name);
+
+		elektraFree (canonical);
+		elektraFree (unescaped);
+	}
+
+	succeed_if (keySetName (key, "usr:/a") == -1, "invalid namespace not detected");
+	succeed_if (keySetName (key, "user:a") == -1, "missing slash after namespace not detected");
+	succeed_if (keySetName (key, "a/b") == -1, "missing namespace not detected");
+
 	keyDel (key);
 }
 
@@ -617,6 +644,29 @@ static void test_keyAddName (void)
 	succeed_if_same_string (keyName (k), "system:/elektra/mountpoints/_t_error/config/on_open/error");
 	keyDel (k);
 
+	// names with and without the need for canonicalization or unescaping
+	const char * bases[] = { "/", "user:/", "/a", "system:/a/b", "user:/#_10", NULL };
+	const char * suffixes[] = { "b",   "b/c/d", "#",     "#1",     "#12",    "#_12",         "#1a",  "%",    "%b",    "b/%",  "b/%/c", ".b",
+				    "b/.", "b/..",  "b/...", "a\\/b", "a\\\\b", "b/with space", "b//c", "b/c/", "\\#12", "ä/ö", NULL };
+	for (const char ** base = bases; *base; ++base)
+	{
+		for (const char ** suffix = suffixes; *suffix; ++suffix)
+		{
+			char full[256];
+			snprintf (full, sizeof (full), "%s/%s", *base, *suffix);
+
+			Key * added = keyNew (*base, KEY_END);
+			Key * set = keyNew (full, KEY_END);
+			succeed_if_fmt (keyAddName (added, *suffix) == keyGetNameSize (set), "wrong size for %s", full);
+			succeed_if_same_string (keyName (added), keyName (set));
+			succeed_if_fmt (keyGetUnescapedNameSize (added) == keyGetUnescapedNameSize (set) &&
+						memcmp (keyUnescapedName (added), keyUnescapedName (set), keyGetUnescapedNameSize (set)) == 0,
+					"wrong unescaped name for %s", full);
+			keyDel (added);
+			keyDel (set);
+		}
+	}
+
 	k = keyNew ("user:/", KEY_END);
 	succeed_if (keyAddName (k, "bar\\/foo_bar\\/") == sizeof ("user:/bar\\/foo_bar\\/"), "could not add name");
 	succeed_if_same_string (keyName (k), "user:/bar\\/foo_bar\\/");
@@ -658,6 +708,52 @@ static void test_keyAddName (void)
 	keyDel (k);
 }
 
+static void test_keyNewTrusted (void)
+{
+	printf ("Test elektraKeyNewTrusted\n");
+
+	const char * parents[] = { "/", "user:/", "/a", "system:/a/b", "user:/#_10", NULL };
+	const char * names[] = { "b",     "b/c/d", "#_12", "%",  "b/%",          "%/b",  "a\\/b",
+				 "a\\\\b", "\\#12", "\\%",  "\\.", "b/with space", "ä/ö", NULL };
+	for (const char ** parent = parents; *parent; ++parent)
+	{
+		Key * parentKey = keyNew (*parent, KEY_END);
+		for (const char ** name = names; *name; ++name)
+		{
+			char full[256];
+			snprintf (full, sizeof (full), "%s/%s", *parent, *name);
+
+			Key * trusted = elektraKeyNewTrusted (parentKey, *name, strlen (*name));
+			Key * expected = keyNew (full, KEY_END);
+			succeed_if_same_string (keyName (trusted), keyName (expected));
+			succeed_if_fmt (keyGetUnescapedNameSize (trusted) == keyGetUnescapedNameSize (expected) &&
+						memcmp (keyUnescapedName (trusted), keyUnescapedName (expected),
+							keyGetUnescapedNameSize (expected)) == 0,
+					"wrong unescaped name for %s", full);
+			keyDel (trusted);
+			keyDel (expected);
+		}
+
+		Key * same = elektraKeyNewTrusted (parentKey, "", 0);
+		succeed_if (keyCmp (same, parentKey) == 0, "empty relative name should give parent name");
+		keyDel (same);
+		keyDel (parentKey);
+	}
+
+	// only size bytes are used
+	Key * parentKey = keyNew ("user:/a", KEY_END);
+	Key * trusted = elektraKeyNewTrusted (parentKey, "b/cdef", 3);
+	succeed_if_same_string (keyName (trusted), "user:/a/b/c");
+	keyDel (trusted);
+
+	// a dangling escape must not be read beyond size
+	trusted = elektraKeyNewTrusted (parentKey, "b\\", 2);
+	succeed_if_same_string (keyName (trusted), "user:/a/b\\");
+	succeed_if_same_string (keyBaseName (trusted), "b");
+	keyDel (trusted);
+	keyDel (parentKey);
+}
+
 static void test_keyNeedSync (void)
 {
 	printf ("Test key need sync\n");
@@ -1221,6 +1317,7 @@ int main (int argc, char ** argv)
 	test_keyNameUnescape ();
 	test_keySetName ();
 	test_keyAddName ();
+	test_keyNewTrusted ();
 
 	test_keyRefcounter ();
 	test_keyHelpers ();
@@ -348,6 +348,34 @@ void test_Invalidate (void)
 	}
 }
 
+void test_Large (void)
+{
+	// large enough to hash the keys in parallel if built with OpenMP
+	const size_t n = 2 * OPMPHM_PARALLEL_MIN_N;
+	KeySet * ks = ksNew (n, KS_END);
+	char name[64];
+	for (size_t i = 0; i < n; ++i)
+	{
+		snprintf (name, sizeof (name), "/large/dir%02zu/key%05zu", i % 16, i);
+		ksAppendKey (ks, keyNew (name, KEY_END));
+	}
+	exit_if_fail (ksGetSize (ks) == (ssize_t) n, "wrong size");
+
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		Key * key = ksAtCursor (ks, it);
+		succeed_if_fmt (ksLookup (ks, key, KDB_O_OPMPHM) == key, "key %s not found", keyName (key));
+	}
+	exit_if_fail (ks->opmphm, "build opmphm");
+	succeed_if (opmphmIsBuild (ks->opmphm), "build opmphm");
+
+	Key * notHere = keyNew ("/large/dir00/nothere", KEY_END);
+	succeed_if (!ksLookup (ks, notHere, KDB_O_OPMPHM), "found key that is not there");
+	keyDel (notHere);
+
+	ksDel (ks);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("KS OPMPHM      TESTS\n");
@@ -358,6 +386,7 @@ int main (int argc, char ** argv)
 	test_keyNotFound ();
 	test_Copy ();
 	test_Invalidate ();
+	test_Large ();
 
 	print_result ("test_ks_opmphm");
 
@@ -0,0 +1,228 @@
+/**
+ * @file
+ *
+ * @brief Tests for the search index of KeySets
+ *
+ * @copyright BSD License (see doc/LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <tests_internal.h>
+
+#define NUM_DIRS 10
+#define NUM_KEYS 20
+
+static KeySet * createKeySet (void)
+{
+	KeySet * ks = ksNew (NUM_DIRS * NUM_KEYS, KS_END);
+	char name[64];
+	for (int dir = 0; dir < NUM_DIRS; ++dir)
+	{
+		for (int key = 0; key < NUM_KEYS; ++key)
+		{
+			snprintf (name, sizeof (name), "user:/tests/searchindex/dir%02d/key%03d", dir, key);
+			ksAppendKey (ks, keyNew (name, KEY_END));
+		}
+	}
+	return ks;
+}
+
+static void buildSearchIndex (KeySet * ks)
+{
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		ksLookup (ks, ksAtCursor (ks, it), KDB_O_BINSEARCH);
+	}
+}
+
+static ssize_t linearSearch (KeySet * ks, Key * key)
+{
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		int cmp = keyCmp (key, ksAtCursor (ks, it));
+		if (cmp == 0) return it;
+		if (cmp < 0) return -it - 1;
+	}
+	return -ksGetSize (ks) - 1;
+}
+
+static void checkSearch (KeySet * ks, const char * msg)
+{
+	if (ks->searchIndex)
+	{
+		for (size_t i = 0; i < ks->size; ++i)
+		{
+			succeed_if_fmt (ks->searchIndex[i].name == ks->array[i]->ukey, "%s: index entry %zu does not match", msg, i);
+		}
+	}
+
+	for (elektraCursor it = 0; it < ksGetSize (ks); ++it)
+	{
+		succeed_if_fmt (ksSearch (ks, ksAtCursor (ks, it)) == it, "%s: key %s not found", msg, keyName (ksAtCursor (ks, it)));
+	}
+
+	const char * probes[] = { "user:/tests",
+				  "user:/tests/searchindex",
+				  "user:/tests/searchindex/dir",
+				  "user:/tests/searchindex/dir00",
+				  "user:/tests/searchindex/dir05/key",
+				  "user:/tests/searchindex/dir05/key010/below",
+				  "user:/tests/searchindex/dir05/key0100",
+				  "user:/tests/searchindex/dir05/key999",
+				  "user:/tests/searchindex/dir99",
+				  "user:/tests/searchindex/other",
+				  "user:/zzz",
+				  "system:/tests",
+				  NULL };
+	for (const char ** probe = probes; *probe; ++probe)
+	{
+		Key * key = keyNew (*probe, KEY_END);
+		succeed_if_fmt (ksSearch (ks, key) == linearSearch (ks, key), "%s: wrong position for %s", msg, *probe);
+		keyDel (key);
+	}
+}
+
+static void test_build (void)
+{
+	printf ("Test build\n");
+
+	KeySet * ks = createKeySet ();
+	succeed_if (!ks->searchIndex, "search index should not be built on append");
+
+	buildSearchIndex (ks);
+	exit_if_fail (ks->searchIndex, "search index not built");
+	// all keys share the unescaped name of user:/tests/searchindex/dir0 without its trailing null byte
+	Key * prefix = keyNew ("user:/tests/searchindex/dir0", KEY_END);
+	succeed_if (ks->searchIndexOffset == (size_t) keyGetUnescapedNameSize (prefix) - 1, "wrong offset");
+	keyDel (prefix);
+	checkSearch (ks, "build");
+
+	elektraCursor end;
+	Key * root = keyNew ("user:/tests/searchindex/dir03", KEY_END);
+	succeed_if (ksFindHierarchy (ks, root, &end) == 3 * NUM_KEYS, "wrong start of hierarchy");
+	succeed_if (end == 4 * NUM_KEYS, "wrong end of hierarchy");
+	keyDel (root);
+
+	ksDel (ks);
+
+	KeySet * small = ksNew (2, keyNew ("user:/a", KEY_END), keyNew ("user:/b", KEY_END), KS_END);
+	buildSearchIndex (small);
+	succeed_if (!small->searchIndex, "search index should not be built for small KeySets");
+	ksDel (small);
+}
+
+static void test_append (void)
+{
+	printf ("Test append\n");
+
+	KeySet * ks = createKeySet ();
+	buildSearchIndex (ks);
+	exit_if_fail (ks->searchIndex, "search index not built");
+
+	ksAppendKey (ks, keyNew ("user:/tests/searchindex/dir05/key010/below", KEY_END));
+	succeed_if (ks->searchIndex, "search index should be kept on insert");
+	checkSearch (ks, "insert");
+
+	ksAppendKey (ks, keyNew ("user:/tests/searchindex/dir05/key010", KEY_VALUE, "replaced", KEY_END));
+	succeed_if (ks->searchIndex, "search index should be kept on replace");
+	checkSearch (ks, "replace");
+
+	ksAppendKey (ks, keyNew ("user:/tests/searchindex/dir09/key999", KEY_END));
+	succeed_if (ks->searchIndex, "search index should be kept on append");
+	checkSearch (ks, "append");
+
+	ksAppendKey (ks, keyNew ("user:/tests/searchindex/dir99", KEY_END));
+	succeed_if (!ks->searchIndex, "search index should be dropped if prefix is not shared");
+	checkSearch (ks, "other prefix");
+
+	buildSearchIndex (ks);
+	exit_if_fail (ks->searchIndex, "search index not rebuilt");
+	KeySet * replace = ksNew (2, keyNew ("user:/tests/searchindex/dir01/key001", KEY_VALUE, "replaced", KEY_END),
+				  keyNew ("user:/tests/searchindex/dir08/key008", KEY_VALUE, "replaced", KEY_END), KS_END);
+	ksAppend (ks, replace);
+	succeed_if (ks->searchIndex, "search index should be kept if ksAppend only replaces keys");
+	checkSearch (ks, "ksAppend replace");
+	ksDel (replace);
+
+	KeySet * insert = ksNew (1, keyNew ("user:/tests/searchindex/dir01/key001/below", KEY_END), KS_END);
+	ksAppend (ks, insert);
+	checkSearch (ks, "ksAppend insert");
+	ksDel (insert);
+
+	ksDel (ks);
+}
+
+static void test_remove (void)
+{
+	printf ("Test remove\n");
+
+	KeySet * ks = createKeySet ();
+	buildSearchIndex (ks);
+	exit_if_fail (ks->searchIndex, "search index not built");
+
+	Key * cutpoint = keyNew ("user:/tests/searchindex/dir04", KEY_END);
+	KeySet * cut = ksCut (ks, cutpoint);
+	succeed_if (ksGetSize (cut) == NUM_KEYS, "wrong number of keys cut");
+	succeed_if (ks->searchIndex, "search index should be kept on cut");
+	checkSearch (ks, "cut");
+	ksDel (cut);
+	keyDel (cutpoint);
+
+	keyDel (elektraKsPopAtCursor (ks, 42));
+	succeed_if (ks->searchIndex, "search index should be kept on pop at cursor");
+	checkSearch (ks, "pop at cursor");
+
+	Key * lookup = keyNew ("user:/tests/searchindex/dir07/key007", KEY_END);
+	keyDel (ksLookup (ks, lookup, KDB_O_BINSEARCH | KDB_O_POP));
+	succeed_if (ks->searchIndex, "search index should be kept on lookup with pop");
+	checkSearch (ks, "lookup with pop");
+	keyDel (lookup);
+
+	keyDel (ksPop (ks));
+	succeed_if (ks->searchIndex, "search index should be kept on pop");
+	checkSearch (ks, "pop");
+
+	ksDel (ks);
+}
+
+static void test_rename (void)
+{
+	printf ("Test rename\n");
+
+	KeySet * ks = createKeySet ();
+	buildSearchIndex (ks);
+	exit_if_fail (ks->searchIndex, "search index not built");
+
+	Key * root = keyNew ("user:/tests/searchindex/dir02", KEY_END);
+	Key * newRoot = keyNew ("user:/tests/searchindex/dir20", KEY_END);
+	succeed_if (ksRename (ks, root, newRoot) == NUM_KEYS, "wrong number of keys renamed");
+	succeed_if (!ks->searchIndex, "search index should be dropped on rename");
+	checkSearch (ks, "rename");
+	keyDel (root);
+	keyDel (newRoot);
+
+	buildSearchIndex (ks);
+	exit_if_fail (ks->searchIndex, "search index not rebuilt");
+	checkSearch (ks, "rebuild");
+
+	ksClear (ks);
+	succeed_if (!ks->searchIndex, "search index should be dropped on clear");
+
+	ksDel (ks);
+}
+
+int main (int argc, char ** argv)
+{
+	printf ("KS SEARCH INDEX TESTS\n");
+	printf ("=====================\n\n");
+
+	init (argc, argv);
+
+	test_build ();
+	test_append ();
+	test_remove ();
+	test_rename ();
+
+	print_result ("test_ks_searchindex");
+
+	return nbError;
+}
@@ -61,13 +61,12 @@ static void test_opmphmGraphNew (void)
 				opmphm->hashFunctionSeeds[r] = 0;
 				succeed_if (opmphm->hashFunctionSeeds[r] == 0, "check access opmphm->hashFunctionSeeds");
 			}
-			// check access OpmphmEdge->vertices ,OpmphmEdge->nextEdge and graph->removeSequence
+			// check access OpmphmEdge->vertices and graph->removeSequence
 			for (size_t i = 0; i < n; ++i)
 			{
 				for (uint8_t r = 0; r < rUniPar; ++r)
 				{
 					graph->edges[i].vertices[r] = i * r;
-					graph->edges[i].nextEdge[r] = i * r;
 				}
 				graph->removeSequence[i] = i;
 			}
@@ -76,14 +75,13 @@ static void test_opmphmGraphNew (void)
 				for (uint8_t r = 0; r < rUniPar; ++r)
 				{
 					succeed_if (graph->edges[i].vertices[r] == i * r, "check access OpmphmEdge->vertices");
-					succeed_if (graph->edges[i].nextEdge[r] == i * r, "check access OpmphmEdge->nextEdge");
 				}
 				succeed_if (graph->removeSequence[i] == i, "check access graph->removeSequence");
 			}
 			// check vertices initialization
 			for (size_t i = 0; i < componentSize * rUniPar; ++i)
 			{
-				succeed_if (graph->vertices[i].firstEdge == 0, "check vertices initialization");
+				succeed_if (graph->vertices[i].edgeXor == 0, "check vertices initialization");
 				succeed_if (graph->vertices[i].degree == 0, "check vertices initialization");
 			}
 
@@ -378,6 +376,38 @@ static void test_acyclicReverseOrder (void)
 }
 
 
+static void test_hashfunctions (void)
+{
+	uint32_t (*hashFunctions[]) (const void *, size_t, uint32_t) = { opmphmHashfunctionJenkins, opmphmHashfunctionWyhash };
+	char data[128];
+	for (size_t i = 0; i < sizeof (data); ++i)
+	{
+		data[i] = 'a' + i % 26;
+	}
+	for (size_t h = 0; h < sizeof (hashFunctions) / sizeof (hashFunctions[0]); ++h)
+	{
+		// cover all tail lengths and the multi-lane loop
+		for (size_t length = 1; length < sizeof (data); ++length)
+		{
+			uint32_t hash = hashFunctions[h](data, length, 1337);
+			succeed_if_fmt (hash == hashFunctions[h](data, length, 1337), "hash function %zu not deterministic for length %zu", h,
+					length);
+			succeed_if_fmt (hash != hashFunctions[h](data, length, 4711), "hash function %zu ignores the seed for length %zu", h,
+					length);
+			succeed_if_fmt (hash != hashFunctions[h](data, length - 1, 1337), "hash function %zu ignores the length %zu", h,
+					length);
+			data[length - 1] ^= 1;
+			succeed_if_fmt (hash != hashFunctions[h](data, length, 1337), "hash function %zu ignores the last byte for length %zu",
+					h, length);
+			data[0] ^= 1;
+			data[length - 1] ^= 1;
+			succeed_if_fmt (hash != hashFunctions[h](data, length, 1337), "hash function %zu ignores the first byte for length %zu",
+					h, length);
+			data[0] ^= 1;
+		}
+	}
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("OPMPHM      TESTS\n");
@@ -393,6 +423,7 @@ int main (int argc, char ** argv)
 	test_cyclicCountDownEdges ();
 	test_acyclicDefaultOrder ();
 	test_acyclicReverseOrder ();
+	test_hashfunctions ();
 
 	print_result ("test_opmphm");
 
@@ -383,6 +383,150 @@ TEST_F (Highlevel, PrimitveGetters)
 #endif
 }
 
+TEST_F (Highlevel, HandleGetters)
+{
+	setValues ({
+		makeKey (KDB_TYPE_STRING, "stringkey", "A string"),
+		makeKey (KDB_TYPE_BOOLEAN, "booleankey", "1"),
+		makeKey (KDB_TYPE_CHAR, "charkey", "c"),
+		makeKey (KDB_TYPE_OCTET, "octetkey", "1"),
+		makeKey (KDB_TYPE_SHORT, "shortkey", "1"),
+		makeKey (KDB_TYPE_UNSIGNED_SHORT, "unsignedshortkey", "1"),
+		makeKey (KDB_TYPE_LONG, "longkey", "1"),
+		makeKey (KDB_TYPE_UNSIGNED_LONG, "unsignedlongkey", "1"),
+		makeKey (KDB_TYPE_LONG_LONG, "longlongkey", "1"),
+		makeKey (KDB_TYPE_UNSIGNED_LONG_LONG, "unsignedlonglongkey", "1"),
+		makeKey (KDB_TYPE_FLOAT, "floatkey", "1.1"),
+		makeKey (KDB_TYPE_DOUBLE, "doublekey", "1.1"),
+
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
+		makeKey (KDB_TYPE_LONG_DOUBLE, "longdoublekey", "1.1"),
+
+#endif
+	});
+
+	createElektra ();
+
+	EXPECT_STREQ (elektraGetStringByHandle (elektraKeyHandle (elektra, 0, "stringkey", KDB_TYPE_STRING)), "A string")
+		<< "Wrong key value.";
+	EXPECT_TRUE (elektraGetBooleanByHandle (elektraKeyHandle (elektra, 1, "booleankey", KDB_TYPE_BOOLEAN))) << "Wrong key value.";
+	EXPECT_EQ (elektraGetCharByHandle (elektraKeyHandle (elektra, 2, "charkey", KDB_TYPE_CHAR)), 'c') << "Wrong key value.";
+	EXPECT_EQ (elektraGetOctetByHandle (elektraKeyHandle (elektra, 3, "octetkey", KDB_TYPE_OCTET)), 1) << "Wrong key value.";
+	EXPECT_EQ (elektraGetShortByHandle (elektraKeyHandle (elektra, 4, "shortkey", KDB_TYPE_SHORT)), 1) << "Wrong key value.";
+	EXPECT_EQ (elektraGetUnsignedShortByHandle (elektraKeyHandle (elektra, 5, "unsignedshortkey", KDB_TYPE_UNSIGNED_SHORT)), 1)
+		<< "Wrong key value.";
+	EXPECT_EQ (elektraGetLongByHandle (elektraKeyHandle (elektra, 6, "longkey", KDB_TYPE_LONG)), 1) << "Wrong key value.";
+	EXPECT_EQ (elektraGetUnsignedLongByHandle (elektraKeyHandle (elektra, 7, "unsignedlongkey", KDB_TYPE_UNSIGNED_LONG)), 1)
+		<< "Wrong key value.";
+	EXPECT_EQ (elektraGetLongLongByHandle (elektraKeyHandle (elektra, 8, "longlongkey", KDB_TYPE_LONG_LONG)), 1) << "Wrong key value.";
+	EXPECT_EQ (elektraGetUnsignedLongLongByHandle (elektraKeyHandle (elektra, 9, "unsignedlonglongkey", KDB_TYPE_UNSIGNED_LONG_LONG)), 1)
+		<< "Wrong key value.";
+
+	EXPECT_EQ (elektraGetFloatByHandle (elektraKeyHandle (elektra, 10, "floatkey", KDB_TYPE_FLOAT)), 1.1f) << "Wrong key value.";
+	EXPECT_EQ (elektraGetDoubleByHandle (elektraKeyHandle (elektra, 11, "doublekey", KDB_TYPE_DOUBLE)), 1.1) << "Wrong key value.";
+
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
+	EXPECT_EQ (elektraGetLongDoubleByHandle (elektraKeyHandle (elektra, 12, "longdoublekey", KDB_TYPE_LONG_DOUBLE)), 1.1L)
+		<< "Wrong key value.";
+
+#endif
+
+	// handles are only created once per id
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 6, "longkey", KDB_TYPE_LONG);
+	EXPECT_EQ (elektraKeyHandle (elektra, 6, "longkey", KDB_TYPE_LONG), handle);
+
+	// handles must be resolved again after the config was modified
+	ElektraError * error = nullptr;
+	elektraSetLong (elektra, "longkey", 2, &error);
+	EXPECT_EQ (error, nullptr);
+	EXPECT_EQ (elektraGetLongByHandle (elektraKeyHandle (elektra, 6, "longkey", KDB_TYPE_LONG)), 2) << "Wrong key value.";
+	EXPECT_EQ (elektraFindKeyByHandle (handle), elektraFindKey (elektra, "longkey", KDB_TYPE_LONG));
+
+	// ids do not have to be dense
+	EXPECT_EQ (elektraGetLongByHandle (elektraKeyHandle (elektra, 100, "longkey", KDB_TYPE_LONG)), 2) << "Wrong key value.";
+
+	EXPECT_THROW (elektraKeyHandle (elektra, 13, "missingkey", KDB_TYPE_LONG), std::runtime_error);
+	EXPECT_THROW (elektraKeyHandle (elektra, 14, "longkey", KDB_TYPE_STRING), std::runtime_error);
+	// failed resolutions are reported again
+	EXPECT_THROW (elektraKeyHandle (elektra, 14, "longkey", KDB_TYPE_STRING), std::runtime_error);
+}
+
+TEST_F (Highlevel, HandleValueCache)
+{
+	setValues ({
+		makeKey (KDB_TYPE_LONG, "longkey", "1"),
+	});
+
+	createElektra ();
+
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 0, "longkey", KDB_TYPE_LONG);
+	EXPECT_EQ (elektraGetLongByHandle (handle), 1) << "Wrong key value.";
+
+	// the converted value is cached, direct modifications of the key are not detected
+	ckdb::keySetString (elektraFindKey (elektra, "longkey", KDB_TYPE_LONG), "3");
+	EXPECT_EQ (elektraGetLongByHandle (handle), 1) << "Value was not cached.";
+
+	// the cache is invalidated by elektraSet*
+	ElektraError * error = nullptr;
+	elektraSetLong (elektra, "longkey", 2, &error);
+	EXPECT_EQ (error, nullptr);
+	EXPECT_EQ (elektraGetLongByHandle (elektraKeyHandle (elektra, 0, "longkey", KDB_TYPE_LONG)), 2) << "Wrong key value.";
+
+	// a handle without type caches only the last type read
+	ElektraKeyHandle * untyped = elektraKeyHandle (elektra, 1, "longkey", nullptr);
+	EXPECT_EQ (elektraGetLongByHandle (untyped), 2) << "Wrong key value.";
+	EXPECT_STREQ (elektraGetStringByHandle (untyped), "2") << "Wrong key value.";
+	EXPECT_EQ (elektraGetLongByHandle (untyped), 2) << "Wrong key value.";
+}
+
+TEST_F (Highlevel, Batch)
+{
+	setValues ({
+		makeKey (KDB_TYPE_LONG, "longkey", "1"),
+	});
+
+	createElektra ();
+
+	auto storedConfig = [] () {
+		kdb::KDB kdb;
+		kdb::KeySet config;
+		kdb.get (config, testRoot);
+		return config;
+	};
+
+	ElektraError * error = nullptr;
+	elektraBeginBatch (elektra);
+	elektraSetLong (elektra, "longkey", 2, &error);
+	elektraSetString (elektra, "stringkey", "A string", &error);
+	EXPECT_EQ (error, nullptr);
+
+	// modifications of a batch are visible, but not stored
+	EXPECT_EQ (elektraGetLong (elektra, "longkey"), 2) << "Wrong key value.";
+	EXPECT_STREQ (elektraGetString (elektra, "stringkey"), "A string") << "Wrong key value.";
+	kdb::KeySet config = storedConfig ();
+	EXPECT_KEYVALUE (config.lookup ("user:" + testRoot + "longkey"), "1");
+	EXPECT_FALSE (config.lookup ("user:" + testRoot + "stringkey")) << "Key was stored before commit.";
+
+	elektraCommitBatch (elektra, &error);
+	EXPECT_EQ (error, nullptr);
+	config = storedConfig ();
+	EXPECT_KEYVALUE (config.lookup ("user:" + testRoot + "longkey"), "2");
+	EXPECT_KEYVALUE (config.lookup ("user:" + testRoot + "stringkey"), "A string");
+
+	// after the commit setters store immediately again
+	elektraSetLong (elektra, "longkey", 3, &error);
+	EXPECT_EQ (error, nullptr);
+	EXPECT_KEYVALUE (storedConfig ().lookup ("user:" + testRoot + "longkey"), "3");
+
+	// uncommitted batches are discarded
+	elektraBeginBatch (elektra);
+	elektraSetLong (elektra, "longkey", 4, &error);
+	closeElektra ();
+	EXPECT_KEYVALUE (storedConfig ().lookup ("user:" + testRoot + "longkey"), "3");
+}
+
 TEST_F (Highlevel, ArrayGetters)
 {
 	setArrays ({
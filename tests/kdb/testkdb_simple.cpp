@@ -9,6 +9,8 @@
 
 #include <keysetio.hpp>
 
+#include <kdbproposal.h>
+
 #include <gtest/gtest-elektra.h>
 
 
@@ -261,6 +263,268 @@ TEST_F (Simple, GetSystem)
 	EXPECT_EQ (ks.at (0).getString (), "") << "string of element in keyset wrong";
 }
 
+TEST_F (Simple, GetPrepared)
+{
+	using namespace ckdb;
+	Key * parentKey = keyNew (("system:" + testRoot).c_str (), KEY_END);
+	KDB * handle = kdbOpen (NULL, parentKey);
+	ASSERT_NE (handle, nullptr);
+
+	KeySet * ks = ksNew (0, KS_END);
+	ASSERT_NE (kdbGet (handle, ks, parentKey), -1);
+	ksAppendKey (ks, keyNew (("system:" + testRoot + "key").c_str (), KEY_VALUE, "value1", KEY_END));
+	ASSERT_EQ (kdbSet (handle, ks, parentKey), 1);
+	ksDel (ks);
+	kdbClose (handle, parentKey);
+
+	handle = kdbOpen (NULL, parentKey);
+	KDBPreparedGet * prepared = kdbGetPrepare (handle, parentKey);
+	ASSERT_NE (prepared, nullptr);
+
+	ks = ksNew (0, KS_END);
+	EXPECT_EQ (kdbGetPrepared (prepared, ks, parentKey), 1);
+	ASSERT_EQ (ksGetSize (ks), 1) << "wrong size";
+	EXPECT_STREQ (keyString (ksAtCursor (ks, 0)), "value1") << "string of element in keyset wrong";
+
+	EXPECT_EQ (kdbGetPrepared (prepared, ks, parentKey), 0) << "no update expected";
+	EXPECT_EQ (kdbGetPrepared (prepared, ks, parentKey), 0) << "no update expected";
+	ASSERT_EQ (ksGetSize (ks), 1) << "keys lost on prepared get without update";
+
+	Key * otherKey = keyNew (("user:" + testRoot).c_str (), KEY_END);
+	EXPECT_EQ (kdbGetPrepared (prepared, ks, otherKey), -1) << "different parent key must be rejected";
+	keyDel (otherKey);
+
+	keySetString (ksLookupByName (ks, ("system:" + testRoot + "key").c_str (), 0), "value2");
+	ASSERT_EQ (kdbSet (handle, ks, parentKey), 1);
+	ksDel (ks);
+
+	KDB * other = kdbOpen (NULL, parentKey);
+	KeySet * otherKs = ksNew (0, KS_END);
+	ASSERT_NE (kdbGet (other, otherKs, parentKey), -1);
+	keySetString (ksLookupByName (otherKs, ("system:" + testRoot + "key").c_str (), 0), "value3");
+	ASSERT_EQ (kdbSet (other, otherKs, parentKey), 1);
+	ksDel (otherKs);
+	kdbClose (other, parentKey);
+
+	ks = ksNew (0, KS_END);
+	EXPECT_EQ (kdbGetPrepared (prepared, ks, parentKey), 1) << "changes of other handle not detected";
+	ASSERT_EQ (ksGetSize (ks), 1) << "wrong size";
+	EXPECT_STREQ (keyString (ksAtCursor (ks, 0)), "value3") << "string of element in keyset wrong";
+	ksDel (ks);
+
+	kdbGetPreparedDel (prepared);
+	kdbClose (handle, parentKey);
+	keyDel (parentKey);
+}
+
+TEST_F (Simple, Stats)
+{
+	using namespace ckdb;
+	Key * parentKey = keyNew (("system:" + testRoot).c_str (), KEY_END);
+	KDB * handle = kdbOpen (NULL, parentKey);
+	ASSERT_NE (handle, nullptr);
+	size_t size = 42;
+	EXPECT_EQ (kdbGetStats (handle, &size), nullptr) << "statistics recorded without contract";
+	EXPECT_EQ (size, 0);
+	kdbClose (handle, parentKey);
+
+	KeySet * contract = ksNew (1, keyNew ("system:/elektra/contract/globalkeyset/stats", KEY_END), KS_END);
+	handle = kdbOpen (contract, parentKey);
+	ksDel (contract);
+	ASSERT_NE (handle, nullptr);
+
+	KeySet * ks = ksNew (0, KS_END);
+	ASSERT_NE (kdbGet (handle, ks, parentKey), -1);
+	ksAppendKey (ks, keyNew (("system:" + testRoot + "key").c_str (), KEY_VALUE, "value", KEY_END));
+	ASSERT_EQ (kdbSet (handle, ks, parentKey), 1);
+	ksDel (ks);
+
+	const KDBStatsEntry * entries = kdbGetStats (handle, &size);
+	ASSERT_NE (entries, nullptr);
+	bool kdbGetFound = false;
+	bool kdbSetFound = false;
+	bool resolverFound = false;
+	bool setResolverFound = false;
+	bool commitFound = false;
+	for (size_t i = 0; i < size; ++i)
+	{
+		std::string phase = entries[i].phase;
+		EXPECT_GE (entries[i].calls, 1) << "entry without calls in " << phase;
+		if (entries[i].backend == nullptr)
+		{
+			EXPECT_EQ (entries[i].plugin, nullptr) << "plugin entry without backend in " << phase;
+			if (phase == "kdbget") kdbGetFound = entries[i].calls == 1;
+			if (phase == "kdbset") kdbSetFound = entries[i].calls == 1;
+		}
+		else if (entries[i].plugin != nullptr)
+		{
+			if (phase == "getresolver") resolverFound = true;
+			if (phase == "setresolver") setResolverFound = true;
+			if (phase == "commit") commitFound = true;
+		}
+	}
+	EXPECT_TRUE (kdbGetFound) << "no single call of kdbGet recorded";
+	EXPECT_TRUE (kdbSetFound) << "no single call of kdbSet recorded";
+	EXPECT_TRUE (resolverFound) << "no plugin recorded in getresolver";
+	EXPECT_TRUE (setResolverFound) << "no plugin recorded in setresolver";
+	EXPECT_TRUE (commitFound) << "no plugin recorded in commit";
+
+	kdbClose (handle, parentKey);
+	keyDel (parentKey);
+}
+
+TEST_F (Simple, StatsPositions)
+{
+	using namespace ckdb;
+	const std::string mountpoint = "system:/tests/kdbstats";
+	{
+		using namespace kdb::tools;
+		Backend b;
+		b.setMountpoint (kdb::Key (mountpoint, KEY_END), kdb::KeySet (0, KS_END));
+		b.addPlugin (PluginSpec (KDB_RESOLVER));
+		b.useConfigFile ("kdbStats.dump");
+		b.addPlugin (PluginSpec ("dump"));
+		b.addPlugin (PluginSpec ("logchange"));
+		kdb::KeySet mountpoints;
+		kdb::KDB kdb;
+		kdb::Key mountpointsKey ("system:/elektra/mountpoints", KEY_END);
+		kdb.get (mountpoints, mountpointsKey);
+		b.serialize (mountpoints);
+		kdb.set (mountpoints, mountpointsKey);
+	}
+
+	Key * parentKey = keyNew (mountpoint.c_str (), KEY_END);
+	KeySet * contract = ksNew (1, keyNew ("system:/elektra/contract/globalkeyset/stats", KEY_END), KS_END);
+	KDB * handle = kdbOpen (contract, parentKey);
+	ksDel (contract);
+	ASSERT_NE (handle, nullptr);
+
+	KeySet * ks = ksNew (0, KS_END);
+	ASSERT_NE (kdbGet (handle, ks, parentKey), -1);
+	ksAppendKey (ks, keyNew ((mountpoint + "/key").c_str (), KEY_VALUE, "value", KEY_END));
+	testing::internal::CaptureStdout ();
+	ASSERT_EQ (kdbSet (handle, ks, parentKey), 1);
+	testing::internal::GetCapturedStdout ();
+
+	size_t size = 0;
+	const KDBStatsEntry * entries = kdbGetStats (handle, &size);
+	ASSERT_NE (entries, nullptr);
+	bool postCommitFound = false;
+	for (size_t i = 0; i < size; ++i)
+	{
+		if (entries[i].plugin == nullptr || std::string (entries[i].plugin) != "logchange") continue;
+		std::string phase = entries[i].phase;
+		EXPECT_TRUE (phase == "pregetstorage" || phase == "postgetstorage" || phase == "postcommit")
+			<< "logchange recorded in " << phase;
+		if (phase == "postcommit") postCommitFound = true;
+	}
+	EXPECT_TRUE (postCommitFound) << "logchange not recorded in postcommit";
+
+	unlink (keyString (parentKey));
+	ksDel (ks);
+	kdbClose (handle, parentKey);
+	keyDel (parentKey);
+	testing::Mountpoint::umount (mountpoint);
+}
+
+TEST_F (Simple, ChangeSet)
+{
+	using namespace ckdb;
+	Key * parentKey = keyNew (("system:" + testRoot).c_str (), KEY_END);
+	KDB * handle = kdbOpen (NULL, parentKey);
+	ASSERT_NE (handle, nullptr);
+	KeySet * ks = ksNew (0, KS_END);
+	ASSERT_NE (kdbGet (handle, ks, parentKey), -1);
+	ksAppendKey (ks, keyNew (("system:" + testRoot + "changed").c_str (), KEY_VALUE, "value", KEY_END));
+	ksAppendKey (ks, keyNew (("system:" + testRoot + "removed").c_str (), KEY_VALUE, "value", KEY_END));
+	ksAppendKey (ks, keyNew (("system:" + testRoot + "unchanged").c_str (), KEY_VALUE, "value", KEY_END));
+	ASSERT_EQ (kdbSet (handle, ks, parentKey), 1);
+	ksDel (ks);
+	kdbClose (handle, parentKey);
+
+	KeySet * contract = ksNew (1, keyNew ("system:/elektra/contract/mountglobal/logchange", KEY_END), KS_END);
+	handle = kdbOpen (contract, parentKey);
+	ksDel (contract);
+	ASSERT_NE (handle, nullptr);
+
+	ks = ksNew (0, KS_END);
+	ASSERT_EQ (kdbGet (handle, ks, parentKey), 1);
+
+	keySetString (ksLookupByName (ks, ("system:" + testRoot + "changed").c_str (), 0), "modified");
+	keyDel (ksLookupByName (ks, ("system:" + testRoot + "removed").c_str (), KDB_O_POP));
+	ksAppendKey (ks, keyNew (("system:" + testRoot + "added").c_str (), KEY_VALUE, "value", KEY_END));
+
+	testing::internal::CaptureStdout ();
+	ASSERT_EQ (kdbSet (handle, ks, parentKey), 1);
+	std::string output = testing::internal::GetCapturedStdout ();
+	EXPECT_NE (output.find ("added key: system:" + testRoot + "added\n"), std::string::npos) << output;
+	EXPECT_NE (output.find ("changed key: system:" + testRoot + "changed\n"), std::string::npos) << output;
+	EXPECT_NE (output.find ("removed key: system:" + testRoot + "removed\n"), std::string::npos) << output;
+	EXPECT_EQ (output.find ("unchanged"), std::string::npos) << output;
+
+	ksDel (ks);
+	kdbClose (handle, parentKey);
+	keyDel (parentKey);
+}
+
+TEST_F (Simple, ChangeSetBackend)
+{
+	using namespace ckdb;
+	const std::string mountpoint = "system:/tests/kdbchangeset";
+	{
+		using namespace kdb::tools;
+		Backend b;
+		b.setMountpoint (kdb::Key (mountpoint, KEY_END), kdb::KeySet (0, KS_END));
+		b.addPlugin (PluginSpec (KDB_RESOLVER));
+		b.useConfigFile ("kdbChangeSet.dump");
+		b.addPlugin (PluginSpec ("dump"));
+		b.addPlugin (PluginSpec ("logchange"));
+		kdb::KeySet mountpoints;
+		kdb::KDB kdb;
+		kdb::Key mountpointsKey ("system:/elektra/mountpoints", KEY_END);
+		kdb.get (mountpoints, mountpointsKey);
+		b.serialize (mountpoints);
+		kdb.set (mountpoints, mountpointsKey);
+	}
+
+	Key * parentKey = keyNew (mountpoint.c_str (), KEY_END);
+	KDB * handle = kdbOpen (NULL, parentKey);
+	ASSERT_NE (handle, nullptr);
+	KeySet * ks = ksNew (0, KS_END);
+	ASSERT_NE (kdbGet (handle, ks, parentKey), -1);
+	ksAppendKey (ks, keyNew ((mountpoint + "/changed").c_str (), KEY_VALUE, "value", KEY_END));
+	ksAppendKey (ks, keyNew ((mountpoint + "/removed").c_str (), KEY_VALUE, "value", KEY_END));
+	ksAppendKey (ks, keyNew ((mountpoint + "/unchanged").c_str (), KEY_VALUE, "value", KEY_END));
+	testing::internal::CaptureStdout ();
+	ASSERT_EQ (kdbSet (handle, ks, parentKey), 1);
+	testing::internal::GetCapturedStdout ();
+	kdbClose (handle, parentKey);
+	ksDel (ks);
+
+	handle = kdbOpen (NULL, parentKey);
+	ASSERT_NE (handle, nullptr);
+	ks = ksNew (0, KS_END);
+	ASSERT_EQ (kdbGet (handle, ks, parentKey), 1);
+
+	keySetString (ksLookupByName (ks, (mountpoint + "/changed").c_str (), 0), "modified");
+	keyDel (ksLookupByName (ks, (mountpoint + "/removed").c_str (), KDB_O_POP));
+	ksAppendKey (ks, keyNew ((mountpoint + "/added").c_str (), KEY_VALUE, "value", KEY_END));
+
+	testing::internal::CaptureStdout ();
+	ASSERT_EQ (kdbSet (handle, ks, parentKey), 1);
+	std::string output = testing::internal::GetCapturedStdout ();
+	EXPECT_NE (output.find ("added key: " + mountpoint + "/added\n"), std::string::npos) << output;
+	EXPECT_NE (output.find ("changed key: " + mountpoint + "/changed\n"), std::string::npos) << output;
+	EXPECT_NE (output.find ("removed key: " + mountpoint + "/removed\n"), std::string::npos) << output;
+	EXPECT_EQ (output.find ("unchanged"), std::string::npos) << output;
+
+	unlink (keyString (parentKey));
+	ksDel (ks);
+	kdbClose (handle, parentKey);
+	keyDel (parentKey);
+	testing::Mountpoint::umount (mountpoint);
+}
+
 TEST_F (Simple, WrongStateSystem)
 {
 	using namespace kdb;
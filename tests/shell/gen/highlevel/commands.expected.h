@@ -278,7 +278,8 @@ static inline kdb_long_long_t ELEKTRA_SIZE (ELEKTRA_TAG_DYNAMIC) (Elektra * elek
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_GET) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "get");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 0, "get", KDB_TYPE_STRING);
+	return ELEKTRA_GET_BY_HANDLE (String) (handle);
 }
 
 
@@ -314,7 +315,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_GET_KEYNAME) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "get/keyname");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 1, "get/keyname", KDB_TYPE_STRING);
+	return ELEKTRA_GET_BY_HANDLE (String) (handle);
 }
 
 
@@ -349,7 +351,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_KEYNAME) (Elektra * elektra,
 static inline kdb_long_t ELEKTRA_GET (ELEKTRA_TAG_GET_MAXLENGTH) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Long) (elektra, "get/maxlength");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 2, "get/maxlength", KDB_TYPE_LONG);
+	return ELEKTRA_GET_BY_HANDLE (Long) (handle);
 }
 
 
@@ -385,7 +388,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_MAXLENGTH) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_GET_META) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "get/meta");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 3, "get/meta", KDB_TYPE_STRING);
+	return ELEKTRA_GET_BY_HANDLE (String) (handle);
 }
 
 
@@ -421,7 +425,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_META) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_GET_META_KEYNAME) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "get/meta/keyname");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 4, "get/meta/keyname", KDB_TYPE_STRING);
+	return ELEKTRA_GET_BY_HANDLE (String) (handle);
 }
 
 
@@ -457,7 +462,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_META_KEYNAME) (Elektra * elektra
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_GET_META_METANAME) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "get/meta/metaname");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 5, "get/meta/metaname", KDB_TYPE_STRING);
+	return ELEKTRA_GET_BY_HANDLE (String) (handle);
 }
 
 
@@ -492,7 +498,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_META_METANAME) (Elektra * elektr
 static inline kdb_boolean_t ELEKTRA_GET (ELEKTRA_TAG_GET_META_VERBOSE) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Boolean) (elektra, "get/meta/verbose");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 6, "get/meta/verbose", KDB_TYPE_BOOLEAN);
+	return ELEKTRA_GET_BY_HANDLE (Boolean) (handle);
 }
 
 
@@ -527,7 +534,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_META_VERBOSE) (Elektra * elektra
 static inline kdb_boolean_t ELEKTRA_GET (ELEKTRA_TAG_GET_VERBOSE) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Boolean) (elektra, "get/verbose");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 7, "get/verbose", KDB_TYPE_BOOLEAN);
+	return ELEKTRA_GET_BY_HANDLE (Boolean) (handle);
 }
 
 
@@ -562,7 +570,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GET_VERBOSE) (Elektra * elektra,
 static inline kdb_boolean_t ELEKTRA_GET (ELEKTRA_TAG_PRINTVERSION) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Boolean) (elektra, "printversion");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 8, "printversion", KDB_TYPE_BOOLEAN);
+	return ELEKTRA_GET_BY_HANDLE (Boolean) (handle);
 }
 
 
@@ -598,7 +607,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_PRINTVERSION) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_SETTER) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "setter");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 9, "setter", KDB_TYPE_STRING);
+	return ELEKTRA_GET_BY_HANDLE (String) (handle);
 }
 
 
@@ -634,7 +644,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_SETTER) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_SETTER_KEYNAME) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "setter/keyname");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 10, "setter/keyname", KDB_TYPE_STRING);
+	return ELEKTRA_GET_BY_HANDLE (String) (handle);
 }
 
 
@@ -670,7 +681,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_SETTER_KEYNAME) (Elektra * elektra,
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_SETTER_VALUE) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "setter/value");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 11, "setter/value", KDB_TYPE_STRING);
+	return ELEKTRA_GET_BY_HANDLE (String) (handle);
 }
 
 
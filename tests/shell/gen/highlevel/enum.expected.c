@@ -486,6 +486,18 @@ ELEKTRA_GET_SIGNATURE (ElektraEnumDisjointed, EnumDisjointed)
 	return result;
 }
 
+ELEKTRA_GET_BY_HANDLE_SIGNATURE (ElektraEnumDisjointed, EnumDisjointed)
+{
+	ElektraEnumDisjointed result;
+	const Key * key = elektraFindKeyByHandle (handle);
+	if (key == NULL || !ELEKTRA_KEY_TO (EnumDisjointed) (key, &result))
+	{
+		elektraKeyHandleFatalConversionError (handle, KDB_TYPE_ENUM);
+		return (ElektraEnumDisjointed) 0;
+	}
+	return result;
+}
+
 ELEKTRA_GET_ARRAY_ELEMENT_SIGNATURE (ElektraEnumDisjointed, EnumDisjointed)
 {
 	ElektraEnumDisjointed result;
@@ -533,6 +545,18 @@ ELEKTRA_GET_SIGNATURE (ExistingColors, EnumExistingColors)
 	return result;
 }
 
+ELEKTRA_GET_BY_HANDLE_SIGNATURE (ExistingColors, EnumExistingColors)
+{
+	ExistingColors result;
+	const Key * key = elektraFindKeyByHandle (handle);
+	if (key == NULL || !ELEKTRA_KEY_TO (EnumExistingColors) (key, &result))
+	{
+		elektraKeyHandleFatalConversionError (handle, KDB_TYPE_ENUM);
+		return (ExistingColors) 0;
+	}
+	return result;
+}
+
 ELEKTRA_GET_ARRAY_ELEMENT_SIGNATURE (ExistingColors, EnumExistingColors)
 {
 	ExistingColors result;
@@ -580,6 +604,18 @@ ELEKTRA_GET_SIGNATURE (Colors, EnumColors)
 	return result;
 }
 
+ELEKTRA_GET_BY_HANDLE_SIGNATURE (Colors, EnumColors)
+{
+	Colors result;
+	const Key * key = elektraFindKeyByHandle (handle);
+	if (key == NULL || !ELEKTRA_KEY_TO (EnumColors) (key, &result))
+	{
+		elektraKeyHandleFatalConversionError (handle, KDB_TYPE_ENUM);
+		return (Colors) 0;
+	}
+	return result;
+}
+
 ELEKTRA_GET_ARRAY_ELEMENT_SIGNATURE (Colors, EnumColors)
 {
 	Colors result;
@@ -627,6 +663,18 @@ ELEKTRA_GET_SIGNATURE (ElektraEnumMyenum, EnumMyenum)
 	return result;
 }
 
+ELEKTRA_GET_BY_HANDLE_SIGNATURE (ElektraEnumMyenum, EnumMyenum)
+{
+	ElektraEnumMyenum result;
+	const Key * key = elektraFindKeyByHandle (handle);
+	if (key == NULL || !ELEKTRA_KEY_TO (EnumMyenum) (key, &result))
+	{
+		elektraKeyHandleFatalConversionError (handle, KDB_TYPE_ENUM);
+		return (ElektraEnumMyenum) 0;
+	}
+	return result;
+}
+
 ELEKTRA_GET_ARRAY_ELEMENT_SIGNATURE (ElektraEnumMyenum, EnumMyenum)
 {
 	ElektraEnumMyenum result;
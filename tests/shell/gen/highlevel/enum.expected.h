@@ -79,6 +79,7 @@ ELEKTRA_TO_STRING_SIGNATURE (ElektraEnumDisjointed, EnumDisjointed);
 ELEKTRA_TO_CONST_STRING_SIGNATURE (ElektraEnumDisjointed, EnumDisjointed);
 
 ELEKTRA_GET_SIGNATURE (ElektraEnumDisjointed, EnumDisjointed);
+ELEKTRA_GET_BY_HANDLE_SIGNATURE (ElektraEnumDisjointed, EnumDisjointed);
 ELEKTRA_GET_ARRAY_ELEMENT_SIGNATURE (ElektraEnumDisjointed, EnumDisjointed);
 ELEKTRA_SET_SIGNATURE (ElektraEnumDisjointed, EnumDisjointed);
 ELEKTRA_SET_ARRAY_ELEMENT_SIGNATURE (ElektraEnumDisjointed, EnumDisjointed);
@@ -88,6 +89,7 @@ ELEKTRA_TO_STRING_SIGNATURE (ExistingColors, EnumExistingColors);
 ELEKTRA_TO_CONST_STRING_SIGNATURE (ExistingColors, EnumExistingColors);
 
 ELEKTRA_GET_SIGNATURE (ExistingColors, EnumExistingColors);
+ELEKTRA_GET_BY_HANDLE_SIGNATURE (ExistingColors, EnumExistingColors);
 ELEKTRA_GET_ARRAY_ELEMENT_SIGNATURE (ExistingColors, EnumExistingColors);
 ELEKTRA_SET_SIGNATURE (ExistingColors, EnumExistingColors);
 ELEKTRA_SET_ARRAY_ELEMENT_SIGNATURE (ExistingColors, EnumExistingColors);
@@ -97,6 +99,7 @@ ELEKTRA_TO_STRING_SIGNATURE (Colors, EnumColors);
 ELEKTRA_TO_CONST_STRING_SIGNATURE (Colors, EnumColors);
 
 ELEKTRA_GET_SIGNATURE (Colors, EnumColors);
+ELEKTRA_GET_BY_HANDLE_SIGNATURE (Colors, EnumColors);
 ELEKTRA_GET_ARRAY_ELEMENT_SIGNATURE (Colors, EnumColors);
 ELEKTRA_SET_SIGNATURE (Colors, EnumColors);
 ELEKTRA_SET_ARRAY_ELEMENT_SIGNATURE (Colors, EnumColors);
@@ -106,6 +109,7 @@ ELEKTRA_TO_STRING_SIGNATURE (ElektraEnumMyenum, EnumMyenum);
 ELEKTRA_TO_CONST_STRING_SIGNATURE (ElektraEnumMyenum, EnumMyenum);
 
 ELEKTRA_GET_SIGNATURE (ElektraEnumMyenum, EnumMyenum);
+ELEKTRA_GET_BY_HANDLE_SIGNATURE (ElektraEnumMyenum, EnumMyenum);
 ELEKTRA_GET_ARRAY_ELEMENT_SIGNATURE (ElektraEnumMyenum, EnumMyenum);
 ELEKTRA_SET_SIGNATURE (ElektraEnumMyenum, EnumMyenum);
 ELEKTRA_SET_ARRAY_ELEMENT_SIGNATURE (ElektraEnumMyenum, EnumMyenum);
@@ -228,7 +232,8 @@ ELEKTRA_SET_ARRAY_ELEMENT_SIGNATURE (ElektraEnumMyenum, EnumMyenum);
 static inline ElektraEnumDisjointed ELEKTRA_GET (ELEKTRA_TAG_DISJOINTED) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (EnumDisjointed) (elektra, "disjointed");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 0, "disjointed", KDB_TYPE_ENUM);
+	return ELEKTRA_GET_BY_HANDLE (EnumDisjointed) (handle);
 }
 
 
@@ -263,7 +268,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_DISJOINTED) (Elektra * elektra,
 static inline ExistingColors ELEKTRA_GET (ELEKTRA_TAG_EXISTINGGENTYPE) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (EnumExistingColors) (elektra, "existinggentype");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 1, "existinggentype", KDB_TYPE_ENUM);
+	return ELEKTRA_GET_BY_HANDLE (EnumExistingColors) (handle);
 }
 
 
@@ -298,7 +304,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_EXISTINGGENTYPE) (Elektra * elektra,
 static inline Colors ELEKTRA_GET (ELEKTRA_TAG_GENTYPE) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (EnumColors) (elektra, "gentype");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 2, "gentype", KDB_TYPE_ENUM);
+	return ELEKTRA_GET_BY_HANDLE (EnumColors) (handle);
 }
 
 
@@ -333,7 +340,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GENTYPE) (Elektra * elektra,
 static inline Colors ELEKTRA_GET (ELEKTRA_TAG_GENTYPE2) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (EnumColors) (elektra, "gentype2");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 3, "gentype2", KDB_TYPE_ENUM);
+	return ELEKTRA_GET_BY_HANDLE (EnumColors) (handle);
 }
 
 
@@ -368,7 +376,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_GENTYPE2) (Elektra * elektra,
 static inline ElektraEnumMyenum ELEKTRA_GET (ELEKTRA_TAG_MYENUM) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (EnumMyenum) (elektra, "myenum");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 4, "myenum", KDB_TYPE_ENUM);
+	return ELEKTRA_GET_BY_HANDLE (EnumMyenum) (handle);
 }
 
 
@@ -170,7 +170,8 @@ extern "C" {
 static inline kdb_double_t ELEKTRA_GET (ELEKTRA_TAG_MYDOUBLE) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Double) (elektra, "mydouble");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 0, "mydouble", KDB_TYPE_DOUBLE);
+	return ELEKTRA_GET_BY_HANDLE (Double) (handle);
 }
 
 
@@ -225,7 +226,8 @@ static inline kdb_long_long_t ELEKTRA_SIZE (ELEKTRA_TAG_MYFLOATARRAY) (Elektra *
 static inline kdb_long_t ELEKTRA_GET (ELEKTRA_TAG_MYINT) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Long) (elektra, "myint");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 1, "myint", KDB_TYPE_LONG);
+	return ELEKTRA_GET_BY_HANDLE (Long) (handle);
 }
 
 
@@ -246,7 +248,8 @@ static inline kdb_long_t ELEKTRA_GET (ELEKTRA_TAG_MYINT) (Elektra * elektra )
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_MYSTRING) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "mystring");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 2, "mystring", KDB_TYPE_STRING);
+	return ELEKTRA_GET_BY_HANDLE (String) (handle);
 }
 
 
@@ -266,7 +269,8 @@ static inline const char * ELEKTRA_GET (ELEKTRA_TAG_MYSTRING) (Elektra * elektra
 static inline kdb_boolean_t ELEKTRA_GET (ELEKTRA_TAG_PRINT) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Boolean) (elektra, "print");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 3, "print", KDB_TYPE_BOOLEAN);
+	return ELEKTRA_GET_BY_HANDLE (Boolean) (handle);
 }
 
 
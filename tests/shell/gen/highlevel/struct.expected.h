@@ -338,7 +338,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_MYOTHERSTRUCT) (Elektra * elektra, c
 static inline kdb_long_t ELEKTRA_GET (ELEKTRA_TAG_MYOTHERSTRUCT_X) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Long) (elektra, "myotherstruct/x");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 0, "myotherstruct/x", KDB_TYPE_LONG);
+	return ELEKTRA_GET_BY_HANDLE (Long) (handle);
 }
 
 
@@ -373,7 +374,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_MYOTHERSTRUCT_X) (Elektra * elektra,
 static inline kdb_long_t ELEKTRA_GET (ELEKTRA_TAG_MYOTHERSTRUCT_X_Y) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Long) (elektra, "myotherstruct/x/y");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 1, "myotherstruct/x/y", KDB_TYPE_LONG);
+	return ELEKTRA_GET_BY_HANDLE (Long) (handle);
 }
 
 
@@ -448,7 +450,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_MYSTRUCT) (Elektra * elektra, const
 static inline const char * ELEKTRA_GET (ELEKTRA_TAG_MYSTRUCT_A) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (String) (elektra, "mystruct/a");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 2, "mystruct/a", KDB_TYPE_STRING);
+	return ELEKTRA_GET_BY_HANDLE (String) (handle);
 }
 
 
@@ -483,7 +486,8 @@ static inline void ELEKTRA_SET (ELEKTRA_TAG_MYSTRUCT_A) (Elektra * elektra,
 static inline kdb_long_t ELEKTRA_GET (ELEKTRA_TAG_MYSTRUCT_B) (Elektra * elektra )
 {
 	
-	return ELEKTRA_GET (Long) (elektra, "mystruct/b");
+	ElektraKeyHandle * handle = elektraKeyHandle (elektra, 3, "mystruct/b", KDB_TYPE_LONG);
+	return ELEKTRA_GET_BY_HANDLE (Long) (handle);
 }
 
 